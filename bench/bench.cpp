@@ -0,0 +1,468 @@
+#include "simulator.h"
+#include "circuits.h"
+#include "clock_domain.h"
+#include "event.h"
+#include "event_queue.h"
+#include "trace_writer.h"
+#include "stimulus.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <sys/resource.h>
+#include <time.h>
+
+// Benchmark suite: builds synthetic / ISCAS-style circuits, drives them with
+// deterministic random stimulus and reports throughput per engine backend.
+//
+// Usage: bench [--quick] [--filter SUBSTR] [--out results.json]
+
+struct BenchCase {
+    std::string name;
+    std::function<CircuitPorts(Simulator&)> build;
+    bool sequential;   // Driven by clock cycles instead of input vectors
+    int iterations;    // Input vectors or clock cycles
+};
+
+// An engine configuration applied to a freshly built simulator before the run
+struct Backend {
+    std::string name;
+    std::function<void(Simulator&)> configure;
+};
+
+struct BenchResult {
+    std::string circuit;
+    std::string backend;
+    size_t signals;
+    size_t components;
+    double build_ms;
+    double run_ms;
+    uint64_t events;
+    uint64_t evaluations;
+    uint64_t sim_time;
+    long peak_rss_kb;
+};
+
+// ===== Memory measurement =====
+
+// Reset the kernel's peak-RSS watermark so each case reports its own peak
+// (Linux >= 4.0; elsewhere the process-wide getrusage peak is reported)
+static void reset_peak_rss() {
+    std::ofstream clear("/proc/self/clear_refs");
+    if (clear.is_open()) {
+        clear << "5";
+    }
+}
+
+static long peak_rss_kb() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmHWM:", 0) == 0) {
+            return std::stol(line.substr(6));
+        }
+    }
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// ===== Stimulus =====
+
+static void drive_vectors(Simulator& sim, const CircuitPorts& ports, int vectors, uint32_t seed) {
+    std::mt19937 gen(seed);
+    uint64_t time = 0;
+    for (int v = 0; v < vectors; v++) {
+        for (Signal* in : ports.inputs) {
+            sim.schedule_event(Event(time, in->get_id(), gen() & 1));
+        }
+        sim.run_all();  // Let the vector settle completely
+        time = sim.get_current_time() + 1000;
+    }
+}
+
+// Clock cycles; any other inputs get fresh random values every cycle
+static void drive_clock(Simulator& sim, const CircuitPorts& ports, int cycles, uint32_t seed) {
+    const uint64_t period = 10000;
+    std::mt19937 gen(seed);
+    for (int c = 0; c < cycles; c++) {
+        uint64_t t = (uint64_t)c * period + period / 2;
+        for (Signal* in : ports.inputs) {
+            if (in != ports.clock) {
+                sim.schedule_event(Event(t - period / 4, in->get_id(), gen() & 1));
+            }
+        }
+        sim.schedule_event(Event(t, ports.clock->get_id(), 1));
+        sim.schedule_event(Event(t + period / 2, ports.clock->get_id(), 0));
+        sim.run_until(t + period / 2);
+    }
+    sim.run_all();
+}
+
+// ===== Event queue memory =====
+
+// Bytes of queue storage per pending event, with `pending` events queued at
+// `times` distinct times (1: one wide bus; pending: every event on its own)
+struct QueueMemoryResult {
+    std::string pattern;
+    size_t pending;
+    size_t bytes;
+};
+
+static QueueMemoryResult measure_queue_memory(const std::string& pattern, size_t pending, size_t times) {
+    std::mt19937 gen(12345);
+    EventQueue eq;
+    eq.schedule(Event(0, 0, 0));
+    eq.pop_next();  // Queue time 0: the first later time uses the near FIFO
+    for (size_t i = 0; i < pending; i++) {
+        eq.schedule(Event(1000 + gen() % times, (int)(i % 65536), gen() & 1));
+    }
+    return {pattern, eq.size(), eq.memory_bytes()};
+}
+
+// ===== Runner =====
+
+static double elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static BenchResult run_case(const BenchCase& bc, const Backend& backend) {
+    reset_peak_rss();
+
+    BenchResult r{};
+    r.circuit = bc.name;
+    r.backend = backend.name;
+    {
+        Simulator sim;
+
+        auto start = std::chrono::steady_clock::now();
+        CircuitPorts ports = bc.build(sim);
+        backend.configure(sim);
+        r.build_ms = elapsed_ms(start);
+
+        start = std::chrono::steady_clock::now();
+        if (bc.sequential) {
+            drive_clock(sim, ports, bc.iterations, 12345);
+        } else {
+            drive_vectors(sim, ports, bc.iterations, 12345);
+        }
+        r.run_ms = elapsed_ms(start);
+
+        r.signals = sim.get_signal_count();
+        r.components = sim.get_component_count();
+        r.events = sim.get_events_processed();
+        r.evaluations = sim.get_evaluations();
+        r.sim_time = sim.get_current_time();
+        r.peak_rss_kb = peak_rss_kb();
+    }
+    return r;
+}
+
+// ===== Tracing cost =====
+
+// Run time of one traced case: what tracing adds to the simulation thread,
+// then what close() still waits for (draining, compressing, writing)
+struct TraceCostResult {
+    std::string mode;
+    double run_ms;
+    double run_cpu_ms;  // Simulation thread only (background threads excluded)
+    double close_ms;
+    uint64_t changes;
+    uint64_t stalls;
+    uint64_t dropped;
+    uint64_t file_bytes;
+};
+
+static double thread_cpu_ms() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static TraceCostResult measure_trace_cost(const std::string& mode, int vectors, bool store,
+                                          const TraceWriter::Options* options) {
+    const std::string path = "bench_trace.tmp";
+    TraceCostResult r{};
+    r.mode = mode;
+    Simulator sim;
+    CircuitPorts ports = build_random_dag(sim, 64, 10000, 2, 1);
+    std::unique_ptr<TraceWriter> writer;
+    if (options) {
+        writer.reset(new TraceWriter(sim, path, *options));
+        sim.enable_trace(writer.get());
+    } else if (store) {
+        sim.enable_trace(path);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    double cpu_start = thread_cpu_ms();
+    drive_vectors(sim, ports, vectors, 12345);
+    r.run_ms = elapsed_ms(start);
+    r.run_cpu_ms = thread_cpu_ms() - cpu_start;
+
+    start = std::chrono::steady_clock::now();
+    if (writer) {
+        writer->close(sim.get_current_time());
+        r.changes = writer->pushed();
+        r.stalls = writer->stalls();
+        r.dropped = writer->dropped();
+        r.file_bytes = writer->file_bytes();
+    } else if (store) {
+        sim.disable_trace();
+        r.changes = sim.get_trace_store()->record_count();
+        r.file_bytes = sim.get_trace_store()->mapped_bytes();
+    }
+    r.close_ms = elapsed_ms(start);
+
+    std::remove(path.c_str());
+    std::remove((path + ".0.rec").c_str());
+    std::remove((path + ".0.idx").c_str());
+    for (int k = 1; k < 16; k++) {
+        std::remove((path + "." + std::to_string(k) + ".rec").c_str());
+        std::remove((path + "." + std::to_string(k) + ".idx").c_str());
+    }
+    return r;
+}
+
+// ===== Stimulus cost =====
+
+// Generating and queueing `vectors` random vectors on 64 inputs (no
+// gates): a per-event mt19937 loop against Philox streams scheduled in bulk
+struct StimulusCostResult {
+    std::string mode;
+    double ms;
+    uint64_t events;
+};
+
+static StimulusCostResult measure_stimulus(const std::string& mode, size_t vectors) {
+    const uint64_t period = 1000;
+    Simulator sim;
+    std::vector<Signal*> inputs;
+    for (int i = 0; i < 64; i++) {
+        inputs.push_back(sim.create_signal("in" + std::to_string(i), 0));
+    }
+    StimulusGenerator gen(12345);
+    gen.add_inputs(inputs);
+
+    StimulusCostResult r{mode, 0, 0};
+    auto start = std::chrono::steady_clock::now();
+    if (mode == "mt19937_per_event") {
+        std::mt19937 rng(12345);
+        for (size_t v = 0; v < vectors; v++) {
+            for (Signal* in : inputs) {
+                sim.schedule_event(Event(v * period, in->get_id(), rng() & 1));
+            }
+        }
+        r.events = vectors * inputs.size();
+    } else if (mode == "philox_generate") {
+        std::vector<uint8_t> values;
+        gen.generate(0, vectors, values);
+        r.events = values.size();
+    } else {
+        r.events = gen.schedule(sim, 0, vectors, 0, period, mode == "philox_batch_changes");
+    }
+    r.ms = elapsed_ms(start);
+    return r;
+}
+
+static double per_second(uint64_t count, double ms) {
+    return ms > 0 ? count / (ms / 1000.0) : 0.0;
+}
+
+static void print_result(const BenchResult& r) {
+    std::cout << std::left;
+    std::cout.width(22); std::cout << r.circuit;
+    std::cout.width(15); std::cout << r.backend;
+    std::cout.width(10); std::cout << r.components;
+    std::cout.width(12); std::cout << r.events;
+    std::cout.width(14); std::cout << (uint64_t)per_second(r.events, r.run_ms);
+    std::cout.width(14); std::cout << (uint64_t)per_second(r.evaluations, r.run_ms);
+    std::cout.width(10); std::cout << (r.events ? r.run_ms * 1e6 / r.events : 0.0);
+    std::cout << r.peak_rss_kb << "\n";
+}
+
+static void write_json(const std::string& filename, const std::vector<BenchResult>& results,
+                       const std::vector<QueueMemoryResult>& queue_memory,
+                       const std::vector<TraceCostResult>& trace_cost,
+                       const std::vector<StimulusCostResult>& stimulus) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+
+    file << "{\n  \"schema\": 1,\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        file << "    {\"circuit\": \"" << r.circuit << "\", "
+             << "\"backend\": \"" << r.backend << "\", "
+             << "\"signals\": " << r.signals << ", "
+             << "\"components\": " << r.components << ", "
+             << "\"build_ms\": " << r.build_ms << ", "
+             << "\"run_ms\": " << r.run_ms << ", "
+             << "\"events\": " << r.events << ", "
+             << "\"evaluations\": " << r.evaluations << ", "
+             << "\"sim_time_ps\": " << r.sim_time << ", "
+             << "\"events_per_sec\": " << per_second(r.events, r.run_ms) << ", "
+             << "\"evaluations_per_sec\": " << per_second(r.evaluations, r.run_ms) << ", "
+             << "\"ns_per_event\": " << (r.events ? r.run_ms * 1e6 / r.events : 0.0) << ", "
+             << "\"peak_rss_kb\": " << r.peak_rss_kb << "}"
+             << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    file << "  ],\n  \"queue_memory\": [\n";
+    for (size_t i = 0; i < queue_memory.size(); i++) {
+        const QueueMemoryResult& q = queue_memory[i];
+        file << "    {\"pattern\": \"" << q.pattern << "\", "
+             << "\"pending\": " << q.pending << ", "
+             << "\"bytes_per_event\": " << (double)q.bytes / q.pending << "}"
+             << (i + 1 < queue_memory.size() ? "," : "") << "\n";
+    }
+    file << "  ],\n  \"trace_cost\": [\n";
+    for (size_t i = 0; i < trace_cost.size(); i++) {
+        const TraceCostResult& t = trace_cost[i];
+        file << "    {\"mode\": \"" << t.mode << "\", "
+             << "\"run_ms\": " << t.run_ms << ", "
+             << "\"run_cpu_ms\": " << t.run_cpu_ms << ", "
+             << "\"close_ms\": " << t.close_ms << ", "
+             << "\"changes\": " << t.changes << ", "
+             << "\"stalls\": " << t.stalls << ", "
+             << "\"dropped\": " << t.dropped << ", "
+             << "\"file_bytes\": " << t.file_bytes << "}"
+             << (i + 1 < trace_cost.size() ? "," : "") << "\n";
+    }
+    file << "  ],\n  \"stimulus\": [\n";
+    for (size_t i = 0; i < stimulus.size(); i++) {
+        const StimulusCostResult& g = stimulus[i];
+        file << "    {\"mode\": \"" << g.mode << "\", "
+             << "\"ms\": " << g.ms << ", "
+             << "\"events\": " << g.events << ", "
+             << "\"events_per_sec\": " << per_second(g.events, g.ms) << "}"
+             << (i + 1 < stimulus.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n}\n";
+}
+
+int main(int argc, char** argv) {
+    bool quick = false;
+    std::string filter;
+    std::string out = "bench_results.json";
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--quick") == 0) {
+            quick = true;
+        } else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            out = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--quick] [--filter SUBSTR] [--out results.json]\n";
+            return 1;
+        }
+    }
+
+    // Scale factor keeps --quick usable as a smoke test
+    const int s = quick ? 1 : 8;
+
+    std::vector<BenchCase> cases = {
+        {"rca32", [](Simulator& sim) { return build_ripple_carry_adder(sim, 32); }, false, 200 * s},
+        {"cla32", [](Simulator& sim) { return build_carry_lookahead_adder(sim, 32); }, false, 200 * s},
+        {"mul16", [](Simulator& sim) { return build_array_multiplier(sim, 16); }, false, 10 * s},
+        {"lfsr64", [](Simulator& sim) { return build_lfsr(sim, 64); }, true, 1000 * s},
+        {"counter16x8", [](Simulator& sim) { return build_counter_pipeline(sim, 16, 8); }, true, 1000 * s},
+        {"regfile256x8_flat", [](Simulator& sim) { return build_register_file(sim, 256, 8, false); }, true, 100 * s},
+        {"regfile256x8_inst", [](Simulator& sim) { return build_register_file(sim, 256, 8, true); }, true, 100 * s},
+        {"ram1Mx32_2r", [](Simulator& sim) { return build_ram(sim, 20, 32, 2); }, true, 1000 * s},
+        {"dag10k_f2", [](Simulator& sim) { return build_random_dag(sim, 64, 10000, 2, 1); }, false, 20 * s},
+        {"dag10k_f4", [](Simulator& sim) { return build_random_dag(sim, 64, 10000, 4, 2); }, false, 20 * s},
+    };
+
+    std::vector<Backend> backends = {
+        {"event_heap", [](Simulator&) {}},
+        {"heap+stats", [](Simulator& sim) { sim.enable_stats(); }},  // Instrumentation overhead
+        {"heap+activity", [](Simulator& sim) { sim.enable_activity(); }},  // Activity overhead
+        {"heap+domains", [](Simulator& sim) { build_clock_domains(sim); }},  // Batched flop sampling
+        {"heap+batch", [](Simulator& sim) { sim.enable_batch_eval(); }},  // Batched gate kernels
+    };
+
+    std::cout << "circuit               backend        gates     events      events/s      evals/s       ns/event  peak_rss_kb\n";
+    std::cout << std::string(110, '-') << "\n";
+
+    std::vector<BenchResult> results;
+    for (const BenchCase& bc : cases) {
+        if (!filter.empty() && bc.name.find(filter) == std::string::npos) {
+            continue;
+        }
+        for (const Backend& backend : backends) {
+            results.push_back(run_case(bc, backend));
+            print_result(results.back());
+        }
+    }
+
+    const size_t pending = quick ? 100000 : 1000000;
+    std::vector<QueueMemoryResult> queue_memory = {
+        measure_queue_memory("one_time", pending, 1),
+        measure_queue_memory("sparse_times", pending, pending * 16),
+    };
+    std::cout << "\nqueue pattern         pending     bytes/event\n";
+    std::cout << std::string(48, '-') << "\n";
+    for (const QueueMemoryResult& q : queue_memory) {
+        std::cout << std::left;
+        std::cout.width(22); std::cout << q.pattern;
+        std::cout.width(12); std::cout << q.pending;
+        std::cout << (double)q.bytes / q.pending << "\n";
+    }
+
+    TraceWriter::Options vcd;
+    TraceWriter::Options binary;
+    binary.format = TraceWriter::Format::Binary;
+    TraceWriter::Options drop;
+    drop.backpressure = TraceWriter::Backpressure::Drop;
+    const int trace_vectors = 20 * s;
+    std::vector<TraceCostResult> trace_cost = {
+        measure_trace_cost("untraced", trace_vectors, false, nullptr),
+        measure_trace_cost("store", trace_vectors, true, nullptr),
+        measure_trace_cost("writer_vcd_gz", trace_vectors, false, &vcd),
+        measure_trace_cost("writer_bin_gz", trace_vectors, false, &binary),
+        measure_trace_cost("writer_vcd_drop", trace_vectors, false, &drop),
+    };
+    std::cout << "\ntrace mode (dag10k_f2)  run_ms      sim_cpu_ms  close_ms    changes     stalls    dropped   file_kb\n";
+    std::cout << std::string(106, '-') << "\n";
+    for (const TraceCostResult& t : trace_cost) {
+        std::cout << std::left;
+        std::cout.width(24); std::cout << t.mode;
+        std::cout.width(12); std::cout << t.run_ms;
+        std::cout.width(12); std::cout << t.run_cpu_ms;
+        std::cout.width(12); std::cout << t.close_ms;
+        std::cout.width(12); std::cout << t.changes;
+        std::cout.width(10); std::cout << t.stalls;
+        std::cout.width(10); std::cout << t.dropped;
+        std::cout << t.file_bytes / 1024 << "\n";
+    }
+
+    const size_t stimulus_vectors = 2000 * s;
+    std::vector<StimulusCostResult> stimulus = {
+        measure_stimulus("mt19937_per_event", stimulus_vectors),
+        measure_stimulus("philox_generate", stimulus_vectors),
+        measure_stimulus("philox_batch", stimulus_vectors),
+        measure_stimulus("philox_batch_changes", stimulus_vectors),
+    };
+    std::cout << "\nstimulus (64 inputs)    ms          events      events/s\n";
+    std::cout << std::string(62, '-') << "\n";
+    for (const StimulusCostResult& g : stimulus) {
+        std::cout << std::left;
+        std::cout.width(24); std::cout << g.mode;
+        std::cout.width(12); std::cout << g.ms;
+        std::cout.width(12); std::cout << g.events;
+        std::cout << (uint64_t)per_second(g.events, g.ms) << "\n";
+    }
+
+    write_json(out, results, queue_memory, trace_cost, stimulus);
+    std::cout << "\nResults written to: " << out << "\n";
+    return 0;
+}
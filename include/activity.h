@@ -0,0 +1,64 @@
+#ifndef ACTIVITY_H
+#define ACTIVITY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Switching activity accumulator (for power estimation)
+//
+// One fixed-size record per net in a contiguous array indexed by the signal's
+// dense index. record() is called from Simulator::step() for every value change
+// and does no allocation or string work.
+class ActivityProfile {
+public:
+    struct NetActivity {
+        uint64_t rise = 0;           // 0 -> 1 transitions
+        uint64_t fall = 0;           // 1 -> 0 transitions
+        uint64_t x_transitions = 0;  // Transitions into or out of X or Z
+        uint64_t time_in[4] = {0, 0, 0, 0};  // Residency in 0 / 1 / X / Z (ps)
+        uint64_t last_change = 0;    // Time the current value was entered
+        uint8_t value = 2;           // Current value
+
+        uint64_t toggles() const { return rise + fall; }
+    };
+
+    // Start accumulating at `start_time` with the nets' current values
+    void reset(const std::vector<uint8_t>& initial_values, uint64_t start_time);
+    void add_net(uint8_t value, uint64_t time);  // Net registered after reset
+
+    void record(uint32_t index, uint8_t new_value, uint64_t time) {
+        NetActivity& net = nets[index];
+        uint8_t old_value = net.value;
+        if (old_value == new_value) {
+            return;
+        }
+        net.time_in[old_value] += time - net.last_change;
+        net.last_change = time;
+        net.value = new_value;
+
+        if (old_value > 1 || new_value > 1) {
+            net.x_transitions++;
+        } else if (new_value == 1) {
+            net.rise++;
+        } else {
+            net.fall++;
+        }
+    }
+
+    // Activity of one net with residency closed at `end_time`
+    NetActivity totals(uint32_t index, uint64_t end_time) const;
+
+    size_t size() const;
+    uint64_t get_start_time() const;
+
+    // SAIF-style summary; names[i] is the name of net index i
+    void write_saif(const std::string& filename, const std::vector<std::string>& names,
+                    uint64_t end_time) const;
+
+private:
+    std::vector<NetActivity> nets;
+    uint64_t start_time = 0;
+};
+
+#endif // ACTIVITY_H
@@ -0,0 +1,84 @@
+#ifndef ASSERTIONS_H
+#define ASSERTIONS_H
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class Simulator;  // Forward declaration
+class Signal;
+
+// In-simulator assertions
+//
+// Each assertion is a small observer component attached to the nets it
+// reads, so it runs only when one of them changes; with no assertions
+// registered nothing in the simulator changes. Immediate (unclocked)
+// assertions see every intermediate value, including glitches between gate
+// delays; pass a clock to sample on its rising edges instead. A clocked
+// assertion observes only the clock and reports the nets it samples through
+// Component::get_fanin (for fan-out cones and netlist passes).
+//
+// Temporal properties are fixed-size automata over clock edges:
+//   implies_within(clk, a, b, n)  a |-> ##[0:n] b, a bit per open obligation
+//   stable_while(clk, en, sigs)   sigs hold their value between two edges
+//                                 that both see en = 1
+//
+// The observers belong to the simulator but report to their AssertionSet,
+// which must stay alive while the simulator runs.
+
+struct AssertionFailure {
+    uint32_t assertion;  // Id returned when the assertion was added
+    uint64_t time;
+};
+
+class AssertionSet {
+public:
+    static constexpr uint32_t MAX_CYCLES = 63;  // implies_within window limit
+
+    explicit AssertionSet(Simulator& simulator);
+
+    // Add assertions; each returns an id for failures(). `clock` = nullptr
+    // checks on every change of the inputs.
+    uint32_t always(const std::string& name, const std::vector<Signal*>& signals,
+                    std::function<bool()> predicate, Signal* clock = nullptr);
+    uint32_t one_hot(const std::string& name, const std::vector<Signal*>& signals,
+                     bool allow_zero = false, Signal* clock = nullptr);   // X/Z bits fail
+    uint32_t implies_within(const std::string& name, Signal* clock, Signal* antecedent,
+                            Signal* consequent, uint32_t cycles);
+    uint32_t stable_while(const std::string& name, Signal* clock, Signal* condition,
+                          const std::vector<Signal*>& signals);
+
+    // Stop the simulator (Simulator::stop) at the first failure
+    void set_fail_fast(bool enable) { fail_fast = enable; }
+    // Keep at most `max_entries` failures in the log; the rest are only counted
+    void set_log_limit(size_t max_entries) { max_log = max_entries; }
+
+    // Results
+    size_t size() const { return names.size(); }
+    const std::string& name(uint32_t id) const { return names[id]; }
+    uint64_t failures(uint32_t id) const { return failure_counts[id]; }
+    uint64_t total_failures() const { return total; }
+    bool passed() const { return total == 0; }
+    const std::vector<AssertionFailure>& get_log() const { return log; }
+    void report(std::ostream& os) const;
+
+    void reset();  // Forget failures (automaton states are kept)
+
+    // Called by the assertion observers
+    void record_failure(uint32_t id, uint64_t time);
+
+private:
+    Simulator& sim;
+    std::vector<std::string> names;
+    std::vector<uint64_t> failure_counts;
+    std::vector<AssertionFailure> log;
+    uint64_t total;
+    size_t max_log;
+    bool fail_fast;
+
+    uint32_t add_name(const std::string& name);
+};
+
+#endif // ASSERTIONS_H
@@ -0,0 +1,117 @@
+#ifndef BATCH_EVAL_H
+#define BATCH_EVAL_H
+
+#include "event.h"
+#include "gate.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Simulator;  // Forward declaration
+
+// Batched evaluation of plain gates (see Simulator::enable_batch_eval)
+//
+// AND/OR/XOR gates are grouped by type and fan-in, NOT/BUF gates by type.
+// During an evaluate phase the simulator hands their activations to the
+// batcher instead of calling evaluate(); a gate activated through several
+// changed inputs is evaluated once. At the end of the phase each group with
+// enough active gates copies its input values into one byte lane per gate
+// and folds them through the type's 4x4 logic table 32 lanes at a time
+// (AVX2 byte shuffles, picked at run time, or a scalar loop). A vector
+// compare against the current outputs yields the changed lanes, whose
+// events go to the queue in one schedule_batch call. Smaller groups fall
+// back to evaluate().
+//
+// Gates with back-annotated delays are left out (their delay depends on
+// the triggering pin), as are wider gates than MAX_FANIN. A grouped gate
+// rewired or annotated after build() (its Gate::get_revision() moved) is
+// evaluated on its own and marks the batcher stale, and the simulator
+// regroups before the next phase.
+//
+// Order: batched gates schedule their outputs after the phase's other
+// observers, group by group. Where several gates drive one net for the
+// same time (last writer wins), the winner can differ from unbatched
+// evaluation; tri-state and wired nets go through a Resolver, whose
+// drivers each have their own net, and are not affected.
+namespace batch {
+
+enum class Kernel { Scalar, AVX2 };
+
+bool avx2_supported();  // The CPU can run the AVX2 kernel
+
+// Fold `fanin` pin lanes (values 0-3, each `n` bytes, padded to a multiple
+// of 32) through `table` (16 entries: [a * 4 + b], or [a] for one pin).
+// Writes `n` results and the indices of lanes that differ from `current`
+// to `changed`; returns their count.
+size_t eval_lanes(Kernel kernel, const uint8_t* table, const uint8_t* const* pins, size_t fanin,
+                  const uint8_t* current, uint8_t* results, uint32_t* changed, size_t n);
+
+}  // namespace batch
+
+class GateBatcher {
+public:
+    static constexpr size_t MAX_FANIN = 8;
+    static constexpr size_t LANES = 32;  // One AVX2 register of byte lanes
+
+    explicit GateBatcher(size_t min_batch = 8);
+
+    // Group the simulator's gates (by component index)
+    void build(const std::vector<Component*>& components);
+    void set_min_batch(size_t n) { min_batch = n; }
+    void set_kernel(batch::Kernel k) { kernel = k; }
+    batch::Kernel get_kernel() const { return kernel; }
+
+    // Queue a batchable component for this phase (true), or leave it to
+    // the caller's evaluate() (false)
+    bool defer(Component* component) {
+        uint32_t index = component->get_index();
+        if (index >= group_of.size() || group_of[index] == NO_GROUP) {
+            return false;
+        }
+        if (static_cast<Gate*>(component)->get_revision() != revisions[index]) {
+            stale = true;  // Rewired since build()
+            return false;
+        }
+        if (marks[index] != epoch) {
+            marks[index] = epoch;
+            groups[group_of[index]].active.push_back(static_cast<Gate*>(component));
+        }
+        return true;
+    }
+
+    // Evaluate the queued gates and schedule their changed outputs. Adds one
+    // per evaluated gate to `evaluation_counts` (by component index) when
+    // given; returns the number of gates evaluated.
+    uint64_t run(Simulator* sim, uint64_t current_time, uint64_t* evaluation_counts);
+
+    bool is_stale() const { return stale; }  // A grouped gate changed since build()
+    size_t batched_gates() const;  // Gates in some group
+    uint64_t get_lanes_evaluated() const { return lanes_evaluated; }  // Through the kernels
+
+private:
+    static constexpr uint32_t NO_GROUP = UINT32_MAX;
+
+    struct Group {
+        uint8_t table[16];
+        size_t fanin;
+        std::vector<Gate*> active;
+        std::vector<uint8_t> pins;     // fanin lanes of `capacity` bytes
+        std::vector<uint8_t> current;
+        std::vector<uint8_t> results;
+        size_t capacity = 0;
+    };
+
+    size_t min_batch;
+    batch::Kernel kernel;
+    std::vector<Group> groups;
+    std::vector<uint32_t> group_of;  // Per component index
+    std::vector<uint32_t> revisions; // Per component index: gate revision at build()
+    bool stale = false;
+    std::vector<uint32_t> marks;     // Per component index: epoch when queued
+    uint32_t epoch = 1;
+    std::vector<uint32_t> changed;
+    std::vector<Event> events;
+    uint64_t lanes_evaluated = 0;
+};
+
+#endif // BATCH_EVAL_H
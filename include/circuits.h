@@ -0,0 +1,68 @@
+#ifndef CIRCUITS_H
+#define CIRCUITS_H
+
+#include "simulator.h"
+#include "signal.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// Parameterized netlist generators (used by the benchmark suite)
+//
+// Every generator builds into an existing Simulator, prefixes all of its
+// signal names with `prefix` so several circuits can share one simulator,
+// and returns the primary ports so a testbench can drive/observe them.
+
+struct CircuitPorts {
+    std::vector<Signal*> inputs;   // Primary inputs (driven by the testbench)
+    std::vector<Signal*> outputs;  // Primary outputs
+    Signal* clock = nullptr;       // Clock net for sequential circuits
+    size_t gate_count = 0;         // Number of components created
+};
+
+// N-bit ripple-carry adder: inputs a[0..n), b[0..n), cin; outputs s[0..n), cout
+CircuitPorts build_ripple_carry_adder(Simulator& sim, int bits,
+                                      const std::string& prefix = "rca", uint64_t delay = 100);
+
+// N-bit carry-lookahead adder built from 4-bit lookahead groups (groups ripple)
+CircuitPorts build_carry_lookahead_adder(Simulator& sim, int bits,
+                                         const std::string& prefix = "cla", uint64_t delay = 100);
+
+// N x N array multiplier: inputs a[0..n), b[0..n); outputs p[0..2n)
+CircuitPorts build_array_multiplier(Simulator& sim, int bits,
+                                    const std::string& prefix = "mul", uint64_t delay = 100);
+
+// N-bit Fibonacci LFSR (DFF chain with XOR feedback), one clock input
+CircuitPorts build_lfsr(Simulator& sim, int bits,
+                        const std::string& prefix = "lfsr", uint64_t delay = 100);
+
+// `stages` x N-bit counter pipeline: an incrementing counter register followed
+// by `stages` pipeline registers, all on one clock
+CircuitPorts build_counter_pipeline(Simulator& sim, int bits, int stages,
+                                    const std::string& prefix = "cnt", uint64_t delay = 100);
+
+// Random DAG of 2-input AND/OR/XOR and NOT gates with a target average fan-out.
+// Deterministic for a given seed.
+CircuitPorts build_random_dag(Simulator& sim, int num_inputs, int num_gates, int fanout,
+                              uint32_t seed, const std::string& prefix = "dag",
+                              uint64_t delay = 100);
+
+// Register file of `slices` x N-bit enable registers (per bit: a 2:1 mux
+// feeding a DFF). With `instanced` the slices share one ModuleDef instead of
+// being built flat. Inputs: clk, en[0..slices), d[0..n); outputs: every q.
+CircuitPorts build_register_file(Simulator& sim, int slices, int bits, bool instanced,
+                                 const std::string& prefix = "rf", uint64_t delay = 100);
+
+// Synchronous RAM of 2^addr_bits x N-bit words with one write port and
+// `read_ports` read ports. Inputs: clk, we, wa[..], wd[..], then ra<p>[..] per
+// read port; outputs: rd<p>[..] per read port.
+CircuitPorts build_ram(Simulator& sim, int addr_bits, int bits, int read_ports,
+                       const std::string& prefix = "ram", uint64_t delay = 100);
+
+// Fixed-size circuits picked by name (used by sim_server and load_gen):
+// rca32, cla32, mul16, lfsr64, counter16x8, regfile64x8, ram10x32, dag10k.
+// Signal names use the generator's default prefix (e.g. "rca.a0").
+std::vector<std::string> named_circuits();
+CircuitPorts build_named_circuit(Simulator& sim, const std::string& name);  // Throws std::invalid_argument
+
+#endif // CIRCUITS_H
@@ -0,0 +1,59 @@
+#ifndef CLOCK_DOMAIN_H
+#define CLOCK_DOMAIN_H
+
+#include "sequential.h"
+#include "signal.h"
+#include <cstdint>
+#include <vector>
+
+class Simulator;  // Forward declaration
+
+// All DFFs triggered by one edge of one clock net, sampled as a batch
+//
+// The domain is the only observer of the clock for its flops. On an edge it
+// reads every D, builds enable and reset masks, computes every next Q and
+// then schedules the Qs that change. Member flops stop observing their clock,
+// data and enable nets; they keep watching the async reset. Flops on other
+// clocks (or other domains) still interleave through the event queue.
+class ClockDomain : public SequentialElement {
+private:
+    static uint32_t id_counter;
+
+    std::vector<DFF*> flops;
+    std::vector<Signal*> d;
+    std::vector<Signal*> q;
+    std::vector<uint64_t> delays;
+    std::vector<uint32_t> with_enable;  // Flops that have an enable
+    std::vector<uint32_t> with_reset;   // Flops that have an async reset
+
+    // Scratch for one edge
+    std::vector<uint8_t> d_values;
+    std::vector<uint8_t> q_values;
+    std::vector<uint8_t> hold_mask;
+    std::vector<uint8_t> reset_mask;
+
+protected:
+    void on_clock_edge(Simulator* sim, uint64_t current_time) override;
+
+public:
+    ClockDomain(Signal* clk, Edge edge = RISING);
+
+    // Move a flop into the domain; it must be fully connected and use this
+    // domain's clock and edge
+    void add_flop(DFF* flop);
+
+    void get_fanin(std::vector<Signal*>& nets) const override;
+    void get_fanout(std::vector<Signal*>& nets) const override;
+
+    size_t size() const;
+    const std::vector<DFF*>& get_flops() const;
+};
+
+// Group every DFF of the simulator by (clock net, edge) and create one
+// ClockDomain per group with at least `min_flops` members. Flops with timing
+// checks stay on the event path. Run after the netlist is final (e.g. after
+// optimize_netlist): batched flops no longer appear as observers of their D
+// nets. Returns the number of domains created.
+size_t build_clock_domains(Simulator& sim, size_t min_flops = 2);
+
+#endif // CLOCK_DOMAIN_H
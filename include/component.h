@@ -3,22 +3,104 @@
 
 #include <vector>
 #include <cstdint>
+#include <cstring>
 #include <string>
 #include "signal.h"
 
 class Simulator;  // Forward declaration
 
+// Input pins of a component: the first two are stored inline, so the common
+// gate needs no allocation of its own; wider components spill to the heap
+class PinList {
+private:
+    static constexpr uint32_t INLINE = 2;
+    Signal* local[INLINE];
+    Signal** items = local;
+    uint32_t count = 0;
+    uint32_t capacity = INLINE;
+
+public:
+    PinList() = default;
+    PinList(const PinList& other) {
+        for (Signal* sig : other) {
+            push_back(sig);
+        }
+    }
+    PinList& operator=(const PinList& other) {
+        if (this != &other) {
+            count = 0;
+            for (Signal* sig : other) {
+                push_back(sig);
+            }
+        }
+        return *this;
+    }
+    ~PinList() {
+        if (items != local) {
+            delete[] items;
+        }
+    }
+
+    void push_back(Signal* sig) {
+        if (count == capacity) {
+            Signal** grown = new Signal*[capacity * 2];
+            std::memcpy(grown, items, count * sizeof(Signal*));
+            if (items != local) {
+                delete[] items;
+            }
+            items = grown;
+            capacity *= 2;
+        }
+        items[count++] = sig;
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    Signal* operator[](size_t i) const { return items[i]; }
+    Signal* const* data() const { return items; }
+    Signal* const* begin() const { return items; }
+    Signal* const* end() const { return items + count; }
+};
+
 class Component{
+    friend class Simulator;  // Assigns the dense per-simulator index
+    uint32_t index = 0;
 protected:
     std::string id;
     uint64_t propagation_delay;
-    std::vector<Signal*> inputs;
-    Signal* output;
+    PinList inputs;
+    Signal* output = nullptr;
+
+    // Helpers for save_state/restore_state
+    template<typename T>
+    static void put_state(std::vector<uint8_t>& out, const T& value) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+    template<typename T>
+    static void get_state(const uint8_t*& in, T& value) {
+        std::memcpy(&value, in, sizeof(T));
+        in += sizeof(T);
+    }
 public:
     virtual void evaluate(Simulator* sim, uint64_t current_time) = 0;
     virtual ~Component() = default;
     uint64_t get_delay() const;
     std::string get_id() const;
+    uint32_t get_index() const { return index; }  // Position in the owning simulator's component list
+    Signal* get_output() const;
+    const PinList& get_inputs() const;
+    virtual bool is_sequential() const;  // Stateful element (its output is a state net)
+
+    // Nets the component may read and nets it drives (default: inputs and
+    // output). Used for fan-out cones, see history.h.
+    virtual void get_fanin(std::vector<Signal*>& nets) const;
+    virtual void get_fanout(std::vector<Signal*>& nets) const;
+
+    // Checkpointing: append internal state (beyond net values) and read it
+    // back in the same order. Stateless by default.
+    virtual void save_state(std::vector<uint8_t>& out) const;
+    virtual void restore_state(const uint8_t*& in);
 };
 
 #endif // COMPONENT_H
\ No newline at end of file
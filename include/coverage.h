@@ -0,0 +1,66 @@
+#ifndef COVERAGE_H
+#define COVERAGE_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Toggle and state coverage database
+//
+// Four bitsets indexed by the signal's dense index: rose (0->1), fell (1->0),
+// seen0 and seen1. A net is toggle-covered once it has both risen and fallen;
+// a state net (sequential element output) is state-covered once it has held
+// both 0 and 1. Databases are keyed by net name when saved, so runs of the same
+// design in different processes can be merged.
+class CoverageDB {
+public:
+    void add_net(const std::string& name, uint8_t value, bool is_state = false);
+    void mark_state(uint32_t index);
+    void clear();  // Drop all recorded bits (nets stay registered)
+
+    void record(uint32_t index, uint8_t new_value, uint8_t old_value) {
+        const uint64_t bit = 1ULL << (index & 63);
+        const size_t word = index >> 6;
+        seen[new_value & 1][word] |= (new_value < 2) ? bit : 0;
+        rose[word] |= (old_value == 0 && new_value == 1) ? bit : 0;
+        fell[word] |= (old_value == 1 && new_value == 0) ? bit : 0;
+    }
+
+    bool toggle_covered(uint32_t index) const;
+    bool state_covered(uint32_t index) const;
+    bool has_risen(uint32_t index) const;
+    bool has_fallen(uint32_t index) const;
+    bool is_state(uint32_t index) const;
+
+    size_t size() const;
+    const std::string& get_name(uint32_t index) const;
+    size_t toggle_covered_count() const;
+    size_t state_net_count() const;
+    size_t state_covered_count() const;
+
+    // Merge another run of the same design (nets matched by name; nets only
+    // present in `other` are appended)
+    void merge(const CoverageDB& other);
+
+    // Text database: one "<flags> <name>" line per net
+    void save(const std::string& filename) const;
+    static CoverageDB load(const std::string& filename);
+
+    // Summary plus the list of uncovered nets
+    void report(std::ostream& out) const;
+
+private:
+    std::vector<std::string> names;
+    std::vector<uint64_t> rose;
+    std::vector<uint64_t> fell;
+    std::vector<uint64_t> seen[2];
+    std::vector<uint64_t> state;
+
+    static bool test(const std::vector<uint64_t>& bits, uint32_t index);
+    static void set(std::vector<uint64_t>& bits, uint32_t index);
+    uint32_t flags(uint32_t index) const;
+    void set_flags(uint32_t index, uint32_t flags);
+};
+
+#endif // COVERAGE_H
@@ -0,0 +1,51 @@
+#ifndef DELAY_H
+#define DELAY_H
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+// Rise/fall delay pair; transitions to X take the shorter of the two
+struct RiseFall {
+    uint64_t rise;
+    uint64_t fall;
+
+    uint64_t for_value(uint8_t new_value) const {
+        return new_value == 1 ? rise : new_value == 0 ? fall : std::min(rise, fall);
+    }
+};
+
+// Deduplicated delay table shared by all annotated components of a simulator
+//
+// Back-annotated netlists reuse a handful of distinct delays many times, so
+// each pin stores a 32-bit index into this table instead of its own pair.
+class DelayTable {
+private:
+    std::vector<RiseFall> entries;
+    std::map<std::pair<uint64_t, uint64_t>, uint32_t> lookup;
+
+public:
+    // Index of (rise, fall), adding it on first use
+    uint32_t intern(uint64_t rise, uint64_t fall) {
+        auto key = std::make_pair(rise, fall);
+        auto it = lookup.find(key);
+        if (it != lookup.end()) {
+            return it->second;
+        }
+        uint32_t id = entries.size();
+        entries.push_back({rise, fall});
+        lookup.emplace(key, id);
+        return id;
+    }
+
+    const RiseFall& operator[](uint32_t id) const { return entries[id]; }
+    size_t size() const { return entries.size(); }
+    void clear() {
+        entries.clear();
+        lookup.clear();
+    }
+};
+
+#endif // DELAY_H
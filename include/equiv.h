@@ -0,0 +1,131 @@
+#ifndef EQUIV_H
+#define EQUIV_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class Simulator;  // Forward declaration
+class Signal;
+
+// Equivalence checking of two netlists by random simulation
+//
+// Inputs and outputs are matched by name (Simulator::get_signal_by_name;
+// a leading prefix may be renamed for the second netlist). Each netlist's
+// AND/OR/XOR/NOT/BUF gates are compiled into a levelized two-state program
+// over 64-bit words, one bit per vector, so one instruction evaluates a
+// gate for 64 vectors. Worker threads take blocks of BLOCK_VECTORS vectors
+// in turn, run both programs and compare the outputs bit-parallel.
+//
+// Sequential elements are cut points: their outputs (register state) become
+// inputs, which must be register outputs of the same name in both
+// netlists, and the nets they read are compared like outputs. Nets without
+// a driver that are not inputs are constants at their present value.
+// Tri-state buffers, resolvers and module instances are not supported.
+//
+// Vectors are uniformly random unless constrained, or exhaustive when
+// 2^inputs fits in the vector budget (then a pass proves equivalence).
+// Random words come from a counter-based generator keyed by (seed, block,
+// input), so results do not depend on the number of threads.
+
+struct EquivOptions {
+    uint64_t vectors = 1 << 20;   // Budget, rounded up to whole blocks
+    size_t threads = 0;           // 0: one per hardware thread
+    uint64_t seed = 1;
+    bool exhaustive = true;       // Enumerate when 2^inputs <= vectors and nothing is constrained
+    // (name, probability of a 1): a name ending in '*' matches a prefix;
+    // first match wins. 0 or 1 holds the input constant.
+    std::vector<std::pair<std::string, double>> constraints;
+};
+
+// The first failing vector, reduced: inputs that could be lowered to 0
+// without hiding the difference were, and `care` marks the inputs whose
+// flip makes the outputs agree
+struct Counterexample {
+    uint64_t vector = 0;                  // Index of the failing vector
+    std::vector<std::string> inputs;      // Names in the first netlist
+    std::vector<uint8_t> values;
+    std::vector<bool> care;
+    std::vector<std::string> outputs;     // Differing outputs
+    std::vector<uint8_t> values_a;
+    std::vector<uint8_t> values_b;
+
+    // Schedule the input values at `time` (names in `sim`'s netlist)
+    void apply(Simulator& sim, uint64_t time, const std::string& from_prefix = "",
+               const std::string& to_prefix = "") const;
+};
+
+struct EquivResult {
+    bool equivalent = true;       // No difference in the vectors run
+    bool exhaustive = false;      // Every input combination was run
+    uint64_t vectors = 0;         // Run, in whole blocks
+    uint64_t gate_evaluations = 0;  // Gates of both netlists x vectors
+    double seconds = 0;
+    size_t threads = 0;
+    Counterexample counterexample;  // When not equivalent
+
+    double evaluations_per_second() const { return seconds > 0 ? gate_evaluations / seconds : 0; }
+};
+
+class EquivalenceChecker {
+public:
+    static constexpr size_t WORDS = 4;                   // 64-bit words per net per block
+    static constexpr uint64_t BLOCK_VECTORS = WORDS * 64;
+
+    // Empty `inputs`: the first netlist's undriven, non-constant nets with
+    // fan-out. Empty `outputs`: its driven nets without fan-out. Names
+    // starting with `prefix_a` are looked up in `b` with `prefix_b` instead.
+    // Throws std::invalid_argument for unmatched names or unsupported
+    // components, std::runtime_error for combinational loops.
+    EquivalenceChecker(Simulator& a, Simulator& b, const std::vector<std::string>& inputs = {},
+                       const std::vector<std::string>& outputs = {}, const std::string& prefix_a = "",
+                       const std::string& prefix_b = "");
+
+    EquivResult run(const EquivOptions& options = EquivOptions()) const;
+
+    const std::vector<std::string>& get_inputs() const { return inputs; }    // Including register outputs
+    const std::vector<std::string>& get_outputs() const { return outputs; }  // Including register inputs
+    size_t gate_count_a() const { return program_a.code.size(); }
+    size_t gate_count_b() const { return program_b.code.size(); }
+
+private:
+    enum Op : uint8_t { AND, OR, XOR, NOT, BUF };
+
+    struct Instr {
+        Op op;
+        uint32_t out;
+        uint32_t first;  // Into `operands`
+        uint32_t count;
+    };
+
+    // One netlist, levelized: slot s holds WORDS words at s * WORDS
+    struct Program {
+        std::vector<Instr> code;
+        std::vector<uint32_t> operands;
+        std::vector<std::pair<uint32_t, uint64_t>> constants;  // (slot, word)
+        std::vector<uint32_t> input_slots;
+        std::vector<uint32_t> output_slots;
+        size_t slots = 0;
+
+        void evaluate(uint64_t* words) const;
+    };
+
+    std::vector<std::string> inputs;
+    std::vector<std::string> outputs;
+    Program program_a;
+    Program program_b;
+
+    static Program compile(Simulator& sim, const std::vector<Signal*>& ins, const std::vector<Signal*>& outs);
+    // Input words of block `block` (inputs x WORDS)
+    void generate(const EquivOptions& options, const std::vector<uint16_t>& bias, bool exhaustive,
+                  uint64_t block, uint64_t* words) const;
+    // OR of a ^ b over the outputs, per word; true if any bit differs
+    bool compare(const uint64_t* a, const uint64_t* b, uint64_t* diff) const;
+    bool fails(const std::vector<uint8_t>& values, std::vector<uint64_t>& a, std::vector<uint64_t>& b) const;
+    Counterexample reduce(uint64_t vector, std::vector<uint8_t> values, const std::vector<uint16_t>& bias) const;
+};
+
+#endif // EQUIV_H
@@ -7,10 +7,9 @@
 struct Event {
     uint64_t time; // Simulation time in picoseconds
     int signal_id; // Unique identifier for the signal
-    uint8_t new_value; // New value of the signal (0, 1 or 'X' for unknown)
+    uint8_t new_value; // New value of the signal (0, 1, 'X' for unknown or 'Z' for undriven)
 
-    // Constructor
-    Event(uint64_t t, int id, uint8_t val);
+    Event(uint64_t t, int id, uint8_t val) : time(t), signal_id(id), new_value(val) {}
 
     // For debugging
     std::string to_string() const;
@@ -2,25 +2,161 @@
 #define EVENT_QUEUE_H
 
 #include "event.h"
-#include <queue>
+#include "stats.h"
+#include <cstdint>
+#include <memory>
 #include <vector>
 
-struct EventComparator {
-    bool operator()(const Event& a, const Event& b) const{
-        return a.time > b.time; // Min-heap based on event time
-    }
+// Pending events, popped in time order and in delta cycles within a time
+//
+// Events for the current time (`now`, zero-delay outputs) go to the delta
+// FIFO; events for one later time (usually now + the common gate delay) go
+// to the near FIFO; only events for any other time go through the heap.
+// The events in the delta FIFO when begin_delta() is called form one delta
+// cycle: events scheduled while it is processed make up the next one.
+// Zero-delay and unit-delay designs therefore never touch the heap.
+//
+// Storage: the FIFOs hold 8-byte PackedEvents (the time is the FIFO's) in
+// 2 KB chunks from an EventPool, and the heap keeps its entries in chunks
+// too, so a growing queue allocates one chunk at a time instead of
+// reallocating and copying one large array. Drained chunks are recycled.
+//
+// A FIFO event can be found again through a PendingSlot kept per net: a
+// second write to the net for the same time overwrites the queued event's
+// value instead of adding an event (the last writer wins, as it would when
+// both were applied in order). Events in the heap are never coalesced, but
+// each carries its insertion sequence, which breaks ties between equal
+// times: same-time events always pop in the order they were scheduled, so
+// the last writer wins there too.
+
+// An event as queued: its time is implied by the FIFO holding it
+struct PackedEvent {
+    int32_t signal_id;
+    uint8_t new_value;
+};
+static_assert(sizeof(PackedEvent) == 8, "PackedEvent must stay 8 bytes");
+
+struct PendingSlot {
+    uint64_t time = UINT64_MAX;  // Time of the net's last FIFO-queued event
+    uint32_t position = 0;       // Its pool address (EventPool::address)
+};
+
+// Fixed-size chunks of PackedEvents, recycled through a free list. Each
+// chunk records the time of its events and the range still queued, which
+// is what makes a PendingSlot checkable after its event was consumed.
+class EventPool {
+public:
+    static constexpr uint32_t CHUNK_EVENTS = 256;
+
+    struct Chunk {
+        uint64_t time;    // UINT64_MAX while free
+        Chunk* next;      // Next chunk of the same FIFO
+        uint32_t id;      // Index in the pool
+        uint16_t begin;   // Queued events are [begin, end)
+        uint16_t end;
+        PackedEvent events[CHUNK_EVENTS];
+    };
+
+    Chunk* allocate(uint64_t time);
+    void release(Chunk* chunk);
+    Chunk* find(uint32_t address) const;  // Null past the last chunk
+    size_t memory_bytes() const;
+
+    static uint32_t address(const Chunk* chunk, uint32_t offset) { return chunk->id * CHUNK_EVENTS + offset; }
+
+private:
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    std::vector<Chunk*> free_chunks;
 };
 
 class EventQueue {
 private:
-    std::priority_queue<Event, std::vector<Event>, EventComparator> pq;
+    struct Fifo {
+        EventPool::Chunk* head = nullptr;  // Chunk list, consumed from the head;
+                                           // an emptied FIFO keeps its last chunk
+        EventPool::Chunk* tail = nullptr;
+        size_t count = 0;
+    };
+    struct HeapEntry {
+        uint64_t time;
+        uint64_t sequence;  // Insertion order, the tie-break for equal times
+        PackedEvent event;
+
+        bool before(const HeapEntry& other) const {
+            return time < other.time || (time == other.time && sequence < other.sequence);
+        }
+    };
+    static constexpr size_t HEAP_CHUNK = 256;
+
+    EventPool pool;
+    Fifo delta;                 // Events at `now`
+    Fifo near;                  // Events at near_time (> now)
+    uint64_t near_time = 0;
+    // Binary min-heap on (time, sequence), stored in chunks of HEAP_CHUNK entries
+    std::vector<std::unique_ptr<HeapEntry[]>> heap_chunks;
+    size_t heap_size = 0;
+    uint64_t heap_sequence = 0; // Next HeapEntry::sequence
+    uint64_t now = UINT64_MAX;  // Time of the last delta cycle begun (none yet)
+    uint32_t delta_index = 0;   // Delta cycles begun at `now`, minus one
+    bool started = false;       // A delta cycle has begun at `now`
+
+    size_t batch_start = SIZE_MAX; // Heap size at begin_batch() (SIZE_MAX: not batching)
+
+    uint64_t scheduled_count = 0;  // Instrumentation: total schedule() calls
+    uint64_t heap_count = 0;       // Instrumentation: events that went through the heap
+    uint64_t coalesced_count = 0;  // Instrumentation: writes merged into a queued event
+    size_t peak_size = 0;          // Instrumentation: queue depth high-water mark
+
+    uint32_t fifo_push(Fifo& fifo, uint64_t time, const Event& e);  // Returns the pool address
+    PackedEvent fifo_pop(Fifo& fifo);
+    void fifo_clear(Fifo& fifo);
+    void fifo_retime(Fifo& fifo, uint64_t time);  // New time for an empty FIFO's chunk
+    template <typename Fn> void fifo_for_each(const Fifo& fifo, Fn fn) const;
+
+    HeapEntry& heap_at(size_t i) { return heap_chunks[i / HEAP_CHUNK][i % HEAP_CHUNK]; }
+    const HeapEntry& heap_at(size_t i) const { return heap_chunks[i / HEAP_CHUNK][i % HEAP_CHUNK]; }
+    void sift_up(size_t i);
+    void sift_down(size_t i);
+    void push_heap(uint64_t time, const PackedEvent& e);
+    HeapEntry pop_heap();
+    void advance();  // Move every event at the next time into the delta FIFO
     
 public:
-    void schedule(const Event& e);
+    void schedule(const Event& e, PendingSlot* slot = nullptr);  // `slot`: the net's, to coalesce
     Event pop_next();
     bool empty() const;
     size_t size() const;
     uint64_t next_time() const;  // Peek at next event time without popping
+
+    // Start the next delta cycle: the events at the current time if any are
+    // left, else every event at the next time. Returns its event count (0
+    // when empty); the next that many pop_next() calls return them.
+    size_t begin_delta();
+    uint64_t current_time() const { return now; }
+    uint32_t current_delta() const { return delta_index; }  // 0 for the first cycle at a time
+
+    // Bulk scheduling: in between, heap-bound events are only appended, and
+    // end_batch() restores the heap once (std::make_heap for large batches).
+    // Nothing may be popped or peeked until end_batch(); end_batch() without
+    // begin_batch() does nothing.
+    void begin_batch();
+    void end_batch();
+
+    // Checkpointing: pending events in pop order, and a queue rebuilt from
+    // them (pops in time order, then in the given order; a time's events
+    // become one delta cycle)
+    std::vector<Event> snapshot() const;
+    void restore(const std::vector<Event>& events);
+
+    // Instrumentation (zero unless stats are compiled in)
+    uint64_t get_scheduled_count() const;
+    uint64_t get_heap_count() const;
+    uint64_t get_coalesced_count() const;
+    size_t get_peak_size() const;
+    void reset_counters();
+
+    // Bytes held by the queue's storage, including recycled chunks
+    size_t memory_bytes() const;
 };
 
-#endif // EVENT_QUEUE_H
\ No newline at end of file
+#endif // EVENT_QUEUE_H
@@ -0,0 +1,167 @@
+#ifndef FIXED_GATE_H
+#define FIXED_GATE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <typeinfo>
+#include "gate.h"
+#include "logic.h"
+
+// Fixed fan-in gates
+//
+// FixedGate<ANDGate, 2> is an ANDGate whose N input pins are connected by
+// its constructor. evaluate() packs the N input values (2 bits each) into
+// one index of a 4^N-entry truth table generated at compile time, so an
+// evaluation is N pin loads and one table load: no loop over a pin list and
+// no fan-in check. It is still an ANDGate, so netlist passes, SDF annotation
+// and batching treat it like one, and its pins stay listed by get_inputs().
+//
+// Simulator::create_component<ANDGate>(delay, out, a, b) builds one (see
+// FixedGateFor); Simulator::create_gate picks one for a pin list known only
+// at run time. Its pins are fixed: connect_input() throws std::logic_error.
+
+// Fold of a gate type's values, one pin at a time (from `start`)
+template <typename GateType>
+struct GateLogic {
+    static constexpr bool defined = false;
+    static constexpr bool unary = false;
+};
+
+template <>
+struct GateLogic<ANDGate> {
+    static constexpr bool defined = true;
+    static constexpr bool unary = false;
+    static constexpr uint8_t start = LOGIC_1;
+    static constexpr uint8_t fold(uint8_t r, uint8_t v) { return TWO_STATE ? (r & v) : logic::AND_TABLE[r][v]; }
+};
+
+template <>
+struct GateLogic<ORGate> {
+    static constexpr bool defined = true;
+    static constexpr bool unary = false;
+    static constexpr uint8_t start = LOGIC_0;
+    static constexpr uint8_t fold(uint8_t r, uint8_t v) { return TWO_STATE ? (r | v) : logic::OR_TABLE[r][v]; }
+};
+
+template <>
+struct GateLogic<XORGate> {
+    static constexpr bool defined = true;
+    static constexpr bool unary = false;
+    static constexpr uint8_t start = LOGIC_0;
+    static constexpr uint8_t fold(uint8_t r, uint8_t v) { return TWO_STATE ? (r ^ v) : logic::XOR_TABLE[r][v]; }
+};
+
+template <>
+struct GateLogic<NOTGate> {
+    static constexpr bool defined = true;
+    static constexpr bool unary = true;
+    static constexpr uint8_t start = LOGIC_0;
+    static constexpr uint8_t fold(uint8_t, uint8_t v) { return TWO_STATE ? (v ^ 1) : logic::NOT_TABLE[v]; }
+};
+
+template <>
+struct GateLogic<BUFGate> {
+    static constexpr bool defined = true;
+    static constexpr bool unary = true;
+    static constexpr uint8_t start = LOGIC_0;
+    static constexpr uint8_t fold(uint8_t, uint8_t v) { return TWO_STATE ? v : logic::BUF_TABLE[v]; }
+};
+
+constexpr size_t MAX_FIXED_FANIN = 4;  // 256-entry tables
+
+// Fan-ins with a FixedGate form for the gate type
+template <typename GateType>
+constexpr bool has_fixed_form(size_t fanin) {
+    return GateLogic<GateType>::defined &&
+           (GateLogic<GateType>::unary ? fanin == 1 : fanin >= 2 && fanin <= MAX_FIXED_FANIN);
+}
+
+// Output for every combination of N four-state inputs; pin 0 is the most
+// significant digit of the index
+template <typename GateType, size_t N>
+struct FixedTable {
+    uint8_t values[size_t(1) << (2 * N)];
+
+    constexpr FixedTable() : values() {
+        for (size_t index = 0; index < (size_t(1) << (2 * N)); index++) {
+            uint8_t r = GateLogic<GateType>::start;
+            for (size_t pin = 0; pin < N; pin++) {
+                r = GateLogic<GateType>::fold(r, (index >> (2 * (N - 1 - pin))) & 3);
+            }
+            values[index] = r;
+        }
+    }
+};
+
+template <typename GateType, size_t N>
+class FixedGate final : public GateType {
+    static_assert(has_fixed_form<GateType>(N), "FixedGate: no fixed form for this gate type and fan-in");
+
+    static constexpr FixedTable<GateType, N> table{};
+
+public:
+    template <typename... Pins>
+    FixedGate(uint64_t delay, Signal* out, Pins... pins) : GateType(delay) {
+        static_assert(sizeof...(Pins) == N, "FixedGate: needs exactly N input pins");
+        (this->connect_input(pins), ...);
+        this->connect_output(out);
+    }
+
+    // evaluate() reads exactly N pins, so none can be added
+    void connect_input(Signal* sig) override {
+        if (this->inputs.size() == N) {
+            throw std::logic_error("Fixed fan-in gate " + this->id + " already has all its input pins");
+        }
+        GateType::connect_input(sig);
+    }
+
+    void evaluate(Simulator* sim, uint64_t current_time) override {
+        Signal* const* pins = this->inputs.data();
+        size_t index = 0;
+        for (size_t pin = 0; pin < N; pin++) {  // Unrolled: N is a constant
+            index = index << 2 | pins[pin]->get_value();
+        }
+        uint8_t result = table.values[index];
+        if (result != this->output->get_value()) {
+            this->drive_output(sim, current_time, result);
+        }
+    }
+};
+
+// Type create_component<GateType>(args...) builds: a FixedGate for
+// (delay, output, input pins...) with a fixed form, otherwise GateType
+template <typename GateType, typename... Args>
+struct FixedGateFor {
+    using type = GateType;
+};
+
+template <typename GateType, typename Delay, typename Out, typename... Pins>
+struct FixedGateFor<GateType, Delay, Out, Pins...> {
+    static constexpr bool fits = has_fixed_form<GateType>(sizeof...(Pins)) &&
+                                 std::is_integral_v<std::decay_t<Delay>> &&
+                                 std::is_convertible_v<Out, Signal*> &&
+                                 (std::is_convertible_v<Pins, Signal*> && ...);
+    using type = std::conditional_t<fits, FixedGate<GateType, sizeof...(Pins)>, GateType>;
+};
+
+// The component is exactly a GateType or one of its fixed forms (not a
+// subclass with its own evaluate())
+template <typename GateType>
+bool is_gate_type(const Component* component) {
+    const std::type_info& type = typeid(*component);
+    if (type == typeid(GateType)) {
+        return true;
+    }
+    if constexpr (GateLogic<GateType>::unary) {
+        return type == typeid(FixedGate<GateType, 1>);
+    } else if constexpr (GateLogic<GateType>::defined) {
+        return type == typeid(FixedGate<GateType, 2>) || type == typeid(FixedGate<GateType, 3>) ||
+               type == typeid(FixedGate<GateType, 4>);
+    } else {
+        return false;
+    }
+}
+
+#endif // FIXED_GATE_H
@@ -9,13 +9,42 @@
 class Simulator;  // Forward declaration
 
 class Gate : public Component {
+private:
+    // Back-annotated delays: per input pin, an index into the simulator's
+    // DelayTable (NO_DELAY = use propagation_delay). Empty when unannotated.
+    std::vector<uint32_t> pin_delays;
+    uint32_t revision = 0;  // Bumped by every rewiring or annotation
+
+    uint64_t annotated_delay(Simulator* sim, uint8_t new_value) const;
+
+protected:
+    // Delay for an output transition to `new_value`: rise/fall of the pin
+    // whose change is being propagated, or the plain propagation delay
+    uint64_t delay_for(Simulator* sim, uint8_t new_value) const {
+        return pin_delays.empty() ? propagation_delay : annotated_delay(sim, new_value);
+    }
+
+    // Schedule the output's transition to `new_value` after delay_for()
+    void drive_output(Simulator* sim, uint64_t current_time, uint8_t new_value);
+
 public:
+    static constexpr uint32_t NO_DELAY = UINT32_MAX;
+
     Gate(std::string id, uint64_t delay);
     virtual ~Gate() = default;
 
     // Common functionality
-    void connect_input(Signal* sig);
+    virtual void connect_input(Signal* sig);
     void connect_output(Signal* sig);
+
+    // Delay annotation (ids come from Simulator::get_delay_table())
+    void annotate_pin(size_t pin, uint32_t delay_id);
+    uint32_t get_pin_delay(size_t pin) const;  // NO_DELAY if not annotated
+    bool is_annotated() const;
+    void clear_annotation();
+
+    // Changes whenever pins, output or annotation change (see GateBatcher)
+    uint32_t get_revision() const { return revision; }
 };
 
 class ANDGate : public Gate {
@@ -42,6 +71,14 @@ public:
     void evaluate(Simulator* sim, uint64_t current_time) override;
 };
 
+class BUFGate : public Gate {
+private:
+    static uint32_t id_counter;
+public:
+    BUFGate(uint64_t delay = 50);
+    void evaluate(Simulator* sim, uint64_t current_time) override;
+};
+
 class XORGate : public Gate {
 private:
     static uint32_t id_counter;
@@ -50,4 +87,25 @@ public:
     void evaluate(Simulator* sim, uint64_t current_time) override;
 };
 
+// Tri-state buffer: input 0 is data, input 1 is the enable (active high).
+// Drives Z while disabled and X for an unknown enable.
+class TriBuf : public Gate {
+private:
+    static uint32_t id_counter;
+public:
+    TriBuf(uint64_t delay = 50);
+    void evaluate(Simulator* sim, uint64_t current_time) override;
+};
+
+// Resolution function for a net with several drivers: each driver drives
+// its own net into one input, the output carries the resolved value
+// (Z yields, agreeing drivers win, conflicts give X).
+class Resolver : public Gate {
+private:
+    static uint32_t id_counter;
+public:
+    Resolver(uint64_t delay = 0);
+    void evaluate(Simulator* sim, uint64_t current_time) override;
+};
+
 #endif // GATE_H
\ No newline at end of file
@@ -0,0 +1,121 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include "event.h"
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+class Simulator;  // Forward declaration
+class Signal;
+class Component;
+
+// Recording for incremental re-simulation
+//
+// While attached, the history logs every applied event and takes a
+// checkpoint (net values, component state, pending events) at the first
+// step of every `interval` ps window. After a small edit -- a changed input
+// transition, or a component modified in place -- resimulate() restarts
+// from the last checkpoint before the edit and only evaluates the edit's
+// fan-out cone: every other net replays its recorded changes. At each later
+// checkpoint the new state is compared with the recorded one, and once they
+// match (after the last stimulus edit) the recorded tail is spliced on and
+// the run stops. The result is a patched log and waveform, as if the whole
+// simulation had been re-run.
+//
+// Limits: component edits never reconverge (the cone runs to the end);
+// stats, activity and coverage see the replayed steps again; setup/hold
+// checker state and testbench processes are not checkpointed (pending
+// process wake-ups are dropped on restart).
+class History {
+public:
+    struct Change {
+        uint64_t time;
+        int signal_id;
+        uint8_t value;  // As stored (same-value events are kept)
+    };
+
+    struct Report {
+        uint64_t diverged_at = 0;      // Earliest edited time
+        uint64_t restarted_at = 0;     // Checkpoint the run resumed from
+        bool reconverged = false;
+        uint64_t reconverged_at = 0;   // Checkpoint that matched the recording
+        size_t cone_components = 0;
+        uint64_t events = 0;           // Events applied by the re-simulation
+        uint64_t evaluations = 0;
+    };
+
+    // Starts recording immediately (first checkpoint at the current time)
+    History(Simulator& simulator, uint64_t interval);
+    ~History();  // Detaches from the simulator
+    History(const History&) = delete;
+    History& operator=(const History&) = delete;
+
+    // Edits, applied by the next resimulate(). Inputs are nets no component
+    // drives; their recorded changes form the stimulus.
+    void change_input(Signal* net, uint64_t time, uint8_t value);  // Add a change
+    void remove_input(Signal* net, uint64_t time);   // Drop the recorded changes at `time`
+    void component_changed(Component* component);    // After modifying it in place
+
+    // Re-simulate up to the recording's end (the current time)
+    Report resimulate();
+
+    // Recording
+    const std::vector<Change>& get_log() const { return log; }
+    size_t checkpoint_count() const { return checkpoints.size(); }
+    size_t checkpoint_bytes() const;
+    void dump_vcd(const std::string& filename) const;  // Log as a waveform
+
+    // Simulator hooks
+    bool checkpoint_due(uint64_t next_event_time) const { return next_event_time >= next_checkpoint; }
+    void checkpoint();
+    void record(uint64_t time, int signal_id, uint8_t value) {
+        log.push_back({time, signal_id, value});
+    }
+
+private:
+    struct Checkpoint {
+        uint64_t time;                  // State before the events at `time`
+        size_t log_position;            // Changes recorded before it
+        std::vector<uint8_t> values;    // Per signal, simulator order
+        std::vector<uint8_t> state;     // Component states, concatenated
+        std::vector<size_t> state_offset;   // Per component, plus the end
+        std::vector<Event> pending;
+    };
+
+    struct InputEdit {
+        int signal_id;
+        uint64_t time;
+        uint8_t value;
+        bool remove;
+    };
+
+    // Set while resimulate() runs
+    struct Resim {
+        std::vector<uint8_t> in_cone;        // Per component index
+        std::unordered_set<int> cone_nets;   // Driven by cone components
+        const std::vector<Checkpoint>* old_checkpoints;
+        size_t first_old;                    // Old checkpoints after the restart
+        const Checkpoint* final_state;
+        uint64_t settled_after;              // Reconvergence only after this time
+        bool can_reconverge;
+        bool reconverged;
+        uint64_t reconverged_at;
+    };
+
+    Simulator& sim;
+    uint64_t interval;
+    uint64_t next_checkpoint;
+    std::vector<Change> log;
+    std::vector<Checkpoint> checkpoints;
+    std::vector<InputEdit> input_edits;
+    std::vector<Component*> changed_components;
+    Resim* resim;
+
+    Checkpoint capture(uint64_t time) const;
+    const Checkpoint& recorded_at(uint64_t time) const;  // Old state at a checkpoint boundary
+    bool matches(const Checkpoint& now, const Checkpoint& recorded) const;
+};
+
+#endif // HISTORY_H
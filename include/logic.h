@@ -0,0 +1,106 @@
+#ifndef LOGIC_H
+#define LOGIC_H
+
+#include <cstdint>
+
+// Four-state logic (IEEE 1164 subset): 0, 1, X (unknown) and Z (undriven)
+//
+// Gate kernels fold their inputs through small constant tables, so X/Z
+// handling costs one indexed load per input and no branches. A Z input acts
+// like X everywhere except in bus resolution, where it yields to any driver.
+//
+// Defining LOGIC_SIM_TWO_STATE compiles a pure 0/1 simulator: X and Z
+// collapse to 0 when stored, and the kernels use plain bit operations.
+#ifdef LOGIC_SIM_TWO_STATE
+constexpr bool TWO_STATE = true;
+#else
+constexpr bool TWO_STATE = false;
+#endif
+
+constexpr uint8_t LOGIC_0 = 0;
+constexpr uint8_t LOGIC_1 = 1;
+constexpr uint8_t LOGIC_X = 2;
+constexpr uint8_t LOGIC_Z = 3;
+
+namespace logic {
+
+//                                  b = 0  1  X  Z
+constexpr uint8_t AND_TABLE[4][4] = {{0, 0, 0, 0},    // a = 0
+                                     {0, 1, 2, 2},    // a = 1
+                                     {0, 2, 2, 2},    // a = X
+                                     {0, 2, 2, 2}};   // a = Z
+constexpr uint8_t OR_TABLE[4][4]  = {{0, 1, 2, 2},
+                                     {1, 1, 1, 1},
+                                     {2, 1, 2, 2},
+                                     {2, 1, 2, 2}};
+constexpr uint8_t XOR_TABLE[4][4] = {{0, 1, 2, 2},
+                                     {1, 0, 2, 2},
+                                     {2, 2, 2, 2},
+                                     {2, 2, 2, 2}};
+constexpr uint8_t NOT_TABLE[4] = {1, 0, 2, 2};
+constexpr uint8_t BUF_TABLE[4] = {0, 1, 2, 2};   // Also "Z reads as X"
+
+// Two drivers on one net: Z yields, equal values agree, anything else is X
+constexpr uint8_t RESOLVE_TABLE[4][4] = {{0, 2, 2, 0},
+                                         {2, 1, 2, 1},
+                                         {2, 2, 2, 2},
+                                         {0, 1, 2, 3}};
+
+// Tri-state buffer output, indexed [enable][data]
+constexpr uint8_t TRI_TABLE[4][4] = {{3, 3, 3, 3},
+                                     {0, 1, 2, 2},
+                                     {2, 2, 2, 2},
+                                     {2, 2, 2, 2}};
+
+// Value as stored in a signal (two-state mode drops X/Z)
+inline uint8_t canonical(uint8_t v) { return TWO_STATE ? (v == LOGIC_1) : v; }
+
+inline uint8_t and2(uint8_t a, uint8_t b) {
+    if constexpr (TWO_STATE) return a & b;
+    else return AND_TABLE[a][b];
+}
+inline uint8_t or2(uint8_t a, uint8_t b) {
+    if constexpr (TWO_STATE) return a | b;
+    else return OR_TABLE[a][b];
+}
+inline uint8_t xor2(uint8_t a, uint8_t b) {
+    if constexpr (TWO_STATE) return a ^ b;
+    else return XOR_TABLE[a][b];
+}
+inline uint8_t not1(uint8_t a) {
+    if constexpr (TWO_STATE) return a ^ 1;
+    else return NOT_TABLE[a];
+}
+inline uint8_t buf1(uint8_t a) {
+    if constexpr (TWO_STATE) return a;
+    else return BUF_TABLE[a];
+}
+inline uint8_t resolve(uint8_t a, uint8_t b) {
+    if constexpr (TWO_STATE) return a | b;   // Wired-OR without Z
+    else return RESOLVE_TABLE[a][b];
+}
+inline uint8_t tri(uint8_t enable, uint8_t data) {
+    if constexpr (TWO_STATE) return enable & data;
+    else return TRI_TABLE[enable][data];
+}
+
+inline char to_char(uint8_t v) {
+    static constexpr char chars[4] = {'0', '1', 'X', 'Z'};
+    return chars[v & 3];
+}
+
+// Accepts the nine std_ulogic characters: U, X, W and - read as X, L as 0,
+// H as 1 (strength is not modelled). Returns 0xFF for anything else.
+inline uint8_t from_char(char c) {
+    switch (c) {
+        case '0': case 'L': case 'l': return LOGIC_0;
+        case '1': case 'H': case 'h': return LOGIC_1;
+        case 'Z': case 'z': return LOGIC_Z;
+        case 'X': case 'x': case 'U': case 'u': case 'W': case 'w': case '-': return LOGIC_X;
+        default: return 0xFF;
+    }
+}
+
+}  // namespace logic
+
+#endif // LOGIC_H
@@ -0,0 +1,183 @@
+#ifndef MEMORIES_H
+#define MEMORIES_H
+
+#include "sequential.h"
+#include "signal.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Simulator;  // Forward declaration
+
+// One memory word: `xmask` marks unknown (X) bits
+struct MemWord {
+    uint64_t value = 0;
+    uint64_t xmask = 0;
+};
+
+// Read-only file mapping used to back memory images
+class MappedFile {
+private:
+    int fd;
+    const uint8_t* data;
+    size_t length;
+
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* bytes() const { return data; }
+    size_t size() const { return length; }
+};
+
+// Sparse word store
+//
+// Words live in fixed-size pages that are allocated on first write, so a
+// large address space only costs the pages that are touched. A binary image
+// stays mapped and is read in place; its pages are copied out only when
+// written. Untouched words read as the fill value (X by default).
+class SparseMemory {
+public:
+    static constexpr unsigned PAGE_BITS = 10;
+    static constexpr uint64_t PAGE_WORDS = uint64_t(1) << PAGE_BITS;
+
+    enum ImageFormat { HEX, BINARY };
+
+    SparseMemory(unsigned width, uint64_t depth);
+
+    unsigned get_width() const { return width; }
+    uint64_t get_depth() const { return depth; }
+
+    MemWord read(uint64_t addr) const;
+    void write(uint64_t addr, MemWord word);
+    void write(uint64_t addr, uint64_t value) { write(addr, MemWord{value, 0}); }
+
+    // Value for words never written and outside any image: 0, 1 (all ones) or 2 (X)
+    void set_fill(uint8_t fill_value);
+
+    // Load an image starting at word `base`. HEX is $readmemh style: one hex
+    // word per token, "@addr" sets the address, "//" starts a comment, x/X
+    // digits are unknown. BINARY holds little-endian words of ceil(width/8)
+    // bytes (a partial word at the end is an error) and is mapped rather
+    // than copied.
+    void load_image(const std::string& path, ImageFormat format, uint64_t base = 0);
+
+    size_t pages_allocated() const { return pages.size(); }
+    size_t bytes_allocated() const;
+    void clear();
+
+    // Checkpointing: the written pages (the image and fill are not copied)
+    void save(std::vector<uint8_t>& out) const;
+    void restore(const uint8_t*& in);
+
+private:
+    struct Page {
+        std::unique_ptr<uint64_t[]> value;
+        std::unique_ptr<uint64_t[]> xmask;  // Allocated on the first X write
+    };
+
+    unsigned width;
+    uint64_t depth;
+    uint64_t word_mask;
+    MemWord fill;
+
+    std::unordered_map<uint64_t, Page> pages;
+    mutable uint64_t cached_page_number;  // One-entry lookup cache
+    mutable Page* cached_page;
+
+    std::shared_ptr<MappedFile> image;   // Mapped binary image, if any
+    uint64_t image_base;
+    uint64_t image_words;
+    unsigned image_word_bytes;
+
+    Page* find_page(uint64_t page_number) const;
+    Page& materialize(uint64_t page_number);
+    MemWord background(uint64_t addr) const;  // Image or fill value
+    void check_address(uint64_t addr) const;
+    void load_hex(const MappedFile& file, uint64_t base);
+};
+
+// Base for clocked memories: owns the store and the read ports
+//
+// A read port samples its address bus on the active clock edge and drives
+// its data bus after the propagation delay; only bits that change get an
+// event. Reads see the contents from before the edge (read-first), and an
+// address with X bits or beyond the depth reads as all X.
+//
+// The store is word-level (one lookup per port per edge); the bus is not,
+// since nets are one bit wide and only an event on the net itself updates
+// its value, trace and fan-out. A read's bit events all share one time, so
+// they land in the queue's near FIFO together without heap work.
+class MemoryElement : public SequentialElement {
+protected:
+    struct Port {
+        std::vector<Signal*> addr;
+        std::vector<Signal*> data;
+        Signal* enable;  // Optional; read/write only when 1
+    };
+
+    SparseMemory store;
+    std::vector<Port> read_ports;
+
+    MemoryElement(const std::string& element_id, unsigned width, uint64_t depth, uint64_t delay);
+
+    void check_port(const std::vector<Signal*>& addr, const std::vector<Signal*>& data) const;
+    // Returns false when the address is unknown or out of range
+    bool decode_address(const Port& port, uint64_t& addr) const;
+    bool port_enabled(const Port& port) const;
+    void perform_reads(Simulator* sim, uint64_t current_time);
+
+public:
+    // Address bus is LSB first; data bus must be exactly `width` bits
+    size_t add_read_port(const std::vector<Signal*>& addr, const std::vector<Signal*>& dout,
+                         Signal* enable = nullptr);
+
+    SparseMemory& get_memory() { return store; }
+    const SparseMemory& get_memory() const { return store; }
+
+    void get_fanin(std::vector<Signal*>& nets) const override;
+    void get_fanout(std::vector<Signal*>& nets) const override;
+    void save_state(std::vector<uint8_t>& out) const override;
+    void restore_state(const uint8_t*& in) override;
+};
+
+// Synchronous RAM with any number of read and write ports
+//
+// On a rising edge all read ports sample first, then enabled write ports
+// commit in the order they were added (the last port wins on a collision).
+class SyncRAM : public MemoryElement {
+private:
+    static uint32_t id_counter;
+    std::vector<Port> write_ports;
+
+protected:
+    void on_clock_edge(Simulator* sim, uint64_t current_time) override;
+
+public:
+    SyncRAM(unsigned width, uint64_t depth, uint64_t delay = 100);
+
+    size_t add_write_port(const std::vector<Signal*>& addr, const std::vector<Signal*>& din,
+                          Signal* write_enable);
+
+    void get_fanin(std::vector<Signal*>& nets) const override;
+};
+
+// Synchronous ROM: read ports only, contents from an image (or poked)
+class SyncROM : public MemoryElement {
+private:
+    static uint32_t id_counter;
+
+protected:
+    void on_clock_edge(Simulator* sim, uint64_t current_time) override;
+
+public:
+    SyncROM(unsigned width, uint64_t depth, uint64_t delay = 100);
+    SyncROM(unsigned width, uint64_t depth, const std::string& image_path,
+            SparseMemory::ImageFormat format, uint64_t delay = 100);
+};
+
+#endif // MEMORIES_H
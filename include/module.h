@@ -0,0 +1,130 @@
+#ifndef MODULE_H
+#define MODULE_H
+
+#include "component.h"
+#include "signal.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Simulator;  // Forward declaration
+
+// Hierarchical module definition (flyweight)
+//
+// A definition stores the topology of a block once: its nets, gates, flops and
+// ports. Any number of ModuleInstance components share one definition and keep
+// only their own net values. Sub-modules added with add_instance are inlined
+// into the definition under a hierarchical prefix ("fa0.s").
+class ModuleDef {
+public:
+    enum Op : uint8_t { AND, OR, XOR, NOT, BUF };
+
+    explicit ModuleDef(const std::string& def_name);
+
+    // Structure (indices are local net numbers)
+    uint32_t add_net(const std::string& net_name, uint8_t initial_value = 2);
+    uint32_t add_input(const std::string& port_name);
+    uint32_t add_output(const std::string& port_name, uint8_t initial_value = 2);
+    void add_gate(Op op, const std::vector<uint32_t>& ins, uint32_t out, uint64_t delay);
+    // Rising-edge D flip-flop; `clk` must be an input port
+    void add_dff(uint32_t d, uint32_t clk, uint32_t q, uint64_t delay);
+    // Inline a child definition; port_nets maps the child's ports (inputs then
+    // outputs, in declaration order) to nets of this definition
+    void add_instance(const ModuleDef& child, const std::string& inst_name,
+                      const std::vector<uint32_t>& port_nets);
+
+    // Levelize the logic and compute port delays; called by ModuleInstance
+    void finalize();
+
+    const std::string& get_name() const;
+    size_t net_count() const;
+    size_t gate_count() const;
+    size_t flop_count() const;
+    const std::vector<uint32_t>& get_inputs() const;
+    const std::vector<uint32_t>& get_outputs() const;
+    const std::string& get_net_name(uint32_t net) const;
+    uint64_t get_output_delay(size_t port) const;
+
+    // Local net number for a (hierarchical) net name, -1 if unknown. The name
+    // table is built on first use.
+    int32_t find_net(const std::string& net_name) const;
+
+private:
+    friend class ModuleInstance;
+
+    struct Node {
+        Op op;
+        uint32_t first_input;  // Into `pins`
+        uint32_t num_inputs;
+        uint32_t output;
+        uint64_t delay;
+    };
+    struct Flop {
+        uint32_t d, clk, q;
+        uint64_t delay;
+    };
+
+    std::string name;
+    std::vector<std::string> net_names;
+    std::vector<uint8_t> net_init;
+    std::vector<uint32_t> inputs;
+    std::vector<uint32_t> outputs;
+    std::vector<Node> nodes;
+    std::vector<uint32_t> pins;
+    std::vector<Flop> flops;
+
+    // Derived by finalize()
+    bool finalized;
+    std::vector<uint32_t> order;          // Nodes in topological order
+    std::vector<uint64_t> output_delay;   // Longest path delay to each output port
+    std::vector<int32_t> input_slot;      // Net -> input port number (-1 if none)
+
+    mutable std::unordered_map<std::string, uint32_t> net_lookup;  // Lazy name table
+
+    static uint8_t eval_op(Op op, const uint8_t* values, const uint32_t* pins, uint32_t count);
+};
+
+// One instance of a shared definition
+//
+// Internal logic is evaluated zero-delay in levelized order whenever an input
+// port changes; each output port is driven after the definition's longest path
+// delay to that port. Per-instance memory is one byte per net plus one per flop.
+class ModuleInstance : public Component {
+private:
+    std::shared_ptr<ModuleDef> def;
+    std::vector<Signal*> in_ports;
+    std::vector<Signal*> out_ports;
+    std::vector<uint8_t> state;        // Net values
+    std::vector<uint8_t> last_clock;   // Per flop
+
+public:
+    ModuleInstance(std::shared_ptr<ModuleDef> definition, const std::string& inst_name);
+
+    // Connect ports in declaration order
+    void connect_input(size_t port, Signal* sig);
+    void connect_output(size_t port, Signal* sig);
+
+    void evaluate(Simulator* sim, uint64_t current_time) override;
+    bool is_sequential() const override;
+    void get_fanin(std::vector<Signal*>& nets) const override;
+    void get_fanout(std::vector<Signal*>& nets) const override;
+    void save_state(std::vector<uint8_t>& out) const override;
+    void restore_state(const uint8_t*& in) override;
+
+    const ModuleDef& get_def() const;
+    uint8_t get_net_value(uint32_t net) const;
+    Signal* get_input_port(size_t port) const;
+    Signal* get_output_port(size_t port) const;
+};
+
+// Create an instance and one simulator signal per port, named
+// "<inst_name>.<port>"; the simulator owns both
+ModuleInstance* instantiate(Simulator& sim, std::shared_ptr<ModuleDef> def, const std::string& inst_name);
+
+// Resolve "<signal>" or "<instance>.<internal net>" to its current value
+// (names are only looked up when asked for); throws if the path is unknown
+uint8_t resolve_value(Simulator& sim, const std::string& path);
+
+#endif // MODULE_H
@@ -0,0 +1,41 @@
+#ifndef OPTIMIZE_H
+#define OPTIMIZE_H
+
+#include "simulator.h"
+#include <cstddef>
+
+// Netlist simplification pass (run after elaboration, before simulation)
+//
+// - Folds constants (nets tied with Simulator::tie_constant) through
+//   AND/OR/XOR/NOT/BUF gates; gates left with one input become BUF/NOT
+// - Collapses NOT/BUF chains (double inversions become a single BUF) into one
+//   gate whose delay is the sum of the chain's delays
+// - Removes gates whose output has no fanout and is not probed, then the nets
+//   they drove
+//
+// Path delays are preserved: a rebuilt gate keeps its delay, a folded constant
+// is driven at the time it would have arrived. Nets marked with
+// Simulator::probe, tied constants and nets that were never gate outputs are
+// always kept; other internal nets may be deleted.
+//
+// A net counts as read if a component observes it or reports it from
+// Component::get_fanin. Components that sample nets without observing them
+// (memories read address and data at the clock edge) must report those nets
+// through get_fanin, or the gates driving them are removed as dead.
+struct OptimizeReport {
+    size_t gates_before = 0;
+    size_t gates_after = 0;
+    size_t nets_before = 0;
+    size_t nets_after = 0;
+    size_t constants_folded = 0;      // Gates replaced by a constant
+    size_t gates_simplified = 0;      // Gates rebuilt with fewer inputs
+    size_t chains_collapsed = 0;      // NOT/BUF pairs merged into one gate
+    size_t dead_gates = 0;            // Gates removed for lack of fanout
+
+    size_t gates_removed() const { return gates_before - gates_after; }
+    size_t nets_removed() const { return nets_before - nets_after; }
+};
+
+OptimizeReport optimize_netlist(Simulator& sim);
+
+#endif // OPTIMIZE_H
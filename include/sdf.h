@@ -0,0 +1,36 @@
+#ifndef SDF_H
+#define SDF_H
+
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+class Simulator;  // Forward declaration
+
+// Back-annotation from a subset of SDF (IEEE 1497)
+//
+// Supported: DELAYFILE with TIMESCALE, CELL / CELLTYPE / INSTANCE (an exact
+// component id, or "*" for every component of CELLTYPE), DELAY with ABSOLUTE
+// or INCREMENT, and IOPATH entries with one (rise = fall) or two (rise, fall)
+// delay values, each "v" or "min:typ:max". Input pins are named A, B, C, ...
+// or by number; the output pin name is not checked. Other constructs are
+// skipped. Delays are rounded to whole picoseconds.
+//
+// Only gates take annotations; everything lands in the simulator's
+// deduplicated DelayTable.
+
+enum class SdfCorner { MIN, TYP, MAX };
+
+struct SdfReport {
+    size_t cells = 0;               // CELL entries read
+    size_t paths_annotated = 0;     // Pin delays written
+    size_t unknown_instances = 0;   // INSTANCE names with no matching component
+    size_t skipped = 0;             // Entries that could not be applied
+    std::vector<std::string> warnings;
+};
+
+SdfReport load_sdf(Simulator& sim, const std::string& filename, SdfCorner corner = SdfCorner::TYP);
+SdfReport parse_sdf(Simulator& sim, std::istream& in, SdfCorner corner = SdfCorner::TYP);
+
+#endif // SDF_H
@@ -10,15 +10,16 @@ class Simulator;  // Forward declaration
 
 // Base class for sequential (stateful) elements
 class SequentialElement : public Component {
-protected:
-    Signal* clock;
-    uint8_t last_clock_value;
-    
+public:
     enum Edge {
         RISING,
         FALLING,
         BOTH
     };
+
+protected:
+    Signal* clock;
+    uint8_t last_clock_value;
     
     Edge trigger_edge;
     
@@ -37,17 +38,29 @@ public:
     
     // Evaluate checks for clock edge and calls on_clock_edge
     void evaluate(Simulator* sim, uint64_t current_time) override;
+
+    bool is_sequential() const override;
+    void get_fanin(std::vector<Signal*>& nets) const override;
+    void save_state(std::vector<uint8_t>& out) const override;
+    void restore_state(const uint8_t*& in) override;
+
+    Signal* get_clock() const;
+    Edge get_edge() const;
 };
 
 
 // D Flip-Flop (positive edge triggered)
 class DFF : public SequentialElement {
 private:
+    friend class ClockDomain;    // Takes over edge sampling for batched flops
+    friend class TimingChecker;  // Assigns the timing slot
     static uint32_t id_counter;
     Signal* d;           // Data input
     Signal* q;           // Output
     Signal* async_reset; // Asynchronous reset (optional)
     Signal* enable;      // Enable signal (optional)
+    bool in_domain;      // Sampled by a ClockDomain instead of on its own
+    uint32_t timing_slot; // Setup/hold check slot (TimingChecker::NO_SLOT if unchecked)
     
 protected:
     void on_clock_edge(Simulator* sim, uint64_t current_time) override;
@@ -63,6 +76,14 @@ public:
     
     // Override evaluate to handle async reset
     void evaluate(Simulator* sim, uint64_t current_time) override;
+    void get_fanin(std::vector<Signal*>& nets) const override;
+
+    Signal* get_data() const;
+    Signal* get_q() const;
+    Signal* get_reset() const;
+    Signal* get_enable() const;
+    bool is_in_domain() const;
+    bool has_timing_checks() const;
 };
 
 #endif // SEQUENTIAL_H
@@ -9,11 +9,13 @@
 class Component;
 
 class Signal {
+    friend class Simulator;  // Assigns the dense per-simulator index
 private:
     static uint32_t id_counter;  // Static counter for unique IDs
     uint32_t id;  // Unique identifier for the signal
+    uint32_t index;  // Position in the owning simulator's signal list (for per-net arrays)
     std::string name;
-    uint8_t current_value;  // 0, 1, or 2 (for 'X' unknown)
+    uint8_t current_value;  // 0, 1, 2 (for 'X' unknown) or 3 (for 'Z' undriven), see logic.h
     std::vector<Component*> observers;  // Components that depend on this signal
     
 public:
@@ -21,19 +23,21 @@ public:
     explicit Signal(const std::string& signal_name, uint8_t initial_value = 2);
     
     // Value/ID access (encapsulation)
-    uint8_t get_value() const;
+    uint8_t get_value() const { return current_value; }  // Inline: read on every gate evaluation
     void set_value(uint8_t new_val);
-    uint32_t get_id() const;
+    uint32_t get_id() const { return id; }
+    uint32_t get_index() const { return index; }
     
     // Identity
     const std::string& get_name() const;
     
     // Observer management
     void attach_observer(Component* component);
+    void detach_observer(Component* component);
     const std::vector<Component*>& get_observers() const;
     
     // Utility
-    std::string value_to_string() const;  // "0", "1", or "X"
+    std::string value_to_string() const;  // "0", "1", "X" or "Z"
     std::string to_string() const;
 };
 
@@ -0,0 +1,156 @@
+#ifndef SIM_SERVER_H
+#define SIM_SERVER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+class Simulator;  // Forward declaration
+
+// Local simulation server
+//
+// Keeps elaborated netlists resident and runs short simulations on them for
+// clients on a Unix-domain socket, so a run costs its own events instead of
+// process start plus elaboration. Every worker thread elaborates its own
+// copy of each registered design once, snapshots it (Simulator::save_snapshot)
+// and rewinds to that snapshot before each run.
+//
+// Protocol: text lines ending in '\n'. A request is
+//   design <name>
+//   set <net> <time> <value>      Stimulus, value 0/1/X/Z
+//   clock <net> <period>          Toggle 0 -> 1 at period/2, every period/2
+//   trace <net> [<net> ...]       Nets whose changes are sent back
+//   run <ps>                      Simulate [0, ps] and answer
+// and the answer is
+//   ok <design>
+//   <time> <net> <value>          Traced values at t=0, then every change,
+//                                 streamed while the run goes on
+//   done <last event time> <events> <evaluations>
+// or "error <message>" in place of (or after) the ok line, e.g. when the
+// run exceeds the event limit. "designs" is
+// answered with "designs <name> <name> ...", and "shutdown" with "bye"
+// before wait() returns in the server process. A connection may send any
+// number of requests; each one goes to the next free worker once it has
+// arrived in full, so a client that stalls mid-request holds no worker.
+//
+// Times in a request are relative to the design's elaborated state.
+// Stimulus and clock edges are only scheduled up to the run length.
+
+struct SimRequest {
+    struct Drive {
+        std::string net;
+        uint64_t time;
+        uint8_t value;
+    };
+    struct Clock {
+        std::string net;
+        uint64_t period;
+    };
+    std::string design;
+    std::vector<Drive> drives;
+    std::vector<Clock> clocks;
+    std::vector<std::string> traces;
+    uint64_t run_length = 0;
+};
+
+struct SimResult {
+    struct Change {
+        uint64_t time;
+        std::string net;
+        uint8_t value;
+    };
+    std::vector<Change> changes;
+    uint64_t end_time = 0;
+    uint64_t events = 0;
+    uint64_t evaluations = 0;
+};
+
+class SimServer {
+public:
+    using DesignBuilder = std::function<void(Simulator&)>;
+
+    // `workers` = 0 uses one per hardware thread
+    SimServer(const std::string& socket_path, size_t workers);
+    ~SimServer();  // Stops the server
+    SimServer(const SimServer&) = delete;
+    SimServer& operator=(const SimServer&) = delete;
+
+    void add_design(const std::string& name, DesignBuilder build);  // Before start()
+    // A run that applies more events than this fails with an error (0: no
+    // limit, default 50M). Guards the daemon against stimulus that never settles.
+    void set_event_limit(uint64_t events) { event_limit = events; }
+
+    // Elaborate every design in every worker, then listen. Throws
+    // std::runtime_error if the socket cannot be bound.
+    void start();
+    // Stop accepting, cut open connections, join the threads and remove the
+    // socket file. Requests already running finish first.
+    void stop();
+    void wait();  // Until a client asks for a shutdown (or stop() is called)
+
+    size_t worker_count() const { return worker_threads; }
+    uint64_t requests_served() const { return served.load(); }
+    uint64_t requests_failed() const { return failed.load(); }
+
+private:
+    struct Connection;
+    struct Worker;
+
+    std::string path;
+    size_t worker_threads;
+    std::vector<std::pair<std::string, DesignBuilder>> designs;
+    uint64_t event_limit;
+
+    int listen_fd;
+    int wake_pipe[2];  // Workers hand connections back to the dispatcher
+    std::atomic<bool> running;
+    std::thread dispatcher;
+    std::vector<Worker*> workers;
+
+    std::mutex mutex;
+    std::condition_variable ready_cv;
+    std::condition_variable shutdown_cv;
+    bool shutdown_requested;
+    std::deque<Connection*> ready;      // Connections with a request waiting
+    std::vector<Connection*> returned;  // Served, back to the dispatcher
+    std::unordered_set<Connection*> connections;
+
+    std::atomic<uint64_t> served;
+    std::atomic<uint64_t> failed;
+
+    void dispatch_loop();
+    void worker_loop(Worker* worker);
+    void serve(Worker* worker, Connection* conn);  // One request
+    void close_connection(Connection* conn);
+};
+
+// Blocking client for one connection
+class SimClient {
+public:
+    explicit SimClient(const std::string& socket_path);  // Throws std::runtime_error
+    ~SimClient();
+    SimClient(const SimClient&) = delete;
+    SimClient& operator=(const SimClient&) = delete;
+
+    // Throws std::runtime_error with the server's message on an error answer
+    SimResult run(const SimRequest& request);
+    std::vector<std::string> designs();
+    void shutdown();  // Ask the server to exit (see SimServer::wait)
+
+private:
+    int fd;
+    std::string buffer;  // Received, consumed up to buffer_pos
+    size_t buffer_pos;
+
+    void send_text(const std::string& text);
+    std::string read_line();
+};
+
+#endif // SIM_SERVER_H
@@ -2,20 +2,44 @@
 #define SIMULATOR_H
 
 #include "event_queue.h"
+#include "batch_eval.h"
+#include "fixed_gate.h"
 #include "signal.h"
 #include "component.h"
+#include "stats.h"
+#include "activity.h"
+#include "coverage.h"
+#include "timing.h"
+#include "delay.h"
+#include "trace_store.h"
 #include <vector>
 #include <map>
+#include <memory>
+#include <set>
 #include <string>
 #include <cstdint>
+#include <initializer_list>
+#include <ostream>
+#include <utility>
+
+class History;  // Forward declaration
+class TraceWriter;
 
 class Simulator {
+    friend class History;  // Checkpoints and restarts the run (see history.h)
+    friend class TraceWriter;  // Writes the VCD header (see trace_writer.h)
 private:
     EventQueue event_queue;
     std::vector<Signal*> signals;
     std::vector<Component*> components;
     std::map<std::string, Signal*> signal_by_name;
-    std::map<int, Signal*> signal_by_id;
+    // Signal ids are global (see Signal), so the table starts at the lowest
+    // id registered; ids of other simulators' signals leave null gaps
+    std::vector<Signal*> signal_by_id;
+    int id_base;
+    // Per net (by index): where its last FIFO-queued event sits, so another
+    // write for the same time coalesces into it (see EventQueue::schedule)
+    std::vector<PendingSlot> pending_slots;
     uint64_t current_time;
     bool trace_enabled;
     struct SignalChange {
@@ -25,42 +49,250 @@ private:
         uint8_t new_value;
     };
     std::vector<SignalChange> trace_log;
+    // Out-of-core recording (enable_trace(path)): store slot per signal id
+    // (from trace_id_base), UINT32_MAX for nets created after it started
+    std::unique_ptr<TraceStore> trace_store;
+    std::vector<uint32_t> trace_slots;
+    int trace_id_base;
+    TraceWriter* trace_writer;  // Pipelined output (enable_trace(writer)), not owned
     std::map<int, uint8_t> initial_values; // for vcd dump
+
+    // Objects created through create_signal/create_component are owned
+    // (and deleted) by the simulator; objects passed to add_* are not
+    std::vector<Signal*> owned_signals;
+    std::vector<Component*> owned_components;
+
+    // Run counters (cumulative over the simulator's lifetime)
+    uint64_t events_processed;
+    uint64_t evaluations;
+
+    // Detailed instrumentation (see stats.h)
+    bool stats_enabled;
+    StatsCollector stats;
+
+    // Switching activity (see activity.h)
+    bool activity_enabled;
+    ActivityProfile activity;
+
+    // Toggle/state coverage (see coverage.h), on by default
+    bool coverage_enabled;
+    CoverageDB coverage;
+
+    // Back-annotated delays (see delay.h, sdf.h)
+    DelayTable delay_table;
+    Signal* trigger;  // Net whose change is being propagated (nullptr outside step)
+
+    // Delta cycles: each step() applies one cycle's events (update phase),
+    // then evaluates their observers (evaluate phase)
+    uint32_t delta_limit;                // Max delta cycles at one time
+    std::vector<Signal*> changed_nets;   // Nets updated in the current cycle
+    std::vector<uint32_t> woken_slots;   // Process wake-ups in the current cycle
+    uint64_t update_phase(size_t count, bool record);  // Returns events applied
+    uint64_t evaluate_phase(bool record);              // Returns evaluations
+
+    // Batched gate evaluation (see batch_eval.h); groups are rebuilt at the
+    // next evaluate phase after components are added or removed
+    bool batch_enabled;
+    bool batch_dirty;
+    GateBatcher batcher;
+
+    // Process wake-ups: an event with a negative signal_id (-1 - slot)
+    // calls the slot's function once its step's evaluations are done
+    struct WakeSlot {
+        void (*fn)(void* context);  // nullptr once cancelled
+        void* context;
+    };
+    std::vector<WakeSlot> wake_slots;
+    std::vector<uint32_t> free_wake_slots;
+
+    bool stop_requested;  // Set by stop(), ends run_until/run_all after the step
+
+    History* history;  // Recording for incremental re-simulation, if any
+
+    // Setup/hold checks (see timing.h)
+    bool timing_enabled;
+    TimingChecker timing;
+
+    // Netlist annotations (used by netlist passes)
+    std::map<int, uint8_t> constant_values;  // Tied nets: signal id -> value
+    std::set<int> probed_ids;                // Nets the user observes
+
+    void reindex();  // Renumber signals/components and rebuild per-net tables
+    void write_vcd_header(std::ostream& file) const;  // Up to $enddefinitions
     
 public:
     Simulator();
+    Simulator(const Simulator&) = delete;
+    Simulator& operator=(const Simulator&) = delete;
     
     // Component management
     Signal* create_signal(const std::string& name, uint8_t value); // Create and register signal
 
-    // Create and register components
-    template<typename ComponentType>
-    ComponentType* create_component(uint64_t delay){
-        ComponentType* component = new ComponentType(delay);
+    // Create and register components (arguments go to the constructor,
+    // usually just the propagation delay). For AND/OR/XOR/NOT/BUF gates,
+    // (delay, output, inputs...) builds a connected FixedGate instead.
+    template<typename ComponentType, typename... Args>
+    ComponentType* create_component(Args&&... args){
+        using Concrete = typename FixedGateFor<ComponentType, Args...>::type;
+        ComponentType* component = new Concrete(std::forward<Args>(args)...);
         add_component(component);
+        owned_components.push_back(component);
         return component;
     }
+
+    // A gate on `count` input pins driving `out`: a FixedGate when the
+    // fan-in has a fixed form, otherwise a plain GateType
+    template<typename GateType>
+    GateType* create_gate(uint64_t delay, Signal* const* ins, size_t count, Signal* out){
+        if constexpr (GateLogic<GateType>::unary) {
+            if (count == 1) return create_component<GateType>(delay, out, ins[0]);
+        } else if constexpr (GateLogic<GateType>::defined) {
+            switch (count) {
+                case 2: return create_component<GateType>(delay, out, ins[0], ins[1]);
+                case 3: return create_component<GateType>(delay, out, ins[0], ins[1], ins[2]);
+                case 4: return create_component<GateType>(delay, out, ins[0], ins[1], ins[2], ins[3]);
+                default: break;
+            }
+        }
+        GateType* gate = create_component<GateType>(delay);
+        for (size_t i = 0; i < count; i++) {
+            gate->connect_input(ins[i]);
+        }
+        gate->connect_output(out);
+        return gate;
+    }
+    template<typename GateType>
+    GateType* create_gate(uint64_t delay, std::initializer_list<Signal*> ins, Signal* out){
+        return create_gate<GateType>(delay, ins.begin(), ins.size(), out);
+    }
     void add_signal(Signal* sig);
     void add_component(Component* component);
     
     // Signal lookup
     Signal* get_signal_by_name(const std::string& name);
     Signal* get_signal_by_id(int id);
+
+    // Netlist access (for netlist passes such as optimize_netlist)
+    const std::vector<Signal*>& get_signals() const;
+    const std::vector<Component*>& get_components() const;
+    // Removal renumbers indices and resets per-net coverage/stats/activity;
+    // removed signals must not have pending events
+    void remove_components(const std::vector<Component*>& list);
+    void remove_signals(const std::vector<Signal*>& list);
+
+    // Netlist annotations
+    void tie_constant(Signal* sig, uint8_t value);  // Drive a net to a constant from now on
+    bool is_constant(const Signal* sig) const;
+    uint8_t get_constant(const Signal* sig) const;
+    void probe(Signal* sig);                        // Mark a net as observed by the user
+    bool is_probed(const Signal* sig) const;
     
-    // Event scheduling (called by gates)
+    // Event scheduling (called by gates). A write to a net that already has
+    // an event queued for the same time replaces that event's value (the last
+    // writer wins) instead of queueing a second event.
     void schedule_event(const Event& e);
+    // Many events at once (testbench stimulus): same coalescing, and the
+    // heap is rebuilt once instead of once per event
+    void schedule_batch(const Event* events, size_t count);
+    void schedule_batch(const std::vector<Event>& events) { schedule_batch(events.data(), events.size()); }
+
+    // Call fn(context) at `time`, after that step's component evaluations
+    // (used by the coroutine testbench, see testbench.h). Returns a slot
+    // that can be cancelled until it fires.
+    uint32_t schedule_wake(uint64_t time, void (*fn)(void* context), void* context);
+    void cancel_wake(uint32_t slot);
     
     // Simulation control
-    void step();                          // Process one event
+    void step();                          // Process one delta cycle
     void run_until(uint64_t end_time);   // Run until time limit
     void run_all();                      // Run until queue empty
+    void stop();                          // End the current run after this step
+    bool stopped() const { return stop_requested; }  // Last run ended by stop()
+
+    // Evaluate plain AND/OR/XOR/NOT/BUF gates in batches of one type and
+    // fan-in: a gate is evaluated once per phase however many of its inputs
+    // changed, groups of at least `min_batch` active gates run through a
+    // SIMD kernel (AVX2 when the CPU has it) and the rest through evaluate().
+    // Gates rewired or delay-annotated later are regrouped automatically.
+    // See batch_eval.h for the scheduling order of batched outputs.
+    void enable_batch_eval(size_t min_batch = 8);
+    void disable_batch_eval();
+    bool batch_eval_enabled() const { return batch_enabled; }
+    GateBatcher& get_batcher() { return batcher; }
+
+    // Zero-delay events form delta cycles at the same time; step() throws
+    // std::runtime_error past `limit` cycles at one time (default 10000)
+    void set_delta_limit(uint32_t limit) { delta_limit = limit; }
+    uint32_t get_delta_limit() const { return delta_limit; }
+    uint32_t get_delta() const { return event_queue.current_delta(); }  // Cycle of the last step, 0 first
+
+    // Whole-run state: time, net values, component state and pending events.
+    // Restoring rewinds a resident netlist for another run (see sim_server.h);
+    // process wake-ups are not captured, and stats/activity/coverage/history
+    // are left as they are.
+    struct Snapshot {
+        uint64_t time = 0;
+        std::vector<uint8_t> values;   // Per signal, simulator order
+        std::vector<uint8_t> state;    // Component states, concatenated
+        std::vector<Event> pending;
+    };
+    Snapshot save_snapshot() const;
+    void restore_snapshot(const Snapshot& snapshot);  // Same netlist only
     
     // Time access
     uint64_t get_current_time() const;
+    bool has_pending_events() const { return !event_queue.empty(); }
+    uint64_t get_next_event_time() const { return event_queue.next_time(); }  // Needs a pending event
+
+    // Run counters
+    uint64_t get_events_processed() const;  // Events popped from the queue
+    uint64_t get_evaluations() const;       // Component::evaluate calls
+    size_t get_signal_count() const;
+    size_t get_component_count() const;
+
+    // Performance instrumentation
+    void enable_stats();   // Reset and start recording
+    void disable_stats();
+    SimStats get_stats(size_t top_n = 10) const;
+    void dump_stats(const std::string& filename, size_t top_n = 10) const;  // JSON
+
+    // Switching activity (toggle counts and 0/1/X residency per net)
+    void enable_activity();   // Reset and start accumulating at the current time
+    void disable_activity();
+    ActivityProfile::NetActivity get_activity(Signal* sig) const;  // Closed at current time
+    void dump_saif(const std::string& filename) const;
+
+    // Toggle/state coverage (always on unless disabled)
+    void enable_coverage();
+    void disable_coverage();
+    void reset_coverage();
+    CoverageDB get_coverage() const;  // Snapshot with sequential outputs marked as state nets
+
+    // Setup/hold timing checks (need LOGIC_SIM_TIMING_CHECKS at compile time)
+    void enable_timing_checks(bool force_x = false);  // Reset logs; optionally X the Q on violations
+    void disable_timing_checks();
+    void check_timing(DFF* flop, uint64_t setup, uint64_t hold);  // Set one flop's windows
+    void check_timing(uint64_t setup, uint64_t hold);             // Same windows for every DFF
+    bool timing_checks_enabled() const { return timing_enabled; }
+    TimingChecker& get_timing() { return timing; }
+    const TimingChecker& get_timing() const { return timing; }
+
+    // Delay annotation
+    DelayTable& get_delay_table() { return delay_table; }
+    const DelayTable& get_delay_table() const { return delay_table; }
+    Signal* get_trigger() const { return trigger; }  // For Component::evaluate
 
     // Waveform output
     void enable_trace();
-    void disable_trace();
+    void disable_trace();  // Also closes a trace store (it stays queryable)
+    // Record every change into a memory-mapped trace store at `path`
+    // instead of the in-memory log (no console output; see trace_store.h)
+    void enable_trace(const std::string& path,
+                      uint32_t shard_signals = TraceStore::DEFAULT_SHARD_SIGNALS);
+    TraceStore* get_trace_store() { return trace_store.get(); }  // nullptr unless recording to one
+    // Hand every change to a background TraceWriter (no log, no console
+    // output); disable_trace() detaches it, closing it is up to the caller
+    void enable_trace(TraceWriter* writer);
     void dump_waveform(const std::string& filename);
     void print_trace();
     
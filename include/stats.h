@@ -0,0 +1,101 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// Hot-path instrumentation
+//
+// Counters are compiled in unless LOGIC_SIM_NO_STATS is defined, and are only
+// recorded after Simulator::enable_stats(). With stats disabled the hot path
+// pays one predictable branch per step; compiled out it pays nothing.
+#ifdef LOGIC_SIM_NO_STATS
+constexpr bool STATS_COMPILED_IN = false;
+#else
+constexpr bool STATS_COMPILED_IN = true;
+#endif
+
+// Histogram with power-of-two buckets: bucket k counts samples in [2^(k-1), 2^k)
+// (bucket 0 counts zeros)
+struct Log2Histogram {
+    std::array<uint64_t, 65> buckets{};
+    uint64_t samples = 0;
+    uint64_t total = 0;
+    uint64_t max = 0;
+
+    void record(uint64_t value);
+    double mean() const;
+    std::string to_json() const;
+};
+
+// Raw counters owned by the simulator while stats are enabled
+struct StatsCollector {
+    uint64_t steps = 0;
+    uint64_t delta_cycles = 0;  // Steps after the first at their time
+    uint64_t events = 0;
+    uint64_t evaluations = 0;
+    double step_seconds = 0;
+    double trace_seconds = 0;
+    Log2Histogram events_per_step;       // Activity set: signal updates per step
+    Log2Histogram evaluations_per_step;  // Activity set: evaluations per step
+    std::vector<uint64_t> net_events;             // Indexed by signal index
+    std::vector<uint64_t> component_evaluations;  // Indexed by component index
+
+    void reset(size_t num_signals, size_t num_components);
+};
+
+struct HotEntry {
+    std::string name;
+    uint64_t count;
+};
+
+// Per-run performance report (snapshot built by Simulator::get_stats)
+struct SimStats {
+    uint64_t steps = 0;
+    uint64_t delta_cycles = 0;      // Steps that were a later delta cycle at their time
+    uint64_t events_processed = 0;
+    uint64_t events_scheduled = 0;  // Recorded by the EventQueue
+    uint64_t heap_events = 0;       // Scheduled events that went through the heap (not a FIFO)
+    uint64_t events_coalesced = 0;  // Writes merged into an event already queued for that time
+    uint64_t evaluations = 0;
+    size_t peak_queue_depth = 0;    // Recorded by the EventQueue
+    double step_seconds = 0;        // Wall time inside step() (includes tracing)
+    double trace_seconds = 0;       // Wall time spent in trace logging
+    Log2Histogram events_per_step;
+    Log2Histogram evaluations_per_step;
+    std::map<std::string, uint64_t> evaluations_by_type;
+    std::vector<HotEntry> hottest_nets;
+    std::vector<HotEntry> hottest_components;
+
+    std::string to_json() const;
+};
+
+// Component type for reporting: the component id without its numeric suffix
+// ("AND12" -> "AND")
+std::string component_type_name(const std::string& component_id);
+
+// Top `n` non-zero entries of `counts`, named through `name_of(index)`
+template<typename NameFn>
+std::vector<HotEntry> top_entries(const std::vector<uint64_t>& counts, size_t n, NameFn name_of) {
+    std::vector<size_t> order;
+    for (size_t i = 0; i < counts.size(); i++) {
+        if (counts[i] > 0) {
+            order.push_back(i);
+        }
+    }
+    n = std::min(n, order.size());
+    std::partial_sort(order.begin(), order.begin() + n, order.end(),
+                      [&](size_t a, size_t b) { return counts[a] > counts[b]; });
+
+    std::vector<HotEntry> entries;
+    for (size_t i = 0; i < n; i++) {
+        entries.push_back({name_of(order[i]), counts[order[i]]});
+    }
+    return entries;
+}
+
+#endif // STATS_H
@@ -0,0 +1,77 @@
+#ifndef STIMULUS_H
+#define STIMULUS_H
+
+#include "logic.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Simulator;  // Forward declaration
+class Signal;
+
+// Reproducible random stimulus
+//
+// Values come from Philox4x32-10, a counter-based generator: each block of
+// four 32-bit words is a pure function of a 64-bit key and a 128-bit
+// counter, with no state carried from one block to the next. The key is
+// the seed; the counter holds (vector / 4, run, input), so every input of
+// every run has its own stream. Any run, input or vector can be
+// regenerated on its own, in any order and on any thread, and gives the
+// same values.
+namespace philox {
+
+// Four words for `counter` under the key (seed): the reference round function
+void block(uint64_t seed, const uint32_t counter[4], uint32_t out[4]);
+
+// Blocks for counters (first + j, c2, c3), j < n, as 4 * n words. Eight
+// counters at a time through AVX2 when the CPU has it (`simd` false forces
+// the scalar loop).
+void blocks(uint64_t seed, uint64_t first, uint32_t c2, uint32_t c3, uint32_t* out, size_t n,
+            bool simd = true);
+
+}  // namespace philox
+
+class StimulusGenerator {
+public:
+    explicit StimulusGenerator(uint64_t seed, uint32_t run = 0);
+
+    // Inputs are numbered (and get their streams) in the order added.
+    // Each vector drives X with probability p_x, else 1 with p_one.
+    uint32_t add_input(Signal* net, double p_one = 0.5, double p_x = 0.0);
+    void add_inputs(const std::vector<Signal*>& nets, double p_one = 0.5);
+    size_t input_count() const { return inputs.size(); }
+
+    void set_run(uint32_t r) { run = r; }
+    uint32_t get_run() const { return run; }
+    uint64_t get_seed() const { return seed; }
+
+    // Input `input`'s value in vector `vector`
+    uint8_t value(uint32_t input, uint64_t vector) const;
+    // Vectors [first, first + count) as values[v * input_count() + i]
+    void generate(uint64_t first, size_t count, std::vector<uint8_t>& values) const;
+    // Schedule vectors [first, first + count) at start_time, start_time +
+    // period, ... with one Simulator::schedule_batch call. With
+    // `changes_only` a value equal to the input's value in the vector
+    // before is left out (so a run scheduled in chunks gets the same
+    // events as in one call); vector 0 is always scheduled in full.
+    // Returns the number of events.
+    size_t schedule(Simulator& sim, uint64_t first, size_t count, uint64_t start_time, uint64_t period,
+                    bool changes_only = true) const;
+
+private:
+    struct Input {
+        Signal* net;
+        uint64_t x_below;    // Word < x_below: X
+        uint64_t one_below;  // Else word < one_below: 1
+    };
+
+    uint64_t seed;
+    uint32_t run;
+    std::vector<Input> inputs;
+
+    uint8_t to_value(const Input& in, uint32_t word) const {
+        return word < in.x_below ? LOGIC_X : word < in.one_below ? LOGIC_1 : LOGIC_0;
+    }
+};
+
+#endif // STIMULUS_H
@@ -0,0 +1,132 @@
+#ifndef TESTBENCH_H
+#define TESTBENCH_H
+
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <unordered_map>
+#include <unordered_set>
+#include "simulator.h"
+
+// Coroutine testbench (requires C++20; the simulator core stays C++17)
+//
+// A Process is a coroutine that waits on simulation time or on nets:
+//
+//   Process clock_gen(Testbench& tb, Signal* clk) {
+//       while (true) {
+//           tb.drive(clk, 1);
+//           co_await delay(500);
+//           tb.drive(clk, 0);
+//           co_await delay(500);
+//       }
+//   }
+//   ...
+//   tb.spawn(clock_gen(tb, clk));
+//   sim.run_until(10000);
+//
+// Waits are ordinary simulator events (see Simulator::schedule_wake), so a
+// suspended process costs one coroutine frame and nothing while it sleeps.
+// A process resumes after the component evaluations of its time step, and a
+// wait on a net resumes one step after the change, at the same timestamp.
+// An exception escaping a process is rethrown from the simulator's run call.
+// Pass state to a process as parameters: a capturing lambda coroutine
+// dangles once the lambda object is gone.
+
+class Testbench;
+
+class Process {
+public:
+    struct promise_type {
+        Testbench* tb = nullptr;
+        uint32_t wake_slot = NO_WAKE;  // Pending delay, if any
+
+        static constexpr uint32_t NO_WAKE = UINT32_MAX;
+
+        Process get_return_object() {
+            return Process(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }  // Starts in spawn()
+        std::suspend_never final_suspend() noexcept { return {}; }     // Frame frees itself
+        void return_void() {}
+        void unhandled_exception();
+        ~promise_type();
+    };
+
+    explicit Process(std::coroutine_handle<promise_type> coroutine) : handle(coroutine) {}
+    Process(Process&& other) noexcept : handle(other.handle) { other.handle = nullptr; }
+    Process(const Process&) = delete;
+    Process& operator=(const Process&) = delete;
+    ~Process() {
+        if (handle) {
+            handle.destroy();  // Never spawned
+        }
+    }
+
+private:
+    friend class Testbench;
+    std::coroutine_handle<promise_type> handle;
+};
+
+using ProcessHandle = std::coroutine_handle<Process::promise_type>;
+
+class Testbench {
+public:
+    explicit Testbench(Simulator& simulator);
+    ~Testbench();  // Destroys processes that are still waiting
+    Testbench(const Testbench&) = delete;
+    Testbench& operator=(const Testbench&) = delete;
+
+    // Start a process; it runs until its first co_await before this returns
+    void spawn(Process process);
+
+    // Schedule `sig` to take value `v` after `after` ps
+    void drive(Signal* sig, uint8_t v, uint64_t after = 0);
+
+    size_t active_processes() const;
+    uint64_t now() const;
+    Simulator& get_simulator();
+
+    enum class WaitKind : uint8_t { RISING, FALLING, CHANGE };
+
+    // Used by the awaiters below
+    void wait_delay(ProcessHandle handle, uint64_t dt);
+    void wait_signal(ProcessHandle handle, Signal* sig, WaitKind kind);
+
+private:
+    friend struct Process::promise_type;
+    class WaitList;
+
+    Simulator& sim;
+    std::unordered_set<void*> live;                // Frames of unfinished processes
+    std::unordered_map<Signal*, WaitList*> waits;  // Owned by the simulator
+    std::exception_ptr failure;
+
+    static void resume_process(void* frame);
+};
+
+// Awaiters (only usable inside a Process)
+struct DelayAwaiter {
+    uint64_t dt;
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(ProcessHandle handle) const {
+        handle.promise().tb->wait_delay(handle, dt);
+    }
+    void await_resume() const noexcept {}
+};
+
+struct SignalAwaiter {
+    Signal* sig;
+    Testbench::WaitKind kind;
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(ProcessHandle handle) const {
+        handle.promise().tb->wait_signal(handle, sig, kind);
+    }
+    uint8_t await_resume() const { return sig->get_value(); }  // Value after the change
+};
+
+inline DelayAwaiter delay(uint64_t dt) { return {dt}; }
+inline SignalAwaiter rising_edge(Signal* sig) { return {sig, Testbench::WaitKind::RISING}; }
+inline SignalAwaiter falling_edge(Signal* sig) { return {sig, Testbench::WaitKind::FALLING}; }
+inline SignalAwaiter value_change(Signal* sig) { return {sig, Testbench::WaitKind::CHANGE}; }
+
+#endif // TESTBENCH_H
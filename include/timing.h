@@ -0,0 +1,108 @@
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class DFF;  // Forward declaration
+
+// Setup/hold timing checks
+//
+// Checks are only compiled in when LOGIC_SIM_TIMING_CHECKS is defined, and
+// only run for flops registered with Simulator::check_timing() after
+// Simulator::enable_timing_checks(). Compiled out, DFF::evaluate carries no
+// trace of them.
+#ifdef LOGIC_SIM_TIMING_CHECKS
+constexpr bool TIMING_CHECKS_COMPILED_IN = true;
+#else
+constexpr bool TIMING_CHECKS_COMPILED_IN = false;
+#endif
+
+struct TimingViolation {
+    enum Kind : uint8_t { SETUP, HOLD };
+
+    Kind kind;
+    uint32_t flop;        // Slot in the checker
+    uint64_t time;        // When the violation was detected
+    uint64_t data_time;   // Last D change
+    uint64_t clock_time;  // Active clock edge
+};
+
+// Per-flop windows and last-change timestamps in flat arrays indexed by a
+// slot number the checker hands out to each registered DFF
+class TimingChecker {
+public:
+    static constexpr uint32_t NO_SLOT = UINT32_MAX;
+    static constexpr uint64_t NEVER = UINT64_MAX;
+
+    TimingChecker();
+
+    // Register a flop (again: update its windows); returns its slot
+    uint32_t add_flop(DFF* flop, uint64_t setup, uint64_t hold);
+    size_t flop_count() const { return setup_window.size(); }
+
+    // Drive Q to X at the flop's clock-to-Q delay after a violation
+    void set_force_x(bool force) { force_x = force; }
+    bool get_force_x() const { return force_x; }
+
+    // Keep at most `max_entries` violations and at most `per_flop` per flop;
+    // the rest are only counted
+    void set_log_limits(size_t max_entries, size_t per_flop);
+
+    // Hot path (called from DFF::evaluate); returns true on a violation
+    bool data_changed(uint32_t slot, uint8_t value, uint64_t time) {
+        if (value == last_data_value[slot]) {
+            return false;
+        }
+        last_data_value[slot] = value;
+        last_data_change[slot] = time;
+        uint64_t edge = last_clock_edge[slot];
+        if (edge != NEVER && time - edge < hold_window[slot]) {
+            record(TimingViolation::HOLD, slot, time, time, edge);
+            return true;
+        }
+        return false;
+    }
+    bool clock_edge(uint32_t slot, uint64_t time) {
+        last_clock_edge[slot] = time;
+        uint64_t change = last_data_change[slot];
+        if (change != NEVER && time - change < setup_window[slot]) {
+            record(TimingViolation::SETUP, slot, time, change, time);
+            return true;
+        }
+        return false;
+    }
+
+    // Results
+    uint64_t total_violations() const { return total; }
+    uint64_t suppressed_violations() const { return suppressed; }
+    const std::vector<TimingViolation>& get_log() const { return log; }
+    const std::string& flop_name(uint32_t slot) const { return names[slot]; }
+    void report(std::ostream& os) const;
+
+    // Forget timestamps and violations (windows and registrations stay)
+    void reset();
+
+private:
+    std::vector<uint64_t> setup_window;
+    std::vector<uint64_t> hold_window;
+    std::vector<uint64_t> last_data_change;
+    std::vector<uint64_t> last_clock_edge;
+    std::vector<uint8_t> last_data_value;
+    std::vector<uint32_t> reported;   // Logged violations per flop
+    std::vector<std::string> names;
+
+    bool force_x;
+    size_t max_entries;
+    size_t per_flop;
+    std::vector<TimingViolation> log;
+    uint64_t total;
+    uint64_t suppressed;
+
+    void record(TimingViolation::Kind kind, uint32_t slot, uint64_t time,
+                uint64_t data_time, uint64_t clock_time);
+};
+
+#endif // TIMING_H
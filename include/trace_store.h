@@ -0,0 +1,117 @@
+#ifndef TRACE_STORE_H
+#define TRACE_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Out-of-core trace of every value change (see Simulator::enable_trace)
+//
+// Signals are split into shards of `shard_signals` consecutive slots. Each
+// shard appends 16-byte change records to its own memory-mapped file
+// (<path>.<shard>.rec), which grows by doubling; the OS page cache decides
+// what stays resident. Every BLOCK_RECORDS records the shard's index file
+// (<path>.<shard>.idx) gets an entry: the time of the block's first record
+// and a snapshot of the shard's values just before it. <path> itself is a
+// small text file with the signal names.
+//
+// A query binary-searches the index for its start time, then reads at most
+// the records from there on (one block for value_at), so only those pages
+// are touched. Queries work on a store being recorded and on one reopened
+// with open() after the run.
+class TraceStore {
+public:
+    static constexpr uint32_t DEFAULT_SHARD_SIGNALS = 1024;
+    static constexpr uint32_t BLOCK_RECORDS = 4096;
+
+    struct Change {
+        uint64_t time;
+        uint32_t signal;  // Slot
+        uint8_t value;
+    };
+
+    // Record a new store: one slot per name, holding `initial` at `start_time`
+    TraceStore(const std::string& path, const std::vector<std::string>& names,
+               const std::vector<uint8_t>& initial, uint64_t start_time,
+               uint32_t shard_signals = DEFAULT_SHARD_SIGNALS);
+    ~TraceStore();
+    TraceStore(const TraceStore&) = delete;
+    TraceStore& operator=(const TraceStore&) = delete;
+
+    // Map a closed store read-only
+    static std::unique_ptr<TraceStore> open(const std::string& path);
+
+    // Append a change (times must not decrease)
+    void record(uint64_t time, uint32_t signal, uint8_t value) {
+        if (signal < names.size()) {
+            append(shards[signal / shard_signals], time, signal % shard_signals, value);
+        }
+    }
+    // Trim the files to their contents and write the end time; recording stops
+    void close(uint64_t end_time);
+    bool is_open() const { return writable; }
+
+    size_t signal_count() const { return names.size(); }
+    const std::string& signal_name(uint32_t signal) const { return names[signal]; }
+    int find_signal(const std::string& name) const;  // -1 if not recorded
+    size_t shard_count() const { return shards.size(); }
+    uint64_t start_time() const { return start; }
+    uint64_t end_time() const { return end; }  // Last record's time until closed
+    uint64_t record_count() const;
+    size_t mapped_bytes() const;  // Address space of the mappings (not RSS)
+
+    // Value of a signal at `time` (after all changes at that time)
+    uint8_t value_at(uint32_t signal, uint64_t time) const;
+    // Changes with from <= time <= to: of one signal, or of all of them in
+    // time order
+    std::vector<Change> changes(uint32_t signal, uint64_t from, uint64_t to) const;
+    std::vector<Change> changes(uint64_t from, uint64_t to) const;
+
+private:
+    // A file mapped in full; a writable one grows by doubling. Owns the
+    // descriptor and the mapping, so they go with the shard however it ends.
+    struct Mapping {
+        int fd = -1;
+        uint8_t* data = nullptr;
+        size_t length = 0;
+
+        Mapping() = default;
+        Mapping(Mapping&& other) noexcept;
+        Mapping(const Mapping&) = delete;
+        Mapping& operator=(const Mapping&) = delete;
+        ~Mapping() { close(); }
+
+        void open(const std::string& filename, bool create);
+        void reserve(size_t bytes);
+        void truncate(size_t bytes);
+        void close();
+    };
+
+    struct Shard {
+        uint32_t first;    // First slot
+        uint32_t signals;  // Slots in this shard
+        Mapping records;   // Header, then Record[]
+        Mapping index;     // Header, initial values, then index entries
+        std::vector<uint8_t> values;  // Current values (while recording)
+    };
+
+    std::string path;
+    std::vector<std::string> names;
+    uint32_t shard_signals;
+    uint64_t start;
+    uint64_t end;
+    bool writable;
+    std::vector<Shard> shards;
+
+    explicit TraceStore(const std::string& path);  // For open()
+    void create_shard(size_t k, const std::vector<uint8_t>& initial);
+    void append(Shard& shard, uint64_t time, uint32_t offset, uint8_t value);
+    void write_meta() const;
+    size_t entry_bytes(const Shard& shard) const;
+    size_t blocks_before(const Shard& shard, uint64_t time, bool inclusive) const;
+    void scan(const Shard& shard, uint64_t from, uint64_t to, int64_t offset, std::vector<Change>& out) const;
+};
+
+#endif // TRACE_STORE_H
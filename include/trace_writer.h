@@ -0,0 +1,159 @@
+#ifndef TRACE_WRITER_H
+#define TRACE_WRITER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Simulator;  // Forward declaration
+
+// Pipelined waveform output (see Simulator::enable_trace(TraceWriter*))
+//
+// The simulation thread only appends (time, signal id, value) to a
+// single-producer/single-consumer ring: a slot store and one release store
+// of the head index. A background encoder thread drains the ring into VCD
+// text or a compact binary form (varint time deltas) in one of two
+// buffers; when a buffer fills it is handed to a second thread that
+// compresses (zlib, gzip format) and writes it while encoding continues in
+// the other buffer.
+//
+// When the ring is full the producer either waits for the encoder
+// (Backpressure::Block, counted in stalls()) or drops the change
+// (Backpressure::Drop, counted in dropped()); a dropped change is missing
+// from the file.
+class TraceWriter {
+public:
+    enum class Format { VCD, Binary };
+    enum class Backpressure { Block, Drop };
+
+    struct Options {
+        Format format = Format::VCD;
+        Backpressure backpressure = Backpressure::Block;
+        int compression = 1;            // zlib level 1-9; 0 writes plain files
+        size_t ring_events = 1 << 16;   // Rounded up to a power of two
+        size_t buffer_bytes = 1 << 20;  // Per encode buffer
+    };
+
+    struct Change {
+        uint64_t time;
+        uint32_t signal;  // Index in `names`
+        uint8_t value;
+    };
+
+    // Contents of a binary trace (plain or compressed)
+    struct Waveform {
+        std::vector<std::string> names;
+        std::vector<uint8_t> initial;
+        uint64_t start_time = 0;
+        std::vector<Change> changes;
+    };
+
+    // Open `path` for the simulator's current nets (header and initial
+    // values are written from their state now) and start the threads
+    TraceWriter(Simulator& sim, const std::string& path);
+    TraceWriter(Simulator& sim, const std::string& path, const Options& options);
+    ~TraceWriter();  // close(), keeping a write failure in error() instead of throwing
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    // Simulation thread: queue a change of the net with id `signal_id`
+    void push(uint64_t time, int signal_id, uint8_t value) {
+        uint64_t h = head.load(std::memory_order_relaxed);
+        if (h - cached_tail > mask) {
+            cached_tail = tail.load(std::memory_order_acquire);
+            if (h - cached_tail > mask) {
+                if (options.backpressure == Backpressure::Drop) {
+                    dropped_count.store(dropped_count.load(std::memory_order_relaxed) + 1,
+                                        std::memory_order_relaxed);
+                    return;
+                }
+                wait_for_space(h);
+            }
+        }
+        ring[h & mask] = {time, signal_id, value};
+        head.store(h + 1, std::memory_order_release);
+    }
+
+    // Drain the ring, flush, close the file and join the threads; `end_time`
+    // closes the last VCD time step. Later pushes are ignored. Throws
+    // std::runtime_error if a write or the close failed (the file is then
+    // incomplete).
+    void close(uint64_t end_time = 0);
+
+    uint64_t pushed() const { return head.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return dropped_count.load(std::memory_order_relaxed); }
+    uint64_t stalls() const { return stall_count; }   // Blocked pushes (simulation thread)
+    uint64_t encoded_bytes() const { return encoded; }  // Before compression (after close)
+    uint64_t file_bytes() const { return written; }     // On disk (after close)
+    uint64_t write_errors() const { return write_error_count; }  // Failed writes and close (after close)
+    const std::string& error() const { return io_error; }        // First failure, empty if none
+
+    static Waveform read_binary(const std::string& path);
+
+private:
+    struct Entry {
+        uint64_t time;
+        int32_t signal_id;
+        uint8_t value;
+    };
+
+    Options options;
+    std::vector<Entry> ring;
+    uint64_t mask;
+
+    // Producer and consumer indices on their own cache lines
+    alignas(64) std::atomic<uint64_t> head{0};
+    uint64_t cached_tail = 0;   // Producer's last view of `tail`
+    std::atomic<uint64_t> dropped_count{0};
+    uint64_t stall_count = 0;
+    alignas(64) std::atomic<uint64_t> tail{0};
+    alignas(64) std::atomic<bool> stopping{false};
+
+    // Encoder state (encoder thread only)
+    std::vector<uint32_t> slots;   // By signal id - id_base: index in the header
+    int id_base;
+    uint64_t last_time;
+    bool time_open;
+    std::string active;            // Buffer being encoded into
+
+    // Hand-off to the I/O thread
+    std::mutex io_mutex;
+    std::condition_variable io_cv;
+    std::string pending;           // Full buffer being written
+    bool pending_ready = false;
+    bool io_stop = false;
+
+    void* file;  // gzFile
+    uint64_t encoded = 0;
+    uint64_t written = 0;
+    uint64_t write_error_count = 0;  // I/O thread, then close()
+    std::string io_error;
+    std::string path;
+    std::thread encoder;
+    std::thread io;
+    bool closed = false;
+
+    void wait_for_space(uint64_t h);
+    void encode(const Entry& e);
+    void hand_off();               // Swap `active` into `pending`
+    void encode_loop();
+    void io_loop();
+    void write_header(Simulator& sim);
+    void record_error(const std::string& message);
+};
+
+// Inline so the simulator needs no link dependency for push()
+inline void TraceWriter::wait_for_space(uint64_t h) {
+    stall_count++;
+    while (h - cached_tail > mask && !stopping.load(std::memory_order_relaxed)) {
+        std::this_thread::yield();
+        cached_tail = tail.load(std::memory_order_acquire);
+    }
+}
+
+#endif // TRACE_WRITER_H
@@ -0,0 +1,180 @@
+#ifndef WAVE_DIFF_H
+#define WAVE_DIFF_H
+
+#include "component.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class Simulator;  // Forward declaration
+class Signal;
+
+// Waveform comparison against a golden run
+//
+// Signals are aligned by hierarchical name (scopes below the top scope
+// joined with '.', as Simulator::dump_waveform writes them). A compared
+// signal mismatches when its golden and actual values differ for longer
+// than its tolerance: a transition up to `tolerance` ps early or late, or
+// a glitch no longer than that, is accepted. Values are settled per time
+// step, so delta-cycle order within a time does not matter.
+//
+// compare_waveforms() streams two VCD files (plain or gzip) side by side;
+// LiveComparator checks a running Simulator against a golden file and
+// stops the run once it has found max_mismatches mismatches.
+
+struct WaveDiffOptions {
+    uint64_t tolerance = 0;                                          // ps, for every signal
+    std::vector<std::pair<std::string, uint64_t>> signal_tolerances; // (pattern, ps): first match wins
+    std::vector<std::string> masks;   // Patterns ('*' matches any run of characters) not compared
+    bool golden_x_matches_any = false;  // X in the golden file is a don't-care
+    size_t max_mismatches = 10;       // Stop after this many (0: no limit)
+};
+
+struct WaveMismatch {
+    std::string signal;
+    uint64_t time;      // Start of the difference
+    uint8_t golden;
+    uint8_t actual;
+};
+
+struct WaveDiffReport {
+    std::vector<WaveMismatch> mismatches;   // In the order found
+    size_t compared_signals = 0;
+    size_t masked_signals = 0;
+    std::vector<std::string> only_in_golden;
+    std::vector<std::string> only_in_actual;
+    uint64_t golden_changes = 0;
+    uint64_t actual_changes = 0;
+    uint64_t end_time = 0;       // Last time compared
+    bool stopped_early = false;  // Hit max_mismatches
+
+    bool passed() const { return mismatches.empty(); }
+};
+
+// Streaming VCD reader: the header up front, then value changes in file
+// order (times converted to ps). Scalar and 1-bit vector variables only;
+// wider vectors and reals are skipped.
+class VcdReader {
+public:
+    struct Change {
+        uint64_t time;
+        uint32_t signal;
+        uint8_t value;
+    };
+
+    explicit VcdReader(const std::string& path);  // Reads up to $enddefinitions
+    ~VcdReader();
+    VcdReader(const VcdReader&) = delete;
+    VcdReader& operator=(const VcdReader&) = delete;
+
+    const std::vector<std::string>& get_names() const { return names; }
+    bool next(Change& change);  // false at the end of the file
+    uint64_t get_time() const { return time; }
+
+private:
+    void* file;  // gzFile
+    std::string path;
+    std::vector<char> buffer;
+    size_t pos = 0;
+    size_t end = 0;
+    uint64_t time = 0;
+    uint64_t timescale = 1;   // ps per time unit
+    std::vector<std::string> names;
+    std::unordered_map<std::string, std::vector<uint32_t>> ids;  // VCD id -> signals
+    std::vector<uint32_t> queued;  // Signals of an aliased id still to return
+    uint8_t queued_value = 0;
+
+    bool token(std::string& out);
+    void skip_to_end(const std::string& keyword);  // Through the next $end
+    void read_header();
+};
+
+// The comparison itself, fed one time step at a time
+class WaveComparator {
+public:
+    WaveComparator(const std::vector<std::string>& names, const WaveDiffOptions& options);
+
+    void begin(uint64_t time);  // Settle the previous step; times must not decrease
+    void golden(uint32_t signal, uint8_t value) { set(signal, value, golden_values); }
+    void actual(uint32_t signal, uint8_t value) { set(signal, value, actual_values); }
+    void finish();              // Settle, then report signals still different
+    bool done() const;          // max_mismatches reached
+
+    WaveDiffReport& get_report() { return report; }
+    const WaveDiffReport& get_report() const { return report; }
+
+private:
+    static constexpr uint64_t NONE = UINT64_MAX;
+    static constexpr uint64_t REPORTED = UINT64_MAX - 1;  // Still different, already reported
+
+    std::vector<std::string> names;
+    WaveDiffOptions options;
+    std::vector<uint64_t> tolerance;
+    std::vector<bool> masked;
+    std::vector<uint8_t> golden_values;
+    std::vector<uint8_t> actual_values;
+    std::vector<uint64_t> differs_since;   // Start of the current difference
+    std::vector<uint8_t> first_golden;     // Values when it started
+    std::vector<uint8_t> first_actual;
+    std::vector<uint32_t> touched;
+    std::vector<bool> is_touched;
+    // (deadline, signal): differing after `deadline` is a mismatch
+    std::priority_queue<std::pair<uint64_t, uint32_t>, std::vector<std::pair<uint64_t, uint32_t>>,
+                        std::greater<std::pair<uint64_t, uint32_t>>> deadlines;
+    uint64_t now;
+    WaveDiffReport report;
+
+    void set(uint32_t signal, uint8_t value, std::vector<uint8_t>& values) {
+        values[signal] = value;
+        if (!is_touched[signal]) {
+            is_touched[signal] = true;
+            touched.push_back(signal);
+        }
+    }
+    bool same(uint32_t signal) const;
+    void settle();
+    void expire(uint64_t before);
+    void mismatch(uint32_t signal);
+};
+
+// Compare two VCD files; names missing from either side are listed, not compared
+WaveDiffReport compare_waveforms(const std::string& golden_path, const std::string& actual_path,
+                                 const WaveDiffOptions& options = WaveDiffOptions());
+
+// Compares a simulator's nets against a golden VCD while it runs. Every net
+// named in the golden file is observed; the golden file is read as far as
+// simulated time has got. Once max_mismatches are found the run is stopped
+// (Simulator::stop). A difference outlasting its tolerance is noticed at the
+// next change of any compared net, or in finish().
+class LiveComparator : public Component {
+public:
+    LiveComparator(Simulator& sim, const std::string& golden_path,
+                   const WaveDiffOptions& options = WaveDiffOptions());
+    ~LiveComparator() override;
+
+    void evaluate(Simulator* sim, uint64_t current_time) override;
+    // Compare the rest of the golden file up to the simulator's time
+    // and return the report (call after the run)
+    const WaveDiffReport& finish();
+
+private:
+    Simulator& sim;
+    VcdReader golden_file;
+    std::unique_ptr<WaveComparator> comparator;
+    std::unordered_map<Signal*, uint32_t> slots;
+    std::vector<Signal*> nets;
+    std::vector<uint8_t> last;            // By slot: last value seen
+    std::vector<uint32_t> golden_map;     // Golden file signal -> slot
+    VcdReader::Change next_golden;
+    bool golden_pending;
+    bool finished;
+
+    void golden_until(uint64_t time, bool inclusive);
+};
+
+#endif // WAVE_DIFF_H
@@ -0,0 +1,70 @@
+#include "activity.h"
+#include <fstream>
+#include <stdexcept>
+
+void ActivityProfile::reset(const std::vector<uint8_t>& initial_values, uint64_t start) {
+    start_time = start;
+    nets.assign(initial_values.size(), NetActivity());
+    for (size_t i = 0; i < nets.size(); i++) {
+        nets[i].value = initial_values[i];
+        nets[i].last_change = start;
+    }
+}
+
+void ActivityProfile::add_net(uint8_t value, uint64_t time) {
+    NetActivity net;
+    net.value = value;
+    net.last_change = time;
+    nets.push_back(net);
+}
+
+ActivityProfile::NetActivity ActivityProfile::totals(uint32_t index, uint64_t end_time) const {
+    if (index >= nets.size()) {
+        throw std::out_of_range("No activity record for net index " + std::to_string(index));
+    }
+    NetActivity net = nets[index];
+    if (end_time > net.last_change) {
+        net.time_in[net.value] += end_time - net.last_change;
+        net.last_change = end_time;
+    }
+    return net;
+}
+
+size_t ActivityProfile::size() const {
+    return nets.size();
+}
+
+uint64_t ActivityProfile::get_start_time() const {
+    return start_time;
+}
+
+void ActivityProfile::write_saif(const std::string& filename, const std::vector<std::string>& names,
+                                 uint64_t end_time) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+
+    file << "(SAIFILE\n";
+    file << "(SAIFVERSION \"2.0\")\n";
+    file << "(DIRECTION \"backward\")\n";
+    file << "(DESIGN \"top\")\n";
+    file << "(VENDOR \"Digital Logic Simulator\")\n";
+    file << "(DIVIDER . )\n";
+    file << "(TIMESCALE 1 ps)\n";
+    file << "(DURATION " << (end_time - start_time) << ")\n";
+    file << "(INSTANCE top\n";
+    // TC counts 0<->1 toggles; transitions through X or Z are reported as IG
+    file << "  (NET\n";
+    for (size_t i = 0; i < nets.size() && i < names.size(); i++) {
+        NetActivity net = totals(i, end_time);
+        file << "    (" << names[i] << "\n"
+             << "      (T0 " << net.time_in[0] << ") (T1 " << net.time_in[1]
+             << ") (TX " << net.time_in[2] << ") (TZ " << net.time_in[3] << ")\n"
+             << "      (TC " << net.toggles() << ") (IG " << net.x_transitions << ")\n"
+             << "    )\n";
+    }
+    file << "  )\n";
+    file << ")\n";
+    file << ")\n";
+}
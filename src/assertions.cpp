@@ -0,0 +1,341 @@
+#include "assertions.h"
+#include "simulator.h"
+#include "component.h"
+#include "signal.h"
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+
+// Common part of the assertion observers: owner, id, sampling clock and one
+// failure per timestamp (an immediate check re-runs once per changed input).
+// A clocked assertion observes only its clock; the nets it samples at the
+// edge are reported by get_fanin, so fan-out cones and netlist passes see them.
+class AssertionObserver : public Component {
+public:
+    AssertionObserver(AssertionSet& assertions, uint32_t assertion_id, Signal* sample_clock)
+        : owner(assertions), slot(assertion_id), clock(sample_clock),
+          last_clock(sample_clock ? sample_clock->get_value() : 0), last_failure(UINT64_MAX) {
+        id = "ASSERT_" + assertions.name(assertion_id);
+        propagation_delay = 0;
+        if (clock) {
+            watch(clock);
+        }
+    }
+
+    void save_state(std::vector<uint8_t>& out) const override {
+        put_state(out, last_clock);
+        put_state(out, last_failure);
+    }
+    void restore_state(const uint8_t*& in) override {
+        get_state(in, last_clock);
+        get_state(in, last_failure);
+    }
+
+protected:
+    AssertionSet& owner;
+    uint32_t slot;
+    Signal* clock;
+    uint8_t last_clock;
+    uint64_t last_failure;
+
+    void watch(Signal* sig) {
+        inputs.push_back(sig);
+        sig->attach_observer(this);
+    }
+
+    // True when this evaluation is a rising edge of the sampling clock
+    bool clock_rose(Simulator* sim) {
+        if (sim->get_trigger() != clock) {
+            return false;
+        }
+        uint8_t value = clock->get_value();
+        bool rose = last_clock == 0 && value == 1;
+        last_clock = value;
+        return rose;
+    }
+
+    void fail(uint64_t time) {
+        if (time != last_failure) {
+            last_failure = time;
+            owner.record_failure(slot, time);
+        }
+    }
+};
+
+class InvariantAssertion : public AssertionObserver {
+public:
+    InvariantAssertion(AssertionSet& assertions, uint32_t assertion_id, const std::vector<Signal*>& signals,
+                       std::function<bool()> check, Signal* sample_clock)
+        : AssertionObserver(assertions, assertion_id, sample_clock), sampled(signals),
+          predicate(std::move(check)) {
+        if (!clock) {
+            for (Signal* sig : signals) {
+                watch(sig);
+            }
+        }
+    }
+
+    void get_fanin(std::vector<Signal*>& nets) const override {
+        Component::get_fanin(nets);
+        if (clock) {
+            nets.insert(nets.end(), sampled.begin(), sampled.end());
+        }
+    }
+
+    void evaluate(Simulator* sim, uint64_t current_time) override {
+        if (clock && !clock_rose(sim)) {
+            return;
+        }
+        if (!predicate()) {
+            fail(current_time);
+        }
+    }
+
+private:
+    std::vector<Signal*> sampled;
+    std::function<bool()> predicate;
+};
+
+// Counts of 0/1/X/Z bits kept up to date from the changed net alone
+class OneHotAssertion : public AssertionObserver {
+public:
+    OneHotAssertion(AssertionSet& assertions, uint32_t assertion_id, const std::vector<Signal*>& signals,
+                    bool zero_ok, Signal* sample_clock)
+        : AssertionObserver(assertions, assertion_id, sample_clock), allow_zero(zero_ok), counts{0, 0, 0, 0} {
+        for (Signal* sig : signals) {
+            position.emplace(sig, (uint32_t)values.size());
+            values.push_back(sig->get_value());
+            counts[sig->get_value()]++;
+            watch(sig);
+        }
+    }
+
+    void evaluate(Simulator* sim, uint64_t current_time) override {
+        Signal* changed = sim->get_trigger();
+        auto it = position.find(changed);
+        if (it != position.end()) {
+            uint8_t& value = values[it->second];
+            counts[value]--;
+            value = changed->get_value();
+            counts[value]++;
+            if (clock) {
+                return;
+            }
+        } else if (!clock_rose(sim)) {
+            return;
+        }
+        bool ok = counts[2] == 0 && counts[3] == 0 && (counts[1] == 1 || (allow_zero && counts[1] == 0));
+        if (!ok) {
+            fail(current_time);
+        }
+    }
+
+    void save_state(std::vector<uint8_t>& out) const override {
+        AssertionObserver::save_state(out);
+        put_state(out, counts);
+        out.insert(out.end(), values.begin(), values.end());
+    }
+    void restore_state(const uint8_t*& in) override {
+        AssertionObserver::restore_state(in);
+        get_state(in, counts);
+        std::copy(in, in + values.size(), values.begin());
+        in += values.size();
+    }
+
+private:
+    bool allow_zero;
+    uint32_t counts[4];
+    std::vector<uint8_t> values;
+    std::unordered_map<const Signal*, uint32_t> position;
+};
+
+// a |-> ##[0:n] b: bit k of `open` is an obligation started k edges ago
+class ImplicationAssertion : public AssertionObserver {
+public:
+    ImplicationAssertion(AssertionSet& assertions, uint32_t assertion_id, Signal* sample_clock,
+                         Signal* a, Signal* b, uint32_t cycles)
+        : AssertionObserver(assertions, assertion_id, sample_clock), antecedent(a), consequent(b),
+          deadline(1ULL << cycles), open(0) {}
+
+    void get_fanin(std::vector<Signal*>& nets) const override {
+        Component::get_fanin(nets);
+        nets.push_back(antecedent);
+        nets.push_back(consequent);
+    }
+
+    void evaluate(Simulator* sim, uint64_t current_time) override {
+        if (!clock_rose(sim)) {
+            return;
+        }
+        open = (open << 1) | (antecedent->get_value() == 1);
+        if (consequent->get_value() == 1) {
+            open = 0;
+        } else if (open & deadline) {
+            open &= deadline - 1;
+            fail(current_time);
+        }
+    }
+
+    void save_state(std::vector<uint8_t>& out) const override {
+        AssertionObserver::save_state(out);
+        put_state(out, open);
+    }
+    void restore_state(const uint8_t*& in) override {
+        AssertionObserver::restore_state(in);
+        get_state(in, open);
+    }
+
+private:
+    Signal* antecedent;
+    Signal* consequent;
+    uint64_t deadline;
+    uint64_t open;
+};
+
+class StableAssertion : public AssertionObserver {
+public:
+    StableAssertion(AssertionSet& assertions, uint32_t assertion_id, Signal* sample_clock,
+                    Signal* enable, const std::vector<Signal*>& signals)
+        : AssertionObserver(assertions, assertion_id, sample_clock), condition(enable), held(signals),
+          previous(signals.size()), was_enabled(false) {}
+
+    void get_fanin(std::vector<Signal*>& nets) const override {
+        Component::get_fanin(nets);
+        nets.push_back(condition);
+        nets.insert(nets.end(), held.begin(), held.end());
+    }
+
+    void evaluate(Simulator* sim, uint64_t current_time) override {
+        if (!clock_rose(sim)) {
+            return;
+        }
+        bool enabled = condition->get_value() == 1;
+        bool moved = false;
+        for (size_t i = 0; i < held.size(); i++) {
+            uint8_t value = held[i]->get_value();
+            moved |= value != previous[i];
+            previous[i] = value;
+        }
+        if (enabled && was_enabled && moved) {
+            fail(current_time);
+        }
+        was_enabled = enabled;
+    }
+
+    void save_state(std::vector<uint8_t>& out) const override {
+        AssertionObserver::save_state(out);
+        put_state(out, was_enabled);
+        out.insert(out.end(), previous.begin(), previous.end());
+    }
+    void restore_state(const uint8_t*& in) override {
+        AssertionObserver::restore_state(in);
+        get_state(in, was_enabled);
+        std::copy(in, in + previous.size(), previous.begin());
+        in += previous.size();
+    }
+
+private:
+    Signal* condition;
+    std::vector<Signal*> held;
+    std::vector<uint8_t> previous;  // Values at the last edge
+    bool was_enabled;
+};
+
+void require(Signal* sig, const char* what) {
+    if (!sig) {
+        throw std::invalid_argument(std::string("Assertion needs a ") + what);
+    }
+}
+
+}  // namespace
+
+AssertionSet::AssertionSet(Simulator& simulator)
+    : sim(simulator), total(0), max_log(1000), fail_fast(false) {
+}
+
+uint32_t AssertionSet::add_name(const std::string& name) {
+    names.push_back(name);
+    failure_counts.push_back(0);
+    return names.size() - 1;
+}
+
+uint32_t AssertionSet::always(const std::string& name, const std::vector<Signal*>& signals,
+                              std::function<bool()> predicate, Signal* clock) {
+    if (!predicate) {
+        throw std::invalid_argument("Assertion needs a predicate");
+    }
+    for (Signal* sig : signals) {
+        require(sig, "signal");
+    }
+    uint32_t id = add_name(name);
+    sim.create_component<InvariantAssertion>(*this, id, signals, std::move(predicate), clock);
+    return id;
+}
+
+uint32_t AssertionSet::one_hot(const std::string& name, const std::vector<Signal*>& signals,
+                               bool allow_zero, Signal* clock) {
+    if (signals.empty()) {
+        throw std::invalid_argument("one_hot needs at least one signal");
+    }
+    for (Signal* sig : signals) {
+        require(sig, "signal");
+    }
+    uint32_t id = add_name(name);
+    sim.create_component<OneHotAssertion>(*this, id, signals, allow_zero, clock);
+    return id;
+}
+
+uint32_t AssertionSet::implies_within(const std::string& name, Signal* clock, Signal* antecedent,
+                                      Signal* consequent, uint32_t cycles) {
+    require(clock, "clock");
+    require(antecedent, "antecedent");
+    require(consequent, "consequent");
+    if (cycles > MAX_CYCLES) {
+        throw std::invalid_argument("implies_within supports at most " + std::to_string(MAX_CYCLES) + " cycles");
+    }
+    uint32_t id = add_name(name);
+    sim.create_component<ImplicationAssertion>(*this, id, clock, antecedent, consequent, cycles);
+    return id;
+}
+
+uint32_t AssertionSet::stable_while(const std::string& name, Signal* clock, Signal* condition,
+                                    const std::vector<Signal*>& signals) {
+    require(clock, "clock");
+    require(condition, "condition");
+    for (Signal* sig : signals) {
+        require(sig, "signal");
+    }
+    uint32_t id = add_name(name);
+    sim.create_component<StableAssertion>(*this, id, clock, condition, signals);
+    return id;
+}
+
+void AssertionSet::record_failure(uint32_t id, uint64_t time) {
+    failure_counts[id]++;
+    total++;
+    if (log.size() < max_log) {
+        log.push_back({id, time});
+    }
+    if (fail_fast) {
+        sim.stop();
+    }
+}
+
+void AssertionSet::report(std::ostream& os) const {
+    os << "Assertion failures: " << total << "\n";
+    for (const AssertionFailure& failure : log) {
+        os << "  t=" << failure.time << "ps " << names[failure.assertion] << " failed\n";
+    }
+    if (total > log.size()) {
+        os << "  ... " << (total - log.size()) << " more not logged\n";
+    }
+}
+
+void AssertionSet::reset() {
+    std::fill(failure_counts.begin(), failure_counts.end(), 0);
+    log.clear();
+    total = 0;
+}
@@ -0,0 +1,223 @@
+#include "batch_eval.h"
+#include "simulator.h"
+#include "logic.h"
+#include <algorithm>
+#include <map>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BATCH_EVAL_X86 1
+#include <immintrin.h>
+#endif
+
+namespace batch {
+
+bool avx2_supported() {
+#ifdef BATCH_EVAL_X86
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+static size_t eval_scalar(const uint8_t* table, const uint8_t* const* pins, size_t fanin,
+                          const uint8_t* current, uint8_t* results, uint32_t* changed, size_t n) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint8_t r = fanin == 1 ? table[pins[0][i]] : table[pins[0][i] * 4 + pins[1][i]];
+        for (size_t p = 2; p < fanin; p++) {
+            r = table[r * 4 + pins[p][i]];
+        }
+        results[i] = r;
+        if (r != current[i]) {
+            changed[count++] = i;
+        }
+    }
+    return count;
+}
+
+#ifdef BATCH_EVAL_X86
+// Values are 0-3, so a * 4 + b is a 4-bit index into the table held in both
+// 128-bit halves of a register, and vpshufb looks up 32 lanes at once
+__attribute__((target("avx2")))
+static size_t eval_avx2(const uint8_t* table, const uint8_t* const* pins, size_t fanin,
+                        const uint8_t* current, uint8_t* results, uint32_t* changed, size_t n) {
+    const __m256i lut = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(table)));
+    size_t count = 0;
+    for (size_t i = 0; i < n; i += GateBatcher::LANES) {
+        __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pins[0] + i));
+        if (fanin == 1) {
+            r = _mm256_shuffle_epi8(lut, r);
+        }
+        for (size_t p = 1; p < fanin; p++) {
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pins[p] + i));
+            // r < 4, so the 16-bit shift cannot carry into the neighbouring byte
+            r = _mm256_shuffle_epi8(lut, _mm256_or_si256(_mm256_slli_epi16(r, 2), b));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(results + i), r);
+
+        __m256i cur = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(current + i));
+        uint32_t mask = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(r, cur));
+        if (n - i < GateBatcher::LANES) {
+            mask &= (1u << (n - i)) - 1;  // Padding lanes
+        }
+        while (mask) {  // Compress the changed lane indices
+            changed[count++] = i + __builtin_ctz(mask);
+            mask &= mask - 1;
+        }
+    }
+    return count;
+}
+#endif
+
+size_t eval_lanes(Kernel kernel, const uint8_t* table, const uint8_t* const* pins, size_t fanin,
+                  const uint8_t* current, uint8_t* results, uint32_t* changed, size_t n) {
+#ifdef BATCH_EVAL_X86
+    if (kernel == Kernel::AVX2) {
+        return eval_avx2(table, pins, fanin, current, results, changed, n);
+    }
+#endif
+    (void)kernel;
+    return eval_scalar(table, pins, fanin, current, results, changed, n);
+}
+
+}  // namespace batch
+
+GateBatcher::GateBatcher(size_t min_batch)
+    : min_batch(min_batch), kernel(batch::avx2_supported() ? batch::Kernel::AVX2 : batch::Kernel::Scalar) {
+}
+
+void GateBatcher::build(const std::vector<Component*>& components) {
+    enum Kind { AND, OR, XOR, NOT, BUF };
+    std::map<std::pair<int, size_t>, uint32_t> index;  // (kind, fan-in) -> group
+
+    groups.clear();
+    group_of.assign(components.size(), NO_GROUP);
+    revisions.assign(components.size(), 0);
+    stale = false;
+    marks.assign(components.size(), 0);
+    epoch = 1;
+    for (Component* component : components) {
+        int kind;
+        if (is_gate_type<ANDGate>(component)) {
+            kind = AND;
+        } else if (is_gate_type<ORGate>(component)) {
+            kind = OR;
+        } else if (is_gate_type<XORGate>(component)) {
+            kind = XOR;
+        } else if (is_gate_type<NOTGate>(component)) {
+            kind = NOT;
+        } else if (is_gate_type<BUFGate>(component)) {
+            kind = BUF;
+        } else {
+            continue;
+        }
+        const Gate* gate = static_cast<const Gate*>(component);
+        size_t fanin = gate->get_inputs().size();
+        if (kind == NOT || kind == BUF) {
+            fanin = fanin >= 1 ? 1 : 0;   // Only the first pin is read
+        } else if (fanin < 2) {
+            continue;                     // evaluate() ignores these
+        }
+        if (fanin == 0 || fanin > MAX_FANIN || !gate->get_output() || gate->is_annotated()) {
+            continue;
+        }
+
+        auto it = index.find({kind, fanin});
+        if (it == index.end()) {
+            Group group;
+            group.fanin = fanin;
+            for (uint8_t a = 0; a < 4; a++) {
+                for (uint8_t b = 0; b < 4; b++) {
+                    uint8_t v;
+                    switch (kind) {
+                        case AND: v = logic::and2(a, b); break;
+                        case OR: v = logic::or2(a, b); break;
+                        case XOR: v = logic::xor2(a, b); break;
+                        case NOT: v = b == 0 ? logic::not1(a) : 0; break;   // One pin: [a]
+                        default: v = b == 0 ? logic::buf1(a) : 0; break;
+                    }
+                    group.table[(kind == NOT || kind == BUF) ? a + b * 4 : a * 4 + b] = v;
+                }
+            }
+            it = index.emplace(std::make_pair(kind, fanin), groups.size()).first;
+            groups.push_back(std::move(group));
+        }
+        group_of[component->get_index()] = it->second;
+        revisions[component->get_index()] = gate->get_revision();
+    }
+}
+
+uint64_t GateBatcher::run(Simulator* sim, uint64_t current_time, uint64_t* evaluation_counts) {
+    uint64_t evaluated = 0;
+    events.clear();
+    for (Group& group : groups) {
+        size_t n = group.active.size();
+        if (n == 0) {
+            continue;
+        }
+        evaluated += n;
+        if (evaluation_counts) {
+            for (Gate* gate : group.active) {
+                evaluation_counts[gate->get_index()]++;
+            }
+        }
+        if (n < min_batch) {
+            for (Gate* gate : group.active) {
+                gate->evaluate(sim, current_time);
+            }
+            group.active.clear();
+            continue;
+        }
+
+        size_t padded = (n + LANES - 1) / LANES * LANES;
+        if (padded > group.capacity) {
+            group.capacity = padded;
+            group.pins.assign(group.fanin * padded, 0);
+            group.current.assign(padded, 0);
+            group.results.assign(padded, 0);
+            changed.resize(std::max(changed.size(), padded));
+        }
+        uint8_t* current = group.current.data();
+        uint8_t* pins = group.pins.data();
+        for (size_t i = 0; i < n; i++) {
+            const Gate* gate = group.active[i];
+            const PinList& inputs = gate->get_inputs();
+            for (size_t p = 0; p < group.fanin; p++) {
+                pins[p * group.capacity + i] = inputs[p]->get_value();
+            }
+            current[i] = gate->get_output()->get_value();
+        }
+
+        const uint8_t* lanes[MAX_FANIN];
+        for (size_t p = 0; p < group.fanin; p++) {
+            lanes[p] = pins + p * group.capacity;
+        }
+        size_t count = batch::eval_lanes(kernel, group.table, lanes, group.fanin, current,
+                                         group.results.data(), changed.data(), n);
+        for (size_t k = 0; k < count; k++) {
+            const Gate* gate = group.active[changed[k]];
+            events.emplace_back(current_time + gate->get_delay(), gate->get_output()->get_id(),
+                                group.results[changed[k]]);
+        }
+        lanes_evaluated += n;
+        group.active.clear();
+    }
+
+    if (++epoch == 0) {  // Wrapped: old marks could match again
+        std::fill(marks.begin(), marks.end(), 0);
+        epoch = 1;
+    }
+    if (!events.empty()) {
+        sim->schedule_batch(events);
+    }
+    return evaluated;
+}
+
+size_t GateBatcher::batched_gates() const {
+    size_t count = 0;
+    for (uint32_t group : group_of) {
+        count += group != NO_GROUP;
+    }
+    return count;
+}
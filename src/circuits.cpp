@@ -0,0 +1,492 @@
+#include "circuits.h"
+#include "gate.h"
+#include "sequential.h"
+#include "event.h"
+#include "module.h"
+#include "memories.h"
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+
+// ===== Helpers =====
+
+static std::string net_name(const std::string& prefix, const std::string& base, int index) {
+    return prefix + "." + base + std::to_string(index);
+}
+
+template<typename GateType>
+static Signal* make_gate(Simulator& sim, CircuitPorts& ports, uint64_t delay,
+                         std::initializer_list<Signal*> ins, Signal* out) {
+    sim.create_gate<GateType>(delay, ins, out);
+    ports.gate_count++;
+    return out;
+}
+
+// Full adder: s = a ^ b ^ c, co = (a & b) | (c & (a ^ b))
+static void full_adder(Simulator& sim, CircuitPorts& ports, const std::string& name, uint64_t delay,
+                       Signal* a, Signal* b, Signal* c, Signal* s, Signal* co) {
+    Signal* ab = sim.create_signal(name + ".ab", 2);
+    Signal* g = sim.create_signal(name + ".g", 2);
+    Signal* pc = sim.create_signal(name + ".pc", 2);
+    make_gate<XORGate>(sim, ports, delay, {a, b}, ab);
+    make_gate<XORGate>(sim, ports, delay, {ab, c}, s);
+    make_gate<ANDGate>(sim, ports, delay, {a, b}, g);
+    make_gate<ANDGate>(sim, ports, delay, {ab, c}, pc);
+    make_gate<ORGate>(sim, ports, delay, {g, pc}, co);
+}
+
+static void check_width(int bits) {
+    if (bits < 1) {
+        throw std::invalid_argument("Circuit width must be at least 1 bit");
+    }
+}
+
+// ===== Adders =====
+
+CircuitPorts build_ripple_carry_adder(Simulator& sim, int bits, const std::string& prefix, uint64_t delay) {
+    check_width(bits);
+    CircuitPorts ports;
+
+    std::vector<Signal*> a, b;
+    for (int i = 0; i < bits; i++) {
+        a.push_back(sim.create_signal(net_name(prefix, "a", i), 0));
+        b.push_back(sim.create_signal(net_name(prefix, "b", i), 0));
+    }
+    Signal* carry = sim.create_signal(prefix + ".cin", 0);
+
+    ports.inputs = a;
+    ports.inputs.insert(ports.inputs.end(), b.begin(), b.end());
+    ports.inputs.push_back(carry);
+
+    for (int i = 0; i < bits; i++) {
+        Signal* s = sim.create_signal(net_name(prefix, "s", i), 2);
+        Signal* co = sim.create_signal(net_name(prefix, "c", i + 1), 2);
+        full_adder(sim, ports, net_name(prefix, "fa", i), delay, a[i], b[i], carry, s, co);
+        ports.outputs.push_back(s);
+        carry = co;
+    }
+    ports.outputs.push_back(carry);
+    return ports;
+}
+
+CircuitPorts build_carry_lookahead_adder(Simulator& sim, int bits, const std::string& prefix, uint64_t delay) {
+    check_width(bits);
+    CircuitPorts ports;
+
+    std::vector<Signal*> a, b, g, p;
+    for (int i = 0; i < bits; i++) {
+        a.push_back(sim.create_signal(net_name(prefix, "a", i), 0));
+        b.push_back(sim.create_signal(net_name(prefix, "b", i), 0));
+    }
+    Signal* cin = sim.create_signal(prefix + ".cin", 0);
+
+    ports.inputs = a;
+    ports.inputs.insert(ports.inputs.end(), b.begin(), b.end());
+    ports.inputs.push_back(cin);
+
+    // Bit-level generate / propagate
+    for (int i = 0; i < bits; i++) {
+        g.push_back(make_gate<ANDGate>(sim, ports, delay, {a[i], b[i]},
+                                       sim.create_signal(net_name(prefix, "g", i), 2)));
+        p.push_back(make_gate<XORGate>(sim, ports, delay, {a[i], b[i]},
+                                       sim.create_signal(net_name(prefix, "p", i), 2)));
+    }
+
+    // Carries: within a 4-bit group every carry is a two-level sum of products
+    // of the group's g/p terms and the group carry-in
+    //   c[i+1] = g[i] | p[i]g[i-1] | ... | p[i]..p[base]c[base]
+    std::vector<Signal*> carry(bits + 1, nullptr);
+    carry[0] = cin;
+    for (int base = 0; base < bits; base += 4) {
+        int end = std::min(base + 4, bits);
+        for (int i = base; i < end; i++) {
+            Gate* sum_of_products = sim.create_component<ORGate>(delay);
+            ports.gate_count++;
+            sum_of_products->connect_input(g[i]);
+
+            for (int j = i - 1; j >= base - 1; j--) {
+                // Product term: p[i] & ... & p[j+1] & (j >= base ? g[j] : carry[base])
+                Gate* product = sim.create_component<ANDGate>(delay);
+                ports.gate_count++;
+                for (int k = i; k > j; k--) {
+                    product->connect_input(p[k]);
+                }
+                product->connect_input(j >= base ? g[j] : carry[base]);
+
+                Signal* term = sim.create_signal(prefix + ".t" + std::to_string(i) + "_" + std::to_string(j + 1), 2);
+                product->connect_output(term);
+                sum_of_products->connect_input(term);
+            }
+
+            carry[i + 1] = sim.create_signal(net_name(prefix, "c", i + 1), 2);
+            sum_of_products->connect_output(carry[i + 1]);
+        }
+    }
+
+    for (int i = 0; i < bits; i++) {
+        ports.outputs.push_back(make_gate<XORGate>(sim, ports, delay, {p[i], carry[i]},
+                                                   sim.create_signal(net_name(prefix, "s", i), 2)));
+    }
+    ports.outputs.push_back(carry[bits]);
+    return ports;
+}
+
+// ===== Multiplier =====
+
+CircuitPorts build_array_multiplier(Simulator& sim, int bits, const std::string& prefix, uint64_t delay) {
+    check_width(bits);
+    CircuitPorts ports;
+
+    std::vector<Signal*> a, b;
+    for (int i = 0; i < bits; i++) {
+        a.push_back(sim.create_signal(net_name(prefix, "a", i), 0));
+    }
+    for (int i = 0; i < bits; i++) {
+        b.push_back(sim.create_signal(net_name(prefix, "b", i), 0));
+    }
+    ports.inputs = a;
+    ports.inputs.insert(ports.inputs.end(), b.begin(), b.end());
+
+    Signal* zero = sim.create_signal(prefix + ".zero", 0);
+
+    // Partial product pp[j][i] = a[i] & b[j]
+    auto partial = [&](int i, int j) {
+        return make_gate<ANDGate>(sim, ports, delay, {a[i], b[j]},
+                                  sim.create_signal(prefix + ".pp" + std::to_string(j) + "_" + std::to_string(i), 2));
+    };
+
+    // Row 0 is the first partial product; each following row adds the next
+    // partial product (shifted by one) with a ripple-carry adder row
+    std::vector<Signal*> acc;
+    for (int i = 0; i < bits; i++) {
+        acc.push_back(partial(i, 0));
+    }
+    ports.outputs.push_back(acc[0]);
+
+    for (int j = 1; j < bits; j++) {
+        std::vector<Signal*> next;
+        Signal* carry = zero;
+        for (int i = 0; i < bits; i++) {
+            Signal* upper = (i + 1 < (int)acc.size()) ? acc[i + 1] : zero;
+            std::string cell = prefix + ".r" + std::to_string(j) + "_" + std::to_string(i);
+            Signal* s = sim.create_signal(cell + ".s", 2);
+            Signal* co = sim.create_signal(cell + ".co", 2);
+            full_adder(sim, ports, cell, delay, upper, partial(i, j), carry, s, co);
+            next.push_back(s);
+            carry = co;
+        }
+        next.push_back(carry);
+        ports.outputs.push_back(next[0]);
+        acc.assign(next.begin(), next.end());
+    }
+
+    for (size_t i = 1; i < acc.size(); i++) {
+        ports.outputs.push_back(acc[i]);
+    }
+    return ports;
+}
+
+// ===== Sequential circuits =====
+
+// Drive every register output to its reset value at t=0 so the combinational
+// logic behind the registers settles before the first clock edge
+static void reset_registers(Simulator& sim, const std::vector<Signal*>& regs) {
+    for (Signal* q : regs) {
+        sim.schedule_event(Event(0, q->get_id(), q->get_value()));
+    }
+}
+
+CircuitPorts build_lfsr(Simulator& sim, int bits, const std::string& prefix, uint64_t delay) {
+    if (bits < 2) {
+        throw std::invalid_argument("LFSR width must be at least 2 bits");
+    }
+    CircuitPorts ports;
+    ports.clock = sim.create_signal(prefix + ".clk", 0);
+    ports.inputs.push_back(ports.clock);
+
+    // Maximal-length taps for common widths (1-based bit positions)
+    std::vector<int> taps;
+    switch (bits) {
+        case 8:  taps = {8, 6, 5, 4}; break;
+        case 16: taps = {16, 15, 13, 4}; break;
+        case 32: taps = {32, 22, 2, 1}; break;
+        case 64: taps = {64, 63, 61, 60}; break;
+        default: taps = {bits, bits - 1}; break;
+    }
+
+    std::vector<Signal*> q;
+    for (int i = 0; i < bits; i++) {
+        q.push_back(sim.create_signal(net_name(prefix, "q", i), i == 0 ? 1 : 0));  // Non-zero seed
+    }
+    Signal* feedback = sim.create_signal(prefix + ".fb", 2);
+
+    XORGate* fb_gate = sim.create_component<XORGate>(delay);
+    ports.gate_count++;
+    for (int tap : taps) {
+        fb_gate->connect_input(q[tap - 1]);
+    }
+    fb_gate->connect_output(feedback);
+
+    for (int i = 0; i < bits; i++) {
+        DFF* dff = sim.create_component<DFF>(delay);
+        ports.gate_count++;
+        dff->connect_clock(ports.clock);
+        dff->connect_data(i == 0 ? feedback : q[i - 1]);
+        dff->connect_q(q[i]);
+    }
+
+    ports.outputs = q;
+    reset_registers(sim, q);
+    return ports;
+}
+
+CircuitPorts build_counter_pipeline(Simulator& sim, int bits, int stages, const std::string& prefix, uint64_t delay) {
+    check_width(bits);
+    CircuitPorts ports;
+    ports.clock = sim.create_signal(prefix + ".clk", 0);
+    ports.inputs.push_back(ports.clock);
+
+    std::vector<Signal*> regs;
+    std::vector<Signal*> count;
+    for (int i = 0; i < bits; i++) {
+        count.push_back(sim.create_signal(net_name(prefix, "q", i), 0));
+    }
+    regs.insert(regs.end(), count.begin(), count.end());
+
+    // Incrementer: s[i] = q[i] ^ c[i], c[i+1] = q[i] & c[i], c[0] = 1
+    Signal* carry = sim.create_signal(prefix + ".one", 1);
+    for (int i = 0; i < bits; i++) {
+        Signal* s = make_gate<XORGate>(sim, ports, delay, {count[i], carry},
+                                       sim.create_signal(net_name(prefix, "inc", i), 2));
+        if (i + 1 < bits) {
+            carry = make_gate<ANDGate>(sim, ports, delay, {count[i], carry},
+                                       sim.create_signal(net_name(prefix, "ic", i + 1), 2));
+        }
+
+        DFF* dff = sim.create_component<DFF>(delay);
+        ports.gate_count++;
+        dff->connect_clock(ports.clock);
+        dff->connect_data(s);
+        dff->connect_q(count[i]);
+    }
+
+    std::vector<Signal*> stage_in = count;
+    for (int st = 0; st < stages; st++) {
+        std::vector<Signal*> stage_out;
+        for (int i = 0; i < bits; i++) {
+            Signal* q = sim.create_signal(prefix + ".p" + std::to_string(st) + "_" + std::to_string(i), 0);
+            DFF* dff = sim.create_component<DFF>(delay);
+            ports.gate_count++;
+            dff->connect_clock(ports.clock);
+            dff->connect_data(stage_in[i]);
+            dff->connect_q(q);
+            stage_out.push_back(q);
+        }
+        regs.insert(regs.end(), stage_out.begin(), stage_out.end());
+        stage_in = stage_out;
+    }
+
+    ports.outputs = stage_in;
+    reset_registers(sim, regs);
+    return ports;
+}
+
+// ===== Random DAG =====
+
+CircuitPorts build_random_dag(Simulator& sim, int num_inputs, int num_gates, int fanout,
+                              uint32_t seed, const std::string& prefix, uint64_t delay) {
+    if (num_inputs < 2 || num_gates < 1 || fanout < 1) {
+        throw std::invalid_argument("Random DAG needs >= 2 inputs, >= 1 gate and fan-out >= 1");
+    }
+    CircuitPorts ports;
+    std::mt19937 gen(seed);
+
+    // Every net starts with `fanout` unused sinks; gates draw their inputs from
+    // nets that still have sinks left, so the average fan-out approaches `fanout`
+    struct OpenNet { Signal* sig; int remaining; };
+    std::vector<OpenNet> open;
+
+    for (int i = 0; i < num_inputs; i++) {
+        Signal* in = sim.create_signal(net_name(prefix, "in", i), 0);
+        ports.inputs.push_back(in);
+        open.push_back({in, fanout});
+    }
+
+    auto take = [&]() {
+        std::uniform_int_distribution<size_t> pick(0, open.size() - 1);
+        size_t idx = pick(gen);
+        Signal* sig = open[idx].sig;
+        if (--open[idx].remaining == 0) {
+            open[idx] = open.back();
+            open.pop_back();
+        }
+        return sig;
+    };
+
+    std::uniform_int_distribution<int> kind_dist(0, 3);
+    for (int i = 0; i < num_gates; i++) {
+        Signal* out = sim.create_signal(net_name(prefix, "n", i), 2);
+        int kind = open.size() < 2 ? 3 : kind_dist(gen);  // Only NOT if one source is left
+
+        Signal* in0 = take();
+        switch (kind) {
+            case 0: make_gate<ANDGate>(sim, ports, delay, {in0, take()}, out); break;
+            case 1: make_gate<ORGate>(sim, ports, delay, {in0, take()}, out); break;
+            case 2: make_gate<XORGate>(sim, ports, delay, {in0, take()}, out); break;
+            default: make_gate<NOTGate>(sim, ports, delay, {in0}, out); break;
+        }
+        open.push_back({out, fanout});
+    }
+
+    // Nets nobody consumed are the DAG's outputs
+    for (const auto& net : open) {
+        if (net.remaining == fanout && net.sig->get_value() == 2) {
+            ports.outputs.push_back(net.sig);
+        }
+    }
+    return ports;
+}
+
+// ===== Register file =====
+
+CircuitPorts build_register_file(Simulator& sim, int slices, int bits, bool instanced,
+                                 const std::string& prefix, uint64_t delay) {
+    check_width(bits);
+    if (slices < 1) {
+        throw std::invalid_argument("Register file needs at least one slice");
+    }
+    CircuitPorts ports;
+    ports.clock = sim.create_signal(prefix + ".clk", 0);
+    ports.inputs.push_back(ports.clock);
+
+    std::vector<Signal*> enable, data;
+    for (int s = 0; s < slices; s++) {
+        enable.push_back(sim.create_signal(net_name(prefix, "en", s), 0));
+    }
+    for (int i = 0; i < bits; i++) {
+        data.push_back(sim.create_signal(net_name(prefix, "d", i), 0));
+    }
+    ports.inputs.insert(ports.inputs.end(), enable.begin(), enable.end());
+    ports.inputs.insert(ports.inputs.end(), data.begin(), data.end());
+
+    if (instanced) {
+        // One shared definition: q[i] <= en ? d[i] : q[i]
+        auto def = std::make_shared<ModuleDef>("regslice");
+        uint32_t clk = def->add_input("clk");
+        uint32_t en = def->add_input("en");
+        std::vector<uint32_t> d;
+        for (int i = 0; i < bits; i++) {
+            d.push_back(def->add_input("d" + std::to_string(i)));
+        }
+        uint32_t nen = def->add_net("nen");
+        def->add_gate(ModuleDef::NOT, {en}, nen, delay);
+        for (int i = 0; i < bits; i++) {
+            std::string bit = std::to_string(i);
+            uint32_t q = def->add_output("q" + bit, 0);
+            uint32_t take = def->add_net("take" + bit);
+            uint32_t hold = def->add_net("hold" + bit);
+            uint32_t next = def->add_net("next" + bit);
+            def->add_gate(ModuleDef::AND, {en, d[i]}, take, delay);
+            def->add_gate(ModuleDef::AND, {nen, q}, hold, delay);
+            def->add_gate(ModuleDef::OR, {take, hold}, next, delay);
+            def->add_dff(next, clk, q, delay);
+        }
+
+        for (int s = 0; s < slices; s++) {
+            std::string inst_name = prefix + ".s" + std::to_string(s);
+            ModuleInstance* inst = sim.create_component<ModuleInstance>(def, inst_name);
+            ports.gate_count++;
+            inst->connect_input(0, ports.clock);
+            inst->connect_input(1, enable[s]);
+            for (int i = 0; i < bits; i++) {
+                inst->connect_input(2 + i, data[i]);
+            }
+            for (int i = 0; i < bits; i++) {
+                Signal* q = sim.create_signal(inst_name + ".q" + std::to_string(i), 0);
+                inst->connect_output(i, q);
+                ports.outputs.push_back(q);
+            }
+        }
+        return ports;
+    }
+
+    std::vector<Signal*> regs;
+    for (int s = 0; s < slices; s++) {
+        std::string slice = prefix + ".s" + std::to_string(s);
+        Signal* nen = make_gate<NOTGate>(sim, ports, delay, {enable[s]}, sim.create_signal(slice + ".nen", 2));
+        for (int i = 0; i < bits; i++) {
+            std::string bit = std::to_string(i);
+            Signal* q = sim.create_signal(slice + ".q" + bit, 0);
+            Signal* take = make_gate<ANDGate>(sim, ports, delay, {enable[s], data[i]},
+                                              sim.create_signal(slice + ".take" + bit, 2));
+            Signal* hold = make_gate<ANDGate>(sim, ports, delay, {nen, q},
+                                              sim.create_signal(slice + ".hold" + bit, 2));
+            Signal* next = make_gate<ORGate>(sim, ports, delay, {take, hold},
+                                             sim.create_signal(slice + ".next" + bit, 2));
+            DFF* dff = sim.create_component<DFF>(delay);
+            ports.gate_count++;
+            dff->connect_clock(ports.clock);
+            dff->connect_data(next);
+            dff->connect_q(q);
+            ports.outputs.push_back(q);
+            regs.push_back(q);
+        }
+    }
+    reset_registers(sim, regs);
+    return ports;
+}
+
+// ===== RAM =====
+
+CircuitPorts build_ram(Simulator& sim, int addr_bits, int bits, int read_ports,
+                       const std::string& prefix, uint64_t delay) {
+    check_width(bits);
+    if (addr_bits < 1 || addr_bits > 40 || read_ports < 1) {
+        throw std::invalid_argument("RAM needs 1..40 address bits and at least one read port");
+    }
+    CircuitPorts ports;
+    ports.clock = sim.create_signal(prefix + ".clk", 0);
+    Signal* we = sim.create_signal(prefix + ".we", 0);
+    ports.inputs = {ports.clock, we};
+
+    auto bus = [&](const std::string& base, int width, std::vector<Signal*>& list) {
+        std::vector<Signal*> sigs;
+        for (int i = 0; i < width; i++) {
+            sigs.push_back(sim.create_signal(net_name(prefix, base, i), 0));
+        }
+        list.insert(list.end(), sigs.begin(), sigs.end());
+        return sigs;
+    };
+
+    SyncRAM* ram = sim.create_component<SyncRAM>(bits, uint64_t(1) << addr_bits, delay);
+    ports.gate_count++;
+    ram->connect_clock(ports.clock);
+    std::vector<Signal*> wa = bus("wa", addr_bits, ports.inputs);
+    std::vector<Signal*> wd = bus("wd", bits, ports.inputs);
+    ram->add_write_port(wa, wd, we);
+    for (int p = 0; p < read_ports; p++) {
+        std::string index = std::to_string(p);
+        std::vector<Signal*> ra = bus("ra" + index + "_", addr_bits, ports.inputs);
+        std::vector<Signal*> rd = bus("rd" + index + "_", bits, ports.outputs);
+        ram->add_read_port(ra, rd);
+    }
+    return ports;
+}
+
+// ===== Named circuits =====
+
+std::vector<std::string> named_circuits() {
+    return {"rca32", "cla32", "mul16", "lfsr64", "counter16x8", "regfile64x8", "ram10x32", "dag10k"};
+}
+
+CircuitPorts build_named_circuit(Simulator& sim, const std::string& name) {
+    if (name == "rca32") return build_ripple_carry_adder(sim, 32);
+    if (name == "cla32") return build_carry_lookahead_adder(sim, 32);
+    if (name == "mul16") return build_array_multiplier(sim, 16);
+    if (name == "lfsr64") return build_lfsr(sim, 64);
+    if (name == "counter16x8") return build_counter_pipeline(sim, 16, 8);
+    if (name == "regfile64x8") return build_register_file(sim, 64, 8, false);
+    if (name == "ram10x32") return build_ram(sim, 10, 32, 2);
+    if (name == "dag10k") return build_random_dag(sim, 64, 10000, 2, 1);
+    throw std::invalid_argument("Unknown circuit: " + name);
+}
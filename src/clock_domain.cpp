@@ -0,0 +1,145 @@
+#include "clock_domain.h"
+#include "simulator.h"
+#include "event.h"
+#include "logic.h"
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+uint32_t ClockDomain::id_counter = 0;
+
+ClockDomain::ClockDomain(Signal* clk, Edge edge)
+    : SequentialElement("DOMAIN" + std::to_string(id_counter++), 0, edge) {
+    connect_clock(clk);
+}
+
+void ClockDomain::add_flop(DFF* flop) {
+    if (!flop || !flop->get_data() || !flop->get_q()) {
+        throw std::invalid_argument("Clock domain needs fully connected flops");
+    }
+    if (flop->get_clock() != clock || flop->get_edge() != trigger_edge) {
+        throw std::invalid_argument(flop->get_id() + " is not clocked by domain " + id);
+    }
+    if (flop->in_domain) {
+        throw std::invalid_argument(flop->get_id() + " already belongs to a clock domain");
+    }
+    if (flop->has_timing_checks()) {
+        throw std::invalid_argument(flop->get_id() + " has timing checks and must see its D changes");
+    }
+
+    uint32_t slot = flops.size();
+    flops.push_back(flop);
+    d.push_back(flop->get_data());
+    q.push_back(flop->get_q());
+    delays.push_back(flop->get_delay());
+    if (flop->get_enable()) {
+        with_enable.push_back(slot);
+    }
+    if (flop->get_reset()) {
+        with_reset.push_back(slot);
+    }
+
+    // The domain now sees the edges; the flop only reacts to its reset
+    flop->in_domain = true;
+    Signal* reset = flop->get_reset();
+    for (Signal* sig : {flop->get_clock(), flop->get_data(), flop->get_enable()}) {
+        if (sig && sig != reset) {
+            sig->detach_observer(flop);
+        }
+    }
+
+    d_values.resize(flops.size());
+    q_values.resize(flops.size());
+    hold_mask.resize(flops.size());
+    reset_mask.resize(flops.size());
+}
+
+void ClockDomain::on_clock_edge(Simulator* sim, uint64_t current_time) {
+    const size_t n = flops.size();
+
+    // Read every D and Q first so no update can leak into another flop's sample
+    for (size_t i = 0; i < n; i++) {
+        d_values[i] = logic::buf1(d[i]->get_value());
+        q_values[i] = q[i]->get_value();
+    }
+    std::fill(hold_mask.begin(), hold_mask.end(), 0);
+    std::fill(reset_mask.begin(), reset_mask.end(), 0);
+    for (uint32_t i : with_enable) {
+        hold_mask[i] = flops[i]->get_enable()->get_value() == 0;
+    }
+    for (uint32_t i : with_reset) {
+        reset_mask[i] = flops[i]->get_reset()->get_value() == 1;
+    }
+
+    // next = reset ? 0 : (hold ? q : d), as byte masks
+    for (size_t i = 0; i < n; i++) {
+        uint8_t keep = -hold_mask[i];
+        uint8_t next = (q_values[i] & keep) | (d_values[i] & ~keep);
+        d_values[i] = next & (uint8_t)(reset_mask[i] - 1);
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        if (d_values[i] != q_values[i]) {
+            sim->schedule_event(Event(current_time + delays[i], q[i]->get_id(), d_values[i]));
+        }
+    }
+}
+
+void ClockDomain::get_fanin(std::vector<Signal*>& nets) const {
+    nets.push_back(clock);
+    nets.insert(nets.end(), d.begin(), d.end());
+    for (uint32_t i : with_enable) {
+        nets.push_back(flops[i]->get_enable());
+    }
+    for (uint32_t i : with_reset) {
+        nets.push_back(flops[i]->get_reset());
+    }
+}
+
+void ClockDomain::get_fanout(std::vector<Signal*>& nets) const {
+    nets.insert(nets.end(), q.begin(), q.end());
+}
+
+size_t ClockDomain::size() const {
+    return flops.size();
+}
+
+const std::vector<DFF*>& ClockDomain::get_flops() const {
+    return flops;
+}
+
+size_t build_clock_domains(Simulator& sim, size_t min_flops) {
+    // Keep the first-seen order of groups so domain ids are deterministic
+    std::map<std::pair<Signal*, int>, size_t> group_of;
+    std::vector<std::vector<DFF*>> groups;
+    for (Component* component : sim.get_components()) {
+        DFF* flop = dynamic_cast<DFF*>(component);
+        if (!flop || flop->is_in_domain() || !flop->get_clock() || !flop->get_data() || !flop->get_q()) {
+            continue;
+        }
+        if (flop->has_timing_checks()) {
+            continue;  // Needs to see its D changes
+        }
+        auto key = std::make_pair(flop->get_clock(), (int)flop->get_edge());
+        auto it = group_of.find(key);
+        if (it == group_of.end()) {
+            it = group_of.emplace(key, groups.size()).first;
+            groups.emplace_back();
+        }
+        groups[it->second].push_back(flop);
+    }
+
+    size_t created = 0;
+    for (const std::vector<DFF*>& group : groups) {
+        if (group.size() < std::max<size_t>(min_flops, 1)) {
+            continue;
+        }
+        ClockDomain* domain = sim.create_component<ClockDomain>(group[0]->get_clock(), group[0]->get_edge());
+        for (DFF* flop : group) {
+            domain->add_flop(flop);
+        }
+        created++;
+    }
+    return created;
+}
@@ -6,4 +6,32 @@ uint64_t Component::get_delay() const {
 
 std::string Component::get_id() const {
     return id;
-}
\ No newline at end of file
+}
+
+Signal* Component::get_output() const {
+    return output;
+}
+
+bool Component::is_sequential() const {
+    return false;
+}
+
+const PinList& Component::get_inputs() const {
+    return inputs;
+}
+
+void Component::get_fanin(std::vector<Signal*>& nets) const {
+    nets.insert(nets.end(), inputs.begin(), inputs.end());
+}
+
+void Component::get_fanout(std::vector<Signal*>& nets) const {
+    if (output) {
+        nets.push_back(output);
+    }
+}
+
+void Component::save_state(std::vector<uint8_t>&) const {
+}
+
+void Component::restore_state(const uint8_t*&) {
+}
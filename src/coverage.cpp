@@ -0,0 +1,227 @@
+#include "coverage.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+// Flag bits used in the saved database
+enum CoverageFlag : uint32_t {
+    COV_ROSE = 1,
+    COV_FELL = 2,
+    COV_SEEN0 = 4,
+    COV_SEEN1 = 8,
+    COV_STATE = 16
+};
+
+static const char* COVERAGE_HEADER = "LOGIC-SIM-COVERAGE 1";
+
+bool CoverageDB::test(const std::vector<uint64_t>& bits, uint32_t index) {
+    return (bits[index >> 6] >> (index & 63)) & 1;
+}
+
+void CoverageDB::set(std::vector<uint64_t>& bits, uint32_t index) {
+    bits[index >> 6] |= 1ULL << (index & 63);
+}
+
+void CoverageDB::add_net(const std::string& name, uint8_t value, bool is_state) {
+    uint32_t index = names.size();
+    names.push_back(name);
+    if ((index & 63) == 0) {
+        rose.push_back(0);
+        fell.push_back(0);
+        seen[0].push_back(0);
+        seen[1].push_back(0);
+        state.push_back(0);
+    }
+    if (value < 2) {
+        set(seen[value], index);
+    }
+    if (is_state) {
+        set(state, index);
+    }
+}
+
+void CoverageDB::mark_state(uint32_t index) {
+    set(state, index);
+}
+
+void CoverageDB::clear() {
+    std::fill(rose.begin(), rose.end(), 0);
+    std::fill(fell.begin(), fell.end(), 0);
+    std::fill(seen[0].begin(), seen[0].end(), 0);
+    std::fill(seen[1].begin(), seen[1].end(), 0);
+}
+
+bool CoverageDB::toggle_covered(uint32_t index) const {
+    return test(rose, index) && test(fell, index);
+}
+
+bool CoverageDB::state_covered(uint32_t index) const {
+    return test(seen[0], index) && test(seen[1], index);
+}
+
+bool CoverageDB::has_risen(uint32_t index) const {
+    return test(rose, index);
+}
+
+bool CoverageDB::has_fallen(uint32_t index) const {
+    return test(fell, index);
+}
+
+bool CoverageDB::is_state(uint32_t index) const {
+    return test(state, index);
+}
+
+size_t CoverageDB::size() const {
+    return names.size();
+}
+
+const std::string& CoverageDB::get_name(uint32_t index) const {
+    return names.at(index);
+}
+
+size_t CoverageDB::toggle_covered_count() const {
+    size_t count = 0;
+    for (size_t w = 0; w < rose.size(); w++) {
+        count += __builtin_popcountll(rose[w] & fell[w]);
+    }
+    return count;
+}
+
+size_t CoverageDB::state_net_count() const {
+    size_t count = 0;
+    for (uint64_t word : state) {
+        count += __builtin_popcountll(word);
+    }
+    return count;
+}
+
+size_t CoverageDB::state_covered_count() const {
+    size_t count = 0;
+    for (size_t w = 0; w < state.size(); w++) {
+        count += __builtin_popcountll(state[w] & seen[0][w] & seen[1][w]);
+    }
+    return count;
+}
+
+uint32_t CoverageDB::flags(uint32_t index) const {
+    return (test(rose, index) ? (uint32_t)COV_ROSE : 0u) |
+           (test(fell, index) ? (uint32_t)COV_FELL : 0u) |
+           (test(seen[0], index) ? (uint32_t)COV_SEEN0 : 0u) |
+           (test(seen[1], index) ? (uint32_t)COV_SEEN1 : 0u) |
+           (test(state, index) ? (uint32_t)COV_STATE : 0u);
+}
+
+void CoverageDB::set_flags(uint32_t index, uint32_t f) {
+    if (f & COV_ROSE) set(rose, index);
+    if (f & COV_FELL) set(fell, index);
+    if (f & COV_SEEN0) set(seen[0], index);
+    if (f & COV_SEEN1) set(seen[1], index);
+    if (f & COV_STATE) set(state, index);
+}
+
+void CoverageDB::merge(const CoverageDB& other) {
+    // Fast path: same design, same net order -> plain bitwise OR
+    if (other.names == names) {
+        for (size_t w = 0; w < rose.size(); w++) {
+            rose[w] |= other.rose[w];
+            fell[w] |= other.fell[w];
+            seen[0][w] |= other.seen[0][w];
+            seen[1][w] |= other.seen[1][w];
+            state[w] |= other.state[w];
+        }
+        return;
+    }
+
+    std::unordered_map<std::string, uint32_t> index_of;
+    for (uint32_t i = 0; i < names.size(); i++) {
+        index_of[names[i]] = i;
+    }
+    for (uint32_t i = 0; i < other.names.size(); i++) {
+        auto it = index_of.find(other.names[i]);
+        uint32_t index;
+        if (it == index_of.end()) {
+            index = names.size();
+            add_net(other.names[i], 2);
+        } else {
+            index = it->second;
+        }
+        set_flags(index, other.flags(i));
+    }
+}
+
+void CoverageDB::save(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+    file << COVERAGE_HEADER << "\n";
+    for (uint32_t i = 0; i < names.size(); i++) {
+        file << flags(i) << " " << names[i] << "\n";
+    }
+}
+
+CoverageDB CoverageDB::load(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+
+    std::string line;
+    if (!std::getline(file, line) || line != COVERAGE_HEADER) {
+        throw std::runtime_error("Not a coverage database: " + filename);
+    }
+
+    CoverageDB db;
+    while (std::getline(file, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        std::istringstream fields(line);
+        uint32_t f;
+        std::string name;
+        if (!(fields >> f >> name)) {
+            throw std::runtime_error("Malformed coverage line: " + line);
+        }
+        uint32_t index = db.names.size();
+        db.add_net(name, 2);
+        db.set_flags(index, f);
+    }
+    return db;
+}
+
+void CoverageDB::report(std::ostream& out) const {
+    size_t nets = names.size();
+    size_t toggled = toggle_covered_count();
+    size_t state_nets = state_net_count();
+    size_t state_done = state_covered_count();
+
+    out << "=== Coverage Report ===\n";
+    out << "Toggle coverage: " << toggled << "/" << nets << " nets";
+    if (nets) {
+        out << " (" << (100.0 * toggled / nets) << "%)";
+    }
+    out << "\n";
+    out << "State coverage:  " << state_done << "/" << state_nets << " sequential outputs";
+    if (state_nets) {
+        out << " (" << (100.0 * state_done / state_nets) << "%)";
+    }
+    out << "\n";
+
+    out << "\nUncovered toggles:\n";
+    for (uint32_t i = 0; i < nets; i++) {
+        if (!toggle_covered(i)) {
+            out << "  " << names[i] << (has_risen(i) ? "" : " (never 0->1)")
+                << (has_fallen(i) ? "" : " (never 1->0)") << "\n";
+        }
+    }
+
+    out << "\nUncovered states:\n";
+    for (uint32_t i = 0; i < nets; i++) {
+        if (is_state(i) && !state_covered(i)) {
+            out << "  " << names[i] << (test(seen[0], i) ? "" : " (never 0)")
+                << (test(seen[1], i) ? "" : " (never 1)") << "\n";
+        }
+    }
+}
@@ -0,0 +1,510 @@
+#include "equiv.h"
+#include "simulator.h"
+#include "signal.h"
+#include "gate.h"
+#include "event.h"
+#include "logic.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
+
+static uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+static std::string rename(const std::string& name, const std::string& from, const std::string& to) {
+    if (!from.empty() || !to.empty()) {
+        if (name.compare(0, from.size(), from) == 0) {
+            return to + name.substr(from.size());
+        }
+    }
+    return name;
+}
+
+static Signal* lookup(Simulator& sim, const std::string& name, const char* which) {
+    Signal* sig = sim.get_signal_by_name(name);
+    if (!sig) {
+        throw std::invalid_argument(std::string("No net ") + name + " in the " + which + " netlist");
+    }
+    return sig;
+}
+
+// ===== Compilation =====
+
+EquivalenceChecker::Program EquivalenceChecker::compile(Simulator& sim, const std::vector<Signal*>& ins,
+                                                        const std::vector<Signal*>& outs) {
+    Program program;
+    const std::vector<Signal*>& signals = sim.get_signals();
+    std::unordered_map<const Signal*, uint32_t> slot;
+    for (size_t i = 0; i < signals.size(); i++) {
+        slot.emplace(signals[i], i);
+    }
+    program.slots = signals.size();
+
+    std::vector<bool> is_input(signals.size(), false);
+    for (Signal* sig : ins) {
+        is_input[slot.at(sig)] = true;
+        program.input_slots.push_back(slot.at(sig));
+    }
+    for (Signal* sig : outs) {
+        program.output_slots.push_back(slot.at(sig));
+    }
+
+    // Gate per driven net; register outputs must be inputs
+    struct Node {
+        Op op;
+        std::vector<uint32_t> ins;
+    };
+    std::vector<int32_t> driver(signals.size(), -1);
+    std::vector<Node> nodes;
+    std::vector<uint32_t> node_out;
+    std::vector<Signal*> nets;
+    for (Component* component : sim.get_components()) {
+        nets.clear();
+        if (component->is_sequential()) {
+            component->get_fanout(nets);
+            for (Signal* sig : nets) {
+                if (!is_input[slot.at(sig)]) {
+                    throw std::invalid_argument("Register output " + sig->get_name() +
+                                                " has no counterpart in the other netlist");
+                }
+            }
+            continue;
+        }
+        Op op;
+        if (dynamic_cast<ANDGate*>(component)) {
+            op = AND;
+        } else if (dynamic_cast<ORGate*>(component)) {
+            op = OR;
+        } else if (dynamic_cast<XORGate*>(component)) {
+            op = XOR;
+        } else if (dynamic_cast<NOTGate*>(component)) {
+            op = NOT;
+        } else if (dynamic_cast<BUFGate*>(component)) {
+            op = BUF;
+        } else {
+            throw std::invalid_argument("Cannot compile component " + component->get_id() +
+                                        " for equivalence checking");
+        }
+        // As in the simulator, an AND/OR/XOR with fewer than two inputs
+        // never drives its output, which keeps its present value
+        size_t min_inputs = op == NOT || op == BUF ? 1 : 2;
+        Signal* out = component->get_output();
+        if (!out || component->get_inputs().size() < min_inputs) {
+            continue;
+        }
+        uint32_t s = slot.at(out);
+        if (is_input[s] || sim.is_constant(out)) {
+            continue;   // Cut point or tied net: the gate is not evaluated
+        }
+        if (driver[s] >= 0) {
+            throw std::invalid_argument("Net " + out->get_name() + " has several drivers");
+        }
+        driver[s] = nodes.size();
+        Node node{op, {}};
+        for (Signal* in : component->get_inputs()) {
+            node.ins.push_back(slot.at(in));
+        }
+        nodes.push_back(std::move(node));
+        node_out.push_back(s);
+    }
+
+    // Undriven nets that are not inputs keep their present value
+    for (size_t s = 0; s < signals.size(); s++) {
+        if (driver[s] >= 0 || is_input[s]) {
+            continue;
+        }
+        uint8_t value = sim.is_constant(signals[s]) ? sim.get_constant(signals[s]) : signals[s]->get_value();
+        if (value == LOGIC_1) {
+            program.constants.push_back({(uint32_t)s, ~0ULL});
+        } else if (value == LOGIC_0) {
+            program.constants.push_back({(uint32_t)s, 0});
+        } else if (!signals[s]->get_observers().empty()) {
+            throw std::invalid_argument("Undriven net " + signals[s]->get_name() + " is " +
+                                        logic::to_char(value) + " and not an input");
+        }
+    }
+
+    // Levelize (Kahn): a gate follows the gates driving its inputs
+    std::vector<uint32_t> pending(nodes.size(), 0);
+    std::vector<std::vector<uint32_t>> readers(nodes.size());
+    for (uint32_t n = 0; n < nodes.size(); n++) {
+        for (uint32_t in : nodes[n].ins) {
+            if (driver[in] >= 0) {
+                pending[n]++;
+                readers[driver[in]].push_back(n);
+            }
+        }
+    }
+    std::vector<uint32_t> order;
+    for (uint32_t n = 0; n < nodes.size(); n++) {
+        if (pending[n] == 0) {
+            order.push_back(n);
+        }
+    }
+    for (size_t i = 0; i < order.size(); i++) {
+        for (uint32_t r : readers[order[i]]) {
+            if (--pending[r] == 0) {
+                order.push_back(r);
+            }
+        }
+    }
+    if (order.size() != nodes.size()) {
+        throw std::runtime_error("Combinational loop: cannot levelize the netlist");
+    }
+
+    for (uint32_t n : order) {
+        const Node& node = nodes[n];
+        program.code.push_back({node.op, node_out[n], (uint32_t)program.operands.size(), (uint32_t)node.ins.size()});
+        program.operands.insert(program.operands.end(), node.ins.begin(), node.ins.end());
+    }
+    return program;
+}
+
+void EquivalenceChecker::Program::evaluate(uint64_t* words) const {
+    for (const auto& c : constants) {
+        std::fill(words + c.first * WORDS, words + (c.first + 1) * WORDS, c.second);
+    }
+    for (const Instr& instr : code) {
+        uint64_t* out = words + (size_t)instr.out * WORDS;
+        const uint32_t* in = operands.data() + instr.first;
+        const uint64_t* x = words + (size_t)in[0] * WORDS;
+        switch (instr.op) {
+            case NOT:
+                for (size_t w = 0; w < WORDS; w++) out[w] = ~x[w];
+                break;
+            case BUF:
+                for (size_t w = 0; w < WORDS; w++) out[w] = x[w];
+                break;
+            case AND: {
+                const uint64_t* y = words + (size_t)in[1] * WORDS;
+                for (size_t w = 0; w < WORDS; w++) out[w] = x[w] & y[w];
+                for (uint32_t k = 2; k < instr.count; k++) {
+                    const uint64_t* z = words + (size_t)in[k] * WORDS;
+                    for (size_t w = 0; w < WORDS; w++) out[w] &= z[w];
+                }
+                break;
+            }
+            case OR: {
+                const uint64_t* y = words + (size_t)in[1] * WORDS;
+                for (size_t w = 0; w < WORDS; w++) out[w] = x[w] | y[w];
+                for (uint32_t k = 2; k < instr.count; k++) {
+                    const uint64_t* z = words + (size_t)in[k] * WORDS;
+                    for (size_t w = 0; w < WORDS; w++) out[w] |= z[w];
+                }
+                break;
+            }
+            case XOR: {
+                const uint64_t* y = words + (size_t)in[1] * WORDS;
+                for (size_t w = 0; w < WORDS; w++) out[w] = x[w] ^ y[w];
+                for (uint32_t k = 2; k < instr.count; k++) {
+                    const uint64_t* z = words + (size_t)in[k] * WORDS;
+                    for (size_t w = 0; w < WORDS; w++) out[w] ^= z[w];
+                }
+                break;
+            }
+        }
+    }
+}
+
+EquivalenceChecker::EquivalenceChecker(Simulator& a, Simulator& b, const std::vector<std::string>& input_names,
+                                       const std::vector<std::string>& output_names,
+                                       const std::string& prefix_a, const std::string& prefix_b)
+    : inputs(input_names), outputs(output_names) {
+    std::vector<Signal*> nets;
+    std::unordered_set<const Signal*> driven;
+    for (Component* component : a.get_components()) {
+        if (!component->is_sequential()) {
+            nets.clear();
+            component->get_fanout(nets);
+            driven.insert(nets.begin(), nets.end());
+        }
+    }
+    if (inputs.empty()) {
+        for (Signal* sig : a.get_signals()) {
+            if (!driven.count(sig) && !a.is_constant(sig) && !sig->get_observers().empty()) {
+                inputs.push_back(sig->get_name());
+            }
+        }
+    }
+    if (outputs.empty()) {
+        for (Signal* sig : a.get_signals()) {
+            if (driven.count(sig) && sig->get_observers().empty()) {
+                outputs.push_back(sig->get_name());
+            }
+        }
+    }
+
+    // Register cut points: outputs become inputs, fan-in nets are compared
+    std::unordered_set<std::string> input_set(inputs.begin(), inputs.end());
+    std::unordered_set<std::string> output_set(outputs.begin(), outputs.end());
+    for (Component* component : a.get_components()) {
+        if (!component->is_sequential()) {
+            continue;
+        }
+        nets.clear();
+        component->get_fanout(nets);
+        for (Signal* sig : nets) {
+            if (input_set.insert(sig->get_name()).second) {
+                inputs.push_back(sig->get_name());
+            }
+        }
+    }
+    for (Component* component : a.get_components()) {
+        if (!component->is_sequential()) {
+            continue;
+        }
+        nets.clear();
+        component->get_fanin(nets);
+        for (Signal* sig : nets) {
+            if (!input_set.count(sig->get_name()) && output_set.insert(sig->get_name()).second) {
+                outputs.push_back(sig->get_name());
+            }
+        }
+    }
+
+    std::vector<Signal*> ins_a, ins_b, outs_a, outs_b;
+    for (const std::string& name : inputs) {
+        ins_a.push_back(lookup(a, name, "first"));
+        ins_b.push_back(lookup(b, rename(name, prefix_a, prefix_b), "second"));
+    }
+    for (const std::string& name : outputs) {
+        outs_a.push_back(lookup(a, name, "first"));
+        outs_b.push_back(lookup(b, rename(name, prefix_a, prefix_b), "second"));
+    }
+    program_a = compile(a, ins_a, outs_a);
+    program_b = compile(b, ins_b, outs_b);
+}
+
+// ===== Running =====
+
+void EquivalenceChecker::generate(const EquivOptions& options, const std::vector<uint16_t>& bias, bool exhaustive,
+                                  uint64_t block, uint64_t* words) const {
+    static const uint64_t LANE_BITS[6] = {0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+                                          0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL};
+    for (size_t i = 0; i < inputs.size(); i++) {
+        for (size_t w = 0; w < WORDS; w++) {
+            uint64_t& word = words[i * WORDS + w];
+            if (exhaustive) {
+                // Bit i of the vector index: lane bits below 64, the word's index above
+                uint64_t base = block * BLOCK_VECTORS + w * 64;
+                word = i < 6 ? LANE_BITS[i] : ((base >> i) & 1 ? ~0ULL : 0);
+                continue;
+            }
+            uint16_t k = bias[i];   // P(1) = k / 256
+            if (k == 0 || k == 256) {
+                word = k ? ~0ULL : 0;
+                continue;
+            }
+            // Fold random words from the lowest set bit of k up: each step
+            // ORs (bit set) or ANDs in a fair word, halving toward 0 or 1
+            uint64_t key = ((block * inputs.size() + i) * WORDS + w) * 8;
+            word = 0;
+            for (int bit = __builtin_ctz(k); bit < 8; bit++) {
+                uint64_t r = splitmix64(options.seed * 0xD1B54A32D192ED03ULL + key + bit);
+                word = (k >> bit) & 1 ? (word | r) : (word & r);
+            }
+        }
+    }
+}
+
+bool EquivalenceChecker::compare(const uint64_t* a, const uint64_t* b, uint64_t* diff) const {
+    std::fill(diff, diff + WORDS, 0);
+    for (size_t o = 0; o < outputs.size(); o++) {
+        const uint64_t* x = a + (size_t)program_a.output_slots[o] * WORDS;
+        const uint64_t* y = b + (size_t)program_b.output_slots[o] * WORDS;
+        for (size_t w = 0; w < WORDS; w++) {
+            diff[w] |= x[w] ^ y[w];
+        }
+    }
+    uint64_t any = 0;
+    for (size_t w = 0; w < WORDS; w++) {
+        any |= diff[w];
+    }
+    return any != 0;
+}
+
+// One vector (in every lane)
+bool EquivalenceChecker::fails(const std::vector<uint8_t>& values, std::vector<uint64_t>& a,
+                               std::vector<uint64_t>& b) const {
+    for (size_t i = 0; i < inputs.size(); i++) {
+        uint64_t word = values[i] ? ~0ULL : 0;
+        std::fill(a.begin() + (size_t)program_a.input_slots[i] * WORDS,
+                  a.begin() + (size_t)(program_a.input_slots[i] + 1) * WORDS, word);
+        std::fill(b.begin() + (size_t)program_b.input_slots[i] * WORDS,
+                  b.begin() + (size_t)(program_b.input_slots[i] + 1) * WORDS, word);
+    }
+    program_a.evaluate(a.data());
+    program_b.evaluate(b.data());
+    uint64_t diff[WORDS];
+    return compare(a.data(), b.data(), diff);
+}
+
+// Lower free inputs to 0 one at a time while the outputs still differ
+// (until no input can be lowered), then mark the inputs the difference depends on
+Counterexample EquivalenceChecker::reduce(uint64_t vector, std::vector<uint8_t> values,
+                                          const std::vector<uint16_t>& bias) const {
+    std::vector<uint64_t> a(program_a.slots * WORDS);
+    std::vector<uint64_t> b(program_b.slots * WORDS);
+    for (bool lowered = true; lowered;) {
+        lowered = false;
+        for (size_t i = 0; i < inputs.size(); i++) {
+            if (values[i] && bias[i] != 256) {
+                values[i] = 0;
+                if (fails(values, a, b)) {
+                    lowered = true;
+                } else {
+                    values[i] = 1;
+                }
+            }
+        }
+    }
+
+    Counterexample cex;
+    cex.vector = vector;
+    cex.inputs = inputs;
+    for (size_t i = 0; i < inputs.size(); i++) {
+        values[i] ^= 1;
+        cex.care.push_back(!fails(values, a, b));
+        values[i] ^= 1;
+    }
+    cex.values = values;
+    fails(values, a, b);
+    for (size_t o = 0; o < outputs.size(); o++) {
+        uint8_t x = a[(size_t)program_a.output_slots[o] * WORDS] & 1;
+        uint8_t y = b[(size_t)program_b.output_slots[o] * WORDS] & 1;
+        if (x != y) {
+            cex.outputs.push_back(outputs[o]);
+            cex.values_a.push_back(x);
+            cex.values_b.push_back(y);
+        }
+    }
+    return cex;
+}
+
+EquivResult EquivalenceChecker::run(const EquivOptions& options) const {
+    auto start = std::chrono::steady_clock::now();
+    EquivResult result;
+
+    std::vector<uint16_t> bias(inputs.size(), 128);
+    bool constrained = false;
+    for (size_t i = 0; i < inputs.size(); i++) {
+        for (const auto& c : options.constraints) {
+            const std::string& pattern = c.first;
+            bool match = !pattern.empty() && pattern.back() == '*'
+                             ? inputs[i].compare(0, pattern.size() - 1, pattern, 0, pattern.size() - 1) == 0
+                             : inputs[i] == pattern;
+            if (match) {
+                bias[i] = (uint16_t)std::lround(std::min(std::max(c.second, 0.0), 1.0) * 256);
+                constrained = true;
+                break;
+            }
+        }
+    }
+    uint64_t budget = std::max<uint64_t>(options.vectors, 1);
+    uint64_t blocks = (budget + BLOCK_VECTORS - 1) / BLOCK_VECTORS;
+    bool exhaustive = options.exhaustive && !constrained && inputs.size() < 64 &&
+                      (1ULL << inputs.size()) <= blocks * BLOCK_VECTORS;
+    if (exhaustive) {
+        blocks = ((1ULL << inputs.size()) + BLOCK_VECTORS - 1) / BLOCK_VECTORS;
+    }
+
+    size_t threads = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    threads = std::max<size_t>(1, std::min<uint64_t>(threads, blocks));
+    std::atomic<uint64_t> next_block{0};
+    std::atomic<uint64_t> failing_block{UINT64_MAX};
+    std::atomic<uint64_t> blocks_run{0};
+
+    // Blocks are taken in order, so every block below the lowest failing
+    // one has been run when the workers stop
+    auto worker = [&]() {
+        std::vector<uint64_t> in(inputs.size() * WORDS);
+        std::vector<uint64_t> a(program_a.slots * WORDS);
+        std::vector<uint64_t> b(program_b.slots * WORDS);
+        uint64_t diff[WORDS];
+        uint64_t run = 0;
+        while (true) {
+            uint64_t block = next_block.fetch_add(1, std::memory_order_relaxed);
+            if (block >= blocks || block > failing_block.load(std::memory_order_relaxed)) {
+                break;
+            }
+            generate(options, bias, exhaustive, block, in.data());
+            for (size_t i = 0; i < inputs.size(); i++) {
+                std::copy(in.begin() + i * WORDS, in.begin() + (i + 1) * WORDS,
+                          a.begin() + (size_t)program_a.input_slots[i] * WORDS);
+                std::copy(in.begin() + i * WORDS, in.begin() + (i + 1) * WORDS,
+                          b.begin() + (size_t)program_b.input_slots[i] * WORDS);
+            }
+            program_a.evaluate(a.data());
+            program_b.evaluate(b.data());
+            run++;
+            if (compare(a.data(), b.data(), diff)) {
+                uint64_t seen = failing_block.load(std::memory_order_relaxed);
+                while (block < seen && !failing_block.compare_exchange_weak(seen, block)) {
+                }
+            }
+        }
+        blocks_run.fetch_add(run, std::memory_order_relaxed);
+    };
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < threads; t++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& t : pool) {
+        t.join();
+    }
+
+    result.threads = threads;
+    result.exhaustive = exhaustive && failing_block == UINT64_MAX;
+    result.vectors = blocks_run * BLOCK_VECTORS;
+    if (failing_block != UINT64_MAX) {
+        // Re-run the failing block for its first differing lane
+        uint64_t block = failing_block;
+        std::vector<uint64_t> in(inputs.size() * WORDS);
+        std::vector<uint64_t> a(program_a.slots * WORDS);
+        std::vector<uint64_t> b(program_b.slots * WORDS);
+        uint64_t diff[WORDS];
+        generate(options, bias, exhaustive, block, in.data());
+        for (size_t i = 0; i < inputs.size(); i++) {
+            std::copy(in.begin() + i * WORDS, in.begin() + (i + 1) * WORDS,
+                      a.begin() + (size_t)program_a.input_slots[i] * WORDS);
+            std::copy(in.begin() + i * WORDS, in.begin() + (i + 1) * WORDS,
+                      b.begin() + (size_t)program_b.input_slots[i] * WORDS);
+        }
+        program_a.evaluate(a.data());
+        program_b.evaluate(b.data());
+        compare(a.data(), b.data(), diff);
+        size_t w = 0;
+        while (diff[w] == 0) {
+            w++;
+        }
+        int lane = __builtin_ctzll(diff[w]);
+        std::vector<uint8_t> values;
+        for (size_t i = 0; i < inputs.size(); i++) {
+            values.push_back((in[i * WORDS + w] >> lane) & 1);
+        }
+        result.equivalent = false;
+        result.counterexample = reduce(block * BLOCK_VECTORS + w * 64 + lane, values, bias);
+    }
+    result.gate_evaluations = (program_a.code.size() + program_b.code.size()) * result.vectors;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+void Counterexample::apply(Simulator& sim, uint64_t time, const std::string& from_prefix,
+                           const std::string& to_prefix) const {
+    std::vector<Event> events;
+    for (size_t i = 0; i < inputs.size(); i++) {
+        Signal* sig = lookup(sim, rename(inputs[i], from_prefix, to_prefix), "given");
+        events.push_back(Event(time, sig->get_id(), values[i]));
+    }
+    sim.schedule_batch(events);
+}
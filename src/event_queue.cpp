@@ -1,31 +1,378 @@
 #include "event_queue.h"
+#include <algorithm>
 #include <stdexcept>
 
+constexpr uint64_t NO_TIME = UINT64_MAX;  // `now` before the first delta cycle
 
-void EventQueue::schedule(const Event& e) {
-    pq.push(e);
+// ===== EventPool =====
+
+EventPool::Chunk* EventPool::allocate(uint64_t time) {
+    Chunk* chunk;
+    if (!free_chunks.empty()) {
+        chunk = free_chunks.back();
+        free_chunks.pop_back();
+    } else {
+        chunks.emplace_back(new Chunk);
+        chunk = chunks.back().get();
+        chunk->id = chunks.size() - 1;
+    }
+    chunk->time = time;
+    chunk->next = nullptr;
+    chunk->begin = 0;
+    chunk->end = 0;
+    return chunk;
+}
+
+void EventPool::release(Chunk* chunk) {
+    chunk->time = NO_TIME;
+    free_chunks.push_back(chunk);
+}
+
+EventPool::Chunk* EventPool::find(uint32_t address) const {
+    uint32_t id = address / CHUNK_EVENTS;
+    return id < chunks.size() ? chunks[id].get() : nullptr;
+}
+
+size_t EventPool::memory_bytes() const {
+    return chunks.size() * sizeof(Chunk) +
+           chunks.capacity() * sizeof(chunks[0]) +
+           free_chunks.capacity() * sizeof(Chunk*);
+}
+
+// ===== FIFOs =====
+
+inline uint32_t EventQueue::fifo_push(Fifo& fifo, uint64_t time, const Event& e) {
+    EventPool::Chunk* chunk = fifo.tail;
+    if (!chunk || chunk->end == EventPool::CHUNK_EVENTS) {
+        chunk = pool.allocate(time);
+        if (fifo.tail) {
+            fifo.tail->next = chunk;
+        } else {
+            fifo.head = chunk;
+        }
+        fifo.tail = chunk;
+    }
+    chunk->events[chunk->end] = {e.signal_id, e.new_value};
+    fifo.count++;
+    return EventPool::address(chunk, chunk->end++);
+}
+
+inline PackedEvent EventQueue::fifo_pop(Fifo& fifo) {
+    EventPool::Chunk* chunk = fifo.head;
+    PackedEvent e = chunk->events[chunk->begin++];
+    fifo.count--;
+    if (chunk->begin == chunk->end) {
+        if (!chunk->next) {
+            chunk->begin = chunk->end = 0;  // Drained: keep the last chunk for the next events
+        } else {
+            fifo.head = chunk->next;
+            pool.release(chunk);
+        }
+    }
+    return e;
+}
+
+void EventQueue::fifo_retime(Fifo& fifo, uint64_t time) {
+    if (fifo.head) {
+        fifo.head->time = time;  // Drained, so at most one chunk
+    }
+}
+
+void EventQueue::fifo_clear(Fifo& fifo) {
+    for (EventPool::Chunk* chunk = fifo.head; chunk;) {
+        EventPool::Chunk* next = chunk->next;
+        pool.release(chunk);
+        chunk = next;
+    }
+    fifo = Fifo();
+}
+
+template <typename Fn>
+void EventQueue::fifo_for_each(const Fifo& fifo, Fn fn) const {
+    for (const EventPool::Chunk* chunk = fifo.head; chunk; chunk = chunk->next) {
+        for (uint32_t i = chunk->begin; i < chunk->end; i++) {
+            fn(chunk->events[i]);
+        }
+    }
+}
+
+// ===== Heap =====
+
+void EventQueue::sift_up(size_t i) {
+    HeapEntry entry = heap_at(i);
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (!entry.before(heap_at(parent))) {
+            break;
+        }
+        heap_at(i) = heap_at(parent);
+        i = parent;
+    }
+    heap_at(i) = entry;
+}
+
+void EventQueue::sift_down(size_t i) {
+    HeapEntry entry = heap_at(i);
+    while (true) {
+        size_t child = 2 * i + 1;
+        if (child >= heap_size) {
+            break;
+        }
+        if (child + 1 < heap_size && heap_at(child + 1).before(heap_at(child))) {
+            child++;
+        }
+        if (!heap_at(child).before(entry)) {
+            break;
+        }
+        heap_at(i) = heap_at(child);
+        i = child;
+    }
+    heap_at(i) = entry;
+}
+
+void EventQueue::push_heap(uint64_t time, const PackedEvent& e) {
+    if (heap_size == heap_chunks.size() * HEAP_CHUNK) {
+        heap_chunks.emplace_back(new HeapEntry[HEAP_CHUNK]);
+    }
+    heap_at(heap_size) = {time, heap_sequence++, e};
+    heap_size++;
+    if (batch_start == SIZE_MAX) {
+        sift_up(heap_size - 1);
+    }
+    if (STATS_COMPILED_IN) {
+        heap_count++;
+    }
+}
+
+EventQueue::HeapEntry EventQueue::pop_heap() {
+    HeapEntry top = heap_at(0);
+    heap_size--;
+    if (heap_size > 0) {
+        heap_at(0) = heap_at(heap_size);
+        sift_down(0);
+    }
+    return top;
+}
+
+// ===== Queue =====
+
+void EventQueue::schedule(const Event& e, PendingSlot* slot) {
+    if (STATS_COMPILED_IN) {
+        scheduled_count++;
+    }
+    if (slot && slot->time == e.time) {
+        // Still queued if its chunk holds events for this time, the entry is
+        // unconsumed and it is for the same net
+        EventPool::Chunk* chunk = pool.find(slot->position);
+        uint32_t offset = slot->position % EventPool::CHUNK_EVENTS;
+        if (chunk && chunk->time == e.time && offset >= chunk->begin && offset < chunk->end &&
+            chunk->events[offset].signal_id == e.signal_id) {
+            chunk->events[offset].new_value = e.new_value;
+            if (STATS_COMPILED_IN) {
+                coalesced_count++;
+            }
+            return;
+        }
+    }
+
+    Fifo* fifo = nullptr;
+    if (e.time == now) {
+        fifo = &delta;
+    } else if ((e.time > now || now == NO_TIME) && (near.count == 0 || e.time == near_time)) {
+        if (near.count == 0) {
+            near_time = e.time;
+            fifo_retime(near, e.time);
+        }
+        fifo = &near;
+    } else if ((e.time > now || now == NO_TIME) && e.time < near_time) {
+        // Sooner than the near FIFO's time: its events move to the heap
+        while (near.count > 0) {
+            push_heap(near_time, fifo_pop(near));
+        }
+        near_time = e.time;
+        fifo_retime(near, e.time);
+        fifo = &near;
+    }
+    if (fifo) {
+        uint32_t position = fifo_push(*fifo, e.time, e);
+        if (slot) {
+            *slot = {e.time, position};
+        }
+    } else {
+        push_heap(e.time, {e.signal_id, e.new_value});
+    }
+    if (STATS_COMPILED_IN) {
+        peak_size = std::max(peak_size, size());
+    }
+}
+
+void EventQueue::begin_batch() {
+    batch_start = heap_size;
+}
+
+void EventQueue::end_batch() {
+    if (batch_start == SIZE_MAX) {
+        return;  // No batch open
+    }
+    size_t start = batch_start;
+    batch_start = SIZE_MAX;
+    if (heap_size - start > start) {
+        for (size_t i = heap_size / 2; i-- > 0;) {  // O(n) heap construction
+            sift_down(i);
+        }
+    } else {
+        for (size_t i = start; i < heap_size; i++) {
+            sift_up(i);
+        }
+    }
+}
+
+void EventQueue::advance() {
+    uint64_t t = near.count == 0 ? heap_at(0).time : near_time;
+    if (heap_size > 0 && heap_at(0).time < t) {
+        t = heap_at(0).time;
+    }
+    bool from_near = near.count > 0 && near_time == t;
+    bool from_heap = heap_size > 0 && heap_at(0).time == t;
+    if (from_near && !from_heap) {
+        fifo_clear(delta);
+        std::swap(delta, near);  // The chunks change hands; their time is already t
+    } else {
+        // Heap events at t were all scheduled before the near FIFO's: the
+        // FIFO only takes t's events once it holds t, and gives them up to
+        // the heap (as newer entries) if it is retimed
+        fifo_retime(delta, t);
+        while (heap_size > 0 && heap_at(0).time == t) {
+            HeapEntry entry = pop_heap();
+            fifo_push(delta, t, Event(t, entry.event.signal_id, entry.event.new_value));
+        }
+        if (from_near) {
+            // The near chunks follow unmoved, so PendingSlots into them stay valid
+            delta.tail->next = near.head;
+            delta.tail = near.tail;
+            delta.count += near.count;
+            near = Fifo();
+        }
+    }
+    now = t;
+    delta_index = 0;
+    started = true;
+}
+
+size_t EventQueue::begin_delta() {
+    if (delta.count == 0) {
+        if (near.count == 0 && heap_size == 0) {
+            return 0;
+        }
+        advance();
+    } else if (started) {
+        delta_index++;
+    } else {
+        started = true;
+    }
+    return delta.count;
 }
 
 Event EventQueue::pop_next() {
-    if (pq.empty()) {
-        throw std::runtime_error("EventQueue is empty");
+    if (delta.count == 0) {
+        if (near.count == 0 && heap_size == 0) {
+            throw std::runtime_error("EventQueue is empty");
+        }
+        advance();
     }
-    Event next_event = pq.top();
-    pq.pop();
-    return next_event;
+    PackedEvent e = fifo_pop(delta);
+    return Event(now, e.signal_id, e.new_value);
 }
 
 bool EventQueue::empty() const {
-    return pq.empty();
+    return delta.count == 0 && near.count == 0 && heap_size == 0;
 }
 
 size_t EventQueue::size() const {
-    return pq.size();
+    return delta.count + near.count + heap_size;
 }
 
 uint64_t EventQueue::next_time() const {
-    if (pq.empty()) {
+    if (delta.count > 0) {
+        return now;
+    }
+    if (near.count == 0 && heap_size == 0) {
         throw std::runtime_error("EventQueue is empty");
     }
-    return pq.top().time;
+    if (heap_size == 0 || (near.count > 0 && near_time < heap_at(0).time)) {
+        return near_time;
+    }
+    return heap_at(0).time;
+}
+
+std::vector<Event> EventQueue::snapshot() const {
+    std::vector<Event> events;
+    events.reserve(size());
+    fifo_for_each(delta, [&](const PackedEvent& e) { events.emplace_back(now, e.signal_id, e.new_value); });
+    // Heap entries in pop order, then the near FIFO after those at its time
+    std::vector<HeapEntry> entries;
+    entries.reserve(heap_size);
+    for (size_t i = 0; i < heap_size; i++) {
+        entries.push_back(heap_at(i));
+    }
+    std::sort(entries.begin(), entries.end(), [](const HeapEntry& a, const HeapEntry& b) { return a.before(b); });
+    bool near_done = near.count == 0;
+    for (const HeapEntry& entry : entries) {
+        if (!near_done && entry.time > near_time) {
+            fifo_for_each(near, [&](const PackedEvent& e) { events.emplace_back(near_time, e.signal_id, e.new_value); });
+            near_done = true;
+        }
+        events.emplace_back(entry.time, entry.event.signal_id, entry.event.new_value);
+    }
+    if (!near_done) {
+        fifo_for_each(near, [&](const PackedEvent& e) { events.emplace_back(near_time, e.signal_id, e.new_value); });
+    }
+    return events;
+}
+
+void EventQueue::restore(const std::vector<Event>& events) {
+    fifo_clear(delta);
+    fifo_clear(near);
+    heap_size = 0;
+    for (const Event& e : events) {
+        if (heap_size == heap_chunks.size() * HEAP_CHUNK) {
+            heap_chunks.emplace_back(new HeapEntry[HEAP_CHUNK]);
+        }
+        heap_at(heap_size++) = {e.time, heap_sequence++, {e.signal_id, e.new_value}};
+    }
+    for (size_t i = heap_size / 2; i-- > 0;) {
+        sift_down(i);
+    }
+    now = NO_TIME;
+    delta_index = 0;
+    started = false;
+}
+
+uint64_t EventQueue::get_scheduled_count() const {
+    return scheduled_count;
+}
+
+uint64_t EventQueue::get_heap_count() const {
+    return heap_count;
+}
+
+uint64_t EventQueue::get_coalesced_count() const {
+    return coalesced_count;
+}
+
+size_t EventQueue::get_peak_size() const {
+    return peak_size;
+}
+
+void EventQueue::reset_counters() {
+    scheduled_count = 0;
+    heap_count = 0;
+    coalesced_count = 0;
+    peak_size = size();
+}
+
+size_t EventQueue::memory_bytes() const {
+    return sizeof(EventQueue) + pool.memory_bytes() +
+           heap_chunks.size() * HEAP_CHUNK * sizeof(HeapEntry) +
+           heap_chunks.capacity() * sizeof(heap_chunks[0]);
 }
@@ -1,12 +1,17 @@
 #include "gate.h"
 #include "event.h"
 #include "simulator.h"
+#include "logic.h"
+#include <algorithm>
 #include <stdexcept>
 
 uint32_t ANDGate::id_counter = 0;
 uint32_t ORGate::id_counter = 0;
 uint32_t NOTGate::id_counter = 0;
 uint32_t XORGate::id_counter = 0;
+uint32_t BUFGate::id_counter = 0;
+uint32_t TriBuf::id_counter = 0;
+uint32_t Resolver::id_counter = 0;
 
 Gate::Gate(std::string gate_id, uint64_t delay) {
     id = gate_id;
@@ -16,10 +21,59 @@ Gate::Gate(std::string gate_id, uint64_t delay) {
 void Gate::connect_input(Signal* sig) {
     inputs.push_back(sig);
      sig->attach_observer(this);
+    revision++;
 }
 
 void Gate::connect_output(Signal* sig) {
     output = sig;
+    revision++;
+}
+
+void Gate::annotate_pin(size_t pin, uint32_t delay_id) {
+    if (pin >= inputs.size()) {
+        throw std::out_of_range("Gate " + id + " has no input pin " + std::to_string(pin));
+    }
+    if (pin_delays.size() < inputs.size()) {
+        pin_delays.resize(inputs.size(), NO_DELAY);
+    }
+    pin_delays[pin] = delay_id;
+    revision++;
+}
+
+uint32_t Gate::get_pin_delay(size_t pin) const {
+    return pin < pin_delays.size() ? pin_delays[pin] : NO_DELAY;
+}
+
+bool Gate::is_annotated() const {
+    return !pin_delays.empty();
+}
+
+void Gate::clear_annotation() {
+    pin_delays.clear();
+    revision++;
+}
+
+uint64_t Gate::annotated_delay(Simulator* sim, uint8_t new_value) const {
+    const DelayTable& table = sim->get_delay_table();
+    Signal* trigger = sim->get_trigger();
+    for (size_t pin = 0; pin < inputs.size(); pin++) {
+        if (inputs[pin] == trigger) {
+            uint32_t delay_id = pin < pin_delays.size() ? pin_delays[pin] : NO_DELAY;
+            return delay_id == NO_DELAY ? propagation_delay : table[delay_id].for_value(new_value);
+        }
+    }
+
+    // Not triggered through an input (e.g. an explicit evaluate): slowest pin
+    uint64_t worst = 0;
+    for (size_t pin = 0; pin < inputs.size(); pin++) {
+        uint32_t delay_id = pin < pin_delays.size() ? pin_delays[pin] : NO_DELAY;
+        worst = std::max(worst, delay_id == NO_DELAY ? propagation_delay : table[delay_id].for_value(new_value));
+    }
+    return worst;
+}
+
+void Gate::drive_output(Simulator* sim, uint64_t current_time, uint8_t new_value) {
+    sim->schedule_event(Event(current_time + delay_for(sim, new_value), output->get_id(), new_value));
 }
 
 ANDGate::ANDGate(uint64_t delay) 
@@ -31,20 +85,12 @@ void ANDGate::evaluate(Simulator* sim, uint64_t current_time) {
     
     uint8_t result = 1; // Start with true
     for (const auto& input : inputs) {
-        if (input->get_value() == 0) {
-            result = 0; // AND with false yields false
-            break;
-        } else if (input->get_value() == 2) {
-            result = 2; // Unknown if any input is unknown
-        }
+        result = logic::and2(result, input->get_value()); // 0 dominates, X/Z give X
     }
     
     if (result != output->get_value()) {
-        // Schedule event in simulator
-        sim->schedule_event(Event(current_time + propagation_delay, output->get_id(), result));
+        drive_output(sim, current_time, result);
     }
-
-    
 }
 
 ORGate::ORGate(uint64_t delay) : Gate("OR" + std::to_string(id_counter++), delay) {
@@ -55,17 +101,10 @@ void ORGate::evaluate(Simulator* sim, uint64_t current_time) {
 
     uint8_t result = 0; // Start with false
     for (const auto& input : inputs) {
-        if (input->get_value() == 1) {
-            result = 1; // OR with true yields true
-            break;
-        } else if (input->get_value() == 2) {
-            result = 2; // Unknown if any input is unknown
-            // TODO: do real simulator evaluate 1 OR X to 1 ?
-        }
+        result = logic::or2(result, input->get_value()); // 1 dominates (1 OR X = 1)
     }
     if (result != output->get_value()) {
-        // Schedule event in simulator
-        sim->schedule_event(Event(current_time + propagation_delay, output->get_id(), result));
+        drive_output(sim, current_time, result);
     }
 }
 
@@ -75,12 +114,23 @@ NOTGate::NOTGate(uint64_t delay) : Gate("NOT" + std::to_string(id_counter++), de
 void NOTGate::evaluate(Simulator* sim, uint64_t current_time) {
     if (inputs.empty()) return;
 
-    uint8_t input_value = inputs[0]->get_value();
-    uint8_t result = (input_value == 0) ? 1 : 0; // NOT operation
+    uint8_t result = logic::not1(inputs[0]->get_value()); // NOT X (or Z) is X
 
     if (result != output->get_value()) {
-        // Schedule event in simulator
-        sim->schedule_event(Event(current_time + propagation_delay, output->get_id(), result));
+        drive_output(sim, current_time, result);
+    }
+}
+
+BUFGate::BUFGate(uint64_t delay) : Gate("BUF" + std::to_string(id_counter++), delay) {
+}
+
+void BUFGate::evaluate(Simulator* sim, uint64_t current_time) {
+    if (inputs.empty()) return;
+
+    uint8_t result = logic::buf1(inputs[0]->get_value()); // Z reads as X
+
+    if (result != output->get_value()) {
+        drive_output(sim, current_time, result);
     }
 }
 
@@ -90,26 +140,41 @@ XORGate::XORGate(uint64_t delay): Gate("XOR" + std::to_string(id_counter++), del
 void XORGate::evaluate(Simulator* sim, uint64_t current_time){
    if (inputs.size() < 2) return;
 
-    // Check for unknown values first
-    for (const auto& input: inputs){
-        if(input->get_value() == 2){
-            if(output->get_value() != 2){
-                sim->schedule_event(Event(
-                    current_time + propagation_delay,
-                    output->get_id(),
-                    2
-                ));
-            }
-        }
+    uint8_t result = 0;
+    for (const auto& input : inputs) {
+        result = logic::xor2(result, input->get_value()); // Any X/Z gives X
     }
 
-    uint8_t result = 0;
-    for(const auto& input: inputs){
-        result ^= input->get_value();
+    if (result != output->get_value()) {
+        drive_output(sim, current_time, result);
+    }
+}
+
+TriBuf::TriBuf(uint64_t delay) : Gate("TRIBUF" + std::to_string(id_counter++), delay) {
+}
+
+void TriBuf::evaluate(Simulator* sim, uint64_t current_time) {
+    if (inputs.size() < 2) return;
+
+    uint8_t result = logic::tri(inputs[1]->get_value(), inputs[0]->get_value());
+
+    if (result != output->get_value()) {
+        drive_output(sim, current_time, result);
+    }
+}
+
+Resolver::Resolver(uint64_t delay) : Gate("RES" + std::to_string(id_counter++), delay) {
+}
+
+void Resolver::evaluate(Simulator* sim, uint64_t current_time) {
+    if (inputs.empty()) return;
+
+    uint8_t result = logic::canonical(LOGIC_Z); // Undriven until a driver says otherwise
+    for (const auto& input : inputs) {
+        result = logic::resolve(result, input->get_value());
     }
 
     if (result != output->get_value()) {
-        // Schedule event in simulator
-        sim->schedule_event(Event(current_time + propagation_delay, output->get_id(), result));
+        drive_output(sim, current_time, result);
     }
 }
\ No newline at end of file
@@ -0,0 +1,502 @@
+#include "history.h"
+#include "simulator.h"
+#include "component.h"
+#include "signal.h"
+#include "logic.h"
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+// Detaches out-of-cone observers for the duration of a re-simulation
+class ObserverMask {
+public:
+    ObserverMask(const std::vector<Signal*>& signals, const std::vector<uint8_t>& in_cone) {
+        for (Signal* sig : signals) {
+            const std::vector<Component*>& observers = sig->get_observers();
+            bool mixed = std::any_of(observers.begin(), observers.end(),
+                                     [&](Component* c) { return !in_cone[c->get_index()]; });
+            if (!mixed) {
+                continue;
+            }
+            saved.emplace_back(sig, observers);
+            for (Component* c : saved.back().second) {
+                sig->detach_observer(c);
+            }
+            for (Component* c : saved.back().second) {
+                if (in_cone[c->get_index()]) {
+                    sig->attach_observer(c);
+                }
+            }
+        }
+    }
+
+    ~ObserverMask() {
+        for (auto& entry : saved) {
+            for (Component* c : entry.second) {
+                entry.first->detach_observer(c);
+            }
+            for (Component* c : entry.second) {
+                entry.first->attach_observer(c);
+            }
+        }
+    }
+
+private:
+    std::vector<std::pair<Signal*, std::vector<Component*>>> saved;
+};
+
+bool event_before(const Event& a, const Event& b) {
+    if (a.time != b.time) return a.time < b.time;
+    if (a.signal_id != b.signal_id) return a.signal_id < b.signal_id;
+    return a.new_value < b.new_value;
+}
+
+}  // namespace
+
+History::History(Simulator& simulator, uint64_t checkpoint_interval)
+    : sim(simulator), interval(checkpoint_interval), resim(nullptr) {
+    if (interval == 0) {
+        throw std::invalid_argument("History needs a non-zero checkpoint interval");
+    }
+    if (sim.history) {
+        throw std::logic_error("Simulator already has a history attached");
+    }
+    checkpoints.push_back(capture(sim.current_time));
+    next_checkpoint = (sim.current_time / interval + 1) * interval;
+    sim.history = this;
+}
+
+History::~History() {
+    if (sim.history == this) {
+        sim.history = nullptr;
+    }
+}
+
+History::Checkpoint History::capture(uint64_t time) const {
+    Checkpoint cp;
+    cp.time = time;
+    cp.log_position = log.size();
+    cp.values.reserve(sim.signals.size());
+    for (Signal* sig : sim.signals) {
+        cp.values.push_back(sig->get_value());
+    }
+    cp.state_offset.reserve(sim.components.size() + 1);
+    for (Component* component : sim.components) {
+        cp.state_offset.push_back(cp.state.size());
+        component->save_state(cp.state);
+    }
+    cp.state_offset.push_back(cp.state.size());
+    for (const Event& e : sim.event_queue.snapshot()) {
+        if (e.signal_id >= 0) {  // Process wake-ups cannot be restored
+            cp.pending.push_back(e);
+        }
+    }
+    return cp;
+}
+
+void History::checkpoint() {
+    uint64_t t = sim.event_queue.next_time();
+    uint64_t boundary = t - t % interval;
+    next_checkpoint = boundary + interval;
+    Checkpoint cp = capture(boundary);
+    if (!resim) {
+        checkpoints.push_back(std::move(cp));
+        return;
+    }
+
+    // Components and nets outside the cone were not simulated: take their
+    // state from the recording
+    const Checkpoint& recorded = recorded_at(boundary);
+    Checkpoint merged;
+    merged.time = boundary;
+    merged.log_position = cp.log_position;
+    merged.values = std::move(cp.values);
+    for (size_t i = 0; i + 1 < cp.state_offset.size(); i++) {
+        const Checkpoint& source = resim->in_cone[i] ? cp : recorded;
+        merged.state_offset.push_back(merged.state.size());
+        merged.state.insert(merged.state.end(), source.state.begin() + source.state_offset[i],
+                            source.state.begin() + source.state_offset[i + 1]);
+    }
+    merged.state_offset.push_back(merged.state.size());
+    for (const Event& e : cp.pending) {
+        if (resim->cone_nets.count(e.signal_id)) {
+            merged.pending.push_back(e);
+        }
+    }
+    for (const Event& e : recorded.pending) {
+        if (!resim->cone_nets.count(e.signal_id)) {
+            merged.pending.push_back(e);
+        }
+    }
+
+    if (resim->can_reconverge && boundary > resim->settled_after && matches(merged, recorded)) {
+        resim->reconverged = true;
+        resim->reconverged_at = boundary;
+    }
+    checkpoints.push_back(std::move(merged));
+}
+
+const History::Checkpoint& History::recorded_at(uint64_t time) const {
+    // No recorded event falls between a boundary and the next checkpoint
+    // after it, so that checkpoint (or the end state) is the state there
+    const std::vector<Checkpoint>& old = *resim->old_checkpoints;
+    auto it = std::lower_bound(old.begin() + resim->first_old, old.end(), time,
+                               [](const Checkpoint& cp, uint64_t t) { return cp.time < t; });
+    return it != old.end() ? *it : *resim->final_state;
+}
+
+bool History::matches(const Checkpoint& now, const Checkpoint& recorded) const {
+    if (now.values != recorded.values) {
+        return false;
+    }
+    for (size_t i = 0; i + 1 < now.state_offset.size(); i++) {
+        if (!resim->in_cone[i]) {
+            continue;
+        }
+        size_t length = now.state_offset[i + 1] - now.state_offset[i];
+        if (length != recorded.state_offset[i + 1] - recorded.state_offset[i] ||
+            !std::equal(now.state.begin() + now.state_offset[i], now.state.begin() + now.state_offset[i + 1],
+                        recorded.state.begin() + recorded.state_offset[i])) {
+            return false;
+        }
+    }
+    std::vector<Event> a, b;
+    for (const Event& e : now.pending) {
+        if (resim->cone_nets.count(e.signal_id)) a.push_back(e);
+    }
+    for (const Event& e : recorded.pending) {
+        if (resim->cone_nets.count(e.signal_id)) b.push_back(e);
+    }
+    if (a.size() != b.size()) {
+        return false;
+    }
+    std::sort(a.begin(), a.end(), event_before);
+    std::sort(b.begin(), b.end(), event_before);
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].time != b[i].time || a[i].signal_id != b[i].signal_id || a[i].new_value != b[i].new_value) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t History::checkpoint_bytes() const {
+    size_t total = 0;
+    for (const Checkpoint& cp : checkpoints) {
+        total += cp.values.size() + cp.state.size() + cp.state_offset.size() * sizeof(size_t) +
+                 cp.pending.size() * sizeof(Event);
+    }
+    return total;
+}
+
+// ===== Edits =====
+
+void History::change_input(Signal* net, uint64_t time, uint8_t value) {
+    if (!net) {
+        throw std::invalid_argument("Cannot edit a null input");
+    }
+    input_edits.push_back({(int)net->get_id(), time, value, false});
+}
+
+void History::remove_input(Signal* net, uint64_t time) {
+    if (!net) {
+        throw std::invalid_argument("Cannot edit a null input");
+    }
+    input_edits.push_back({(int)net->get_id(), time, 0, true});
+}
+
+void History::component_changed(Component* component) {
+    if (!component) {
+        throw std::invalid_argument("Cannot mark a null component as changed");
+    }
+    changed_components.push_back(component);
+}
+
+// ===== Re-simulation =====
+
+History::Report History::resimulate() {
+    Report report;
+    const std::vector<Signal*>& signals = sim.signals;
+    const std::vector<Component*>& components = sim.components;
+    if (checkpoints.front().values.size() != signals.size() ||
+        checkpoints.front().state_offset.size() != components.size() + 1) {
+        throw std::logic_error("Netlist changed size since recording started");
+    }
+
+    // Who reads and who drives each net
+    std::unordered_map<int, std::vector<Component*>> readers;
+    std::unordered_set<int> driven;
+    std::vector<Signal*> nets;
+    for (Component* component : components) {
+        nets.clear();
+        component->get_fanin(nets);
+        for (Signal* sig : nets) {
+            std::vector<Component*>& list = readers[sig->get_id()];
+            if (list.empty() || list.back() != component) {
+                list.push_back(component);
+            }
+        }
+        nets.clear();
+        component->get_fanout(nets);
+        for (Signal* sig : nets) {
+            driven.insert(sig->get_id());
+        }
+    }
+
+    // First divergent time
+    const uint64_t end_time = sim.current_time;
+    uint64_t diverged = UINT64_MAX;
+    uint64_t settled_after = 0;
+    for (const InputEdit& edit : input_edits) {
+        if (driven.count(edit.signal_id)) {
+            throw std::invalid_argument("Edited net " + sim.get_signal_by_id(edit.signal_id)->get_name() +
+                                        " is driven by a component; only inputs can be edited");
+        }
+        if (edit.time < checkpoints.front().time || edit.time > end_time) {
+            throw std::out_of_range("Input edit at t=" + std::to_string(edit.time) + " is outside the recording");
+        }
+        diverged = std::min(diverged, edit.time);
+        settled_after = std::max(settled_after, edit.time);
+    }
+    for (Component* component : changed_components) {
+        nets.clear();
+        component->get_fanin(nets);
+        std::unordered_set<int> fanin;
+        for (Signal* sig : nets) {
+            fanin.insert(sig->get_id());
+        }
+        for (const Change& change : log) {  // Evaluated first when an input first changed
+            if (fanin.count(change.signal_id)) {
+                diverged = std::min(diverged, change.time);
+                break;
+            }
+        }
+    }
+    if (diverged == UINT64_MAX) {
+        input_edits.clear();
+        changed_components.clear();
+        return report;  // Nothing the recording would have seen
+    }
+
+    // Fan-out cone of the edits
+    Resim state;
+    state.in_cone.assign(components.size(), 0);
+    std::vector<Component*> work;
+    auto add = [&](Component* component) {
+        if (!state.in_cone[component->get_index()]) {
+            state.in_cone[component->get_index()] = 1;
+            work.push_back(component);
+        }
+    };
+    for (const InputEdit& edit : input_edits) {
+        for (Component* reader : readers[edit.signal_id]) {
+            add(reader);
+        }
+    }
+    for (Component* component : changed_components) {
+        add(component);
+    }
+    while (!work.empty()) {
+        Component* component = work.back();
+        work.pop_back();
+        report.cone_components++;
+        nets.clear();
+        component->get_fanout(nets);
+        for (Signal* sig : nets) {
+            if (state.cone_nets.insert(sig->get_id()).second) {
+                for (Component* reader : readers[sig->get_id()]) {
+                    add(reader);
+                }
+            }
+        }
+    }
+
+    // Restart from the last checkpoint at or before the divergence
+    size_t k = checkpoints.size() - 1;
+    while (k > 0 && checkpoints[k].time > diverged) {
+        k--;
+    }
+    Checkpoint final_state = capture(end_time);
+    std::vector<Checkpoint> old_checkpoints = std::move(checkpoints);
+    checkpoints.clear();
+    for (size_t i = 0; i <= k; i++) {
+        checkpoints.push_back(std::move(old_checkpoints[i]));
+    }
+    const Checkpoint& start = checkpoints.back();
+    std::vector<Change> old_log = std::move(log);
+    log.assign(old_log.begin(), old_log.begin() + start.log_position);
+    uint64_t saved_next_checkpoint = next_checkpoint;
+
+    state.old_checkpoints = &old_checkpoints;
+    state.first_old = k + 1;
+    state.final_state = &final_state;
+    state.settled_after = settled_after;
+    state.can_reconverge = changed_components.empty();
+    state.reconverged = false;
+    state.reconverged_at = 0;
+    report.diverged_at = diverged;
+    report.restarted_at = start.time;
+
+    // Everything outside the cone replays its recorded (or edited) changes
+    std::vector<Change> replay;
+    for (size_t i = start.log_position; i < old_log.size(); i++) {
+        const Change& change = old_log[i];
+        if (state.cone_nets.count(change.signal_id)) {
+            continue;
+        }
+        bool removed = false;
+        for (const InputEdit& edit : input_edits) {
+            removed |= edit.remove && edit.signal_id == change.signal_id && edit.time == change.time;
+        }
+        if (!removed) {
+            replay.push_back(change);
+        }
+    }
+    for (const InputEdit& edit : input_edits) {
+        if (!edit.remove) {
+            replay.push_back({edit.time, edit.signal_id, edit.value});
+        }
+    }
+    std::stable_sort(replay.begin(), replay.end(),
+                     [](const Change& a, const Change& b) { return a.time < b.time; });
+    input_edits.clear();
+    changed_components.clear();
+
+    // Restore the checkpoint for the cone; other components stay untouched
+    for (size_t i = 0; i < signals.size(); i++) {
+        signals[i]->set_value(start.values[i]);
+    }
+    for (size_t i = 0; i < components.size(); i++) {
+        if (state.in_cone[i]) {
+            const uint8_t* p = start.state.data() + start.state_offset[i];
+            components[i]->restore_state(p);
+        }
+    }
+    std::vector<Event> pending;
+    for (const Event& e : start.pending) {
+        if (state.cone_nets.count(e.signal_id)) {
+            pending.push_back(e);
+        }
+    }
+    sim.event_queue.restore(pending);
+    sim.current_time = start.time;
+    next_checkpoint = (start.time / interval + 1) * interval;
+
+    uint64_t events_before = sim.events_processed;
+    uint64_t evaluations_before = sim.evaluations;
+    {
+        ObserverMask mask(signals, state.in_cone);
+        resim = &state;
+        try {
+            size_t next = 0;
+            while (true) {
+                uint64_t queued = sim.event_queue.empty() ? UINT64_MAX : sim.event_queue.next_time();
+                uint64_t replayed = next < replay.size() ? replay[next].time : UINT64_MAX;
+                uint64_t t = std::min(queued, replayed);
+                if (t == UINT64_MAX || t > end_time) {
+                    break;
+                }
+                for (; next < replay.size() && replay[next].time == t; next++) {
+                    sim.event_queue.schedule(Event(t, replay[next].signal_id, replay[next].value));
+                }
+                if (checkpoint_due(t)) {
+                    checkpoint();
+                    if (state.reconverged) {
+                        break;
+                    }
+                }
+                sim.step();
+            }
+        } catch (...) {
+            resim = nullptr;
+            throw;
+        }
+        resim = nullptr;
+    }
+    report.events = sim.events_processed - events_before;
+    report.evaluations = sim.evaluations - evaluations_before;
+
+    if (state.reconverged) {
+        // The recording is valid from here on: splice it back and jump to its end
+        report.reconverged = true;
+        report.reconverged_at = state.reconverged_at;
+        const Checkpoint* rest = nullptr;
+        for (size_t i = state.first_old; i < old_checkpoints.size() && !rest; i++) {
+            if (old_checkpoints[i].time >= state.reconverged_at) {
+                rest = &old_checkpoints[i];
+            }
+        }
+        size_t tail = rest ? rest->log_position : final_state.log_position;
+        log.insert(log.end(), old_log.begin() + tail, old_log.end());
+        for (size_t i = state.first_old; i < old_checkpoints.size(); i++) {
+            if (old_checkpoints[i].time > state.reconverged_at) {
+                old_checkpoints[i].log_position += log.size() - old_log.size();
+                checkpoints.push_back(std::move(old_checkpoints[i]));
+            }
+        }
+
+        for (size_t i = 0; i < signals.size(); i++) {
+            signals[i]->set_value(final_state.values[i]);
+        }
+        for (size_t i = 0; i < components.size(); i++) {
+            const uint8_t* p = final_state.state.data() + final_state.state_offset[i];
+            components[i]->restore_state(p);
+        }
+        sim.event_queue.restore(final_state.pending);
+        next_checkpoint = saved_next_checkpoint;
+    } else {
+        // Cone components ran to the end; the rest still hold the end state
+        std::vector<Event> end_pending;
+        for (const Event& e : sim.event_queue.snapshot()) {
+            if (e.signal_id >= 0 && state.cone_nets.count(e.signal_id)) {
+                end_pending.push_back(e);
+            }
+        }
+        for (const Event& e : final_state.pending) {
+            if (!state.cone_nets.count(e.signal_id)) {
+                end_pending.push_back(e);
+            }
+        }
+        sim.event_queue.restore(end_pending);
+    }
+    sim.current_time = end_time;
+    return report;
+}
+
+// ===== Output =====
+
+void History::dump_vcd(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+    sim.write_vcd_header(file);
+
+    const Checkpoint& first = checkpoints.front();
+    std::unordered_map<int, uint8_t> value;
+    file << "\n$dumpvars\n";
+    for (size_t i = 0; i < sim.signals.size() && i < first.values.size(); i++) {
+        int id = sim.signals[i]->get_id();
+        value[id] = first.values[i];
+        file << logic::to_char(first.values[i]) << id << "\n";
+    }
+    file << "$end\n";
+
+    uint64_t last_time = UINT64_MAX;
+    for (const Change& change : log) {
+        uint8_t v = logic::canonical(change.value);
+        auto it = value.find(change.signal_id);
+        if (it == value.end() || it->second == v) {
+            continue;
+        }
+        it->second = v;
+        if (change.time != last_time) {
+            file << "#" << change.time << "\n";
+            last_time = change.time;
+        }
+        file << logic::to_char(v) << change.signal_id << "\n";
+    }
+}
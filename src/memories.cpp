@@ -0,0 +1,456 @@
+#include "memories.h"
+#include "simulator.h"
+#include "event.h"
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ===== MappedFile =====
+
+MappedFile::MappedFile(const std::string& path) : fd(-1), data(nullptr), length(0) {
+    fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open memory image: " + path);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        throw std::runtime_error("Cannot stat memory image: " + path);
+    }
+    length = st.st_size;
+    if (length > 0) {
+        void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error("Cannot map memory image: " + path);
+        }
+        data = static_cast<const uint8_t*>(p);
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (data) {
+        munmap(const_cast<uint8_t*>(data), length);
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+// ===== SparseMemory =====
+
+SparseMemory::SparseMemory(unsigned word_width, uint64_t word_depth)
+    : width(word_width), depth(word_depth), cached_page_number(UINT64_MAX), cached_page(nullptr),
+      image_base(0), image_words(0), image_word_bytes(0) {
+    if (width < 1 || width > 64) {
+        throw std::invalid_argument("Memory width must be 1..64 bits");
+    }
+    if (depth < 1) {
+        throw std::invalid_argument("Memory depth must be at least 1");
+    }
+    word_mask = width == 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+    fill = MemWord{0, word_mask};
+}
+
+void SparseMemory::set_fill(uint8_t fill_value) {
+    if (fill_value > 2) {
+        throw std::invalid_argument("Fill value must be 0, 1, or 2");
+    }
+    fill.value = fill_value == 1 ? word_mask : 0;
+    fill.xmask = fill_value == 2 ? word_mask : 0;
+}
+
+void SparseMemory::check_address(uint64_t addr) const {
+    if (addr >= depth) {
+        throw std::out_of_range("Memory address " + std::to_string(addr) + " beyond depth " +
+                                std::to_string(depth));
+    }
+}
+
+SparseMemory::Page* SparseMemory::find_page(uint64_t page_number) const {
+    if (page_number == cached_page_number) {
+        return cached_page;
+    }
+    auto it = pages.find(page_number);
+    if (it == pages.end()) {
+        return nullptr;
+    }
+    cached_page_number = page_number;
+    cached_page = const_cast<Page*>(&it->second);
+    return cached_page;
+}
+
+MemWord SparseMemory::background(uint64_t addr) const {
+    if (image && addr >= image_base && addr - image_base < image_words) {
+        const uint8_t* p = image->bytes() + (addr - image_base) * image_word_bytes;
+        uint64_t value = 0;
+        for (unsigned b = 0; b < image_word_bytes; b++) {
+            value |= uint64_t(p[b]) << (8 * b);
+        }
+        return MemWord{value & word_mask, 0};
+    }
+    return fill;
+}
+
+SparseMemory::Page& SparseMemory::materialize(uint64_t page_number) {
+    if (Page* page = find_page(page_number)) {
+        return *page;
+    }
+    Page& page = pages[page_number];
+    page.value.reset(new uint64_t[PAGE_WORDS]);
+
+    // Copy out whatever the page showed before its first write
+    uint64_t first = page_number << PAGE_BITS;
+    bool any_x = false;
+    for (uint64_t i = 0; i < PAGE_WORDS; i++) {
+        MemWord w = first + i < depth ? background(first + i) : fill;
+        page.value[i] = w.value;
+        any_x |= w.xmask != 0;
+    }
+    if (any_x) {
+        page.xmask.reset(new uint64_t[PAGE_WORDS]);
+        for (uint64_t i = 0; i < PAGE_WORDS; i++) {
+            page.xmask[i] = first + i < depth ? background(first + i).xmask : fill.xmask;
+        }
+    }
+
+    // Rehashing keeps node addresses stable, so only the cache needs updating
+    cached_page_number = page_number;
+    cached_page = &page;
+    return page;
+}
+
+MemWord SparseMemory::read(uint64_t addr) const {
+    check_address(addr);
+    const Page* page = find_page(addr >> PAGE_BITS);
+    if (!page) {
+        return background(addr);
+    }
+    uint64_t offset = addr & (PAGE_WORDS - 1);
+    return MemWord{page->value[offset], page->xmask ? page->xmask[offset] : 0};
+}
+
+void SparseMemory::write(uint64_t addr, MemWord word) {
+    check_address(addr);
+    Page& page = materialize(addr >> PAGE_BITS);
+    uint64_t offset = addr & (PAGE_WORDS - 1);
+    word.xmask &= word_mask;
+    page.value[offset] = word.value & word_mask & ~word.xmask;
+    if (word.xmask && !page.xmask) {
+        page.xmask.reset(new uint64_t[PAGE_WORDS]());
+    }
+    if (page.xmask) {
+        page.xmask[offset] = word.xmask;
+    }
+}
+
+size_t SparseMemory::bytes_allocated() const {
+    size_t total = 0;
+    for (const auto& entry : pages) {
+        total += PAGE_WORDS * sizeof(uint64_t) * (entry.second.xmask ? 2 : 1);
+    }
+    return total;
+}
+
+void SparseMemory::save(std::vector<uint8_t>& out) const {
+    auto put = [&out](const void* data, size_t bytes) {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        out.insert(out.end(), p, p + bytes);
+    };
+    uint64_t count = pages.size();
+    put(&count, sizeof(count));
+    for (const auto& entry : pages) {
+        uint8_t has_x = entry.second.xmask != nullptr;
+        put(&entry.first, sizeof(entry.first));
+        put(&has_x, 1);
+        put(entry.second.value.get(), PAGE_WORDS * sizeof(uint64_t));
+        if (has_x) {
+            put(entry.second.xmask.get(), PAGE_WORDS * sizeof(uint64_t));
+        }
+    }
+}
+
+void SparseMemory::restore(const uint8_t*& in) {
+    auto get = [&in](void* data, size_t bytes) {
+        std::memcpy(data, in, bytes);
+        in += bytes;
+    };
+    pages.clear();
+    cached_page_number = UINT64_MAX;
+    cached_page = nullptr;
+    uint64_t count;
+    get(&count, sizeof(count));
+    for (uint64_t i = 0; i < count; i++) {
+        uint64_t page_number;
+        uint8_t has_x;
+        get(&page_number, sizeof(page_number));
+        get(&has_x, 1);
+        Page& page = pages[page_number];
+        page.value.reset(new uint64_t[PAGE_WORDS]);
+        get(page.value.get(), PAGE_WORDS * sizeof(uint64_t));
+        if (has_x) {
+            page.xmask.reset(new uint64_t[PAGE_WORDS]);
+            get(page.xmask.get(), PAGE_WORDS * sizeof(uint64_t));
+        }
+    }
+}
+
+void SparseMemory::clear() {
+    pages.clear();
+    image.reset();
+    image_words = 0;
+    cached_page_number = UINT64_MAX;
+    cached_page = nullptr;
+}
+
+void SparseMemory::load_image(const std::string& path, ImageFormat format, uint64_t base) {
+    auto file = std::make_shared<MappedFile>(path);
+    if (format == HEX) {
+        load_hex(*file, base);
+        return;
+    }
+
+    unsigned word_bytes = (width + 7) / 8;
+    if (file->size() % word_bytes != 0) {
+        throw std::runtime_error("Memory image " + path + " is not a whole number of " +
+                                 std::to_string(word_bytes) + "-byte words");
+    }
+    uint64_t words = file->size() / word_bytes;
+    if (base >= depth || words > depth - base) {
+        throw std::out_of_range("Memory image " + path + " does not fit in the memory");
+    }
+    // Pages already written keep their contents; the image shows through the rest
+    image = file;
+    image_base = base;
+    image_words = words;
+    image_word_bytes = word_bytes;
+}
+
+void SparseMemory::load_hex(const MappedFile& file, uint64_t base) {
+    const char* p = reinterpret_cast<const char*>(file.bytes());
+    const char* end = p + file.size();
+    uint64_t addr = base;
+
+    auto hex_digit = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    };
+
+    while (p < end) {
+        char c = *p;
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+            p++;
+            continue;
+        }
+        if (c == '/' && p + 1 < end && p[1] == '/') {
+            while (p < end && *p != '\n') {
+                p++;
+            }
+            continue;
+        }
+
+        bool is_address = c == '@';
+        if (is_address) {
+            p++;
+        }
+        MemWord word;
+        int digits = 0;
+        while (p < end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n') {
+            char d = *p++;
+            if (d == '_') {
+                continue;
+            }
+            word.value <<= 4;
+            word.xmask <<= 4;
+            if (d == 'x' || d == 'X') {
+                word.xmask |= 0xF;
+            } else if (hex_digit(d) >= 0) {
+                word.value |= hex_digit(d);
+            } else {
+                throw std::runtime_error(std::string("Invalid character '") + d + "' in hex memory image");
+            }
+            digits++;
+        }
+        if (digits == 0 || digits > 16) {
+            throw std::runtime_error("Malformed token in hex memory image");
+        }
+
+        if (is_address) {
+            if (word.xmask) {
+                throw std::runtime_error("Unknown digits in hex image address");
+            }
+            addr = base + word.value;
+        } else {
+            write(addr++, word);
+        }
+    }
+}
+
+// ===== MemoryElement =====
+
+MemoryElement::MemoryElement(const std::string& element_id, unsigned width, uint64_t depth, uint64_t delay)
+    : SequentialElement(element_id, delay, RISING), store(width, depth) {
+}
+
+void MemoryElement::check_port(const std::vector<Signal*>& addr, const std::vector<Signal*>& data) const {
+    if (addr.empty() || addr.size() > 64) {
+        throw std::invalid_argument("Memory address bus must be 1..64 bits on " + id);
+    }
+    if (data.size() != store.get_width()) {
+        throw std::invalid_argument("Memory data bus must be " + std::to_string(store.get_width()) +
+                                    " bits on " + id);
+    }
+    for (Signal* sig : addr) {
+        if (!sig) throw std::invalid_argument("Cannot connect null address signal");
+    }
+    for (Signal* sig : data) {
+        if (!sig) throw std::invalid_argument("Cannot connect null data signal");
+    }
+}
+
+size_t MemoryElement::add_read_port(const std::vector<Signal*>& addr, const std::vector<Signal*>& dout,
+                                    Signal* enable) {
+    check_port(addr, dout);
+    read_ports.push_back({addr, dout, enable});
+    if (read_ports.size() == 1) {
+        output = dout[0];
+    }
+    return read_ports.size() - 1;
+}
+
+bool MemoryElement::decode_address(const Port& port, uint64_t& addr) const {
+    addr = 0;
+    for (size_t i = 0; i < port.addr.size(); i++) {
+        uint8_t bit = port.addr[i]->get_value();
+        if (bit > 1) {
+            return false;
+        }
+        addr |= uint64_t(bit) << i;
+    }
+    return addr < store.get_depth();
+}
+
+bool MemoryElement::port_enabled(const Port& port) const {
+    return !port.enable || port.enable->get_value() == 1;
+}
+
+void MemoryElement::perform_reads(Simulator* sim, uint64_t current_time) {
+    uint64_t when = current_time + propagation_delay;
+    for (const Port& port : read_ports) {
+        if (!port_enabled(port)) {
+            continue;
+        }
+        uint64_t addr;
+        MemWord word{0, ~uint64_t(0)};
+        if (decode_address(port, addr)) {
+            word = store.read(addr);
+        }
+        for (size_t b = 0; b < port.data.size(); b++) {
+            uint8_t bit = (word.xmask >> b) & 1 ? 2 : (word.value >> b) & 1;
+            if (port.data[b]->get_value() != bit) {
+                sim->schedule_event(Event(when, port.data[b]->get_id(), bit));
+            }
+        }
+    }
+}
+
+void MemoryElement::get_fanin(std::vector<Signal*>& nets) const {
+    nets.push_back(clock);
+    for (const Port& port : read_ports) {
+        nets.insert(nets.end(), port.addr.begin(), port.addr.end());
+        if (port.enable) {
+            nets.push_back(port.enable);
+        }
+    }
+}
+
+void MemoryElement::get_fanout(std::vector<Signal*>& nets) const {
+    for (const Port& port : read_ports) {
+        nets.insert(nets.end(), port.data.begin(), port.data.end());
+    }
+}
+
+void MemoryElement::save_state(std::vector<uint8_t>& out) const {
+    SequentialElement::save_state(out);
+    store.save(out);
+}
+
+void MemoryElement::restore_state(const uint8_t*& in) {
+    SequentialElement::restore_state(in);
+    store.restore(in);
+}
+
+// ===== SyncRAM =====
+
+uint32_t SyncRAM::id_counter = 0;
+
+SyncRAM::SyncRAM(unsigned width, uint64_t depth, uint64_t delay)
+    : MemoryElement("RAM" + std::to_string(id_counter++), width, depth, delay) {
+}
+
+size_t SyncRAM::add_write_port(const std::vector<Signal*>& addr, const std::vector<Signal*>& din,
+                               Signal* write_enable) {
+    check_port(addr, din);
+    if (!write_enable) {
+        throw std::invalid_argument("Write port needs a write enable on " + id);
+    }
+    write_ports.push_back({addr, din, write_enable});
+    return write_ports.size() - 1;
+}
+
+void SyncRAM::get_fanin(std::vector<Signal*>& nets) const {
+    MemoryElement::get_fanin(nets);
+    for (const Port& port : write_ports) {
+        nets.insert(nets.end(), port.addr.begin(), port.addr.end());
+        nets.insert(nets.end(), port.data.begin(), port.data.end());
+        nets.push_back(port.enable);
+    }
+}
+
+void SyncRAM::on_clock_edge(Simulator* sim, uint64_t current_time) {
+    perform_reads(sim, current_time);
+
+    for (const Port& port : write_ports) {
+        uint8_t we = port.enable->get_value();
+        if (we == 0) {
+            continue;
+        }
+        uint64_t addr;
+        if (!decode_address(port, addr)) {
+            continue;  // Unknown or out-of-range address: nothing can be written safely
+        }
+        MemWord word;
+        for (size_t b = 0; b < port.data.size(); b++) {
+            uint8_t bit = port.data[b]->get_value();
+            if (bit > 1 || we > 1) {
+                word.xmask |= uint64_t(1) << b;  // Unknown enable corrupts the word
+            } else {
+                word.value |= uint64_t(bit) << b;
+            }
+        }
+        store.write(addr, word);
+    }
+}
+
+// ===== SyncROM =====
+
+uint32_t SyncROM::id_counter = 0;
+
+SyncROM::SyncROM(unsigned width, uint64_t depth, uint64_t delay)
+    : MemoryElement("ROM" + std::to_string(id_counter++), width, depth, delay) {
+}
+
+SyncROM::SyncROM(unsigned width, uint64_t depth, const std::string& image_path,
+                 SparseMemory::ImageFormat format, uint64_t delay)
+    : SyncROM(width, depth, delay) {
+    store.load_image(image_path, format);
+}
+
+void SyncROM::on_clock_edge(Simulator* sim, uint64_t current_time) {
+    perform_reads(sim, current_time);
+}
@@ -0,0 +1,426 @@
+#include "module.h"
+#include "logic.h"
+#include "simulator.h"
+#include "event.h"
+#include <algorithm>
+#include <stdexcept>
+
+// ===== ModuleDef =====
+
+ModuleDef::ModuleDef(const std::string& def_name) : name(def_name), finalized(false) {
+    if (def_name.empty()) {
+        throw std::invalid_argument("Module name cannot be empty");
+    }
+}
+
+uint32_t ModuleDef::add_net(const std::string& net_name, uint8_t initial_value) {
+    if (finalized) {
+        throw std::runtime_error("Module '" + name + "' is already instantiated");
+    }
+    if (initial_value > LOGIC_Z) {
+        throw std::invalid_argument("Net value must be 0, 1, 2 (for 'X') or 3 (for 'Z')");
+    }
+    net_names.push_back(net_name);
+    net_init.push_back(logic::canonical(initial_value));
+    net_lookup.clear();
+    return net_names.size() - 1;
+}
+
+uint32_t ModuleDef::add_input(const std::string& port_name) {
+    uint32_t net = add_net(port_name);
+    inputs.push_back(net);
+    return net;
+}
+
+uint32_t ModuleDef::add_output(const std::string& port_name, uint8_t initial_value) {
+    uint32_t net = add_net(port_name, initial_value);
+    outputs.push_back(net);
+    return net;
+}
+
+void ModuleDef::add_gate(Op op, const std::vector<uint32_t>& ins, uint32_t out, uint64_t delay) {
+    if (finalized) {
+        throw std::runtime_error("Module '" + name + "' is already instantiated");
+    }
+    size_t min_inputs = (op == NOT || op == BUF) ? 1 : 2;
+    if (ins.size() < min_inputs) {
+        throw std::invalid_argument("Gate in module '" + name + "' has too few inputs");
+    }
+    for (uint32_t net : ins) {
+        if (net >= net_names.size()) {
+            throw std::out_of_range("Unknown net in module '" + name + "'");
+        }
+    }
+    if (out >= net_names.size()) {
+        throw std::out_of_range("Unknown net in module '" + name + "'");
+    }
+
+    nodes.push_back({op, (uint32_t)pins.size(), (uint32_t)ins.size(), out, delay});
+    pins.insert(pins.end(), ins.begin(), ins.end());
+}
+
+void ModuleDef::add_dff(uint32_t d, uint32_t clk, uint32_t q, uint64_t delay) {
+    if (finalized) {
+        throw std::runtime_error("Module '" + name + "' is already instantiated");
+    }
+    if (d >= net_names.size() || clk >= net_names.size() || q >= net_names.size()) {
+        throw std::out_of_range("Unknown net in module '" + name + "'");
+    }
+    flops.push_back({d, clk, q, delay});
+}
+
+void ModuleDef::add_instance(const ModuleDef& child, const std::string& inst_name,
+                             const std::vector<uint32_t>& port_nets) {
+    if (port_nets.size() != child.inputs.size() + child.outputs.size()) {
+        throw std::invalid_argument("Instance '" + inst_name + "' of '" + child.name +
+                                    "' needs " + std::to_string(child.inputs.size() + child.outputs.size()) +
+                                    " port connections");
+    }
+
+    // Child ports map onto the given nets, everything else gets a prefixed copy
+    std::vector<uint32_t> map(child.net_names.size(), UINT32_MAX);
+    for (size_t i = 0; i < child.inputs.size(); i++) {
+        map[child.inputs[i]] = port_nets[i];
+    }
+    for (size_t i = 0; i < child.outputs.size(); i++) {
+        map[child.outputs[i]] = port_nets[child.inputs.size() + i];
+    }
+    for (uint32_t net = 0; net < child.net_names.size(); net++) {
+        if (map[net] == UINT32_MAX) {
+            map[net] = add_net(inst_name + "." + child.net_names[net], child.net_init[net]);
+        }
+    }
+
+    for (const Node& node : child.nodes) {
+        std::vector<uint32_t> ins;
+        for (uint32_t i = 0; i < node.num_inputs; i++) {
+            ins.push_back(map[child.pins[node.first_input + i]]);
+        }
+        add_gate(node.op, ins, map[node.output], node.delay);
+    }
+    for (const Flop& flop : child.flops) {
+        add_dff(map[flop.d], map[flop.clk], map[flop.q], flop.delay);
+    }
+}
+
+void ModuleDef::finalize() {
+    if (finalized) {
+        return;
+    }
+
+    input_slot.assign(net_names.size(), -1);
+    for (size_t i = 0; i < inputs.size(); i++) {
+        input_slot[inputs[i]] = i;
+    }
+    for (const Flop& flop : flops) {
+        if (input_slot[flop.clk] < 0) {
+            throw std::runtime_error("Flop clock in module '" + name + "' must be an input port");
+        }
+    }
+
+    // Levelize: a node is ready once every net it reads is settled. Inputs,
+    // flop outputs and undriven nets are settled from the start.
+    std::vector<int32_t> driver(net_names.size(), -1);
+    for (size_t n = 0; n < nodes.size(); n++) {
+        if (driver[nodes[n].output] >= 0) {
+            throw std::runtime_error("Net '" + net_names[nodes[n].output] + "' in module '" +
+                                     name + "' has multiple drivers");
+        }
+        driver[nodes[n].output] = n;
+    }
+
+    std::vector<uint64_t> arrival(net_names.size(), 0);
+    for (const Flop& flop : flops) {
+        arrival[flop.q] = flop.delay;
+    }
+
+    std::vector<uint32_t> pending(nodes.size(), 0);
+    std::vector<std::vector<uint32_t>> readers(net_names.size());
+    for (size_t n = 0; n < nodes.size(); n++) {
+        for (uint32_t i = 0; i < nodes[n].num_inputs; i++) {
+            uint32_t net = pins[nodes[n].first_input + i];
+            if (driver[net] >= 0) {
+                pending[n]++;
+                readers[net].push_back(n);
+            }
+        }
+    }
+
+    order.clear();
+    for (size_t n = 0; n < nodes.size(); n++) {
+        if (pending[n] == 0) {
+            order.push_back(n);
+        }
+    }
+    for (size_t i = 0; i < order.size(); i++) {
+        const Node& node = nodes[order[i]];
+        uint64_t latest = 0;
+        for (uint32_t p = 0; p < node.num_inputs; p++) {
+            latest = std::max(latest, arrival[pins[node.first_input + p]]);
+        }
+        arrival[node.output] = latest + node.delay;
+
+        for (uint32_t reader : readers[node.output]) {
+            if (--pending[reader] == 0) {
+                order.push_back(reader);
+            }
+        }
+    }
+    if (order.size() != nodes.size()) {
+        throw std::runtime_error("Module '" + name + "' contains a combinational loop");
+    }
+
+    output_delay.clear();
+    for (uint32_t net : outputs) {
+        output_delay.push_back(arrival[net]);
+    }
+    finalized = true;
+}
+
+uint8_t ModuleDef::eval_op(Op op, const uint8_t* values, const uint32_t* in, uint32_t count) {
+    switch (op) {
+        case AND: {
+            uint8_t result = 1;
+            for (uint32_t i = 0; i < count; i++) {
+                result = logic::and2(result, values[in[i]]);
+            }
+            return result;
+        }
+        case OR: {
+            uint8_t result = 0;
+            for (uint32_t i = 0; i < count; i++) {
+                result = logic::or2(result, values[in[i]]);
+            }
+            return result;
+        }
+        case XOR: {
+            uint8_t result = 0;
+            for (uint32_t i = 0; i < count; i++) {
+                result = logic::xor2(result, values[in[i]]);
+            }
+            return result;
+        }
+        case NOT:
+            return logic::not1(values[in[0]]);
+        default:
+            return logic::buf1(values[in[0]]);
+    }
+}
+
+const std::string& ModuleDef::get_name() const {
+    return name;
+}
+
+size_t ModuleDef::net_count() const {
+    return net_names.size();
+}
+
+size_t ModuleDef::gate_count() const {
+    return nodes.size();
+}
+
+size_t ModuleDef::flop_count() const {
+    return flops.size();
+}
+
+const std::vector<uint32_t>& ModuleDef::get_inputs() const {
+    return inputs;
+}
+
+const std::vector<uint32_t>& ModuleDef::get_outputs() const {
+    return outputs;
+}
+
+const std::string& ModuleDef::get_net_name(uint32_t net) const {
+    return net_names.at(net);
+}
+
+uint64_t ModuleDef::get_output_delay(size_t port) const {
+    return output_delay.at(port);
+}
+
+int32_t ModuleDef::find_net(const std::string& net_name) const {
+    if (net_lookup.empty()) {
+        for (uint32_t net = 0; net < net_names.size(); net++) {
+            net_lookup.emplace(net_names[net], net);
+        }
+    }
+    auto it = net_lookup.find(net_name);
+    return it == net_lookup.end() ? -1 : (int32_t)it->second;
+}
+
+// ===== ModuleInstance =====
+
+ModuleInstance::ModuleInstance(std::shared_ptr<ModuleDef> definition, const std::string& inst_name)
+    : def(std::move(definition)) {
+    if (!def) {
+        throw std::invalid_argument("Cannot instantiate null module definition");
+    }
+    def->finalize();
+
+    id = inst_name;
+    propagation_delay = 0;
+    in_ports.assign(def->inputs.size(), nullptr);
+    out_ports.assign(def->outputs.size(), nullptr);
+    state = def->net_init;
+    last_clock.assign(def->flops.size(), 2);
+}
+
+void ModuleInstance::connect_input(size_t port, Signal* sig) {
+    if (port >= in_ports.size() || !sig) {
+        throw std::invalid_argument("Invalid input port connection on '" + id + "'");
+    }
+    in_ports[port] = sig;
+    inputs.push_back(sig);
+    sig->attach_observer(this);
+
+    for (size_t f = 0; f < def->flops.size(); f++) {
+        if (def->flops[f].clk == def->inputs[port]) {
+            last_clock[f] = sig->get_value();
+        }
+    }
+}
+
+void ModuleInstance::connect_output(size_t port, Signal* sig) {
+    if (port >= out_ports.size() || !sig) {
+        throw std::invalid_argument("Invalid output port connection on '" + id + "'");
+    }
+    out_ports[port] = sig;
+    if (port == 0) {
+        output = sig;
+    }
+}
+
+void ModuleInstance::evaluate(Simulator* sim, uint64_t current_time) {
+    const ModuleDef& d = *def;
+
+    // Flops sample D as settled before this change, on a rising clock port
+    // (captured values are applied together so flop-to-flop paths shift);
+    // a floating D samples as X, as in DFlipFlop
+    static constexpr uint8_t NO_CAPTURE = 0xFF;  // Not a logic value
+    static thread_local std::vector<uint8_t> capture;
+    capture.assign(d.flops.size(), NO_CAPTURE);
+    bool captured = false;
+    for (size_t f = 0; f < d.flops.size(); f++) {
+        const ModuleDef::Flop& flop = d.flops[f];
+        Signal* clk = in_ports[d.input_slot[flop.clk]];
+        uint8_t clk_now = clk ? clk->get_value() : 2;
+        if (last_clock[f] == 0 && clk_now == 1) {
+            capture[f] = logic::buf1(state[flop.d]);
+            captured = true;
+        }
+        last_clock[f] = clk_now;
+    }
+
+    for (size_t i = 0; i < in_ports.size(); i++) {
+        if (in_ports[i]) {
+            state[d.inputs[i]] = in_ports[i]->get_value();
+        }
+    }
+    if (captured) {
+        for (size_t f = 0; f < d.flops.size(); f++) {
+            if (capture[f] != NO_CAPTURE) {
+                state[d.flops[f].q] = capture[f];
+            }
+        }
+    }
+
+    for (uint32_t n : d.order) {
+        const ModuleDef::Node& node = d.nodes[n];
+        state[node.output] = ModuleDef::eval_op(node.op, state.data(), &d.pins[node.first_input], node.num_inputs);
+    }
+
+    for (size_t i = 0; i < out_ports.size(); i++) {
+        uint8_t value = state[d.outputs[i]];
+        if (out_ports[i] && value != out_ports[i]->get_value()) {
+            sim->schedule_event(Event(current_time + d.output_delay[i], out_ports[i]->get_id(), value));
+        }
+    }
+}
+
+bool ModuleInstance::is_sequential() const {
+    return !def->flops.empty();
+}
+
+void ModuleInstance::get_fanin(std::vector<Signal*>& nets) const {
+    for (Signal* sig : in_ports) {
+        if (sig) {
+            nets.push_back(sig);
+        }
+    }
+}
+
+void ModuleInstance::get_fanout(std::vector<Signal*>& nets) const {
+    for (Signal* sig : out_ports) {
+        if (sig) {
+            nets.push_back(sig);
+        }
+    }
+}
+
+void ModuleInstance::save_state(std::vector<uint8_t>& out) const {
+    out.insert(out.end(), state.begin(), state.end());
+    out.insert(out.end(), last_clock.begin(), last_clock.end());
+}
+
+void ModuleInstance::restore_state(const uint8_t*& in) {
+    std::copy(in, in + state.size(), state.begin());
+    in += state.size();
+    std::copy(in, in + last_clock.size(), last_clock.begin());
+    in += last_clock.size();
+}
+
+const ModuleDef& ModuleInstance::get_def() const {
+    return *def;
+}
+
+uint8_t ModuleInstance::get_net_value(uint32_t net) const {
+    return state.at(net);
+}
+
+Signal* ModuleInstance::get_input_port(size_t port) const {
+    return in_ports.at(port);
+}
+
+Signal* ModuleInstance::get_output_port(size_t port) const {
+    return out_ports.at(port);
+}
+
+// ===== Helpers =====
+
+ModuleInstance* instantiate(Simulator& sim, std::shared_ptr<ModuleDef> def, const std::string& inst_name) {
+    ModuleInstance* inst = sim.create_component<ModuleInstance>(def, inst_name);
+    const ModuleDef& d = inst->get_def();
+
+    for (size_t i = 0; i < d.get_inputs().size(); i++) {
+        inst->connect_input(i, sim.create_signal(inst_name + "." + d.get_net_name(d.get_inputs()[i]), 2));
+    }
+    for (size_t i = 0; i < d.get_outputs().size(); i++) {
+        uint32_t net = d.get_outputs()[i];
+        inst->connect_output(i, sim.create_signal(inst_name + "." + d.get_net_name(net), inst->get_net_value(net)));
+    }
+    return inst;
+}
+
+uint8_t resolve_value(Simulator& sim, const std::string& path) {
+    if (Signal* sig = sim.get_signal_by_name(path)) {
+        return sig->get_value();
+    }
+
+    // Try every split "<instance>.<net>", longest instance name first
+    for (size_t dot = path.rfind('.'); dot != std::string::npos && dot > 0; dot = path.rfind('.', dot - 1)) {
+        std::string inst_name = path.substr(0, dot);
+        for (Component* component : sim.get_components()) {
+            if (component->get_id() != inst_name) {
+                continue;
+            }
+            if (auto* inst = dynamic_cast<ModuleInstance*>(component)) {
+                int32_t net = inst->get_def().find_net(path.substr(dot + 1));
+                if (net >= 0) {
+                    return inst->get_net_value(net);
+                }
+            }
+        }
+    }
+    throw std::invalid_argument("Unknown hierarchical name: " + path);
+}
@@ -0,0 +1,329 @@
+#include "optimize.h"
+#include "gate.h"
+#include "event.h"
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+enum GateKind { KIND_OTHER, KIND_AND, KIND_OR, KIND_XOR, KIND_NOT, KIND_BUF };
+
+GateKind classify(Component* component) {
+    if (dynamic_cast<ANDGate*>(component)) return KIND_AND;
+    if (dynamic_cast<ORGate*>(component)) return KIND_OR;
+    if (dynamic_cast<XORGate*>(component)) return KIND_XOR;
+    if (dynamic_cast<NOTGate*>(component)) return KIND_NOT;
+    if (dynamic_cast<BUFGate*>(component)) return KIND_BUF;
+    return KIND_OTHER;
+}
+
+bool is_single_input(GateKind kind) {
+    return kind == KIND_NOT || kind == KIND_BUF;
+}
+
+struct Constant {
+    uint8_t value;
+    uint64_t time;  // Time from which the net holds the value
+};
+
+class NetlistOptimizer {
+public:
+    explicit NetlistOptimizer(Simulator& simulator) : sim(simulator) {}
+    OptimizeReport run();
+
+private:
+    Simulator& sim;
+    OptimizeReport report;
+    std::unordered_map<Signal*, Constant> constants;   // Tied and folded nets
+    std::unordered_map<Signal*, Constant> folded;      // Nets now driven by a constant event
+    std::unordered_map<Signal*, Component*> driver;    // Net -> live driving gate
+    std::unordered_set<Component*> removed;
+    std::unordered_set<Signal*> orphaned;              // Nets whose driver was removed
+    std::unordered_set<Signal*> sampled;               // Read by other components (get_fanin)
+    std::vector<Component*> worklist;
+
+    const Constant* constant_of(Signal* sig) const;
+    bool is_read(Signal* sig) const;
+    bool simplify(Component* gate);
+    bool simplify_and_or(Component* gate, GateKind kind);
+    bool simplify_xor(Component* gate);
+    bool simplify_single(Component* gate, GateKind kind);
+
+    void remove_gate(Component* gate);
+    void fold(Component* gate, uint8_t value, uint64_t time);
+    void replace(Component* gate, GateKind kind, uint64_t delay, const std::vector<Signal*>& ins);
+};
+
+const Constant* NetlistOptimizer::constant_of(Signal* sig) const {
+    auto it = constants.find(sig);
+    return it == constants.end() ? nullptr : &it->second;
+}
+
+// Gates read through observers; other components (memories, flops,
+// assertions) may sample nets they do not observe, and are never removed
+bool NetlistOptimizer::is_read(Signal* sig) const {
+    return !sig->get_observers().empty() || sampled.count(sig) > 0;
+}
+
+void NetlistOptimizer::remove_gate(Component* gate) {
+    for (Signal* in : gate->get_inputs()) {
+        in->detach_observer(gate);
+    }
+    removed.insert(gate);
+
+    Signal* out = gate->get_output();
+    auto it = driver.find(out);
+    if (it != driver.end() && it->second == gate) {
+        driver.erase(it);
+        orphaned.insert(out);
+    }
+}
+
+void NetlistOptimizer::fold(Component* gate, uint8_t value, uint64_t time) {
+    Signal* out = gate->get_output();
+    remove_gate(gate);
+
+    Constant c{value, std::max(time, sim.get_current_time())};
+    constants[out] = c;
+    folded[out] = c;
+    report.constants_folded++;
+}
+
+void NetlistOptimizer::replace(Component* gate, GateKind kind, uint64_t delay, const std::vector<Signal*>& ins) {
+    Signal* out = gate->get_output();
+    remove_gate(gate);
+
+    Gate* replacement = nullptr;
+    switch (kind) {
+        case KIND_AND: replacement = sim.create_gate<ANDGate>(delay, ins.data(), ins.size(), out); break;
+        case KIND_OR:  replacement = sim.create_gate<ORGate>(delay, ins.data(), ins.size(), out); break;
+        case KIND_XOR: replacement = sim.create_gate<XORGate>(delay, ins.data(), ins.size(), out); break;
+        case KIND_NOT: replacement = sim.create_gate<NOTGate>(delay, ins.data(), ins.size(), out); break;
+        default:       replacement = sim.create_gate<BUFGate>(delay, ins.data(), ins.size(), out); break;
+    }
+
+    driver[out] = replacement;
+    orphaned.erase(out);
+    worklist.push_back(replacement);
+}
+
+bool NetlistOptimizer::simplify_and_or(Component* gate, GateKind kind) {
+    const PinList& ins = gate->get_inputs();
+    if (ins.size() < 2) {
+        return false;  // Never evaluated by the gate kernel; leave untouched
+    }
+
+    // A controlling constant (0 for AND, 1 for OR) decides the output on its own
+    const uint8_t controlling = (kind == KIND_AND) ? 0 : 1;
+    bool controlled = false;
+    uint64_t controlled_at = UINT64_MAX;
+    uint64_t settled_at = 0;
+    std::vector<Signal*> remaining;
+
+    for (Signal* in : ins) {
+        const Constant* c = constant_of(in);
+        if (!c) {
+            remaining.push_back(in);
+        } else if (c->value == controlling) {
+            controlled = true;
+            controlled_at = std::min(controlled_at, c->time);
+        } else {
+            settled_at = std::max(settled_at, c->time);
+        }
+    }
+
+    if (controlled) {
+        fold(gate, controlling, controlled_at + gate->get_delay());
+        return true;
+    }
+    if (remaining.empty()) {
+        fold(gate, controlling ^ 1, settled_at + gate->get_delay());
+        return true;
+    }
+    if (remaining.size() < ins.size()) {
+        replace(gate, remaining.size() == 1 ? KIND_BUF : kind, gate->get_delay(), remaining);
+        report.gates_simplified++;
+        return true;
+    }
+    return false;
+}
+
+bool NetlistOptimizer::simplify_xor(Component* gate) {
+    const PinList& ins = gate->get_inputs();
+    if (ins.size() < 2) {
+        return false;
+    }
+
+    uint8_t parity = 0;
+    uint64_t settled_at = 0;
+    Signal* const_one = nullptr;
+    std::vector<Signal*> remaining;
+
+    for (Signal* in : ins) {
+        const Constant* c = constant_of(in);
+        if (!c) {
+            remaining.push_back(in);
+            continue;
+        }
+        parity ^= c->value;
+        settled_at = std::max(settled_at, c->time);
+        if (c->value == 1) {
+            const_one = in;
+        }
+    }
+
+    if (remaining.empty()) {
+        fold(gate, parity, settled_at + gate->get_delay());
+        return true;
+    }
+    if (remaining.size() == ins.size()) {
+        return false;
+    }
+    if (remaining.size() == 1) {
+        // x ^ 1 == NOT x, x ^ 0 == x
+        replace(gate, parity ? KIND_NOT : KIND_BUF, gate->get_delay(), remaining);
+        report.gates_simplified++;
+        return true;
+    }
+
+    // Keep a single constant 1 input when the parity of the constants is odd
+    if (parity) {
+        remaining.push_back(const_one);
+    }
+    if (remaining.size() < ins.size()) {
+        replace(gate, KIND_XOR, gate->get_delay(), remaining);
+        report.gates_simplified++;
+        return true;
+    }
+    return false;
+}
+
+bool NetlistOptimizer::simplify_single(Component* gate, GateKind kind) {
+    const PinList& ins = gate->get_inputs();
+    if (ins.empty()) {
+        return false;
+    }
+
+    Signal* in = ins[0];
+    if (const Constant* c = constant_of(in)) {
+        uint8_t value = (kind == KIND_NOT) ? (c->value ^ 1) : c->value;
+        fold(gate, value, c->time + gate->get_delay());
+        return true;
+    }
+
+    // NOT/BUF fed by NOT/BUF: bypass the first gate with one gate carrying
+    // both delays (two inversions cancel into a BUF)
+    auto src = driver.find(in);
+    if (src == driver.end()) {
+        return false;
+    }
+    Component* first = src->second;
+    GateKind first_kind = classify(first);
+    if (!is_single_input(first_kind) || first->get_inputs().empty()) {
+        return false;
+    }
+    Signal* source = first->get_inputs()[0];
+    if (source == gate->get_output() || first == gate) {
+        return false;  // Combinational loop; leave it alone
+    }
+
+    bool inverting = (kind == KIND_NOT) != (first_kind == KIND_NOT);
+    replace(gate, inverting ? KIND_NOT : KIND_BUF, first->get_delay() + gate->get_delay(), {source});
+    report.chains_collapsed++;
+    return true;
+}
+
+bool NetlistOptimizer::simplify(Component* gate) {
+    GateKind kind = classify(gate);
+    Signal* out = gate->get_output();
+    if (kind == KIND_OTHER || !out) {
+        return false;
+    }
+
+    // Dead logic: nobody reads the output and the user does not probe it
+    if (!is_read(out) && !sim.is_probed(out) && !sim.is_constant(out)) {
+        remove_gate(gate);
+        report.dead_gates++;
+        return true;
+    }
+
+    switch (kind) {
+        case KIND_AND:
+        case KIND_OR:
+            return simplify_and_or(gate, kind);
+        case KIND_XOR:
+            return simplify_xor(gate);
+        default:
+            return simplify_single(gate, kind);
+    }
+}
+
+OptimizeReport NetlistOptimizer::run() {
+    report.gates_before = sim.get_components().size();
+    report.nets_before = sim.get_signals().size();
+
+    std::vector<Signal*> fanin;
+    for (Component* component : sim.get_components()) {
+        if (component->get_output()) {
+            driver[component->get_output()] = component;
+        }
+        if (classify(component) == KIND_OTHER) {
+            fanin.clear();
+            component->get_fanin(fanin);
+            sampled.insert(fanin.begin(), fanin.end());
+        }
+    }
+    for (Signal* sig : sim.get_signals()) {
+        if (sim.is_constant(sig)) {
+            constants[sig] = {sim.get_constant(sig), sim.get_current_time()};
+        }
+    }
+
+    // Sweep until nothing changes; each rewrite may enable rewrites downstream
+    worklist = sim.get_components();
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 0; i < worklist.size(); i++) {
+            if (!removed.count(worklist[i]) && simplify(worklist[i])) {
+                changed = true;
+            }
+        }
+        worklist.erase(std::remove_if(worklist.begin(), worklist.end(),
+                                      [this](Component* c) { return removed.count(c) > 0; }),
+                       worklist.end());
+    }
+
+    // Nets left without driver or fanout (and not probed) go away with their gates
+    std::vector<Signal*> dead_nets;
+    std::unordered_set<Signal*> dead_set;
+    for (Signal* sig : orphaned) {
+        if (!driver.count(sig) && !is_read(sig) &&
+            !sim.is_probed(sig) && !sim.is_constant(sig)) {
+            dead_nets.push_back(sig);
+            dead_set.insert(sig);
+        }
+    }
+
+    // Surviving folded nets are driven once, at the time the constant arrives
+    for (const auto& entry : folded) {
+        if (!dead_set.count(entry.first) && entry.first->get_value() != entry.second.value) {
+            sim.schedule_event(Event(entry.second.time, entry.first->get_id(), entry.second.value));
+        }
+    }
+
+    sim.remove_components(std::vector<Component*>(removed.begin(), removed.end()));
+    sim.remove_signals(dead_nets);
+
+    report.gates_after = sim.get_components().size();
+    report.nets_after = sim.get_signals().size();
+    return report;
+}
+
+}  // namespace
+
+OptimizeReport optimize_netlist(Simulator& sim) {
+    NetlistOptimizer optimizer(sim);
+    return optimizer.run();
+}
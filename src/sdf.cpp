@@ -0,0 +1,363 @@
+#include "sdf.h"
+#include "simulator.h"
+#include "gate.h"
+#include "stats.h"
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+
+namespace {
+
+// S-expression node: a list whose first child is usually a keyword, or an atom
+struct SdfNode {
+    bool is_list = false;
+    int line = 0;  // Where the atom, or the list's "(", is
+    std::string atom;
+    std::vector<SdfNode> children;
+
+    const std::string& keyword() const {
+        static const std::string none;
+        return !children.empty() && !children[0].is_list ? children[0].atom : none;
+    }
+};
+
+class SdfReader {
+public:
+    explicit SdfReader(std::istream& input) : in(input), line(1) {}
+
+    SdfNode parse_file() {
+        std::string token = next();
+        if (token != "(") {
+            fail("expected '(' at start of file");
+        }
+        SdfNode root = parse_list();
+        if (!next().empty()) {
+            fail("trailing data after DELAYFILE");
+        }
+        return root;
+    }
+
+private:
+    std::istream& in;
+    int line;
+
+    [[noreturn]] void fail(const std::string& message) {
+        throw std::runtime_error("SDF line " + std::to_string(line) + ": " + message);
+    }
+
+    // Next token: "(", ")", an atom, or "" at end of input
+    std::string next() {
+        int c;
+        while ((c = in.get()) != EOF) {
+            if (c == '\n') {
+                line++;
+            } else if (c == '/' && in.peek() == '/') {
+                while ((c = in.get()) != EOF && c != '\n') {}
+                line++;
+            } else if (c == '/' && in.peek() == '*') {
+                in.get();
+                int prev = 0;
+                while ((c = in.get()) != EOF && !(prev == '*' && c == '/')) {
+                    line += c == '\n';
+                    prev = c;
+                }
+            } else if (!std::isspace(c)) {
+                break;
+            }
+        }
+        if (c == EOF) {
+            return "";
+        }
+        if (c == '(' || c == ')') {
+            return std::string(1, (char)c);
+        }
+        std::string token;
+        if (c == '"') {
+            while ((c = in.get()) != EOF && c != '"') {
+                token += (char)c;
+            }
+            if (c == EOF) {
+                fail("unterminated string");
+            }
+            return token;
+        }
+        token += (char)c;
+        while ((c = in.peek()) != EOF && !std::isspace(c) && c != '(' && c != ')') {
+            token += (char)in.get();
+        }
+        return token;
+    }
+
+    // After "(": children up to the matching ")"
+    SdfNode parse_list() {
+        SdfNode node;
+        node.is_list = true;
+        node.line = line;
+        while (true) {
+            std::string token = next();
+            if (token.empty()) {
+                fail("unexpected end of file");
+            }
+            if (token == ")") {
+                return node;
+            }
+            if (token == "(") {
+                node.children.push_back(parse_list());
+            } else {
+                SdfNode leaf;
+                leaf.line = line;
+                leaf.atom = token;
+                node.children.push_back(leaf);
+            }
+        }
+    }
+};
+
+class SdfAnnotator {
+public:
+    SdfAnnotator(Simulator& simulator, SdfCorner sdf_corner)
+        : sim(simulator), corner(sdf_corner), scale(1.0) {
+        for (Component* component : sim.get_components()) {
+            by_id[component->get_id()] = component;
+        }
+    }
+
+    SdfReport run(const SdfNode& root) {
+        if (root.keyword() != "DELAYFILE") {
+            throw std::runtime_error("SDF: expected DELAYFILE");
+        }
+        for (const SdfNode& entry : root.children) {
+            if (entry.keyword() == "TIMESCALE") {
+                read_timescale(entry);
+            } else if (entry.keyword() == "CELL") {
+                read_cell(entry);
+            }
+        }
+        return report;
+    }
+
+private:
+    Simulator& sim;
+    SdfCorner corner;
+    double scale;  // Picoseconds per SDF time unit
+    std::map<std::string, Component*> by_id;
+    SdfReport report;
+
+    void warn(const std::string& message) {
+        report.skipped++;
+        if (report.warnings.size() < 100) {
+            report.warnings.push_back(message);
+        }
+    }
+
+    // The whole of `text` as a number; errors carry the line of `node`
+    static double parse_number(const SdfNode& node, const std::string& text) {
+        size_t used = 0;
+        double number = 0;
+        try {
+            number = std::stod(text, &used);
+        } catch (const std::logic_error&) {
+            used = 0;
+        }
+        if (used == 0 || used != text.size()) {
+            throw std::runtime_error("SDF line " + std::to_string(node.line) + ": bad number '" + text + "'");
+        }
+        return number;
+    }
+
+    void read_timescale(const SdfNode& node) {
+        std::string text;
+        for (size_t i = 1; i < node.children.size(); i++) {
+            text += node.children[i].atom;
+        }
+        size_t unit_start = 0;
+        while (unit_start < text.size() && (std::isdigit((unsigned char)text[unit_start]) || text[unit_start] == '.')) {
+            unit_start++;
+        }
+        double number = unit_start > 0 ? parse_number(node, text.substr(0, unit_start)) : 1.0;
+        std::string unit = text.substr(unit_start);
+        double unit_ps;
+        if (unit == "fs") unit_ps = 0.001;
+        else if (unit == "ps") unit_ps = 1.0;
+        else if (unit == "ns") unit_ps = 1000.0;
+        else if (unit == "us") unit_ps = 1e6;
+        else throw std::runtime_error("SDF: unsupported TIMESCALE '" + text + "'");
+        scale = number * unit_ps;
+    }
+
+    void read_cell(const SdfNode& cell) {
+        report.cells++;
+        std::string cell_type;
+        std::string instance;
+        for (const SdfNode& field : cell.children) {
+            if (field.keyword() == "CELLTYPE" && field.children.size() > 1) {
+                cell_type = field.children[1].atom;
+            } else if (field.keyword() == "INSTANCE") {
+                instance = field.children.size() > 1 ? field.children[1].atom : "*";
+            }
+        }
+
+        std::vector<Gate*> targets;
+        if (instance.empty() || instance == "*") {
+            for (const auto& entry : by_id) {
+                if (component_type_name(entry.first) == cell_type) {
+                    if (Gate* gate = dynamic_cast<Gate*>(entry.second)) {
+                        targets.push_back(gate);
+                    }
+                }
+            }
+        } else {
+            auto it = by_id.find(instance);
+            if (it == by_id.end()) {
+                report.unknown_instances++;
+                return;
+            }
+            Gate* gate = dynamic_cast<Gate*>(it->second);
+            if (!gate) {
+                warn("instance " + instance + " is not a gate");
+                return;
+            }
+            targets.push_back(gate);
+        }
+
+        for (const SdfNode& field : cell.children) {
+            if (field.keyword() != "DELAY") {
+                continue;
+            }
+            for (const SdfNode& block : field.children) {
+                bool increment = block.keyword() == "INCREMENT";
+                if (!increment && block.keyword() != "ABSOLUTE") {
+                    continue;
+                }
+                for (const SdfNode& path : block.children) {
+                    if (path.keyword() == "IOPATH") {
+                        read_iopath(path, targets, increment);
+                    } else if (path.is_list) {
+                        warn("unsupported delay entry " + path.keyword());
+                    }
+                }
+            }
+        }
+    }
+
+    // Pin names: A, B, C, ... / a number / I<n> / IN<n>
+    static int pin_index(const std::string& name) {
+        if (name.size() == 1 && std::isalpha((unsigned char)name[0])) {
+            return std::toupper((unsigned char)name[0]) - 'A';
+        }
+        size_t digits = 0;
+        while (digits < name.size() && std::isalpha((unsigned char)name[digits])) {
+            digits++;
+        }
+        std::string prefix = name.substr(0, digits);
+        for (char& ch : prefix) {
+            ch = std::toupper((unsigned char)ch);
+        }
+        if ((prefix.empty() || prefix == "I" || prefix == "IN") && digits < name.size()) {
+            std::string number = name.substr(digits);
+            for (char ch : number) {
+                if (!std::isdigit((unsigned char)ch)) {
+                    return -1;
+                }
+            }
+            try {
+                return std::stoi(number);
+            } catch (const std::out_of_range&) {
+                return -1;  // No gate has that many pins
+            }
+        }
+        return -1;
+    }
+
+    // "(v)" or "(min:typ:max)"; false for "()"
+    bool read_value(const SdfNode& node, uint64_t& value) const {
+        if (!node.is_list || node.children.empty()) {
+            return false;
+        }
+        const std::string& text = node.children[0].atom;
+        std::vector<std::string> parts;
+        size_t start = 0;
+        for (size_t colon; (colon = text.find(':', start)) != std::string::npos; start = colon + 1) {
+            parts.push_back(text.substr(start, colon - start));
+        }
+        parts.push_back(text.substr(start));
+
+        std::string chosen;
+        if (parts.size() == 3) {
+            chosen = parts[corner == SdfCorner::MIN ? 0 : corner == SdfCorner::TYP ? 1 : 2];
+            for (size_t i = 0; chosen.empty() && i < 3; i++) {
+                chosen = parts[i];  // Fall back to any corner that is given
+            }
+        } else if (parts.size() == 1) {
+            chosen = parts[0];
+        }
+        if (chosen.empty()) {
+            return false;
+        }
+        double ps = parse_number(node.children[0], chosen) * scale;
+        value = ps <= 0 ? 0 : (uint64_t)std::llround(ps);
+        return true;
+    }
+
+    void read_iopath(const SdfNode& path, const std::vector<Gate*>& targets, bool increment) {
+        if (path.children.size() < 4 || path.children[1].is_list) {
+            warn("unsupported IOPATH (edge-qualified or malformed)");
+            return;
+        }
+        int pin = pin_index(path.children[1].atom);
+        if (pin < 0) {
+            warn("unknown input pin " + path.children[1].atom);
+            return;
+        }
+
+        uint64_t rise, fall;
+        bool has_rise = read_value(path.children[3], rise);
+        bool has_fall = path.children.size() > 4 ? read_value(path.children[4], fall) : false;
+        if (!has_fall) {
+            fall = rise;
+            has_fall = has_rise;
+        }
+        if (!has_rise) {
+            rise = fall;
+            has_rise = has_fall;
+        }
+        if (!has_rise) {
+            return;  // "()" everywhere: leave as is
+        }
+
+        DelayTable& table = sim.get_delay_table();
+        for (Gate* gate : targets) {
+            if ((size_t)pin >= gate->get_inputs().size()) {
+                warn(gate->get_id() + " has no input pin " + path.children[1].atom);
+                continue;
+            }
+            uint64_t r = rise, f = fall;
+            if (increment) {
+                uint32_t current = gate->get_pin_delay(pin);
+                r += current == Gate::NO_DELAY ? gate->get_delay() : table[current].rise;
+                f += current == Gate::NO_DELAY ? gate->get_delay() : table[current].fall;
+            }
+            gate->annotate_pin(pin, table.intern(r, f));
+            report.paths_annotated++;
+        }
+    }
+};
+
+}  // namespace
+
+SdfReport parse_sdf(Simulator& sim, std::istream& in, SdfCorner corner) {
+    SdfReader reader(in);
+    SdfNode root = reader.parse_file();
+    SdfAnnotator annotator(sim, corner);
+    return annotator.run(root);
+}
+
+SdfReport load_sdf(Simulator& sim, const std::string& filename, SdfCorner corner) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+    return parse_sdf(sim, file, corner);
+}
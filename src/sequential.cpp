@@ -1,6 +1,7 @@
 #include "sequential.h"
 #include "simulator.h"
 #include "event.h"
+#include "logic.h"
 #include <stdexcept>
 
 uint32_t DFF::id_counter = 0;
@@ -27,7 +28,7 @@ bool SequentialElement::detect_edge() {
         return false;
     }
     
-    uint8_t current_clock = clock->get_value();
+    uint8_t current_clock = clock->get_value();  // Z counts as neither level
     bool edge_detected = false;
     
     switch (trigger_edge) {
@@ -38,7 +39,7 @@ bool SequentialElement::detect_edge() {
             edge_detected = (last_clock_value == 1 && current_clock == 0);
             break;
         case BOTH:
-            edge_detected = (last_clock_value != current_clock) && (current_clock != 2);
+            edge_detected = (last_clock_value != current_clock) && (current_clock <= 1);
             break;
     }
     
@@ -52,12 +53,40 @@ void SequentialElement::evaluate(Simulator* sim, uint64_t current_time) {
     }
 }
 
+bool SequentialElement::is_sequential() const {
+    return true;
+}
+
+void SequentialElement::get_fanin(std::vector<Signal*>& nets) const {
+    if (clock) {
+        nets.push_back(clock);
+    }
+    Component::get_fanin(nets);
+}
+
+void SequentialElement::save_state(std::vector<uint8_t>& out) const {
+    put_state(out, last_clock_value);
+}
+
+void SequentialElement::restore_state(const uint8_t*& in) {
+    get_state(in, last_clock_value);
+}
+
+Signal* SequentialElement::get_clock() const {
+    return clock;
+}
+
+SequentialElement::Edge SequentialElement::get_edge() const {
+    return trigger_edge;
+}
+
 
 // ===== D Flip-Flop Implementation =====
 
 DFF::DFF(uint64_t delay, Edge edge)
     : SequentialElement("DFF" + std::to_string(id_counter++), delay, edge),
-      d(nullptr), q(nullptr), async_reset(nullptr), enable(nullptr) {
+      d(nullptr), q(nullptr), async_reset(nullptr), enable(nullptr), in_domain(false),
+      timing_slot(TimingChecker::NO_SLOT) {
 }
 
 void DFF::connect_data(Signal* data) {
@@ -65,7 +94,7 @@ void DFF::connect_data(Signal* data) {
         throw std::invalid_argument("Cannot connect null data signal");
     }
     d = data;
-    d->attach_observer(this);  // Monitor data changes (for future setup/hold checks)
+    d->attach_observer(this);  // Monitor data changes (setup/hold checks)
 }
 
 void DFF::connect_q(Signal* output_signal) {
@@ -100,8 +129,17 @@ void DFF::on_clock_edge(Simulator* sim, uint64_t current_time) {
         return;  // Disabled, don't capture
     }
     
-    // Sample data input
-    uint8_t sampled_value = d->get_value();
+    // Sample data input (a floating D captures X)
+    uint8_t sampled_value = logic::buf1(d->get_value());
+
+    if constexpr (TIMING_CHECKS_COMPILED_IN) {
+        if (timing_slot != TimingChecker::NO_SLOT && sim->timing_checks_enabled()) {
+            TimingChecker& timing = sim->get_timing();
+            if (timing.clock_edge(timing_slot, current_time) && timing.get_force_x()) {
+                sampled_value = 2;  // D was not stable: the captured value is unknown
+            }
+        }
+    }
     
     // Only schedule event if value changed
     if (sampled_value != q->get_value()) {
@@ -117,7 +155,55 @@ void DFF::evaluate(Simulator* sim, uint64_t current_time) {
         }
         return;
     }
+
+    // Edges of a batched flop are handled by its ClockDomain
+    if (in_domain) {
+        return;
+    }
+
+    if constexpr (TIMING_CHECKS_COMPILED_IN) {
+        if (timing_slot != TimingChecker::NO_SLOT && d && sim->timing_checks_enabled()) {
+            TimingChecker& timing = sim->get_timing();
+            if (timing.data_changed(timing_slot, d->get_value(), current_time) &&
+                timing.get_force_x() && q && q->get_value() != 2) {
+                // D moved inside the hold window of the last capture
+                sim->schedule_event(Event(current_time + propagation_delay, q->get_id(), 2));
+            }
+        }
+    }
     
     // Otherwise, normal sequential evaluation (check for clock edge)
     SequentialElement::evaluate(sim, current_time);
 }
+
+void DFF::get_fanin(std::vector<Signal*>& nets) const {
+    for (Signal* sig : {clock, d, async_reset, enable}) {
+        if (sig) {
+            nets.push_back(sig);
+        }
+    }
+}
+
+Signal* DFF::get_data() const {
+    return d;
+}
+
+Signal* DFF::get_q() const {
+    return q;
+}
+
+Signal* DFF::get_reset() const {
+    return async_reset;
+}
+
+Signal* DFF::get_enable() const {
+    return enable;
+}
+
+bool DFF::is_in_domain() const {
+    return in_domain;
+}
+
+bool DFF::has_timing_checks() const {
+    return timing_slot != TimingChecker::NO_SLOT;
+}
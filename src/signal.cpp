@@ -1,15 +1,17 @@
 #include "signal.h"
+#include "logic.h"
 #include <stdexcept>
+#include <algorithm>
 
 uint32_t Signal::id_counter = 0;
 
 Signal::Signal(const std::string& signal_name, uint8_t initial_value) 
-    : id(id_counter++), name(signal_name), current_value(initial_value) {
+    : id(id_counter++), index(0), name(signal_name), current_value(logic::canonical(initial_value)) {
     /*Initial value validation*/
 
     // raise error for invalid values
-    if (initial_value > 2) {
-        throw std::invalid_argument("Initial signal value must be 0, 1, or 2 (for 'X')");
+    if (initial_value > LOGIC_Z) {
+        throw std::invalid_argument("Initial signal value must be 0, 1, 2 (for 'X') or 3 (for 'Z')");
     }
     // raise error for empty names
     if (signal_name.empty()) {
@@ -17,16 +19,12 @@ Signal::Signal(const std::string& signal_name, uint8_t initial_value)
     }
 }
 
-uint8_t Signal::get_value() const {
-    return current_value;
-}
-
 void Signal::set_value(uint8_t new_val) {
     // Value validation, raise error for invalid values
-    if (new_val > 2) {
-        throw std::invalid_argument("Signal value must be 0, 1, or 2 (for 'X')");
+    if (new_val > LOGIC_Z) {
+        throw std::invalid_argument("Signal value must be 0, 1, 2 (for 'X') or 3 (for 'Z')");
     }   
-    current_value = new_val;
+    current_value = logic::canonical(new_val);
 }
 
 const std::string& Signal::get_name() const {
@@ -37,6 +35,10 @@ void Signal::attach_observer(Component* component) {
     observers.push_back(component);
 }
 
+void Signal::detach_observer(Component* component) {
+    observers.erase(std::remove(observers.begin(), observers.end(), component), observers.end());
+}
+
 const std::vector<Component*>& Signal::get_observers() const {
     return observers;
 }
@@ -46,6 +48,7 @@ std::string Signal::value_to_string() const {
         case 0: return "0";
         case 1: return "1";
         case 2: return "X";
+        case 3: return "Z";
         default: return "X";
     }
 }
@@ -53,7 +56,3 @@ std::string Signal::value_to_string() const {
 std::string Signal::to_string() const {
     return "Signal " + name + ": " + value_to_string();
 }
-
-uint32_t Signal::get_id() const {
-    return id;
-}
\ No newline at end of file
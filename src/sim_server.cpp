@@ -0,0 +1,741 @@
+#include "sim_server.h"
+#include "simulator.h"
+#include "component.h"
+#include "signal.h"
+#include "event.h"
+#include "logic.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace {
+
+constexpr size_t MAX_LINE = 1 << 20;          // Longest request line accepted
+constexpr size_t FLUSH_BYTES = 64 * 1024;     // Stream traced changes in chunks this size
+constexpr uint64_t MAX_CLOCK_EDGES = 1 << 24; // Per clock, per request
+constexpr uint64_t DEFAULT_EVENT_LIMIT = 50000000;
+
+// Takes the next complete line (without '\n') from `buffer`, consumed up to
+// `pos`. False if no whole line is buffered.
+bool take_line(const std::string& buffer, size_t& pos, std::string& line) {
+    size_t end = buffer.find('\n', pos);
+    if (end == std::string::npos) {
+        return false;
+    }
+    line.assign(buffer, pos, end - pos);
+    pos = end + 1;
+    if (!line.empty() && line.back() == '\r') {
+        line.pop_back();
+    }
+    return true;
+}
+
+// Appends what `fd` has to `buffer` after dropping the consumed part, up to
+// `pos`. Blocks unless `wait` is false; then returns true with nothing read
+// when no data is pending. False on end of stream or error.
+bool receive(int fd, std::string& buffer, size_t& pos, bool wait) {
+    buffer.erase(0, pos);  // Only the unconsumed part is kept
+    pos = 0;
+    char chunk[65536];
+    while (true) {
+        ssize_t n = recv(fd, chunk, sizeof(chunk), wait ? 0 : MSG_DONTWAIT);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && !wait && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return true;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        buffer.append(chunk, n);
+        return true;
+    }
+}
+
+// Reads one line (without '\n') from `fd`, blocking until it is complete.
+// `buffer` holds received bytes, consumed up to `pos`. False on end of
+// stream, error or a line longer than MAX_LINE.
+bool read_line(int fd, std::string& buffer, size_t& pos, std::string& line) {
+    while (!take_line(buffer, pos, line)) {
+        if (buffer.size() - pos > MAX_LINE || !receive(fd, buffer, pos, true)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool write_all(int fd, const std::string& text) {
+    size_t sent = 0;
+    while (sent < text.size()) {
+        ssize_t n = send(fd, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        sent += n;
+    }
+    return true;
+}
+
+std::vector<std::string> split(const std::string& line) {
+    std::vector<std::string> tokens;
+    size_t pos = 0;
+    while ((pos = line.find_first_not_of(" \t", pos)) != std::string::npos) {
+        size_t end = line.find_first_of(" \t", pos);
+        tokens.push_back(line.substr(pos, end - pos));
+        pos = end;
+    }
+    return tokens;
+}
+
+uint64_t parse_number(const std::string& text) {
+    if (text.empty() || text.size() > 19 || text.find_first_not_of("0123456789") != std::string::npos) {
+        throw std::invalid_argument("bad number '" + text + "'");
+    }
+    return std::stoull(text);
+}
+
+uint8_t parse_value(const std::string& text) {
+    uint8_t value = text.size() == 1 ? logic::from_char(text[0]) : 0xFF;
+    if (value == 0xFF) {
+        throw std::invalid_argument("bad value '" + text + "'");
+    }
+    return value;
+}
+
+}  // namespace
+
+struct SimServer::Connection {
+    int fd;
+    std::string in;
+    size_t in_pos = 0;   // Consumed part of `in`
+    size_t scanned = 0;  // Lines before this offset hold no request end
+    std::string out;
+    bool broken = false;  // A send failed: drop output, close after the request
+
+    explicit Connection(int socket_fd) : fd(socket_fd) {}
+
+    // Whether `in` holds a whole request, up to its run, designs or shutdown
+    // line, so a worker can parse it without waiting on the client
+    bool request_buffered() {
+        std::string line;
+        size_t pos = std::max(scanned, in_pos);
+        while (true) {
+            size_t start = pos;
+            if (!take_line(in, pos, line)) {
+                scanned = start;
+                return false;
+            }
+            std::vector<std::string> tokens = split(line);
+            if (!tokens.empty() && (tokens[0] == "run" || tokens[0] == "designs" || tokens[0] == "shutdown")) {
+                scanned = start;
+                return true;
+            }
+        }
+    }
+
+    // Reads what the client has sent without blocking. False when it hung
+    // up, failed, or sent a line longer than MAX_LINE.
+    bool receive_pending() {
+        size_t consumed = in_pos;
+        if (!receive(fd, in, in_pos, false)) {
+            return false;
+        }
+        scanned -= std::min(scanned, consumed);
+        return in.size() - scanned <= MAX_LINE || in.find('\n', scanned) != std::string::npos;
+    }
+
+    void flush() {
+        if (!broken && !write_all(fd, out)) {
+            broken = true;
+        }
+        out.clear();
+    }
+};
+
+namespace {
+
+// Observer on the traced nets of one run: formats each change into the
+// connection's output and flushes it in chunks while the run goes on
+class TraceTap : public Component {
+public:
+    TraceTap() : out(nullptr), start(0) {
+        id = "SERVER_TRACE";
+        propagation_delay = 0;
+    }
+
+    // `flush` sends and clears `output`; false once the client is gone
+    void begin(std::string& output, std::function<bool()> flush, const std::vector<Signal*>& traced,
+               uint64_t start_time) {
+        out = &output;
+        flush_out = std::move(flush);
+        start = start_time;
+        for (Signal* sig : traced) {
+            if (slot.emplace(sig, nets.size()).second) {
+                nets.push_back(sig);
+                last.push_back(sig->get_value());
+                sig->attach_observer(this);
+                emit(sig, 0, sig->get_value());
+            }
+        }
+    }
+
+    void end() {
+        for (Signal* sig : nets) {
+            sig->detach_observer(this);
+        }
+        nets.clear();
+        last.clear();
+        slot.clear();
+        flush_out = nullptr;
+    }
+
+    void evaluate(Simulator* sim, uint64_t current_time) override {
+        Signal* sig = sim->get_trigger();
+        auto it = slot.find(sig);
+        if (it == slot.end() || last[it->second] == sig->get_value()) {
+            return;
+        }
+        last[it->second] = sig->get_value();
+        emit(sig, current_time - start, sig->get_value());
+        if (out->size() >= FLUSH_BYTES && !flush_out()) {
+            sim->stop();  // Client is gone
+        }
+    }
+
+private:
+    std::string* out;
+    std::function<bool()> flush_out;
+    uint64_t start;
+    std::vector<Signal*> nets;
+    std::vector<uint8_t> last;
+    std::unordered_map<const Signal*, size_t> slot;
+
+    void emit(const Signal* sig, uint64_t time, uint8_t value) {
+        *out += std::to_string(time);
+        *out += ' ';
+        *out += sig->get_name();
+        *out += ' ';
+        *out += logic::to_char(value);
+        *out += '\n';
+    }
+};
+
+}  // namespace
+
+struct SimServer::Worker {
+    struct Resident {
+        std::string name;
+        std::unique_ptr<Simulator> sim;
+        Simulator::Snapshot initial;  // State right after elaboration
+        TraceTap* tap;
+    };
+    std::vector<Resident> residents;
+    std::thread thread;
+
+    Resident* find(const std::string& name) {
+        for (Resident& resident : residents) {
+            if (resident.name == name) {
+                return &resident;
+            }
+        }
+        return nullptr;
+    }
+};
+
+SimServer::SimServer(const std::string& socket_path, size_t workers)
+    : path(socket_path), worker_threads(workers ? workers : std::max(1u, std::thread::hardware_concurrency())),
+      event_limit(DEFAULT_EVENT_LIMIT), listen_fd(-1), wake_pipe{-1, -1}, running(false),
+      shutdown_requested(false), served(0), failed(0) {
+}
+
+SimServer::~SimServer() {
+    stop();
+}
+
+void SimServer::add_design(const std::string& name, DesignBuilder build) {
+    if (running) {
+        throw std::logic_error("Designs must be added before the server starts");
+    }
+    if (name.empty() || name.find_first_of(" \t\n") != std::string::npos) {
+        throw std::invalid_argument("Design names cannot be empty or contain whitespace");
+    }
+    designs.emplace_back(name, std::move(build));
+}
+
+void SimServer::start() {
+    if (running) {
+        throw std::logic_error("Server already started");
+    }
+
+    // Elaborate first, so the socket only appears once the server can answer
+    try {
+        for (size_t i = 0; i < worker_threads; i++) {
+            Worker* worker = new Worker;
+            workers.push_back(worker);
+            for (const auto& design : designs) {
+                Worker::Resident resident;
+                resident.name = design.first;
+                resident.sim = std::make_unique<Simulator>();
+                design.second(*resident.sim);
+                resident.sim->disable_coverage();
+                resident.tap = resident.sim->create_component<TraceTap>();
+                resident.initial = resident.sim->save_snapshot();
+                worker->residents.push_back(std::move(resident));
+            }
+        }
+    } catch (...) {
+        for (Worker* worker : workers) {
+            delete worker;
+        }
+        workers.clear();
+        throw;
+    }
+
+    auto fail = [&](const std::string& what) {
+        std::string message = what + ": " + std::strerror(errno);
+        for (Worker* worker : workers) {
+            delete worker;
+        }
+        workers.clear();
+        for (int* fd : {&listen_fd, &wake_pipe[0], &wake_pipe[1]}) {
+            if (*fd >= 0) {
+                close(*fd);
+                *fd = -1;
+            }
+        }
+        throw std::runtime_error(message);
+    };
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) {
+        errno = ENAMETOOLONG;
+        fail("Socket path " + path);
+    }
+    std::strcpy(addr.sun_path, path.c_str());
+
+    // A stale socket left by a dead server is replaced; a live one is not
+    struct stat st;
+    if (stat(path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) {
+        int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        bool live = probe >= 0 && connect(probe, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+        if (probe >= 0) {
+            close(probe);
+        }
+        if (live) {
+            errno = EADDRINUSE;
+            fail("Socket " + path);
+        }
+        unlink(path.c_str());
+    }
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+        fail("socket");
+    }
+    if (bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        fail("Cannot bind " + path);
+    }
+    if (listen(listen_fd, 128) < 0) {
+        fail("listen");
+    }
+    if (pipe2(wake_pipe, O_CLOEXEC | O_NONBLOCK) < 0) {
+        fail("pipe");
+    }
+
+    shutdown_requested = false;
+    running = true;
+    dispatcher = std::thread(&SimServer::dispatch_loop, this);
+    for (Worker* worker : workers) {
+        worker->thread = std::thread(&SimServer::worker_loop, this, worker);
+    }
+}
+
+void SimServer::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running.exchange(false)) {
+            return;
+        }
+    }
+    shutdown_cv.notify_all();
+    (void)!write(wake_pipe[1], "x", 1);
+    dispatcher.join();
+    {
+        // Unblock workers sending to a client
+        std::lock_guard<std::mutex> lock(mutex);
+        for (Connection* conn : connections) {
+            shutdown(conn->fd, SHUT_RDWR);
+        }
+    }
+    ready_cv.notify_all();
+    for (Worker* worker : workers) {
+        worker->thread.join();
+        delete worker;
+    }
+    workers.clear();
+
+    for (Connection* conn : connections) {
+        close(conn->fd);
+        delete conn;
+    }
+    connections.clear();
+    ready.clear();
+    returned.clear();
+    close(listen_fd);
+    close(wake_pipe[0]);
+    close(wake_pipe[1]);
+    listen_fd = wake_pipe[0] = wake_pipe[1] = -1;
+    unlink(path.c_str());
+}
+
+void SimServer::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    shutdown_cv.wait(lock, [this] { return shutdown_requested || !running; });
+}
+
+// Watches idle connections and the listening socket; a connection with a
+// whole request buffered goes to the ready queue and comes back once that
+// request is served
+void SimServer::dispatch_loop() {
+    std::vector<Connection*> idle;
+    std::vector<pollfd> fds;
+    while (running) {
+        fds.clear();
+        fds.push_back({wake_pipe[0], POLLIN, 0});
+        fds.push_back({listen_fd, POLLIN, 0});
+        for (Connection* conn : idle) {
+            fds.push_back({conn->fd, POLLIN, 0});
+        }
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        // Input is collected here; a connection is only handed to a worker
+        // once a whole request is buffered, so a slow or stalled client
+        // never holds a worker
+        std::vector<Connection*> still_idle;
+        std::vector<Connection*> woke;
+        for (size_t i = 0; i < idle.size(); i++) {
+            Connection* conn = idle[i];
+            if (!fds[i + 2].revents) {
+                still_idle.push_back(conn);
+            } else if (!conn->receive_pending()) {
+                close_connection(conn);  // Hung up, failed, or an oversized line
+            } else {
+                (conn->request_buffered() ? woke : still_idle).push_back(conn);
+            }
+        }
+        idle.swap(still_idle);
+
+        if (fds[1].revents & POLLIN) {
+            int fd = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd >= 0) {
+                Connection* conn = new Connection(fd);
+                std::lock_guard<std::mutex> lock(mutex);
+                connections.insert(conn);
+                idle.push_back(conn);
+            }
+        }
+
+        if (fds[0].revents & POLLIN) {
+            char drain[64];
+            while (read(wake_pipe[0], drain, sizeof(drain)) > 0) {
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for (Connection* conn : returned) {
+            // Pipelined requests may already be buffered
+            (conn->request_buffered() ? woke : idle).push_back(conn);
+        }
+        returned.clear();
+        for (Connection* conn : woke) {
+            ready.push_back(conn);
+        }
+        if (!woke.empty()) {
+            ready_cv.notify_all();
+        }
+    }
+}
+
+void SimServer::worker_loop(Worker* worker) {
+    while (true) {
+        Connection* conn;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            ready_cv.wait(lock, [this] { return !ready.empty() || !running; });
+            if (!running) {
+                return;
+            }
+            conn = ready.front();
+            ready.pop_front();
+        }
+        serve(worker, conn);
+    }
+}
+
+void SimServer::close_connection(Connection* conn) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (connections.erase(conn)) {
+        close(conn->fd);
+        delete conn;
+    }
+}
+
+void SimServer::serve(Worker* worker, Connection* conn) {
+    // Parse one buffered request; the first malformed line is reported once it ends
+    SimRequest request;
+    std::string error;
+    std::string line;
+    bool complete = false;
+    bool list_designs = false;
+    bool shutdown_asked = false;
+    while (!complete && take_line(conn->in, conn->in_pos, line)) {
+        std::vector<std::string> tokens = split(line);
+        if (tokens.empty()) {
+            continue;
+        }
+        const std::string& command = tokens[0];
+        try {
+            if (command == "designs") {
+                list_designs = complete = true;
+            } else if (command == "shutdown") {
+                shutdown_asked = complete = true;
+            } else if (command == "design" && tokens.size() == 2) {
+                request.design = tokens[1];
+            } else if (command == "set" && tokens.size() == 4) {
+                request.drives.push_back({tokens[1], parse_number(tokens[2]), parse_value(tokens[3])});
+            } else if (command == "clock" && tokens.size() == 3) {
+                request.clocks.push_back({tokens[1], parse_number(tokens[2])});
+            } else if (command == "trace" && tokens.size() >= 2) {
+                request.traces.insert(request.traces.end(), tokens.begin() + 1, tokens.end());
+            } else if (command == "run" && tokens.size() == 2) {
+                request.run_length = parse_number(tokens[1]);
+                complete = true;
+            } else {
+                throw std::invalid_argument("bad request line '" + line + "'");
+            }
+        } catch (const std::invalid_argument& e) {
+            if (error.empty()) {
+                error = e.what();
+            }
+            complete = command == "run";
+        }
+    }
+    if (!complete) {
+        close_connection(conn);  // Not reached: the dispatcher waits for a whole request
+        return;
+    }
+
+    if (shutdown_asked) {
+        conn->out = "bye\n";
+        conn->flush();
+        std::lock_guard<std::mutex> lock(mutex);
+        shutdown_requested = true;
+        shutdown_cv.notify_all();
+    } else if (list_designs) {
+        conn->out = "designs";
+        for (const auto& design : designs) {
+            conn->out += " " + design.first;
+        }
+        conn->out += "\n";
+    } else {
+        Worker::Resident* resident = worker->find(request.design);
+        if (error.empty() && !resident) {
+            error = "unknown design '" + request.design + "'";
+        }
+
+        // Resolve everything before answering, so a bad request is one error line
+        std::vector<Event> stimulus;
+        std::vector<Signal*> traced;
+        Simulator* sim = resident ? resident->sim.get() : nullptr;
+        uint64_t start = resident ? resident->initial.time : 0;
+        auto lookup = [&](const std::string& name) {
+            Signal* sig = sim->get_signal_by_name(name);
+            if (!sig && error.empty()) {
+                error = "unknown net '" + name + "'";
+            }
+            return sig;
+        };
+        if (error.empty()) {
+            for (const SimRequest::Drive& drive : request.drives) {
+                Signal* sig = lookup(drive.net);
+                if (sig && drive.time <= request.run_length) {
+                    stimulus.emplace_back(start + drive.time, sig->get_id(), drive.value);
+                }
+            }
+            for (const SimRequest::Clock& clock : request.clocks) {
+                Signal* sig = lookup(clock.net);
+                uint64_t half = clock.period / 2;
+                if (sig && half == 0) {
+                    error = "clock period must be at least 2";
+                } else if (sig && request.run_length / half > MAX_CLOCK_EDGES) {
+                    error = "too many clock edges";
+                } else if (sig) {
+                    uint8_t value = 1;
+                    for (uint64_t t = half; t <= request.run_length; t += half, value ^= 1) {
+                        stimulus.emplace_back(start + t, sig->get_id(), value);
+                    }
+                }
+            }
+            for (const std::string& name : request.traces) {
+                traced.push_back(lookup(name));
+            }
+        }
+
+        if (!error.empty()) {
+            conn->out = "error " + error + "\n";
+            failed++;
+        } else {
+            sim->restore_snapshot(resident->initial);
+            for (const Event& e : stimulus) {
+                sim->schedule_event(e);
+            }
+            uint64_t events = sim->get_events_processed();
+            uint64_t evaluations = sim->get_evaluations();
+            conn->out = "ok " + request.design + "\n";
+            resident->tap->begin(conn->out, [conn] { conn->flush(); return !conn->broken; }, traced, start);
+            try {
+                // run_until, with the event limit checked after every step
+                uint64_t end = start + request.run_length;
+                while (!sim->stopped() && sim->has_pending_events() && sim->get_next_event_time() <= end) {
+                    sim->step();
+                    if (event_limit && sim->get_events_processed() - events > event_limit) {
+                        throw std::runtime_error("event limit of " + std::to_string(event_limit) +
+                                                 " exceeded at t=" + std::to_string(sim->get_current_time() - start));
+                    }
+                }
+                conn->out += "done " + std::to_string(sim->get_current_time() - start) + " " +
+                             std::to_string(sim->get_events_processed() - events) + " " +
+                             std::to_string(sim->get_evaluations() - evaluations) + "\n";
+                served++;
+            } catch (const std::exception& e) {
+                conn->out += std::string("error ") + e.what() + "\n";
+                failed++;
+            }
+            resident->tap->end();
+        }
+    }
+
+    conn->flush();
+    if (conn->broken || !running) {
+        close_connection(conn);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    returned.push_back(conn);
+    (void)!write(wake_pipe[1], "x", 1);
+}
+
+// ===== Client =====
+
+SimClient::SimClient(const std::string& socket_path) : buffer_pos(0) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(addr.sun_path)) {
+        throw std::runtime_error("Socket path too long: " + socket_path);
+    }
+    std::strcpy(addr.sun_path, socket_path.c_str());
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        std::string message = "Cannot connect to " + socket_path + ": " + std::strerror(errno);
+        if (fd >= 0) {
+            close(fd);
+        }
+        throw std::runtime_error(message);
+    }
+}
+
+SimClient::~SimClient() {
+    close(fd);
+}
+
+void SimClient::send_text(const std::string& text) {
+    if (!write_all(fd, text)) {
+        throw std::runtime_error(std::string("Send to server failed: ") + std::strerror(errno));
+    }
+}
+
+std::string SimClient::read_line() {
+    std::string line;
+    if (!::read_line(fd, buffer, buffer_pos, line)) {
+        throw std::runtime_error("Server closed the connection");
+    }
+    if (line.compare(0, 6, "error ") == 0) {
+        throw std::runtime_error("Server: " + line.substr(6));
+    }
+    return line;
+}
+
+SimResult SimClient::run(const SimRequest& request) {
+    std::string text = "design " + request.design + "\n";
+    for (const SimRequest::Drive& drive : request.drives) {
+        text += "set " + drive.net + " " + std::to_string(drive.time) + " " + logic::to_char(drive.value) + "\n";
+    }
+    for (const SimRequest::Clock& clock : request.clocks) {
+        text += "clock " + clock.net + " " + std::to_string(clock.period) + "\n";
+    }
+    if (!request.traces.empty()) {
+        text += "trace";
+        for (const std::string& net : request.traces) {
+            text += " " + net;
+        }
+        text += "\n";
+    }
+    text += "run " + std::to_string(request.run_length) + "\n";
+    send_text(text);
+
+    std::string line = read_line();
+    if (line.compare(0, 3, "ok ") != 0) {
+        throw std::runtime_error("Unexpected answer: " + line);
+    }
+    SimResult result;
+    while (true) {
+        line = read_line();
+        std::vector<std::string> tokens = split(line);
+        if (tokens.size() == 4 && tokens[0] == "done") {
+            result.end_time = parse_number(tokens[1]);
+            result.events = parse_number(tokens[2]);
+            result.evaluations = parse_number(tokens[3]);
+            return result;
+        }
+        if (tokens.size() != 3) {
+            throw std::runtime_error("Unexpected answer: " + line);
+        }
+        result.changes.push_back({parse_number(tokens[0]), tokens[1], parse_value(tokens[2])});
+    }
+}
+
+void SimClient::shutdown() {
+    send_text("shutdown\n");
+    if (read_line() != "bye") {
+        throw std::runtime_error("Unexpected answer to shutdown");
+    }
+}
+
+std::vector<std::string> SimClient::designs() {
+    send_text("designs\n");
+    std::vector<std::string> names = split(read_line());
+    if (names.empty() || names[0] != "designs") {
+        throw std::runtime_error("Unexpected answer to designs");
+    }
+    names.erase(names.begin());
+    return names;
+}
@@ -1,24 +1,56 @@
 #include "simulator.h"
+#include "sequential.h"
+#include "history.h"
+#include "trace_writer.h"
+#include "logic.h"
 #include <stdexcept>
 #include <iostream>
 #include <fstream>
 #include <iomanip>
 #include <functional>
+#include <algorithm>
+#include <chrono>
+#include <unordered_set>
 
 // Helper: convert value to char
 static char value_to_char(uint8_t val) {
-    if (val == 0) return '0';
-    if (val == 1) return '1';
-    return 'X';
+    return logic::to_char(val);
 }
 
-Simulator::Simulator() : current_time(0), trace_enabled(false) {
+// Scope tree for nested VCD $scope sections
+struct VcdScope {
+    std::map<std::string, VcdScope> children;
+    std::vector<std::pair<std::string, Signal*>> vars;
+};
+
+static void write_vcd_scope(std::ostream& file, const std::string& name, const VcdScope& scope) {
+    file << "$scope module " << name << " $end\n";
+    for (const auto& var : scope.vars) {
+        file << "$var wire 1 " << var.second->get_id() << " " << var.first << " $end\n";
+    }
+    for (const auto& child : scope.children) {
+        write_vcd_scope(file, child.first, child.second);
+    }
+    file << "$upscope $end\n";
+}
+
+Simulator::Simulator()
+    : id_base(0), current_time(0), trace_enabled(false), trace_id_base(0), trace_writer(nullptr),
+      events_processed(0), evaluations(0), stats_enabled(false), activity_enabled(false),
+      coverage_enabled(true), trigger(nullptr), delta_limit(10000), batch_enabled(false), batch_dirty(true),
+      stop_requested(false), history(nullptr), timing_enabled(false) {
     trace_log.reserve(10000);  // Pre-allocate for performance
 }
 
 Signal* Simulator::create_signal(const std::string& name, uint8_t value){
     Signal* sig = new Signal(name, value);
-    add_signal(sig);
+    try {
+        add_signal(sig);
+    } catch (...) {
+        delete sig;
+        throw;
+    }
+    owned_signals.push_back(sig);
     return sig;
 }
 
@@ -32,9 +64,28 @@ void Simulator::add_signal(Signal* sig) {
         throw std::runtime_error("Signal name '" + sig->get_name() + "' already exists");
     }
     
+    sig->index = signals.size();
     signals.push_back(sig);
+    if (stats_enabled) {
+        stats.net_events.push_back(0);
+    }
+    if (activity_enabled) {
+        activity.add_net(sig->get_value(), current_time);
+    }
+    coverage.add_net(sig->get_name(), sig->get_value());
     signal_by_name[sig->get_name()] = sig;
-    signal_by_id[sig->get_id()] = sig;
+    int id = sig->get_id();
+    if (signal_by_id.empty()) {
+        id_base = id;
+    } else if (id < id_base) {
+        signal_by_id.insert(signal_by_id.begin(), id_base - id, nullptr);
+        id_base = id;
+    }
+    if ((size_t)(id - id_base) >= signal_by_id.size()) {
+        signal_by_id.resize(id - id_base + 1, nullptr);
+    }
+    signal_by_id[id - id_base] = sig;
+    pending_slots.emplace_back();
 
     initial_values[sig->get_id()] = sig->get_value();
 }
@@ -43,7 +94,12 @@ void Simulator::add_component(Component* component) {
     if (!component) {
         throw std::invalid_argument("Cannot add null component");
     }
+    component->index = components.size();
     components.push_back(component);
+    batch_dirty = true;
+    if (stats_enabled) {
+        stats.component_evaluations.push_back(0);
+    }
 }
 
 Signal* Simulator::get_signal_by_name(const std::string& name) {
@@ -55,35 +111,226 @@ Signal* Simulator::get_signal_by_name(const std::string& name) {
 }
 
 Signal* Simulator::get_signal_by_id(int id) {
-    auto it = signal_by_id.find(id);
-    if (it == signal_by_id.end()) {
+    if (id < id_base || (size_t)(id - id_base) >= signal_by_id.size()) {
         return nullptr;
     }
+    return signal_by_id[id - id_base];
+}
+
+const std::vector<Signal*>& Simulator::get_signals() const {
+    return signals;
+}
+
+const std::vector<Component*>& Simulator::get_components() const {
+    return components;
+}
+
+void Simulator::remove_components(const std::vector<Component*>& list) {
+    std::unordered_set<Component*> dead(list.begin(), list.end());
+    if (dead.empty()) {
+        return;
+    }
+
+    std::vector<Component*> detached;
+    for (Signal* sig : signals) {
+        detached.clear();
+        for (Component* observer : sig->get_observers()) {
+            if (dead.count(observer)) {
+                detached.push_back(observer);
+            }
+        }
+        for (Component* observer : detached) {
+            sig->detach_observer(observer);
+        }
+    }
+
+    auto is_dead = [&](Component* c) { return dead.count(c) > 0; };
+    components.erase(std::remove_if(components.begin(), components.end(), is_dead), components.end());
+    for (Component* component : owned_components) {
+        if (is_dead(component)) {
+            delete component;
+        }
+    }
+    owned_components.erase(std::remove_if(owned_components.begin(), owned_components.end(), is_dead),
+                           owned_components.end());
+    reindex();
+}
+
+void Simulator::remove_signals(const std::vector<Signal*>& list) {
+    std::unordered_set<Signal*> dead(list.begin(), list.end());
+    if (dead.empty()) {
+        return;
+    }
+
+    for (Signal* sig : dead) {
+        signal_by_name.erase(sig->get_name());
+        if (get_signal_by_id(sig->get_id()) == sig) {
+            signal_by_id[sig->get_id() - id_base] = nullptr;
+        }
+        initial_values.erase(sig->get_id());
+        constant_values.erase(sig->get_id());
+        probed_ids.erase(sig->get_id());
+    }
+
+    auto is_dead = [&](Signal* sig) { return dead.count(sig) > 0; };
+    signals.erase(std::remove_if(signals.begin(), signals.end(), is_dead), signals.end());
+    for (Signal* sig : owned_signals) {
+        if (is_dead(sig)) {
+            delete sig;
+        }
+    }
+    owned_signals.erase(std::remove_if(owned_signals.begin(), owned_signals.end(), is_dead),
+                        owned_signals.end());
+    reindex();
+}
+
+void Simulator::reindex() {
+    for (size_t i = 0; i < signals.size(); i++) {
+        signals[i]->index = i;
+    }
+    pending_slots.assign(signals.size(), PendingSlot());  // Stale slots only cost a coalescing chance
+    for (size_t i = 0; i < components.size(); i++) {
+        components[i]->index = i;
+    }
+    batch_dirty = true;
+
+    // Per-net tables are indexed by the dense index, so start them over
+    coverage = CoverageDB();
+    for (Signal* sig : signals) {
+        coverage.add_net(sig->get_name(), sig->get_value());
+    }
+    if (stats_enabled) {
+        enable_stats();
+    }
+    if (activity_enabled) {
+        enable_activity();
+    }
+}
+
+void Simulator::tie_constant(Signal* sig, uint8_t value) {
+    if (!sig || get_signal_by_id(sig->get_id()) != sig) {
+        throw std::invalid_argument("Cannot tie an unregistered signal");
+    }
+    if (value > 1) {
+        throw std::invalid_argument("Constant value must be 0 or 1");
+    }
+    constant_values[sig->get_id()] = value;
+    schedule_event(Event(current_time, sig->get_id(), value));
+}
+
+bool Simulator::is_constant(const Signal* sig) const {
+    return constant_values.count(sig->get_id()) > 0;
+}
+
+uint8_t Simulator::get_constant(const Signal* sig) const {
+    auto it = constant_values.find(sig->get_id());
+    if (it == constant_values.end()) {
+        throw std::invalid_argument("Signal '" + sig->get_name() + "' is not a constant");
+    }
     return it->second;
 }
 
+void Simulator::probe(Signal* sig) {
+    if (!sig) {
+        throw std::invalid_argument("Cannot probe null signal");
+    }
+    probed_ids.insert(sig->get_id());
+}
+
+bool Simulator::is_probed(const Signal* sig) const {
+    return probed_ids.count(sig->get_id()) > 0;
+}
+
 void Simulator::schedule_event(const Event& e) {
-    event_queue.schedule(e);
+    Signal* sig = get_signal_by_id(e.signal_id);
+    event_queue.schedule(e, sig ? &pending_slots[sig->index] : nullptr);
+}
+
+void Simulator::schedule_batch(const Event* events, size_t count) {
+    event_queue.begin_batch();
+    for (size_t i = 0; i < count; i++) {
+        Signal* sig = get_signal_by_id(events[i].signal_id);
+        event_queue.schedule(events[i], sig ? &pending_slots[sig->index] : nullptr);
+    }
+    event_queue.end_batch();
+}
+
+uint32_t Simulator::schedule_wake(uint64_t time, void (*fn)(void* context), void* context) {
+    if (!fn) {
+        throw std::invalid_argument("Cannot schedule a null wake function");
+    }
+    uint32_t slot;
+    if (!free_wake_slots.empty()) {
+        slot = free_wake_slots.back();
+        free_wake_slots.pop_back();
+        wake_slots[slot] = {fn, context};
+    } else {
+        slot = wake_slots.size();
+        wake_slots.push_back({fn, context});
+    }
+    event_queue.schedule(Event(time, -1 - (int)slot, 0));
+    return slot;
+}
+
+void Simulator::cancel_wake(uint32_t slot) {
+    // The slot is recycled when its event is popped, not before
+    if (slot < wake_slots.size()) {
+        wake_slots[slot].fn = nullptr;
+    }
 }
 
 void Simulator::step() {
     if (event_queue.empty()) {
         return;
     }
+    if (history && history->checkpoint_due(event_queue.next_time())) {
+        history->checkpoint();
+    }
 
-    std::vector<std::reference_wrapper<const std::vector<Component *>>> observer_lists;
-    bool same_step = true;
+    using Clock = std::chrono::steady_clock;
+    const bool record = STATS_COMPILED_IN && stats_enabled;
+    Clock::time_point step_start;
+    if (record) {
+        step_start = Clock::now();
+    }
+
+    size_t count = event_queue.begin_delta();
+    uint32_t delta = event_queue.current_delta();
+    if (delta > delta_limit) {
+        throw std::runtime_error("Delta cycle limit (" + std::to_string(delta_limit) + ") exceeded at t=" +
+                                 std::to_string(event_queue.current_time()) + "ps: zero-delay loop?");
+    }
 
-    while(same_step){
-        same_step = false;
+    uint64_t step_events = update_phase(count, record);
+    uint64_t step_evaluations = evaluate_phase(record);
 
+    if (record) {
+        stats.steps++;
+        stats.delta_cycles += delta > 0;
+        stats.events += step_events;
+        stats.evaluations += step_evaluations;
+        stats.events_per_step.record(step_events);
+        stats.evaluations_per_step.record(step_evaluations);
+        stats.step_seconds += std::chrono::duration<double>(Clock::now() - step_start).count();
+    }
+}
+
+// Apply one delta cycle's events to their nets; nothing is evaluated yet,
+// so every observer below sees all of the cycle's new values
+uint64_t Simulator::update_phase(size_t count, bool record) {
+    using Clock = std::chrono::steady_clock;
+    changed_nets.clear();
+    woken_slots.clear();
+
+    for (size_t i = 0; i < count; i++) {
         Event e = event_queue.pop_next();
         current_time = e.time;
+        events_processed++;
 
-        // True if multiple signals change at the same time stamp
-        // Register these simultaneous changes in one step
-        if (!event_queue.empty())
-            same_step = event_queue.next_time() == current_time;
+        if (e.signal_id < 0) {
+            woken_slots.push_back(-1 - e.signal_id);  // Process wake-up, not a net change
+            continue;
+        }
         
         Signal* sig = get_signal_by_id(e.signal_id);
         if (!sig) {
@@ -93,58 +340,341 @@ void Simulator::step() {
         
         uint8_t old_value = sig->get_value();
         sig->set_value(e.new_value);
+        uint8_t new_value = sig->get_value();  // As stored (two-state drops X/Z)
+        if (history) {
+            history->record(current_time, e.signal_id, new_value);
+        }
         
-        observer_lists.push_back(std::cref(sig->get_observers()));
+        changed_nets.push_back(sig);
 
-        // NEW: Log the change if tracing
-        if (trace_enabled && old_value != e.new_value) {
-            trace_log.push_back({current_time, sig->get_name(), old_value, e.new_value});
+        if (record) {
+            stats.net_events[sig->index]++;
         }
-        
-        // Console trace (if enabled)
+        if (activity_enabled) {
+            activity.record(sig->index, new_value, current_time);
+        }
+        if (coverage_enabled) {
+            coverage.record(sig->index, new_value, old_value);
+        }
+
         if (trace_enabled) {
-            std::cout << "t=" << current_time << "ps: " << sig->get_name() 
-                    << " " << value_to_char(old_value) << " -> " 
-                    << value_to_char(e.new_value) << "\n";
+            Clock::time_point trace_start;
+            if (record) {
+                trace_start = Clock::now();
+            }
+
+            if (trace_writer) {
+                if (old_value != new_value) {
+                    trace_writer->push(current_time, e.signal_id, new_value);
+                }
+            } else if (trace_store) {
+                // Out of core: no log, no console output
+                size_t slot = e.signal_id - trace_id_base;
+                if (old_value != new_value && slot < trace_slots.size()) {
+                    trace_store->record(current_time, trace_slots[slot], new_value);
+                }
+            } else {
+                // Log the change
+                if (old_value != new_value) {
+                    trace_log.push_back({current_time, sig->get_name(), old_value, new_value});
+                }
+
+                // Console trace
+                std::cout << "t=" << current_time << "ps: " << sig->get_name() 
+                        << " " << value_to_char(old_value) << " -> " 
+                        << value_to_char(new_value) << "\n";
+            }
+
+            if (record) {
+                stats.trace_seconds += std::chrono::duration<double>(Clock::now() - trace_start).count();
+            }
         }
-        
     }
-    
-    // Notify observers
-    for (const auto& list_wrapper : observer_lists) {
+    return count;
+}
+
+// Evaluate the observers of the changed nets, then resume woken processes.
+// Zero-delay outputs land in the queue's delta FIFO: the next delta cycle.
+uint64_t Simulator::evaluate_phase(bool record) {
+    uint64_t step_evaluations = 0;
+    if (batch_enabled && (batch_dirty || batcher.is_stale())) {
+        batcher.build(components);
+        batch_dirty = false;
+    }
+    for (Signal* sig : changed_nets) {
         
-        const std::vector<Component*>& observer_list = list_wrapper.get();
+        const std::vector<Component*>& observer_list = sig->get_observers();
+        trigger = sig;
         
         for (Component* component : observer_list) {
+            if (batch_enabled && batcher.defer(component)) {
+                continue;  // Evaluated with its batch below
+            }
             component->evaluate(this, current_time);
+            if (record) {
+                stats.component_evaluations[component->index]++;
+            }
+            step_evaluations++;
         }
     }
+    trigger = nullptr;
+    if (batch_enabled) {
+        step_evaluations += batcher.run(this, current_time, record ? stats.component_evaluations.data() : nullptr);
+    }
+    evaluations += step_evaluations;
+
+    // Resume processes last, so they see this step's settled evaluations
+    for (uint32_t slot : woken_slots) {
+        WakeSlot wake = wake_slots[slot];
+        wake_slots[slot].fn = nullptr;
+        free_wake_slots.push_back(slot);
+        if (wake.fn) {
+            wake.fn(wake.context);
+        }
+    }
+    return step_evaluations;
 }
 
 
 void Simulator::run_until(uint64_t end_time) {
-    while (!event_queue.empty() && event_queue.next_time() <= end_time) {
+    stop_requested = false;
+    while (!stop_requested && !event_queue.empty() && event_queue.next_time() <= end_time) {
         step();
     }
 }
 
 void Simulator::run_all() {
-    while (!event_queue.empty()) {
+    stop_requested = false;
+    while (!stop_requested && !event_queue.empty()) {
         step();
     }
 }
 
+void Simulator::stop() {
+    stop_requested = true;  // Pending events stay queued; a new run resumes
+}
+
+Simulator::Snapshot Simulator::save_snapshot() const {
+    Snapshot snapshot;
+    snapshot.time = current_time;
+    snapshot.values.reserve(signals.size());
+    for (Signal* sig : signals) {
+        snapshot.values.push_back(sig->get_value());
+    }
+    for (Component* component : components) {
+        component->save_state(snapshot.state);
+    }
+    for (const Event& e : event_queue.snapshot()) {
+        if (e.signal_id >= 0) {  // Process wake-ups cannot be restored
+            snapshot.pending.push_back(e);
+        }
+    }
+    return snapshot;
+}
+
+void Simulator::restore_snapshot(const Snapshot& snapshot) {
+    if (snapshot.values.size() != signals.size()) {
+        throw std::invalid_argument("Snapshot was taken from a different netlist");
+    }
+    for (size_t i = 0; i < signals.size(); i++) {
+        signals[i]->set_value(snapshot.values[i]);
+    }
+    const uint8_t* p = snapshot.state.data();
+    for (Component* component : components) {
+        component->restore_state(p);
+    }
+    event_queue.restore(snapshot.pending);
+    current_time = snapshot.time;
+    stop_requested = false;
+}
+
 uint64_t Simulator::get_current_time() const {
     return current_time;
 }
 
+uint64_t Simulator::get_events_processed() const {
+    return events_processed;
+}
+
+uint64_t Simulator::get_evaluations() const {
+    return evaluations;
+}
+
+size_t Simulator::get_signal_count() const {
+    return signals.size();
+}
+
+size_t Simulator::get_component_count() const {
+    return components.size();
+}
+
+void Simulator::enable_stats() {
+    stats_enabled = true;
+    stats.reset(signals.size(), components.size());
+    event_queue.reset_counters();
+}
+
+void Simulator::disable_stats() {
+    stats_enabled = false;
+}
+
+SimStats Simulator::get_stats(size_t top_n) const {
+    SimStats report;
+    report.steps = stats.steps;
+    report.delta_cycles = stats.delta_cycles;
+    report.events_processed = stats.events;
+    report.events_scheduled = event_queue.get_scheduled_count();
+    report.heap_events = event_queue.get_heap_count();
+    report.events_coalesced = event_queue.get_coalesced_count();
+    report.evaluations = stats.evaluations;
+    report.peak_queue_depth = event_queue.get_peak_size();
+    report.step_seconds = stats.step_seconds;
+    report.trace_seconds = stats.trace_seconds;
+    report.events_per_step = stats.events_per_step;
+    report.evaluations_per_step = stats.evaluations_per_step;
+
+    for (size_t i = 0; i < stats.component_evaluations.size(); i++) {
+        if (stats.component_evaluations[i]) {
+            report.evaluations_by_type[component_type_name(components[i]->get_id())] +=
+                stats.component_evaluations[i];
+        }
+    }
+    report.hottest_nets = top_entries(stats.net_events, top_n,
+                                      [this](size_t i) { return signals[i]->get_name(); });
+    report.hottest_components = top_entries(stats.component_evaluations, top_n,
+                                            [this](size_t i) { return components[i]->get_id(); });
+    return report;
+}
+
+void Simulator::dump_stats(const std::string& filename, size_t top_n) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+    file << get_stats(top_n).to_json();
+}
+
+void Simulator::enable_batch_eval(size_t min_batch) {
+    batcher.set_min_batch(min_batch);
+    batch_enabled = true;
+    batch_dirty = true;
+}
+
+void Simulator::disable_batch_eval() {
+    batch_enabled = false;
+}
+
+void Simulator::enable_activity() {
+    std::vector<uint8_t> values;
+    values.reserve(signals.size());
+    for (Signal* sig : signals) {
+        values.push_back(sig->get_value());
+    }
+    activity.reset(values, current_time);
+    activity_enabled = true;
+}
+
+void Simulator::disable_activity() {
+    activity_enabled = false;
+}
+
+ActivityProfile::NetActivity Simulator::get_activity(Signal* sig) const {
+    return activity.totals(sig->index, current_time);
+}
+
+void Simulator::dump_saif(const std::string& filename) const {
+    std::vector<std::string> names;
+    names.reserve(signals.size());
+    for (Signal* sig : signals) {
+        names.push_back(sig->get_name());
+    }
+    activity.write_saif(filename, names, current_time);
+}
+
+void Simulator::enable_coverage() {
+    coverage_enabled = true;
+}
+
+void Simulator::disable_coverage() {
+    coverage_enabled = false;
+}
+
+void Simulator::reset_coverage() {
+    coverage.clear();
+}
+
+CoverageDB Simulator::get_coverage() const {
+    CoverageDB snapshot = coverage;
+    for (Component* component : components) {
+        if (component->is_sequential() && component->get_output()) {
+            snapshot.mark_state(component->get_output()->index);
+        }
+    }
+    return snapshot;
+}
+
+void Simulator::enable_timing_checks(bool force_x) {
+    timing_enabled = true;
+    timing.set_force_x(force_x);
+    timing.reset();
+}
+
+void Simulator::disable_timing_checks() {
+    timing_enabled = false;
+}
+
+void Simulator::check_timing(DFF* flop, uint64_t setup, uint64_t hold) {
+    if (!flop) {
+        throw std::invalid_argument("Cannot check timing of null flop");
+    }
+    timing.add_flop(flop, setup, hold);
+}
+
+void Simulator::check_timing(uint64_t setup, uint64_t hold) {
+    for (Component* component : components) {
+        if (DFF* flop = dynamic_cast<DFF*>(component)) {
+            timing.add_flop(flop, setup, hold);
+        }
+    }
+}
+
 void Simulator::enable_trace() {
     trace_enabled = true;
     trace_log.clear();
+    trace_store.reset();
+    trace_writer = nullptr;
+}
+
+void Simulator::enable_trace(const std::string& path, uint32_t shard_signals) {
+    std::vector<std::string> names;
+    std::vector<uint8_t> initial;
+    trace_slots.assign(signal_by_id.size(), UINT32_MAX);
+    trace_id_base = id_base;
+    for (Signal* sig : signals) {
+        trace_slots[sig->get_id() - id_base] = names.size();
+        names.push_back(sig->get_name());
+        initial.push_back(sig->get_value());
+    }
+    trace_store.reset();  // Close the previous store first: `path` may be the same
+    trace_store.reset(new TraceStore(path, names, initial, current_time, shard_signals));
+    trace_writer = nullptr;
+    trace_enabled = true;
+    trace_log.clear();
+}
+
+void Simulator::enable_trace(TraceWriter* writer) {
+    trace_store.reset();
+    trace_writer = writer;
+    trace_enabled = true;
+    trace_log.clear();
 }
 
 void Simulator::disable_trace() {
     trace_enabled = false;
+    trace_writer = nullptr;
+    if (trace_store) {
+        trace_store->close(current_time);
+    }
 }
 
 void Simulator::print_trace() {
@@ -162,26 +692,35 @@ void Simulator::print_trace() {
     }
 }
 
-void Simulator::dump_waveform(const std::string& filename) {
-    std::ofstream file(filename);
-    if (!file.is_open()) {
-        throw std::runtime_error("Cannot open file: " + filename);
-    }
-    
-    // Header
+void Simulator::write_vcd_header(std::ostream& file) const {
     file << "$date\n";
     file << "  Digital Logic Simulator\n";
     file << "$end\n";
     file << "$timescale 1ps $end\n";
     
-    // Signal declarations
-    file << "$scope module top $end\n";
+    // Signal declarations, nested by hierarchical name ("cpu.alu.y")
+    VcdScope root;
     for (const auto& sig : signals) {
-        file << "$var wire 1 " << sig->get_id() << " " 
-             << sig->get_name() << " $end\n";
+        VcdScope* scope = &root;
+        const std::string& name = sig->get_name();
+        size_t start = 0;
+        for (size_t dot = name.find('.'); dot != std::string::npos; dot = name.find('.', start)) {
+            scope = &scope->children[name.substr(start, dot - start)];
+            start = dot + 1;
+        }
+        scope->vars.emplace_back(name.substr(start), sig);
     }
-    file << "$upscope $end\n";
+    write_vcd_scope(file, "top", root);
     file << "$enddefinitions $end\n";
+}
+
+void Simulator::dump_waveform(const std::string& filename) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+    
+    write_vcd_header(file);
     
     // Initial values
     file << "\n$dumpvars\n";
@@ -218,6 +757,12 @@ void Simulator::dump_waveform(const std::string& filename) {
 
 
 Simulator::~Simulator() {
-    // Note: We don't delete signals/gates here
-    // Assume caller manages memory (or use smart pointers later)
+    // Only objects created through create_signal/create_component are deleted;
+    // signals/gates registered with add_signal/add_component stay caller-owned
+    for (Component* component : owned_components) {
+        delete component;
+    }
+    for (Signal* sig : owned_signals) {
+        delete sig;
+    }
 }
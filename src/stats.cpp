@@ -0,0 +1,100 @@
+#include "stats.h"
+#include <sstream>
+
+// ===== Log2Histogram =====
+
+void Log2Histogram::record(uint64_t value) {
+    size_t bucket = 0;
+    while (bucket < 64 && (value >> bucket) != 0) {
+        bucket++;
+    }
+    buckets[bucket]++;
+    samples++;
+    total += value;
+    if (value > max) {
+        max = value;
+    }
+}
+
+double Log2Histogram::mean() const {
+    return samples ? (double)total / samples : 0.0;
+}
+
+std::string Log2Histogram::to_json() const {
+    std::ostringstream out;
+    out << "{\"samples\": " << samples << ", \"mean\": " << mean() << ", \"max\": " << max
+        << ", \"buckets\": [";
+
+    // Emit only up to the highest populated bucket; bucket k holds [2^(k-1), 2^k)
+    size_t last = 0;
+    for (size_t i = 0; i < buckets.size(); i++) {
+        if (buckets[i]) {
+            last = i;
+        }
+    }
+    for (size_t i = 0; i <= last; i++) {
+        uint64_t lo = i == 0 ? 0 : (1ULL << (i - 1));
+        out << (i ? ", " : "") << "{\"ge\": " << lo << ", \"count\": " << buckets[i] << "}";
+    }
+    out << "]}";
+    return out.str();
+}
+
+// ===== StatsCollector =====
+
+void StatsCollector::reset(size_t num_signals, size_t num_components) {
+    *this = StatsCollector();
+    net_events.assign(num_signals, 0);
+    component_evaluations.assign(num_components, 0);
+}
+
+// ===== SimStats =====
+
+static std::string hot_list_json(const std::vector<HotEntry>& entries) {
+    std::ostringstream out;
+    out << "[";
+    for (size_t i = 0; i < entries.size(); i++) {
+        out << (i ? ", " : "") << "{\"name\": \"" << entries[i].name
+            << "\", \"count\": " << entries[i].count << "}";
+    }
+    out << "]";
+    return out.str();
+}
+
+std::string SimStats::to_json() const {
+    std::ostringstream out;
+    out << "{\n"
+        << "  \"steps\": " << steps << ",\n"
+        << "  \"delta_cycles\": " << delta_cycles << ",\n"
+        << "  \"events_processed\": " << events_processed << ",\n"
+        << "  \"events_scheduled\": " << events_scheduled << ",\n"
+        << "  \"heap_events\": " << heap_events << ",\n"
+        << "  \"events_coalesced\": " << events_coalesced << ",\n"
+        << "  \"evaluations\": " << evaluations << ",\n"
+        << "  \"peak_queue_depth\": " << peak_queue_depth << ",\n"
+        << "  \"step_seconds\": " << step_seconds << ",\n"
+        << "  \"trace_seconds\": " << trace_seconds << ",\n"
+        << "  \"events_per_step\": " << events_per_step.to_json() << ",\n"
+        << "  \"evaluations_per_step\": " << evaluations_per_step.to_json() << ",\n"
+        << "  \"evaluations_by_type\": {";
+
+    bool first = true;
+    for (const auto& entry : evaluations_by_type) {
+        out << (first ? "" : ", ") << "\"" << entry.first << "\": " << entry.second;
+        first = false;
+    }
+
+    out << "},\n"
+        << "  \"hottest_nets\": " << hot_list_json(hottest_nets) << ",\n"
+        << "  \"hottest_components\": " << hot_list_json(hottest_components) << "\n"
+        << "}\n";
+    return out.str();
+}
+
+std::string component_type_name(const std::string& component_id) {
+    size_t end = component_id.size();
+    while (end > 0 && component_id[end - 1] >= '0' && component_id[end - 1] <= '9') {
+        end--;
+    }
+    return end ? component_id.substr(0, end) : component_id;
+}
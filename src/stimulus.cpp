@@ -0,0 +1,194 @@
+#include "stimulus.h"
+#include "simulator.h"
+#include "signal.h"
+#include "event.h"
+#include "batch_eval.h"
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define STIMULUS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace philox {
+
+// Philox4x32-10 constants (Salmon et al., "Parallel random numbers: as easy
+// as 1, 2, 3", SC'11)
+constexpr uint32_t M0 = 0xD2511F53;
+constexpr uint32_t M1 = 0xCD9E8D57;
+constexpr uint32_t W0 = 0x9E3779B9;
+constexpr uint32_t W1 = 0xBB67AE85;
+constexpr int ROUNDS = 10;
+
+void block(uint64_t seed, const uint32_t counter[4], uint32_t out[4]) {
+    uint32_t k0 = (uint32_t)seed;
+    uint32_t k1 = (uint32_t)(seed >> 32);
+    uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    for (int r = 0; r < ROUNDS; r++) {
+        uint64_t p0 = (uint64_t)M0 * c0;
+        uint64_t p1 = (uint64_t)M1 * c2;
+        uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+        uint32_t n2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+        c0 = n0;
+        c1 = (uint32_t)p1;
+        c2 = n2;
+        c3 = (uint32_t)p0;
+        k0 += W0;
+        k1 += W1;
+    }
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+}
+
+#ifdef STIMULUS_X86
+// 32x32 -> 64-bit products of eight lanes: even lanes from one multiply,
+// odd lanes (shifted down) from another, low and high halves blended back
+__attribute__((target("avx2")))
+static inline void mulhilo8(__m256i a, __m256i m, __m256i& lo, __m256i& hi) {
+    __m256i even = _mm256_mul_epu32(a, m);
+    __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), m);
+    lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+    hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+}
+
+__attribute__((target("avx2")))
+static size_t blocks_avx2(uint64_t seed, uint64_t first, uint32_t c2, uint32_t c3, uint32_t* out, size_t n) {
+    const __m256i m0 = _mm256_set1_epi32(M0);
+    const __m256i m1 = _mm256_set1_epi32(M1);
+    const __m256i step = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    alignas(32) uint32_t lanes[4][8];
+    size_t j = 0;
+    for (; j + 8 <= n; j += 8) {
+        uint64_t base = first + j;
+        // The low counter word, and a carry into the high word for lanes past 2^32
+        __m256i x0 = _mm256_add_epi32(_mm256_set1_epi32((uint32_t)base), step);
+        __m256i carry = _mm256_cmpgt_epi32(_mm256_xor_si256(_mm256_set1_epi32((uint32_t)base), _mm256_set1_epi32(INT32_MIN)),
+                                           _mm256_xor_si256(x0, _mm256_set1_epi32(INT32_MIN)));
+        __m256i x1 = _mm256_sub_epi32(_mm256_set1_epi32((uint32_t)(base >> 32)), carry);
+        __m256i x2 = _mm256_set1_epi32(c2);
+        __m256i x3 = _mm256_set1_epi32(c3);
+        uint32_t k0 = (uint32_t)seed;
+        uint32_t k1 = (uint32_t)(seed >> 32);
+        for (int r = 0; r < ROUNDS; r++) {
+            __m256i lo0, hi0, lo1, hi1;
+            mulhilo8(x0, m0, lo0, hi0);
+            mulhilo8(x2, m1, lo1, hi1);
+            x0 = _mm256_xor_si256(_mm256_xor_si256(hi1, x1), _mm256_set1_epi32(k0));
+            x1 = lo1;
+            x2 = _mm256_xor_si256(_mm256_xor_si256(hi0, x3), _mm256_set1_epi32(k1));
+            x3 = lo0;
+            k0 += W0;
+            k1 += W1;
+        }
+        _mm256_store_si256((__m256i*)lanes[0], x0);
+        _mm256_store_si256((__m256i*)lanes[1], x1);
+        _mm256_store_si256((__m256i*)lanes[2], x2);
+        _mm256_store_si256((__m256i*)lanes[3], x3);
+        for (int l = 0; l < 8; l++) {
+            uint32_t* o = out + (j + l) * 4;
+            o[0] = lanes[0][l];
+            o[1] = lanes[1][l];
+            o[2] = lanes[2][l];
+            o[3] = lanes[3][l];
+        }
+    }
+    return j;
+}
+#endif
+
+void blocks(uint64_t seed, uint64_t first, uint32_t c2, uint32_t c3, uint32_t* out, size_t n, bool simd) {
+    size_t j = 0;
+#ifdef STIMULUS_X86
+    if (simd && batch::avx2_supported()) {
+        j = blocks_avx2(seed, first, c2, c3, out, n);
+    }
+#else
+    (void)simd;
+#endif
+    for (; j < n; j++) {
+        uint64_t c = first + j;
+        uint32_t counter[4] = {(uint32_t)c, (uint32_t)(c >> 32), c2, c3};
+        block(seed, counter, out + j * 4);
+    }
+}
+
+}  // namespace philox
+
+// ===== StimulusGenerator =====
+
+StimulusGenerator::StimulusGenerator(uint64_t seed, uint32_t run) : seed(seed), run(run) {
+}
+
+uint32_t StimulusGenerator::add_input(Signal* net, double p_one, double p_x) {
+    if (!net) {
+        throw std::invalid_argument("Cannot add null stimulus input");
+    }
+    p_x = std::min(std::max(p_x, 0.0), 1.0);
+    p_one = std::min(std::max(p_one, 0.0), 1.0);
+    const double range = 4294967296.0;   // 2^32
+    uint64_t x_below = (uint64_t)(p_x * range);
+    uint64_t one_below = x_below + (uint64_t)(p_one * (1.0 - p_x) * range);
+    inputs.push_back({net, x_below, std::min<uint64_t>(one_below, 1ULL << 32)});
+    return inputs.size() - 1;
+}
+
+void StimulusGenerator::add_inputs(const std::vector<Signal*>& nets, double p_one) {
+    for (Signal* net : nets) {
+        add_input(net, p_one);
+    }
+}
+
+uint8_t StimulusGenerator::value(uint32_t input, uint64_t vector) const {
+    uint32_t counter[4] = {(uint32_t)(vector / 4), (uint32_t)(vector / 4 >> 32), run, input};
+    uint32_t words[4];
+    philox::block(seed, counter, words);
+    return to_value(inputs.at(input), words[vector % 4]);
+}
+
+void StimulusGenerator::generate(uint64_t first, size_t count, std::vector<uint8_t>& values) const {
+    values.resize(count * inputs.size());
+    if (count == 0) {
+        return;
+    }
+    // Whole blocks covering [first, first + count), one input's stream at a time
+    uint64_t first_block = first / 4;
+    size_t offset = first % 4;
+    size_t n = (offset + count + 3) / 4;
+    std::vector<uint32_t> words(n * 4);
+    for (uint32_t i = 0; i < inputs.size(); i++) {
+        philox::blocks(seed, first_block, run, i, words.data(), n);
+        const Input& in = inputs[i];
+        uint8_t* out = values.data() + i;
+        for (size_t v = 0; v < count; v++) {
+            out[v * inputs.size()] = to_value(in, words[offset + v]);
+        }
+    }
+}
+
+size_t StimulusGenerator::schedule(Simulator& sim, uint64_t first, size_t count, uint64_t start_time,
+                                   uint64_t period, bool changes_only) const {
+    std::vector<uint8_t> values;
+    // One vector of context before the chunk for change detection
+    bool context = changes_only && first > 0;
+    generate(context ? first - 1 : first, count + context, values);
+    const uint8_t* previous = context ? values.data() : nullptr;
+    const uint8_t* current = values.data() + (context ? inputs.size() : 0);
+
+    std::vector<Event> events;
+    events.reserve(count * inputs.size());
+    for (size_t v = 0; v < count; v++) {
+        uint64_t time = start_time + v * period;
+        for (size_t i = 0; i < inputs.size(); i++) {
+            if (!changes_only || !previous || previous[i] != current[i]) {
+                events.push_back(Event(time, inputs[i].net->get_id(), current[i]));
+            }
+        }
+        previous = current;
+        current += inputs.size();
+    }
+    sim.schedule_batch(events);
+    return events.size();
+}
@@ -0,0 +1,148 @@
+#include "testbench.h"
+#include "event.h"
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Observer holding the processes waiting on one net. It only schedules
+// wake-ups, so it never sits on the evaluation path of a resumed process.
+class Testbench::WaitList : public Component {
+public:
+    explicit WaitList(Signal* sig) : last_value(sig->get_value()) {
+        id = "WAIT_" + sig->get_name();
+        propagation_delay = 0;
+        inputs.push_back(sig);
+        sig->attach_observer(this);
+    }
+
+    void add(ProcessHandle handle, WaitKind kind) {
+        waiters.push_back({handle, kind});
+    }
+
+    void clear() {
+        waiters.clear();
+    }
+
+    void evaluate(Simulator* sim, uint64_t current_time) override {
+        uint8_t value = inputs[0]->get_value();
+        uint8_t previous = last_value;
+        last_value = value;
+        if (value == previous || waiters.empty()) {
+            return;
+        }
+
+        // Edges follow the DFF: 0 -> 1 rises, 1 -> 0 falls
+        size_t kept = 0;
+        for (size_t i = 0; i < waiters.size(); i++) {
+            const Waiter& waiter = waiters[i];
+            bool fire = waiter.kind == WaitKind::CHANGE ||
+                        (waiter.kind == WaitKind::RISING && previous == 0 && value == 1) ||
+                        (waiter.kind == WaitKind::FALLING && previous == 1 && value == 0);
+            if (fire) {
+                waiter.handle.promise().wake_slot =
+                    sim->schedule_wake(current_time, &Testbench::resume_process, waiter.handle.address());
+            } else {
+                waiters[kept++] = waiter;
+            }
+        }
+        waiters.resize(kept);
+    }
+
+private:
+    struct Waiter {
+        ProcessHandle handle;
+        WaitKind kind;
+    };
+    uint8_t last_value;
+    std::vector<Waiter> waiters;
+};
+
+// ===== Process =====
+
+void Process::promise_type::unhandled_exception() {
+    if (tb && !tb->failure) {
+        tb->failure = std::current_exception();
+    }
+}
+
+Process::promise_type::~promise_type() {
+    if (!tb) {
+        return;
+    }
+    if (wake_slot != NO_WAKE) {
+        tb->sim.cancel_wake(wake_slot);
+    }
+    tb->live.erase(ProcessHandle::from_promise(*this).address());
+}
+
+// ===== Testbench =====
+
+Testbench::Testbench(Simulator& simulator) : sim(simulator) {}
+
+Testbench::~Testbench() {
+    // Wait lists stay attached (the simulator owns them) but go quiet
+    for (auto& entry : waits) {
+        entry.second->clear();
+    }
+    std::unordered_set<void*> frames;
+    frames.swap(live);
+    for (void* frame : frames) {
+        ProcessHandle handle = ProcessHandle::from_address(frame);
+        handle.destroy();
+    }
+}
+
+void Testbench::spawn(Process process) {
+    ProcessHandle handle = std::exchange(process.handle, nullptr);
+    if (!handle) {
+        throw std::invalid_argument("Cannot spawn an empty process");
+    }
+    handle.promise().tb = this;
+    live.insert(handle.address());
+    resume_process(handle.address());
+}
+
+void Testbench::drive(Signal* sig, uint8_t v, uint64_t after) {
+    if (!sig) {
+        throw std::invalid_argument("Cannot drive a null signal");
+    }
+    sim.schedule_event(Event(sim.get_current_time() + after, sig->get_id(), v));
+}
+
+size_t Testbench::active_processes() const {
+    return live.size();
+}
+
+uint64_t Testbench::now() const {
+    return sim.get_current_time();
+}
+
+Simulator& Testbench::get_simulator() {
+    return sim;
+}
+
+void Testbench::wait_delay(ProcessHandle handle, uint64_t dt) {
+    handle.promise().wake_slot = sim.schedule_wake(sim.get_current_time() + dt, &resume_process, handle.address());
+}
+
+void Testbench::wait_signal(ProcessHandle handle, Signal* sig, WaitKind kind) {
+    if (!sig) {
+        throw std::invalid_argument("Cannot wait on a null signal");
+    }
+    auto it = waits.find(sig);
+    if (it == waits.end()) {
+        it = waits.emplace(sig, sim.create_component<WaitList>(sig)).first;
+    }
+    it->second->add(handle, kind);
+}
+
+void Testbench::resume_process(void* frame) {
+    ProcessHandle handle = ProcessHandle::from_address(frame);
+    Testbench* tb = handle.promise().tb;  // The frame may be gone after resume()
+    handle.promise().wake_slot = Process::promise_type::NO_WAKE;
+    handle.resume();
+    if (tb->failure) {
+        std::exception_ptr failure = std::exchange(tb->failure, nullptr);
+        std::rethrow_exception(failure);
+    }
+}
@@ -0,0 +1,68 @@
+#include "timing.h"
+#include "sequential.h"
+#include <algorithm>
+
+TimingChecker::TimingChecker()
+    : force_x(false), max_entries(1000), per_flop(10), total(0), suppressed(0) {
+}
+
+uint32_t TimingChecker::add_flop(DFF* flop, uint64_t setup, uint64_t hold) {
+    uint32_t slot = flop->timing_slot;
+    if (slot == NO_SLOT) {
+        slot = setup_window.size();
+        flop->timing_slot = slot;
+        setup_window.push_back(0);
+        hold_window.push_back(0);
+        last_data_change.push_back(NEVER);
+        last_clock_edge.push_back(NEVER);
+        last_data_value.push_back(flop->get_data() ? flop->get_data()->get_value() : 2);
+        reported.push_back(0);
+        names.push_back(flop->get_id());
+    }
+    setup_window[slot] = setup;
+    hold_window[slot] = hold;
+    return slot;
+}
+
+void TimingChecker::set_log_limits(size_t entries, size_t flop_limit) {
+    max_entries = entries;
+    per_flop = flop_limit;
+}
+
+void TimingChecker::record(TimingViolation::Kind kind, uint32_t slot, uint64_t time,
+                           uint64_t data_time, uint64_t clock_time) {
+    total++;
+    if (log.size() >= max_entries || reported[slot] >= per_flop) {
+        suppressed++;
+        return;
+    }
+    reported[slot]++;
+    log.push_back({kind, slot, time, data_time, clock_time});
+}
+
+void TimingChecker::report(std::ostream& os) const {
+    os << "Timing violations: " << total << "\n";
+    for (const TimingViolation& v : log) {
+        if (v.kind == TimingViolation::SETUP) {
+            os << "  t=" << v.time << "ps " << names[v.flop] << ": setup violation, D changed "
+               << (v.clock_time - v.data_time) << "ps before the clock edge (window "
+               << setup_window[v.flop] << "ps)\n";
+        } else {
+            os << "  t=" << v.time << "ps " << names[v.flop] << ": hold violation, D changed "
+               << (v.data_time - v.clock_time) << "ps after the clock edge (window "
+               << hold_window[v.flop] << "ps)\n";
+        }
+    }
+    if (suppressed > 0) {
+        os << "  ... " << suppressed << " more not logged\n";
+    }
+}
+
+void TimingChecker::reset() {
+    std::fill(last_data_change.begin(), last_data_change.end(), NEVER);
+    std::fill(last_clock_edge.begin(), last_clock_edge.end(), NEVER);
+    std::fill(reported.begin(), reported.end(), 0);
+    log.clear();
+    total = 0;
+    suppressed = 0;
+}
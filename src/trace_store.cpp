@@ -0,0 +1,412 @@
+#include "trace_store.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char* TRACE_HEADER = "LOGIC-SIM-TRACE 1";
+
+constexpr size_t HEADER_BYTES = 64;           // Start of each shard file
+constexpr size_t INITIAL_BYTES = 64 * 1024;   // First mapping of a record file
+
+struct RecordFileHeader {
+    char magic[8];
+    uint64_t records;
+    uint32_t first;
+    uint32_t signals;
+};
+
+struct IndexFileHeader {
+    char magic[8];
+    uint64_t blocks;
+};
+
+struct Record {
+    uint64_t time;
+    uint32_t offset;  // Slot within the shard
+    uint8_t value;
+};
+static_assert(sizeof(Record) == 16, "Record layout");
+
+static const char RECORD_MAGIC[8] = {'L', 'S', 'T', 'R', 'R', 'E', 'C', '1'};
+static const char INDEX_MAGIC[8] = {'L', 'S', 'T', 'R', 'I', 'D', 'X', '1'};
+
+static size_t padded(size_t bytes) {
+    return (bytes + 7) & ~size_t(7);
+}
+
+static RecordFileHeader* record_header(uint8_t* data) {
+    return reinterpret_cast<RecordFileHeader*>(data);
+}
+
+static IndexFileHeader* index_header(uint8_t* data) {
+    return reinterpret_cast<IndexFileHeader*>(data);
+}
+
+static const Record* record_at(const uint8_t* data, uint64_t i) {
+    return reinterpret_cast<const Record*>(data + HEADER_BYTES) + i;
+}
+
+// ===== Mapping =====
+
+TraceStore::Mapping::Mapping(Mapping&& other) noexcept
+    : fd(other.fd), data(other.data), length(other.length) {
+    other.fd = -1;
+    other.data = nullptr;
+    other.length = 0;
+}
+
+void TraceStore::Mapping::open(const std::string& filename, bool create) {
+    fd = ::open(filename.c_str(), create ? O_RDWR | O_CREAT | O_TRUNC : O_RDONLY, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        throw std::runtime_error("Cannot stat file: " + filename);
+    }
+    length = st.st_size;
+    if (length > 0) {
+        void* p = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) {
+            throw std::runtime_error("Cannot map file: " + filename);
+        }
+        data = static_cast<uint8_t*>(p);
+    }
+}
+
+void TraceStore::Mapping::reserve(size_t bytes) {
+    if (bytes <= length) {
+        return;
+    }
+    truncate(std::max({bytes, length * 2, INITIAL_BYTES}));
+}
+
+void TraceStore::Mapping::truncate(size_t bytes) {
+    if (data) {
+        munmap(data, length);
+        data = nullptr;
+    }
+    if (ftruncate(fd, bytes) != 0) {
+        throw std::runtime_error("Cannot grow trace file to " + std::to_string(bytes) + " bytes");
+    }
+    length = bytes;
+    if (length > 0) {
+        void* p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) {
+            throw std::runtime_error("Cannot map " + std::to_string(bytes) + " bytes of trace file");
+        }
+        data = static_cast<uint8_t*>(p);
+    }
+}
+
+void TraceStore::Mapping::close() {
+    if (data) {
+        munmap(data, length);
+        data = nullptr;
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    length = 0;
+}
+
+// ===== Recording =====
+
+TraceStore::TraceStore(const std::string& path)
+    : path(path), shard_signals(DEFAULT_SHARD_SIGNALS), start(0), end(0), writable(false) {
+}
+
+TraceStore::TraceStore(const std::string& path, const std::vector<std::string>& names,
+                       const std::vector<uint8_t>& initial, uint64_t start_time, uint32_t shard_signals)
+    : path(path), names(names), shard_signals(std::max<uint32_t>(shard_signals, 1)),
+      start(start_time), end(start_time), writable(true) {
+    size_t count = (names.size() + this->shard_signals - 1) / this->shard_signals;
+    shards.resize(count);
+    size_t k = 0;
+    try {
+        for (; k < count; k++) {
+            create_shard(k, initial);
+        }
+        write_meta();
+    } catch (const std::exception&) {
+        // A store that cannot be created in full leaves nothing behind:
+        // the shard files opened so far are closed and removed
+        for (size_t i = 0; i <= k && i < count; i++) {
+            std::string base = path + "." + std::to_string(i);
+            if (shards[i].records.fd >= 0) {
+                shards[i].records.close();
+                std::remove((base + ".rec").c_str());
+            }
+            if (shards[i].index.fd >= 0) {
+                shards[i].index.close();
+                std::remove((base + ".idx").c_str());
+            }
+        }
+        throw;
+    }
+}
+
+void TraceStore::create_shard(size_t k, const std::vector<uint8_t>& initial) {
+    Shard& shard = shards[k];
+    shard.first = k * shard_signals;
+    shard.signals = std::min<size_t>(shard_signals, names.size() - shard.first);
+    shard.values.assign(initial.begin() + shard.first, initial.begin() + shard.first + shard.signals);
+
+    std::string base = path + "." + std::to_string(k);
+    shard.records.open(base + ".rec", true);
+    shard.records.reserve(INITIAL_BYTES);
+    RecordFileHeader* rh = record_header(shard.records.data);
+    std::memcpy(rh->magic, RECORD_MAGIC, sizeof(RECORD_MAGIC));
+    rh->records = 0;
+    rh->first = shard.first;
+    rh->signals = shard.signals;
+
+    shard.index.open(base + ".idx", true);
+    shard.index.reserve(HEADER_BYTES + padded(shard.signals) + 16 * entry_bytes(shard));
+    IndexFileHeader* ih = index_header(shard.index.data);
+    std::memcpy(ih->magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    ih->blocks = 0;
+    std::memcpy(shard.index.data + HEADER_BYTES, shard.values.data(), shard.signals);
+}
+
+TraceStore::~TraceStore() {
+    if (writable) {
+        try {
+            close(end);
+        } catch (const std::exception&) {
+            // Nothing to report to from a destructor; the files keep their records
+        }
+    }
+}
+
+size_t TraceStore::entry_bytes(const Shard& shard) const {
+    return sizeof(uint64_t) + padded(shard.signals);  // Block start time, snapshot
+}
+
+void TraceStore::append(Shard& shard, uint64_t time, uint32_t offset, uint8_t value) {
+    uint64_t n = record_header(shard.records.data)->records;
+    if (n % BLOCK_RECORDS == 0) {
+        // New block: index its start time and the values it starts from
+        uint64_t blocks = index_header(shard.index.data)->blocks;
+        size_t at = HEADER_BYTES + padded(shard.signals) + blocks * entry_bytes(shard);
+        shard.index.reserve(at + entry_bytes(shard));
+        std::memcpy(shard.index.data + at, &time, sizeof(time));
+        std::memcpy(shard.index.data + at + sizeof(time), shard.values.data(), shard.signals);
+        index_header(shard.index.data)->blocks = blocks + 1;
+    }
+    size_t at = HEADER_BYTES + n * sizeof(Record);
+    shard.records.reserve(at + sizeof(Record));
+    Record* r = reinterpret_cast<Record*>(shard.records.data + at);
+    r->time = time;
+    r->offset = offset;
+    r->value = value;
+    record_header(shard.records.data)->records = n + 1;
+    shard.values[offset] = value;
+    end = time;
+}
+
+void TraceStore::close(uint64_t end_time) {
+    if (!writable) {
+        return;
+    }
+    for (Shard& shard : shards) {
+        uint64_t records = record_header(shard.records.data)->records;
+        uint64_t blocks = index_header(shard.index.data)->blocks;
+        shard.records.truncate(HEADER_BYTES + records * sizeof(Record));
+        shard.index.truncate(HEADER_BYTES + padded(shard.signals) + blocks * entry_bytes(shard));
+        shard.values.clear();
+        shard.values.shrink_to_fit();
+    }
+    end = std::max(end, end_time);
+    writable = false;
+    write_meta();
+}
+
+void TraceStore::write_meta() const {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + path);
+    }
+    file << TRACE_HEADER << "\n";
+    file << "shard_signals " << shard_signals << "\n";
+    file << "start " << start << "\n";
+    file << "end " << end << "\n";
+    file << "closed " << (writable ? 0 : 1) << "\n";
+    file << "signals " << names.size() << "\n";
+    for (const std::string& name : names) {
+        file << name << "\n";
+    }
+}
+
+// ===== Reading =====
+
+std::unique_ptr<TraceStore> TraceStore::open(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + path);
+    }
+    std::string line;
+    if (!std::getline(file, line) || line != TRACE_HEADER) {
+        throw std::runtime_error("Not a trace store: " + path);
+    }
+
+    std::unique_ptr<TraceStore> store(new TraceStore(path));
+    size_t count = 0;
+    bool closed = false;
+    auto field = [&](const char* key, auto& value) {
+        std::string name;
+        if (!std::getline(file, line) || !(std::istringstream(line) >> name >> value) || name != key) {
+            throw std::runtime_error("Malformed trace store header: " + path);
+        }
+    };
+    field("shard_signals", store->shard_signals);
+    field("start", store->start);
+    field("end", store->end);
+    field("closed", closed);
+    field("signals", count);
+    if (!closed) {
+        throw std::runtime_error("Trace store is still being recorded: " + path);
+    }
+    store->names.reserve(count);
+    while (store->names.size() < count && std::getline(file, line)) {
+        store->names.push_back(line);
+    }
+    if (store->names.size() != count || store->shard_signals == 0) {
+        throw std::runtime_error("Malformed trace store header: " + path);
+    }
+
+    size_t shard_count = (count + store->shard_signals - 1) / store->shard_signals;
+    store->shards.resize(shard_count);
+    for (size_t k = 0; k < shard_count; k++) {
+        Shard& shard = store->shards[k];
+        std::string base = path + "." + std::to_string(k);
+        shard.records.open(base + ".rec", false);
+        shard.index.open(base + ".idx", false);
+        if (shard.records.length < HEADER_BYTES || shard.index.length < HEADER_BYTES ||
+            std::memcmp(shard.records.data, RECORD_MAGIC, sizeof(RECORD_MAGIC)) != 0 ||
+            std::memcmp(shard.index.data, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0) {
+            throw std::runtime_error("Bad trace shard: " + base);
+        }
+        shard.first = record_header(shard.records.data)->first;
+        shard.signals = record_header(shard.records.data)->signals;
+        if (shard.first != k * store->shard_signals ||
+            shard.records.length < HEADER_BYTES + record_header(shard.records.data)->records * sizeof(Record) ||
+            shard.index.length < HEADER_BYTES + padded(shard.signals) +
+                                     index_header(shard.index.data)->blocks * store->entry_bytes(shard)) {
+            throw std::runtime_error("Truncated trace shard: " + base);
+        }
+    }
+    return store;
+}
+
+int TraceStore::find_signal(const std::string& name) const {
+    auto it = std::find(names.begin(), names.end(), name);
+    return it == names.end() ? -1 : (int)(it - names.begin());
+}
+
+uint64_t TraceStore::record_count() const {
+    uint64_t count = 0;
+    for (const Shard& shard : shards) {
+        count += record_header(shard.records.data)->records;
+    }
+    return count;
+}
+
+size_t TraceStore::mapped_bytes() const {
+    size_t bytes = 0;
+    for (const Shard& shard : shards) {
+        bytes += shard.records.length + shard.index.length;
+    }
+    return bytes;
+}
+
+// Index entries whose block starts before `time` (or at it, if inclusive)
+size_t TraceStore::blocks_before(const Shard& shard, uint64_t time, bool inclusive) const {
+    const uint8_t* entries = shard.index.data + HEADER_BYTES + padded(shard.signals);
+    size_t lo = 0;
+    size_t hi = index_header(shard.index.data)->blocks;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        uint64_t block_time;
+        std::memcpy(&block_time, entries + mid * entry_bytes(shard), sizeof(block_time));
+        if (block_time < time || (inclusive && block_time == time)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+uint8_t TraceStore::value_at(uint32_t signal, uint64_t time) const {
+    if (signal >= names.size()) {
+        throw std::out_of_range("TraceStore: no signal " + std::to_string(signal));
+    }
+    const Shard& shard = shards[signal / shard_signals];
+    uint32_t offset = signal % shard_signals;
+    size_t blocks = blocks_before(shard, time, true);
+    if (blocks == 0) {
+        return shard.index.data[HEADER_BYTES + offset];  // Before the first change
+    }
+
+    // The last block starting at or before `time` holds every later change
+    // up to it
+    size_t block = blocks - 1;
+    const uint8_t* entry = shard.index.data + HEADER_BYTES + padded(shard.signals) + block * entry_bytes(shard);
+    uint8_t value = entry[sizeof(uint64_t) + offset];
+    uint64_t records = record_header(shard.records.data)->records;
+    for (uint64_t i = block * BLOCK_RECORDS; i < records; i++) {
+        const Record* r = record_at(shard.records.data, i);
+        if (r->time > time) {
+            break;
+        }
+        if (r->offset == offset) {
+            value = r->value;
+        }
+    }
+    return value;
+}
+
+void TraceStore::scan(const Shard& shard, uint64_t from, uint64_t to, int64_t offset,
+                      std::vector<Change>& out) const {
+    size_t blocks = blocks_before(shard, from, false);
+    uint64_t records = record_header(shard.records.data)->records;
+    for (uint64_t i = blocks == 0 ? 0 : (blocks - 1) * BLOCK_RECORDS; i < records; i++) {
+        const Record* r = record_at(shard.records.data, i);
+        if (r->time > to) {
+            break;
+        }
+        if (r->time >= from && (offset < 0 || r->offset == offset)) {
+            out.push_back({r->time, shard.first + r->offset, r->value});
+        }
+    }
+}
+
+std::vector<TraceStore::Change> TraceStore::changes(uint32_t signal, uint64_t from, uint64_t to) const {
+    if (signal >= names.size()) {
+        throw std::out_of_range("TraceStore: no signal " + std::to_string(signal));
+    }
+    std::vector<Change> out;
+    scan(shards[signal / shard_signals], from, to, signal % shard_signals, out);
+    return out;
+}
+
+std::vector<TraceStore::Change> TraceStore::changes(uint64_t from, uint64_t to) const {
+    std::vector<Change> out;
+    for (const Shard& shard : shards) {
+        scan(shard, from, to, -1, out);
+    }
+    if (shards.size() > 1) {
+        std::stable_sort(out.begin(), out.end(),
+                         [](const Change& a, const Change& b) { return a.time < b.time; });
+    }
+    return out;
+}
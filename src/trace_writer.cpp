@@ -0,0 +1,281 @@
+#include "trace_writer.h"
+#include "simulator.h"
+#include "signal.h"
+#include "logic.h"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <zlib.h>
+
+static const char* WAVE_HEADER = "LOGIC-SIM-WAVE 1\n";
+
+constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+static void put_varint(std::string& out, uint64_t v) {
+    while (v >= 0x80) {
+        out += (char)(v | 0x80);
+        v >>= 7;
+    }
+    out += (char)v;
+}
+
+static void put_number(std::string& out, uint64_t v) {
+    char digits[20];
+    char* end = std::to_chars(digits, digits + sizeof(digits), v).ptr;
+    out.append(digits, end);
+}
+
+TraceWriter::TraceWriter(Simulator& sim, const std::string& path)
+    : TraceWriter(sim, path, Options()) {
+}
+
+TraceWriter::TraceWriter(Simulator& sim, const std::string& path, const Options& options)
+    : options(options), id_base(0), last_time(sim.get_current_time()), time_open(false),
+      file(nullptr), path(path) {
+    size_t capacity = 1;
+    while (capacity < std::max<size_t>(options.ring_events, 2)) {
+        capacity *= 2;
+    }
+    ring.resize(capacity);
+    mask = capacity - 1;
+
+    std::string mode = options.compression > 0 ? "wb" + std::to_string(std::min(options.compression, 9)) : "wbT";
+    gzFile gz = gzopen(path.c_str(), mode.c_str());
+    if (!gz) {
+        throw std::runtime_error("Cannot open file: " + path);
+    }
+    gzbuffer(gz, 256 * 1024);
+    file = gz;
+
+    write_header(sim);
+    io = std::thread(&TraceWriter::io_loop, this);
+    encoder = std::thread(&TraceWriter::encode_loop, this);
+}
+
+TraceWriter::~TraceWriter() {
+    try {
+        close();
+    } catch (const std::runtime_error&) {
+        // Kept in error()
+    }
+}
+
+void TraceWriter::record_error(const std::string& message) {
+    write_error_count++;
+    if (io_error.empty()) {
+        io_error = message;
+    }
+}
+
+void TraceWriter::write_header(Simulator& sim) {
+    const std::vector<Signal*>& signals = sim.get_signals();
+    if (!signals.empty()) {
+        auto [low, high] = std::minmax_element(signals.begin(), signals.end(), [](Signal* a, Signal* b) {
+            return a->get_id() < b->get_id();
+        });
+        id_base = (*low)->get_id();
+        slots.assign((*high)->get_id() - id_base + 1, NO_SLOT);
+    }
+    for (size_t i = 0; i < signals.size(); i++) {
+        slots[signals[i]->get_id() - id_base] = i;
+    }
+
+    if (options.format == Format::VCD) {
+        std::ostringstream header;
+        sim.write_vcd_header(header);
+        header << "\n$dumpvars\n";
+        for (Signal* sig : signals) {
+            header << logic::to_char(sig->get_value()) << sig->get_id() << "\n";
+        }
+        header << "$end\n";
+        active = header.str();
+    } else {
+        active = WAVE_HEADER;
+        put_varint(active, signals.size());
+        for (Signal* sig : signals) {
+            put_varint(active, sig->get_name().size());
+            active += sig->get_name();
+            active += (char)sig->get_value();
+        }
+        put_varint(active, last_time);
+    }
+}
+
+void TraceWriter::encode(const Entry& e) {
+    size_t index = (size_t)(e.signal_id - id_base);
+    if (index >= slots.size() || slots[index] == NO_SLOT) {
+        return;  // Not in the header (created later, or a process wake-up)
+    }
+    if (options.format == Format::VCD) {
+        if (!time_open || e.time != last_time) {
+            active += '#';
+            put_number(active, e.time);
+            active += '\n';
+            last_time = e.time;
+            time_open = true;
+        }
+        active += logic::to_char(e.value);
+        put_number(active, e.signal_id);
+        active += '\n';
+    } else {
+        put_varint(active, e.time - last_time);
+        put_varint(active, (uint64_t)slots[index] << 2 | (e.value & 3));
+        last_time = e.time;
+    }
+}
+
+void TraceWriter::hand_off() {
+    std::unique_lock<std::mutex> lock(io_mutex);
+    io_cv.wait(lock, [this] { return !pending_ready; });
+    encoded += active.size();
+    std::swap(active, pending);   // `active` gets the written (cleared) buffer back
+    pending_ready = true;
+    lock.unlock();
+    io_cv.notify_all();
+}
+
+void TraceWriter::encode_loop() {
+    constexpr uint64_t CHUNK = 1024;  // Entries between tail updates
+    while (true) {
+        uint64_t t = tail.load(std::memory_order_relaxed);
+        uint64_t h = head.load(std::memory_order_acquire);
+        if (t == h) {
+            if (stopping.load(std::memory_order_acquire)) {
+                if (head.load(std::memory_order_acquire) == t) {
+                    break;  // Nothing was pushed before close()
+                }
+                continue;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            continue;
+        }
+        uint64_t end = std::min(h, t + CHUNK);
+        for (; t < end; t++) {
+            encode(ring[t & mask]);
+        }
+        tail.store(t, std::memory_order_release);
+        if (active.size() >= options.buffer_bytes) {
+            hand_off();
+        }
+    }
+}
+
+void TraceWriter::io_loop() {
+    std::unique_lock<std::mutex> lock(io_mutex);
+    while (true) {
+        io_cv.wait(lock, [this] { return pending_ready || io_stop; });
+        if (!pending_ready) {
+            break;
+        }
+        lock.unlock();
+        if (!pending.empty() && io_error.empty()) {
+            // After a failure the rest is discarded: the file is already incomplete
+            gzFile gz = static_cast<gzFile>(file);
+            if (gzwrite(gz, pending.data(), pending.size()) != (int)pending.size()) {
+                int code;
+                const char* message = gzerror(gz, &code);
+                record_error(code == Z_ERRNO ? std::strerror(errno) : message);
+            }
+        }
+        lock.lock();
+        pending.clear();
+        pending_ready = false;
+        io_cv.notify_all();
+    }
+}
+
+void TraceWriter::close(uint64_t end_time) {
+    if (closed) {
+        return;
+    }
+    closed = true;
+    stopping.store(true, std::memory_order_release);
+    encoder.join();
+
+    if (options.format == Format::VCD && end_time > last_time) {
+        active += '#';
+        put_number(active, end_time);
+        active += '\n';
+    }
+    hand_off();
+    {
+        std::lock_guard<std::mutex> lock(io_mutex);
+        io_stop = true;
+    }
+    io_cv.notify_all();
+    io.join();
+    int result = gzclose(static_cast<gzFile>(file));
+    if (result != Z_OK) {
+        record_error(result == Z_ERRNO ? std::strerror(errno) : "close failed (zlib error " + std::to_string(result) + ")");
+    }
+    file = nullptr;
+
+    struct stat st;
+    written = stat(path.c_str(), &st) == 0 ? st.st_size : 0;
+    if (!io_error.empty()) {
+        throw std::runtime_error("Cannot write trace " + path + ": " + io_error);
+    }
+}
+
+// ===== Reading =====
+
+TraceWriter::Waveform TraceWriter::read_binary(const std::string& path) {
+    gzFile gz = gzopen(path.c_str(), "rb");   // Also reads uncompressed files
+    if (!gz) {
+        throw std::runtime_error("Cannot open file: " + path);
+    }
+    std::string data;
+    char buffer[1 << 16];
+    int n;
+    while ((n = gzread(gz, buffer, sizeof(buffer))) > 0) {
+        data.append(buffer, n);
+    }
+    gzclose(gz);
+    if (n < 0 || data.compare(0, std::string(WAVE_HEADER).size(), WAVE_HEADER) != 0) {
+        throw std::runtime_error("Not a binary trace: " + path);
+    }
+
+    size_t pos = std::string(WAVE_HEADER).size();
+    auto varint = [&]() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos >= data.size()) {
+                throw std::runtime_error("Truncated binary trace: " + path);
+            }
+            uint8_t byte = data[pos++];
+            v |= (uint64_t)(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return v;
+            }
+        }
+        throw std::runtime_error("Malformed binary trace: " + path);
+    };
+
+    Waveform wave;
+    uint64_t count = varint();
+    for (uint64_t i = 0; i < count; i++) {
+        uint64_t length = varint();
+        if (pos + length + 1 > data.size()) {
+            throw std::runtime_error("Truncated binary trace: " + path);
+        }
+        wave.names.push_back(data.substr(pos, length));
+        wave.initial.push_back(data[pos + length]);
+        pos += length + 1;
+    }
+    wave.start_time = varint();
+    uint64_t time = wave.start_time;
+    while (pos < data.size()) {
+        time += varint();
+        uint64_t slot_value = varint();
+        if ((slot_value >> 2) >= count) {
+            throw std::runtime_error("Malformed binary trace: " + path);
+        }
+        wave.changes.push_back({time, (uint32_t)(slot_value >> 2), (uint8_t)(slot_value & 3)});
+    }
+    return wave;
+}
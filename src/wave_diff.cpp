@@ -0,0 +1,457 @@
+#include "wave_diff.h"
+#include "simulator.h"
+#include "signal.h"
+#include "logic.h"
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+#include <zlib.h>
+
+constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+// Glob match with '*' as the only wildcard
+static bool matches(const std::string& pattern, const std::string& name) {
+    size_t p = 0;
+    size_t n = 0;
+    size_t star = std::string::npos;
+    size_t resume = 0;
+    while (n < name.size()) {
+        if (p < pattern.size() && pattern[p] == '*') {
+            star = p++;
+            resume = n;
+        } else if (p < pattern.size() && pattern[p] == name[n]) {
+            p++;
+            n++;
+        } else if (star != std::string::npos) {
+            p = star + 1;
+            n = ++resume;
+        } else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*') {
+        p++;
+    }
+    return p == pattern.size();
+}
+
+static int parse_value(char c) {
+    switch (c) {
+        case '0': return LOGIC_0;
+        case '1': return LOGIC_1;
+        case 'x': case 'X': return LOGIC_X;
+        case 'z': case 'Z': return LOGIC_Z;
+        default: return -1;
+    }
+}
+
+// ===== VcdReader =====
+
+VcdReader::VcdReader(const std::string& path) : file(nullptr), path(path), buffer(1 << 16) {
+    gzFile gz = gzopen(path.c_str(), "rb");   // Also reads uncompressed files
+    if (!gz) {
+        throw std::runtime_error("Cannot open file: " + path);
+    }
+    file = gz;
+    try {
+        read_header();
+    } catch (...) {
+        gzclose(gz);
+        throw;
+    }
+}
+
+VcdReader::~VcdReader() {
+    gzclose(static_cast<gzFile>(file));
+}
+
+bool VcdReader::token(std::string& out) {
+    out.clear();
+    while (true) {
+        if (pos == end) {
+            int n = gzread(static_cast<gzFile>(file), buffer.data(), buffer.size());
+            if (n < 0) {
+                throw std::runtime_error("Cannot read file: " + path);
+            }
+            if (n == 0) {
+                return !out.empty();
+            }
+            pos = 0;
+            end = n;
+        }
+        char c = buffer[pos++];
+        if (std::isspace((unsigned char)c)) {
+            if (!out.empty()) {
+                return true;
+            }
+        } else {
+            out += c;
+        }
+    }
+}
+
+void VcdReader::skip_to_end(const std::string& keyword) {
+    std::string tok;
+    while (token(tok)) {
+        if (tok == "$end") {
+            return;
+        }
+    }
+    throw std::runtime_error("Unterminated " + keyword + " in " + path);
+}
+
+void VcdReader::read_header() {
+    std::vector<std::string> scopes;
+    std::string tok;
+    while (token(tok)) {
+        if (tok == "$scope") {
+            std::string type;
+            std::string name;
+            token(type);
+            token(name);
+            scopes.push_back(name);
+            skip_to_end(tok);
+        } else if (tok == "$upscope") {
+            if (!scopes.empty()) {
+                scopes.pop_back();
+            }
+            skip_to_end(tok);
+        } else if (tok == "$var") {
+            std::string type;
+            std::string width;
+            std::string id;
+            std::string ref;
+            if (!token(type) || !token(width) || !token(id) || !token(ref)) {
+                break;
+            }
+            if (ref != "$end") {
+                skip_to_end(tok);   // Optional bit range
+            }
+            if (width != "1" || type == "real") {
+                continue;
+            }
+            // Scopes below the top one, as the simulator names nets
+            std::string name;
+            for (size_t i = 1; i < scopes.size(); i++) {
+                name += scopes[i] + ".";
+            }
+            name += ref;
+            ids[id].push_back(names.size());
+            names.push_back(name);
+        } else if (tok == "$timescale") {
+            std::string scale;
+            while (token(tok) && tok != "$end") {
+                scale += tok;
+            }
+            size_t digits = scale.find_first_not_of("0123456789");
+            if (digits == 0 || digits == std::string::npos) {
+                throw std::runtime_error("Bad $timescale in " + path);
+            }
+            uint64_t number = std::stoull(scale.substr(0, digits));
+            std::string unit = scale.substr(digits);
+            uint64_t ps = unit == "ps" ? 1 : unit == "ns" ? 1000 : unit == "us" ? 1000000
+                        : unit == "ms" ? 1000000000ULL : unit == "s" ? 1000000000000ULL : 0;
+            if (ps == 0) {
+                throw std::runtime_error("Unsupported $timescale " + scale + " in " + path);
+            }
+            timescale = number * ps;
+        } else if (tok == "$enddefinitions") {
+            skip_to_end(tok);
+            return;
+        } else if (tok[0] == '$') {
+            skip_to_end(tok);   // $date, $version, $comment
+        }
+    }
+    throw std::runtime_error("No $enddefinitions in " + path);
+}
+
+bool VcdReader::next(Change& change) {
+    if (!queued.empty()) {
+        change = {time, queued.back(), queued_value};
+        queued.pop_back();
+        return true;
+    }
+    std::string tok;
+    std::string id;
+    while (token(tok)) {
+        int value;
+        if (tok[0] == '#') {
+            time = std::stoull(tok.substr(1)) * timescale;
+            continue;
+        } else if (tok[0] == '$') {
+            if (tok == "$comment") {
+                skip_to_end(tok);
+            }
+            continue;   // $dumpvars, $dumpall, $dumpon, $dumpoff, $end
+        } else if (tok[0] == 'b' || tok[0] == 'B') {
+            if (!token(id)) {
+                break;
+            }
+            value = tok.size() == 2 ? parse_value(tok[1]) : -1;   // Wider values belong to skipped vars
+        } else if (tok[0] == 'r' || tok[0] == 'R') {
+            token(id);
+            continue;
+        } else {
+            value = parse_value(tok[0]);
+            id = tok.substr(1);
+        }
+
+        auto it = ids.find(id);
+        if (value < 0 || it == ids.end()) {
+            continue;
+        }
+        queued.assign(it->second.rbegin(), it->second.rend());
+        queued_value = value;
+        change = {time, queued.back(), queued_value};
+        queued.pop_back();
+        return true;
+    }
+    return false;
+}
+
+// ===== WaveComparator =====
+
+WaveComparator::WaveComparator(const std::vector<std::string>& names, const WaveDiffOptions& options)
+    : names(names), options(options), tolerance(names.size(), options.tolerance),
+      masked(names.size(), false), golden_values(names.size(), LOGIC_X), actual_values(names.size(), LOGIC_X),
+      differs_since(names.size(), NONE), first_golden(names.size()),
+      first_actual(names.size()), is_touched(names.size(), false), now(0) {
+    for (size_t i = 0; i < names.size(); i++) {
+        for (const auto& pattern : options.signal_tolerances) {
+            if (matches(pattern.first, names[i])) {
+                tolerance[i] = pattern.second;
+                break;
+            }
+        }
+        for (const std::string& pattern : options.masks) {
+            if (matches(pattern, names[i])) {
+                masked[i] = true;
+                break;
+            }
+        }
+    }
+    report.masked_signals = std::count(masked.begin(), masked.end(), true);
+    report.compared_signals = names.size() - report.masked_signals;
+}
+
+bool WaveComparator::same(uint32_t signal) const {
+    return golden_values[signal] == actual_values[signal] ||
+           (options.golden_x_matches_any && golden_values[signal] == LOGIC_X);
+}
+
+// Start (or end) the difference of each signal changed in this time step
+void WaveComparator::settle() {
+    for (uint32_t signal : touched) {
+        is_touched[signal] = false;
+        if (masked[signal]) {
+            continue;
+        }
+        if (same(signal)) {
+            differs_since[signal] = NONE;
+        } else if (differs_since[signal] == NONE) {
+            differs_since[signal] = now;
+            first_golden[signal] = golden_values[signal];
+            first_actual[signal] = actual_values[signal];
+            uint64_t deadline = now + tolerance[signal] < now ? NONE : now + tolerance[signal];
+            deadlines.push({deadline, signal});
+        }
+    }
+    touched.clear();
+}
+
+// Report differences that lasted past their deadline. A stale heap entry
+// (the difference ended, maybe another started) no longer matches its
+// signal's differs_since and is dropped.
+void WaveComparator::expire(uint64_t before) {
+    while (!deadlines.empty() && deadlines.top().first < before && !done()) {
+        auto [deadline, signal] = deadlines.top();
+        deadlines.pop();
+        uint64_t since = differs_since[signal];
+        if (since != NONE && since != REPORTED && (deadline == NONE || since + tolerance[signal] == deadline)) {
+            mismatch(signal);
+        }
+    }
+}
+
+void WaveComparator::mismatch(uint32_t signal) {
+    report.mismatches.push_back({names[signal], differs_since[signal], first_golden[signal], first_actual[signal]});
+    differs_since[signal] = REPORTED;   // Once per difference
+    if (done()) {
+        report.stopped_early = true;
+    }
+}
+
+void WaveComparator::begin(uint64_t time) {
+    if (time <= now) {
+        return;
+    }
+    settle();
+    now = time;
+    expire(time);
+}
+
+void WaveComparator::finish() {
+    settle();
+    report.end_time = now;
+    // Whatever still differs at the end is a mismatch, tolerance or not
+    for (uint32_t signal = 0; signal < names.size() && !done(); signal++) {
+        if (differs_since[signal] != NONE && differs_since[signal] != REPORTED) {
+            mismatch(signal);
+        }
+    }
+    while (!deadlines.empty()) {
+        deadlines.pop();
+    }
+}
+
+bool WaveComparator::done() const {
+    return options.max_mismatches > 0 && report.mismatches.size() >= options.max_mismatches;
+}
+
+// ===== Files =====
+
+WaveDiffReport compare_waveforms(const std::string& golden_path, const std::string& actual_path,
+                                 const WaveDiffOptions& options) {
+    VcdReader golden(golden_path);
+    VcdReader actual(actual_path);
+
+    // Align by name
+    std::unordered_map<std::string, uint32_t> actual_slots;
+    for (size_t i = 0; i < actual.get_names().size(); i++) {
+        actual_slots.emplace(actual.get_names()[i], i);
+    }
+    std::vector<std::string> names;
+    std::vector<uint32_t> golden_map(golden.get_names().size(), NO_SLOT);
+    std::vector<uint32_t> actual_map(actual.get_names().size(), NO_SLOT);
+    std::vector<std::string> only_in_golden;
+    for (size_t i = 0; i < golden.get_names().size(); i++) {
+        const std::string& name = golden.get_names()[i];
+        auto it = actual_slots.find(name);
+        if (it == actual_slots.end()) {
+            only_in_golden.push_back(name);
+        } else if (actual_map[it->second] == NO_SLOT) {
+            golden_map[i] = actual_map[it->second] = names.size();
+            names.push_back(name);
+        }
+    }
+    std::vector<std::string> only_in_actual;
+    for (size_t i = 0; i < actual.get_names().size(); i++) {
+        if (actual_map[i] == NO_SLOT) {
+            only_in_actual.push_back(actual.get_names()[i]);
+        }
+    }
+
+    // Merge the two change streams by time
+    WaveComparator comparator(names, options);
+    WaveDiffReport& report = comparator.get_report();
+    VcdReader::Change g;
+    VcdReader::Change a;
+    bool golden_left = golden.next(g);
+    bool actual_left = actual.next(a);
+    while ((golden_left || actual_left) && !comparator.done()) {
+        uint64_t time = !actual_left ? g.time : !golden_left ? a.time : std::min(g.time, a.time);
+        comparator.begin(time);
+        while (golden_left && g.time <= time) {
+            if (golden_map[g.signal] != NO_SLOT) {
+                comparator.golden(golden_map[g.signal], g.value);
+            }
+            report.golden_changes++;
+            golden_left = golden.next(g);
+        }
+        while (actual_left && a.time <= time) {
+            if (actual_map[a.signal] != NO_SLOT) {
+                comparator.actual(actual_map[a.signal], a.value);
+            }
+            report.actual_changes++;
+            actual_left = actual.next(a);
+        }
+    }
+    comparator.finish();
+    report.only_in_golden = std::move(only_in_golden);
+    report.only_in_actual = std::move(only_in_actual);
+    return report;
+}
+
+// ===== LiveComparator =====
+
+LiveComparator::LiveComparator(Simulator& sim, const std::string& golden_path, const WaveDiffOptions& options)
+    : sim(sim), golden_file(golden_path), golden_pending(false), finished(false) {
+    id = "WAVE_COMPARE";
+    propagation_delay = 0;
+
+    const std::vector<std::string>& golden_names = golden_file.get_names();
+    golden_map.assign(golden_names.size(), NO_SLOT);
+    std::vector<std::string> names;
+    std::vector<std::string> only_in_golden;
+    for (size_t i = 0; i < golden_names.size(); i++) {
+        Signal* sig = sim.get_signal_by_name(golden_names[i]);
+        if (!sig) {
+            only_in_golden.push_back(golden_names[i]);
+        } else if (slots.emplace(sig, nets.size()).second) {
+            golden_map[i] = nets.size();
+            nets.push_back(sig);
+            names.push_back(golden_names[i]);
+        }
+    }
+    comparator = std::make_unique<WaveComparator>(names, options);
+    WaveDiffReport& report = comparator->get_report();
+    report.only_in_golden = std::move(only_in_golden);
+    for (Signal* sig : sim.get_signals()) {
+        if (!slots.count(sig)) {
+            report.only_in_actual.push_back(sig->get_name());
+        }
+    }
+
+    // The nets' present values, against the golden file up to now
+    for (uint32_t i = 0; i < nets.size(); i++) {
+        last.push_back(nets[i]->get_value());
+        comparator->actual(i, last.back());
+        nets[i]->attach_observer(this);
+    }
+    golden_pending = golden_file.next(next_golden);
+    golden_until(sim.get_current_time(), true);
+}
+
+LiveComparator::~LiveComparator() {
+    for (Signal* sig : nets) {
+        sig->detach_observer(this);
+    }
+}
+
+void LiveComparator::golden_until(uint64_t time, bool inclusive) {
+    WaveDiffReport& report = comparator->get_report();
+    while (golden_pending && (next_golden.time < time || (inclusive && next_golden.time == time))) {
+        comparator->begin(next_golden.time);
+        if (golden_map[next_golden.signal] != NO_SLOT) {
+            comparator->golden(golden_map[next_golden.signal], next_golden.value);
+        }
+        report.golden_changes++;
+        golden_pending = golden_file.next(next_golden);
+    }
+}
+
+void LiveComparator::evaluate(Simulator* sim, uint64_t current_time) {
+    Signal* sig = sim->get_trigger();
+    auto it = slots.find(sig);
+    if (finished || it == slots.end() || last[it->second] == sig->get_value()) {
+        return;
+    }
+    last[it->second] = sig->get_value();
+    golden_until(current_time, true);
+    comparator->begin(current_time);
+    comparator->actual(it->second, sig->get_value());
+    comparator->get_report().actual_changes++;
+    if (comparator->done()) {
+        sim->stop();
+    }
+}
+
+const WaveDiffReport& LiveComparator::finish() {
+    if (!finished) {
+        finished = true;
+        golden_until(sim.get_current_time(), true);
+        comparator->begin(sim.get_current_time());
+        comparator->finish();
+    }
+    return comparator->get_report();
+}
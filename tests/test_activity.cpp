@@ -0,0 +1,111 @@
+#include "simulator.h"
+#include "signal.h"
+#include "gate.h"
+#include "event.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cassert>
+
+void test_toggle_counts() {
+    std::cout << "\n=== Test: Toggle Counts ===\n";
+
+    Simulator sim;
+    Signal* a = sim.create_signal("A", 0);
+    Signal* y = sim.create_signal("Y", 2);
+
+    NOTGate* not_gate = sim.create_component<NOTGate>(50);
+    not_gate->connect_input(a);
+    not_gate->connect_output(y);
+
+    sim.enable_activity();
+
+    // A: 0 -> 1 @100, 1 -> 0 @300, 0 -> 1 @600
+    // Y: X -> 0 @150, 0 -> 1 @350, 1 -> 0 @650
+    sim.schedule_event(Event(100, a->get_id(), 1));
+    sim.schedule_event(Event(300, a->get_id(), 0));
+    sim.schedule_event(Event(600, a->get_id(), 1));
+    sim.run_until(1000);
+
+    auto act_a = sim.get_activity(a);
+    assert(act_a.rise == 2);
+    assert(act_a.fall == 1);
+    assert(act_a.toggles() == 3);
+    assert(act_a.x_transitions == 0);
+    std::cout << "✓ A toggled 3 times (2 rise, 1 fall)\n";
+
+    auto act_y = sim.get_activity(y);
+    assert(act_y.x_transitions == 1);
+    assert(act_y.rise == 1);
+    assert(act_y.fall == 1);
+    std::cout << "✓ Y counted X->0 separately from 0/1 toggles\n";
+}
+
+void test_residency() {
+    std::cout << "\n=== Test: Residency Times ===\n";
+
+    Simulator sim;
+    Signal* a = sim.create_signal("A", 0);
+    Signal* y = sim.create_signal("Y", 2);
+
+    NOTGate* not_gate = sim.create_component<NOTGate>(50);
+    not_gate->connect_input(a);
+    not_gate->connect_output(y);
+
+    sim.enable_activity();
+    sim.schedule_event(Event(100, a->get_id(), 1));
+    sim.schedule_event(Event(400, a->get_id(), 0));
+    sim.run_all();  // Ends at t=450 (Y -> 1)
+
+    auto act_a = sim.get_activity(a);
+    assert(act_a.time_in[0] == 100 + 50);   // [0,100) and [400,450)
+    assert(act_a.time_in[1] == 300);        // [100,400)
+    assert(act_a.time_in[2] == 0);
+
+    auto act_y = sim.get_activity(y);
+    assert(act_y.time_in[2] == 150);        // X until t=150
+    assert(act_y.time_in[0] == 300);        // [150,450)
+    std::cout << "✓ 0/1/X residency accumulated per net\n";
+}
+
+void test_saif_export() {
+    std::cout << "\n=== Test: SAIF Export ===\n";
+
+    Simulator sim;
+    Signal* a = sim.create_signal("A", 0);
+    Signal* b = sim.create_signal("B", 0);
+    Signal* y = sim.create_signal("Y", 2);
+
+    ANDGate* and_gate = sim.create_component<ANDGate>(100);
+    and_gate->connect_input(a);
+    and_gate->connect_input(b);
+    and_gate->connect_output(y);
+
+    sim.enable_activity();
+    sim.schedule_event(Event(0, a->get_id(), 1));
+    sim.schedule_event(Event(0, b->get_id(), 1));
+    sim.run_until(500);
+    sim.dump_saif("activity.saif");
+
+    std::ifstream file("activity.saif");
+    std::stringstream content;
+    content << file.rdbuf();
+    std::string saif = content.str();
+
+    assert(saif.find("(SAIFILE") != std::string::npos);
+    assert(saif.find("(DURATION 100)") != std::string::npos);
+    assert(saif.find("(Y\n      (T0 0) (T1 0) (TX 100) (TZ 0)\n      (TC 0) (IG 1)") != std::string::npos);
+    std::cout << "✓ SAIF summary written\n";
+}
+
+int main() {
+    test_toggle_counts();
+    test_residency();
+    test_saif_export();
+
+    std::cout << "\n=========================\n";
+    std::cout << "✓ All Activity Tests Passed!\n";
+    std::cout << "=========================\n";
+
+    return 0;
+}
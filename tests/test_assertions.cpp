@@ -0,0 +1,155 @@
+#include "simulator.h"
+#include "signal.h"
+#include "event.h"
+#include "assertions.h"
+#include <iostream>
+#include <sstream>
+#include <cassert>
+
+static void clock_cycles(Simulator& sim, Signal* clk, uint64_t start, int cycles) {
+    for (int i = 0; i < cycles; i++) {
+        sim.schedule_event(Event(start + i * 100, clk->get_id(), 1));
+        sim.schedule_event(Event(start + i * 100 + 50, clk->get_id(), 0));
+    }
+}
+
+void test_immediate_invariants() {
+    std::cout << "\n=== Test: Immediate Invariants ===\n";
+
+    Simulator sim;
+    Signal* a = sim.create_signal("A", 0);
+    Signal* b = sim.create_signal("B", 0);
+
+    AssertionSet checks(sim);
+    uint32_t never_both = checks.always("a_nand_b", {a, b},
+                                        [&]() { return !(a->get_value() == 1 && b->get_value() == 1); });
+    std::vector<Signal*> grant = {sim.create_signal("g0", 1), sim.create_signal("g1", 0),
+                                  sim.create_signal("g2", 0)};
+    uint32_t hot = checks.one_hot("grant_one_hot", grant);
+
+    sim.schedule_event(Event(100, a->get_id(), 1));
+    sim.schedule_event(Event(200, a->get_id(), 0));
+    sim.schedule_event(Event(200, b->get_id(), 1));   // Same step: never both high
+    sim.run_all();
+    assert(checks.passed());
+
+    sim.schedule_event(Event(300, a->get_id(), 1));
+    sim.schedule_event(Event(300, grant[0]->get_id(), 0));   // Handover with a gap
+    sim.schedule_event(Event(310, grant[2]->get_id(), 1));
+    sim.schedule_event(Event(400, grant[1]->get_id(), 2));   // Two hot, then one X
+    sim.run_all();
+    assert(checks.failures(never_both) == 1);
+    assert(checks.failures(hot) == 2);
+    assert(checks.total_failures() == 3);
+    assert(checks.get_log().size() == 3);
+    assert(checks.get_log().back().time == 400 && checks.get_log().back().assertion == hot);
+
+    std::ostringstream out;
+    checks.report(out);
+    assert(out.str().find("t=400ps grant_one_hot failed") != std::string::npos);
+    std::cout << "✓ Invariants fire once per time step, one-hot counts X bits as failures\n";
+}
+
+void test_clocked_sampling() {
+    std::cout << "\n=== Test: Clocked Sampling ===\n";
+
+    Simulator sim;
+    Signal* clk = sim.create_signal("CLK", 0);
+    std::vector<Signal*> state = {sim.create_signal("s0", 1), sim.create_signal("s1", 0)};
+
+    AssertionSet checks(sim);
+    uint32_t hot = checks.one_hot("state_one_hot", state, false, clk);
+
+    // Glitch between edges: s0 falls at 120, s1 rises at 130
+    sim.schedule_event(Event(120, state[0]->get_id(), 0));
+    sim.schedule_event(Event(130, state[1]->get_id(), 1));
+    clock_cycles(sim, clk, 0, 3);
+    sim.run_all();
+    assert(checks.failures(hot) == 0);
+
+    sim.schedule_event(Event(420, state[0]->get_id(), 1));   // Both hot at the edge at 500
+    clock_cycles(sim, clk, 500, 1);
+    sim.run_all();
+    assert(checks.failures(hot) == 1);
+    assert(checks.get_log()[0].time == 500);
+    std::cout << "✓ Clocked one-hot ignores glitches between edges\n";
+}
+
+void test_temporal_properties() {
+    std::cout << "\n=== Test: Temporal Properties ===\n";
+
+    Simulator sim;
+    Signal* clk = sim.create_signal("CLK", 0);
+    Signal* req = sim.create_signal("REQ", 0);
+    Signal* ack = sim.create_signal("ACK", 0);
+    Signal* valid = sim.create_signal("VALID", 0);
+    Signal* data = sim.create_signal("DATA", 0);
+
+    AssertionSet checks(sim);
+    uint32_t handshake = checks.implies_within("req_ack", clk, req, ack, 2);
+    uint32_t stable = checks.stable_while("data_stable", clk, valid, {data});
+
+    // Edges at 0, 100, ..., 900. REQ at edge 100, ACK by edge 300: ok
+    sim.schedule_event(Event(80, req->get_id(), 1));
+    sim.schedule_event(Event(180, req->get_id(), 0));
+    sim.schedule_event(Event(280, ack->get_id(), 1));
+    sim.schedule_event(Event(380, ack->get_id(), 0));
+    // REQ at edge 500, no ACK by edge 700: fails at 700
+    sim.schedule_event(Event(480, req->get_id(), 1));
+    sim.schedule_event(Event(580, req->get_id(), 0));
+
+    // DATA changes while VALID is high across edges 200..400, and
+    // again after VALID dropped (allowed)
+    sim.schedule_event(Event(150, valid->get_id(), 1));
+    sim.schedule_event(Event(350, data->get_id(), 1));
+    sim.schedule_event(Event(450, valid->get_id(), 0));
+    sim.schedule_event(Event(550, data->get_id(), 0));
+
+    clock_cycles(sim, clk, 0, 10);
+    sim.run_all();
+    assert(checks.failures(handshake) == 1);
+    assert(checks.failures(stable) == 1);
+    bool handshake_at_700 = false, stable_at_400 = false;
+    for (const AssertionFailure& failure : checks.get_log()) {
+        handshake_at_700 |= failure.assertion == handshake && failure.time == 700;
+        stable_at_400 |= failure.assertion == stable && failure.time == 400;
+    }
+    assert(handshake_at_700 && stable_at_400);
+    std::cout << "✓ req |-> ##[0:2] ack and stable-while-valid fail at the right edges\n";
+}
+
+void test_fail_fast() {
+    std::cout << "\n=== Test: Fail-Fast ===\n";
+
+    Simulator sim;
+    Signal* a = sim.create_signal("A", 0);
+    AssertionSet checks(sim);
+    checks.always("a_low", {a}, [&]() { return a->get_value() == 0; });
+    checks.set_fail_fast(true);
+
+    sim.schedule_event(Event(100, a->get_id(), 1));
+    sim.schedule_event(Event(200, a->get_id(), 0));
+    sim.run_all();
+    assert(sim.stopped());
+    assert(sim.get_current_time() == 100);
+    assert(a->get_value() == 1);
+
+    sim.run_all();   // Pending events are still there
+    assert(!sim.stopped());
+    assert(a->get_value() == 0);
+    assert(checks.total_failures() == 1);
+    std::cout << "✓ First failure stops the run; a new run resumes\n";
+}
+
+int main() {
+    test_immediate_invariants();
+    test_clocked_sampling();
+    test_temporal_properties();
+    test_fail_fast();
+
+    std::cout << "\n=========================\n";
+    std::cout << "✓ All Assertion Tests Passed!\n";
+    std::cout << "=========================\n";
+
+    return 0;
+}
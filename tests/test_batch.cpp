@@ -0,0 +1,177 @@
+#include "simulator.h"
+#include "signal.h"
+#include "gate.h"
+#include "event.h"
+#include <iostream>
+#include <cassert>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+static std::vector<Signal*> make_bus(Simulator& sim, const std::string& name, int width) {
+    std::vector<Signal*> bus;
+    for (int i = 0; i < width; i++) {
+        bus.push_back(sim.create_signal(name + std::to_string(i), 0));
+    }
+    return bus;
+}
+
+void test_wide_bus_batch() {
+    std::cout << "\n=== Test: Wide Bus Driven at Once ===\n";
+
+    Simulator sim;
+    std::vector<Signal*> bus = make_bus(sim, "d", 256);
+    sim.enable_stats();
+
+    // Two writes per bit in one batch: the second one wins
+    std::vector<Event> stimulus;
+    for (Signal* bit : bus) {
+        stimulus.emplace_back(1000, bit->get_id(), 1);
+    }
+    for (size_t i = 0; i < bus.size(); i++) {
+        stimulus.emplace_back(1000, bus[i]->get_id(), i % 3 == 0);
+    }
+    sim.schedule_batch(stimulus);
+    sim.run_all();
+
+    for (size_t i = 0; i < bus.size(); i++) {
+        assert(bus[i]->get_value() == (i % 3 == 0));
+    }
+    SimStats stats = sim.get_stats();
+    assert(stats.events_scheduled == 512);
+    assert(stats.events_coalesced == 256);
+    assert(stats.events_processed == 256);
+    assert(stats.peak_queue_depth == 256);
+    assert(stats.heap_events == 0);
+    std::cout << "✓ 512 writes queued as 256 events, no heap operations\n";
+}
+
+void test_last_writer_wins() {
+    std::cout << "\n=== Test: Last Writer Wins ===\n";
+
+    Simulator sim;
+    Signal* x = sim.create_signal("x", 0);
+    Signal* y = sim.create_signal("y", 0);
+    NOTGate* inv = sim.create_component<NOTGate>(0);
+    inv->connect_input(x);
+    inv->connect_output(y);
+    sim.enable_stats();
+
+    sim.schedule_event(Event(100, x->get_id(), 1));
+    sim.schedule_event(Event(100, x->get_id(), 0));
+    sim.schedule_event(Event(100, x->get_id(), 1));
+    sim.run_until(100);
+    assert(x->get_value() == 1 && y->get_value() == 0);
+    assert(sim.get_stats().evaluations == 1);   // One change, one evaluation
+
+    // Transport delay: writes for different times all happen
+    sim.schedule_event(Event(200, x->get_id(), 0));
+    sim.schedule_event(Event(300, x->get_id(), 1));
+    sim.schedule_event(Event(200, x->get_id(), 1));   // Coalesces with the 200 write
+    sim.run_until(250);
+    assert(x->get_value() == 1);
+    sim.run_all();
+    assert(x->get_value() == 1 && sim.get_current_time() == 300);
+    assert(sim.get_stats().events_coalesced == 3);
+    std::cout << "✓ Same-time writes keep the last value; other times are untouched\n";
+}
+
+void test_batch_matches_single_events() {
+    std::cout << "\n=== Test: Batch Equals One-by-One ===\n";
+
+    // Random stimulus at many times, through the heap
+    auto run = [](bool batch) {
+        Simulator sim;
+        std::vector<Signal*> in = make_bus(sim, "in", 32);
+        std::vector<Signal*> out = make_bus(sim, "out", 31);
+        for (int i = 0; i < 31; i++) {
+            XORGate* gate = sim.create_component<XORGate>(7);
+            gate->connect_input(in[i]);
+            gate->connect_input(in[i + 1]);
+            gate->connect_output(out[i]);
+        }
+        std::mt19937 gen(7);
+        std::vector<Event> stimulus;
+        for (int n = 0; n < 5000; n++) {
+            stimulus.emplace_back(gen() % 100000, in[gen() % 32]->get_id(), gen() & 1);
+        }
+        if (batch) {
+            sim.schedule_batch(stimulus);
+        } else {
+            for (const Event& e : stimulus) {
+                sim.schedule_event(e);
+            }
+        }
+        std::vector<uint8_t> trace;
+        while (sim.has_pending_events()) {
+            sim.step();
+            for (Signal* sig : out) {
+                trace.push_back(sig->get_value());
+            }
+        }
+        return trace;
+    };
+    assert(run(true) == run(false));
+    std::cout << "✓ A batched heap build pops the same schedule\n";
+}
+
+void test_heap_last_writer() {
+    std::cout << "\n=== Test: Last Writer Wins Through the Heap ===\n";
+
+    // Several writers per net and time, scheduled in random time order so
+    // most go through the heap; the value scheduled last for a time must win
+    auto run = [](bool batch) {
+        Simulator sim;
+        std::vector<Signal*> nets = make_bus(sim, "n", 8);
+        std::mt19937 gen(3);
+        std::vector<Event> stimulus;
+        for (int n = 0; n < 4000; n++) {
+            stimulus.emplace_back(100 * (1 + gen() % 50), nets[gen() % 8]->get_id(), gen() % 3);
+        }
+        std::map<uint64_t, std::vector<uint8_t>> expected;   // Net values after each time
+        for (const Event& e : stimulus) {
+            expected[e.time];
+        }
+        for (auto& [time, values] : expected) {
+            std::vector<uint64_t> written(8, 0);
+            values.assign(8, 0);
+            for (const Event& e : stimulus) {
+                size_t i = e.signal_id - nets[0]->get_id();
+                if (e.time <= time && e.time >= written[i]) {
+                    written[i] = e.time;
+                    values[i] = e.new_value;
+                }
+            }
+        }
+        if (batch) {
+            sim.schedule_batch(stimulus);
+        } else {
+            for (const Event& e : stimulus) {
+                sim.schedule_event(e);
+            }
+        }
+        for (const auto& [time, values] : expected) {
+            sim.run_until(time);
+            for (size_t i = 0; i < nets.size(); i++) {
+                assert(nets[i]->get_value() == values[i]);
+            }
+        }
+    };
+    run(false);
+    run(true);
+    std::cout << "✓ 4000 writes to 8 nets at 50 times: the last one scheduled wins, one by one and batched\n";
+}
+
+int main() {
+    test_wide_bus_batch();
+    test_last_writer_wins();
+    test_batch_matches_single_events();
+    test_heap_last_writer();
+
+    std::cout << "\n=========================\n";
+    std::cout << "✓ All Batch Scheduling Tests Passed!\n";
+    std::cout << "=========================\n";
+
+    return 0;
+}
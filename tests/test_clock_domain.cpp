@@ -0,0 +1,201 @@
+#include "simulator.h"
+#include "signal.h"
+#include "gate.h"
+#include "sequential.h"
+#include "event.h"
+#include "circuits.h"
+#include "clock_domain.h"
+#include <iostream>
+#include <cassert>
+
+// Same LFSR + counter pipeline in two simulators, one with batched domains
+void test_matches_event_engine() {
+    std::cout << "\n=== Test: Domain Matches Event Engine ===\n";
+
+    Simulator ref, fast;
+    CircuitPorts ref_lfsr = build_lfsr(ref, 16);
+    CircuitPorts ref_cnt = build_counter_pipeline(ref, 8, 3);
+    CircuitPorts fast_lfsr = build_lfsr(fast, 16);
+    CircuitPorts fast_cnt = build_counter_pipeline(fast, 8, 3);
+    assert(build_clock_domains(fast) == 2);
+
+    const uint64_t period = 1000;
+    for (int c = 0; c < 200; c++) {
+        uint64_t t = c * period + period / 2;
+        for (Simulator* sim : {&ref, &fast}) {
+            CircuitPorts& lfsr = sim == &ref ? ref_lfsr : fast_lfsr;
+            CircuitPorts& cnt = sim == &ref ? ref_cnt : fast_cnt;
+            sim->schedule_event(Event(t, lfsr.clock->get_id(), 1));
+            sim->schedule_event(Event(t + period / 2, lfsr.clock->get_id(), 0));
+            sim->schedule_event(Event(t, cnt.clock->get_id(), 1));
+            sim->schedule_event(Event(t + period / 2, cnt.clock->get_id(), 0));
+            sim->run_until(t + period / 2);
+        }
+        for (size_t i = 0; i < ref_lfsr.outputs.size(); i++) {
+            assert(ref_lfsr.outputs[i]->get_value() == fast_lfsr.outputs[i]->get_value());
+        }
+        for (size_t i = 0; i < ref_cnt.outputs.size(); i++) {
+            assert(ref_cnt.outputs[i]->get_value() == fast_cnt.outputs[i]->get_value());
+        }
+    }
+    assert(ref.get_events_processed() == fast.get_events_processed());
+    assert(fast.get_evaluations() < ref.get_evaluations());
+    std::cout << "✓ 200 cycles identical, evaluations " << ref.get_evaluations()
+              << " -> " << fast.get_evaluations() << "\n";
+}
+
+void test_enable_and_reset_masks() {
+    std::cout << "\n=== Test: Enable and Reset Masks ===\n";
+
+    Simulator sim;
+    Signal* clk = sim.create_signal("clk", 0);
+    Signal* d = sim.create_signal("D", 1);
+    Signal* en = sim.create_signal("EN", 0);
+    Signal* rst = sim.create_signal("RST", 0);
+    Signal* q_plain = sim.create_signal("Q_plain", 0);
+    Signal* q_en = sim.create_signal("Q_en", 0);
+    Signal* q_rst = sim.create_signal("Q_rst", 0);
+
+    DFF* plain = sim.create_component<DFF>(100);
+    plain->connect_clock(clk);
+    plain->connect_data(d);
+    plain->connect_q(q_plain);
+    DFF* gated = sim.create_component<DFF>(100);
+    gated->connect_clock(clk);
+    gated->connect_data(d);
+    gated->connect_q(q_en);
+    gated->connect_enable(en);
+    DFF* resettable = sim.create_component<DFF>(100);
+    resettable->connect_clock(clk);
+    resettable->connect_data(d);
+    resettable->connect_q(q_rst);
+    resettable->connect_reset(rst);
+
+    assert(build_clock_domains(sim) == 1);
+    assert(plain->is_in_domain() && gated->is_in_domain() && resettable->is_in_domain());
+    assert(clk->get_observers().size() == 1);   // Only the domain
+    assert(d->get_observers().empty());
+    assert(rst->get_observers().size() == 1);   // Reset stays asynchronous
+
+    sim.schedule_event(Event(1000, clk->get_id(), 1));
+    sim.schedule_event(Event(1500, clk->get_id(), 0));
+    sim.run_until(1200);
+    assert(q_plain->get_value() == 1);
+    assert(q_en->get_value() == 0);    // Held: enable low
+    assert(q_rst->get_value() == 1);
+    std::cout << "✓ Disabled flops hold their value\n";
+
+    sim.schedule_event(Event(1700, rst->get_id(), 1));
+    sim.run_until(1900);
+    assert(q_rst->get_value() == 0);
+    std::cout << "✓ Async reset still acts between edges\n";
+
+    sim.schedule_event(Event(2000, en->get_id(), 1));
+    sim.schedule_event(Event(2500, clk->get_id(), 1));
+    sim.run_until(2700);
+    assert(q_en->get_value() == 1);
+    assert(q_rst->get_value() == 0);   // Reset held high wins over D
+    std::cout << "✓ Enabled flops capture, reset flops stay cleared\n";
+}
+
+// Two flops on unrelated clocks with a path between them
+void test_asynchronous_clocks() {
+    std::cout << "\n=== Test: Asynchronous Clocks ===\n";
+
+    auto build = [](Simulator& sim, std::vector<Signal*>& qs) {
+        Signal* clk_a = sim.create_signal("clk_a", 0);
+        Signal* clk_b = sim.create_signal("clk_b", 0);
+        Signal* a0 = sim.create_signal("a0", 0);
+        Signal* a1 = sim.create_signal("a1", 0);
+        Signal* na1 = sim.create_signal("na1", 1);
+        Signal* b0 = sim.create_signal("b0", 0);
+        Signal* b1 = sim.create_signal("b1", 0);
+
+        // Domain A: 2-bit Johnson counter a0 <- !a1, a1 <- a0
+        NOTGate* inv = sim.create_component<NOTGate>(50);
+        inv->connect_input(a1);
+        inv->connect_output(na1);
+        DFF* fa0 = sim.create_component<DFF>(100);
+        fa0->connect_clock(clk_a);
+        fa0->connect_data(na1);
+        fa0->connect_q(a0);
+        DFF* fa1 = sim.create_component<DFF>(100);
+        fa1->connect_clock(clk_a);
+        fa1->connect_data(a0);
+        fa1->connect_q(a1);
+
+        // Domain B (falling edge) synchronizes a1
+        DFF* fb0 = sim.create_component<DFF>(100, DFF::FALLING);
+        fb0->connect_clock(clk_b);
+        fb0->connect_data(a1);
+        fb0->connect_q(b0);
+        DFF* fb1 = sim.create_component<DFF>(100, DFF::FALLING);
+        fb1->connect_clock(clk_b);
+        fb1->connect_data(b0);
+        fb1->connect_q(b1);
+
+        for (uint64_t t = 500; t < 40000; t += 1000) {
+            sim.schedule_event(Event(t, clk_a->get_id(), 1));
+            sim.schedule_event(Event(t + 500, clk_a->get_id(), 0));
+        }
+        for (uint64_t t = 300; t < 40000; t += 1300) {
+            sim.schedule_event(Event(t, clk_b->get_id(), 1));
+            sim.schedule_event(Event(t + 650, clk_b->get_id(), 0));
+        }
+        qs = {a0, a1, b0, b1};
+    };
+
+    Simulator ref, fast;
+    std::vector<Signal*> ref_q, fast_q;
+    build(ref, ref_q);
+    build(fast, fast_q);
+    assert(build_clock_domains(fast) == 2);
+
+    for (uint64_t t = 100; t < 40000; t += 100) {
+        ref.run_until(t);
+        fast.run_until(t);
+        for (size_t i = 0; i < ref_q.size(); i++) {
+            assert(ref_q[i]->get_value() == fast_q[i]->get_value());
+        }
+    }
+    std::cout << "✓ Rising and falling domains on unrelated clocks match the event engine\n";
+}
+
+void test_domain_errors() {
+    std::cout << "\n=== Test: Domain Errors ===\n";
+
+    Simulator sim;
+    Signal* clk1 = sim.create_signal("clk1", 0);
+    Signal* clk2 = sim.create_signal("clk2", 0);
+    Signal* d = sim.create_signal("D", 0);
+    Signal* q = sim.create_signal("Q", 0);
+    DFF* flop = sim.create_component<DFF>(100);
+    flop->connect_clock(clk2);
+    flop->connect_data(d);
+    flop->connect_q(q);
+
+    ClockDomain* domain = sim.create_component<ClockDomain>(clk1);
+    bool threw = false;
+    try {
+        domain->add_flop(flop);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    assert(build_clock_domains(sim) == 0);   // A single flop is not worth a domain
+    assert(build_clock_domains(sim, 1) == 1);
+    std::cout << "✓ Flops from another clock are rejected\n";
+}
+
+int main() {
+    test_matches_event_engine();
+    test_enable_and_reset_masks();
+    test_asynchronous_clocks();
+    test_domain_errors();
+
+    std::cout << "\n=========================\n";
+    std::cout << "✓ All Clock Domain Tests Passed!\n";
+    std::cout << "=========================\n";
+
+    return 0;
+}
@@ -0,0 +1,131 @@
+#include "simulator.h"
+#include "signal.h"
+#include "gate.h"
+#include "sequential.h"
+#include "event.h"
+#include <iostream>
+#include <sstream>
+#include <cassert>
+
+void test_toggle_coverage() {
+    std::cout << "\n=== Test: Toggle Coverage ===\n";
+
+    Simulator sim;
+    Signal* a = sim.create_signal("A", 0);
+    Signal* b = sim.create_signal("B", 0);
+    Signal* y = sim.create_signal("Y", 2);
+
+    ANDGate* and_gate = sim.create_component<ANDGate>(100);
+    and_gate->connect_input(a);
+    and_gate->connect_input(b);
+    and_gate->connect_output(y);
+
+    // A toggles both ways, B only rises, Y: X -> 0 -> 1
+    sim.schedule_event(Event(0, a->get_id(), 1));
+    sim.schedule_event(Event(200, a->get_id(), 0));
+    sim.schedule_event(Event(400, a->get_id(), 1));
+    sim.schedule_event(Event(400, b->get_id(), 1));
+    sim.run_all();
+
+    CoverageDB cov = sim.get_coverage();
+    assert(cov.toggle_covered(a->get_index()));
+    assert(!cov.toggle_covered(b->get_index()));
+    assert(cov.has_risen(b->get_index()) && !cov.has_fallen(b->get_index()));
+    assert(cov.has_risen(y->get_index()) && !cov.has_fallen(y->get_index()));
+    assert(cov.toggle_covered_count() == 1);
+    std::cout << "✓ Rise/fall bits tracked per net\n";
+
+    std::ostringstream report;
+    cov.report(report);
+    assert(report.str().find("  B (never 1->0)") != std::string::npos);
+    assert(report.str().find("  Y (never 1->0)") != std::string::npos);
+    assert(report.str().find("  A") == std::string::npos);
+    std::cout << "✓ Report lists uncovered nets\n";
+}
+
+void test_state_coverage() {
+    std::cout << "\n=== Test: DFF State Coverage ===\n";
+
+    Simulator sim;
+    Signal* clk = sim.create_signal("clk", 0);
+    Signal* d = sim.create_signal("D", 0);
+    Signal* q = sim.create_signal("Q", 2);
+
+    DFF* dff = sim.create_component<DFF>(50);
+    dff->connect_clock(clk);
+    dff->connect_data(d);
+    dff->connect_q(q);
+
+    // Capture 1 only: Q has never been 0
+    sim.schedule_event(Event(0, d->get_id(), 1));
+    sim.schedule_event(Event(100, clk->get_id(), 1));
+    sim.schedule_event(Event(200, clk->get_id(), 0));
+    sim.run_all();
+
+    CoverageDB cov = sim.get_coverage();
+    assert(cov.is_state(q->get_index()));
+    assert(!cov.is_state(d->get_index()));
+    assert(cov.state_net_count() == 1);
+    assert(!cov.state_covered(q->get_index()));
+
+    // Capture 0: both values seen
+    sim.schedule_event(Event(300, d->get_id(), 0));
+    sim.schedule_event(Event(400, clk->get_id(), 1));
+    sim.run_all();
+
+    cov = sim.get_coverage();
+    assert(cov.state_covered(q->get_index()));
+    assert(cov.state_covered_count() == 1);
+    std::cout << "✓ Q state coverage reached after capturing 1 and 0\n";
+}
+
+// Two "processes" simulating the same design with different stimulus
+static CoverageDB run_inverter(uint8_t first, uint8_t second) {
+    Simulator sim;
+    Signal* a = sim.create_signal("A", first);
+    Signal* y = sim.create_signal("Y", 2);
+    NOTGate* not_gate = sim.create_component<NOTGate>(50);
+    not_gate->connect_input(a);
+    not_gate->connect_output(y);
+
+    sim.schedule_event(Event(0, a->get_id(), first));
+    sim.schedule_event(Event(100, a->get_id(), second));
+    sim.run_all();
+    return sim.get_coverage();
+}
+
+void test_merge_across_runs() {
+    std::cout << "\n=== Test: Coverage Merge ===\n";
+
+    run_inverter(0, 1).save("cov_run0.db");
+    run_inverter(1, 0).save("cov_run1.db");
+
+    CoverageDB merged = CoverageDB::load("cov_run0.db");
+    assert(merged.toggle_covered_count() == 0);
+
+    merged.merge(CoverageDB::load("cov_run1.db"));
+    assert(merged.size() == 2);
+    assert(merged.toggle_covered_count() == 2);
+    std::cout << "✓ Saved databases merge to full toggle coverage\n";
+
+    // Merging a database with a different net list matches by name
+    CoverageDB other;
+    other.add_net("Z", 0);
+    other.add_net("A", 1);
+    merged.merge(other);
+    assert(merged.size() == 3);
+    assert(merged.get_name(2) == "Z");
+    std::cout << "✓ Nets matched by name across designs\n";
+}
+
+int main() {
+    test_toggle_coverage();
+    test_state_coverage();
+    test_merge_across_runs();
+
+    std::cout << "\n=========================\n";
+    std::cout << "✓ All Coverage Tests Passed!\n";
+    std::cout << "=========================\n";
+
+    return 0;
+}
@@ -0,0 +1,201 @@
+#include "simulator.h"
+#include "signal.h"
+#include "gate.h"
+#include "event.h"
+#include "event_queue.h"
+#include <iostream>
+#include <cassert>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+void test_delta_queue() {
+    std::cout << "\n=== Test: Delta and Near FIFOs ===\n";
+
+    EventQueue eq;
+    eq.schedule(Event(100, 1, 1));
+    eq.schedule(Event(100, 2, 1));
+    eq.schedule(Event(300, 3, 1));
+    eq.schedule(Event(50, 4, 1));    // Sooner than the near FIFO: 100s move to the heap
+    assert(eq.size() == 4 && eq.next_time() == 50);
+
+    assert(eq.begin_delta() == 1);
+    assert(eq.current_time() == 50 && eq.current_delta() == 0);
+    assert(eq.pop_next().signal_id == 4);
+    eq.schedule(Event(50, 5, 0));    // Zero delay: next delta cycle
+    eq.schedule(Event(50, 6, 0));
+    assert(eq.next_time() == 50);
+    assert(eq.begin_delta() == 2 && eq.current_delta() == 1);
+    assert(eq.pop_next().signal_id == 5);   // FIFO order within a cycle
+    assert(eq.pop_next().signal_id == 6);
+
+    assert(eq.begin_delta() == 2);   // Both events at 100, from the heap
+    assert(eq.current_time() == 100 && eq.current_delta() == 0);
+    eq.pop_next();
+    eq.pop_next();
+    assert(eq.begin_delta() == 1 && eq.current_time() == 300);
+    eq.pop_next();
+    assert(eq.empty() && eq.begin_delta() == 0);
+    std::cout << "✓ Same-time events form delta cycles, later times pop in order\n";
+
+    eq.schedule(Event(400, 1, 1));
+    eq.schedule(Event(400, 2, 1));
+    eq.schedule(Event(500, 3, 1));
+    EventQueue copy;
+    copy.restore(eq.snapshot());
+    assert(copy.size() == 3 && copy.begin_delta() == 2 && copy.current_time() == 400);
+    std::cout << "✓ Snapshot/restore keeps every pending event\n";
+}
+
+void test_pooled_storage() {
+    std::cout << "\n=== Test: Pooled Event Storage ===\n";
+
+    EventQueue eq;
+    eq.schedule(Event(0, 0, 0));
+    eq.pop_next();
+    for (int i = 0; i < 10000; i++) {
+        eq.schedule(Event(100, i, i & 1));   // Near FIFO, 40 chunks
+    }
+    size_t bytes = eq.memory_bytes();
+    assert(bytes < 10000 * sizeof(Event));
+    for (int i = 0; i < 10000; i++) {
+        Event e = eq.pop_next();
+        assert(e.time == 100 && e.signal_id == i && e.new_value == (i & 1));
+    }
+    std::cout << "✓ " << (double)bytes / 10000 << " bytes per pending event (Event is "
+              << sizeof(Event) << ")\n";
+
+    // Steady state: drained chunks are reused, storage stops growing
+    size_t steady = 0;
+    for (uint64_t t = 101; t < 200; t++) {
+        for (int i = 0; i < 10000; i++) {
+            eq.schedule(Event(t, i, 1));
+        }
+        eq.begin_delta();
+        while (!eq.empty()) {
+            eq.pop_next();
+        }
+        if (t == 101) {
+            steady = eq.memory_bytes();
+        }
+    }
+    assert(eq.memory_bytes() == steady);
+    std::cout << "✓ Recycled chunks: no growth over 100 more times\n";
+
+    // A net's slot stays checkable after its event is consumed
+    PendingSlot slot;
+    eq.schedule(Event(300, 7, 1), &slot);
+    eq.schedule(Event(300, 7, 0), &slot);
+    assert(eq.size() == 1 && eq.get_coalesced_count() == 1);
+    eq.pop_next();
+    eq.schedule(Event(300, 7, 1), &slot);   // Stale: queued as a new event
+    assert(eq.size() == 1 && eq.get_coalesced_count() == 1);
+    std::cout << "✓ Stale slots are not coalesced into\n";
+}
+
+// Zero-delay full adder (the README example)
+void test_zero_delay_adder() {
+    std::cout << "\n=== Test: Zero-Delay Full Adder ===\n";
+
+    Simulator sim;
+    sim.enable_stats();
+    Signal* a = sim.create_signal("A", 0);
+    Signal* b = sim.create_signal("B", 0);
+    Signal* cin = sim.create_signal("Cin", 0);
+    Signal* ab = sim.create_signal("AxB", 2);
+    Signal* sum = sim.create_signal("Sum", 2);
+    Signal* g = sim.create_signal("AB", 2);
+    Signal* p = sim.create_signal("Pc", 2);
+    Signal* cout = sim.create_signal("Cout", 2);
+
+    auto gate = [&](Gate* gt, std::vector<Signal*> ins, Signal* out) {
+        for (Signal* in : ins) {
+            gt->connect_input(in);
+        }
+        gt->connect_output(out);
+    };
+    gate(sim.create_component<XORGate>(0), {a, b}, ab);
+    gate(sim.create_component<XORGate>(0), {ab, cin}, sum);
+    gate(sim.create_component<ANDGate>(0), {a, b}, g);
+    gate(sim.create_component<ANDGate>(0), {ab, cin}, p);
+    gate(sim.create_component<ORGate>(0), {g, p}, cout);
+
+    sim.schedule_event(Event(0, a->get_id(), 1));
+    sim.schedule_event(Event(0, b->get_id(), 0));
+    sim.schedule_event(Event(0, cin->get_id(), 1));
+    std::vector<uint32_t> deltas;
+    while (sim.has_pending_events()) {
+        sim.step();
+        deltas.push_back(sim.get_delta());
+    }
+    assert(sum->get_value() == 0 && cout->get_value() == 1);
+    assert(sim.get_current_time() == 0);
+    assert(deltas.front() == 0 && deltas.size() == 4);
+    for (size_t i = 1; i < deltas.size(); i++) {
+        assert(deltas[i] == deltas[i - 1] + 1);
+    }
+
+    SimStats stats = sim.get_stats();
+    assert(stats.steps == 4 && stats.delta_cycles == 3);
+    assert(stats.heap_events == 0);
+    std::cout << "✓ Settled in " << deltas.size() << " delta cycles at t=0 without touching the heap\n";
+}
+
+void test_unit_delay_chain() {
+    std::cout << "\n=== Test: Unit-Delay Chain ===\n";
+
+    Simulator sim;
+    sim.enable_stats();
+    Signal* in = sim.create_signal("in", 0);
+    Signal* prev = in;
+    for (int i = 0; i < 16; i++) {
+        Signal* next = sim.create_signal("n" + std::to_string(i), i % 2 ? 0 : 1);
+        NOTGate* inv = sim.create_component<NOTGate>(1);
+        inv->connect_input(prev);
+        inv->connect_output(next);
+        prev = next;
+    }
+    sim.schedule_event(Event(10, in->get_id(), 1));
+    sim.run_all();
+    assert(sim.get_current_time() == 26 && prev->get_value() == 1);
+    assert(sim.get_stats().heap_events == 0);
+    assert(sim.get_stats().delta_cycles == 0);
+    std::cout << "✓ 16 unit-delay stages ran from the near FIFO\n";
+}
+
+void test_delta_limit() {
+    std::cout << "\n=== Test: Delta Limit ===\n";
+
+    // Zero-delay ring oscillator: never settles
+    Simulator sim;
+    Signal* x = sim.create_signal("x", 0);
+    NOTGate* inv = sim.create_component<NOTGate>(0);
+    inv->connect_input(x);
+    inv->connect_output(x);
+    sim.set_delta_limit(100);
+    sim.schedule_event(Event(500, x->get_id(), 1));
+
+    bool threw = false;
+    try {
+        sim.run_all();
+    } catch (const std::runtime_error& e) {
+        threw = std::string(e.what()).find("Delta cycle limit (100) exceeded at t=500ps") != std::string::npos;
+    }
+    assert(threw);
+    assert(sim.get_current_time() == 500 && sim.get_delta() == 101);
+    std::cout << "✓ Zero-delay loop stopped after " << sim.get_delta_limit() << " delta cycles\n";
+}
+
+int main() {
+    test_delta_queue();
+    test_pooled_storage();
+    test_zero_delay_adder();
+    test_unit_delay_chain();
+    test_delta_limit();
+
+    std::cout << "\n=========================\n";
+    std::cout << "✓ All Delta Cycle Tests Passed!\n";
+    std::cout << "=========================\n";
+
+    return 0;
+}
@@ -0,0 +1,245 @@
+#include "simulator.h"
+#include "equiv.h"
+#include "circuits.h"
+#include "optimize.h"
+#include "signal.h"
+#include "gate.h"
+#include "event.h"
+#include <iostream>
+#include <cassert>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static std::vector<std::string> names(const std::vector<Signal*>& nets) {
+    std::vector<std::string> out;
+    for (Signal* sig : nets) {
+        out.push_back(sig->get_name());
+    }
+    return out;
+}
+
+// Replace the gate driving `net` with an OR of the same inputs
+static void make_or(Simulator& sim, const std::string& net) {
+    Signal* out = sim.get_signal_by_name(net);
+    for (Component* component : sim.get_components()) {
+        if (component->get_output() == out) {
+            std::vector<Signal*> ins(component->get_inputs().begin(), component->get_inputs().end());
+            sim.remove_components({component});
+            sim.create_gate<ORGate>(100, ins.data(), ins.size(), out);
+            return;
+        }
+    }
+    assert(false);
+}
+
+void test_adders() {
+    std::cout << "\n=== Test: Ripple-Carry vs Lookahead ===\n";
+
+    Simulator a;
+    Simulator b;
+    CircuitPorts ports = build_ripple_carry_adder(a, 8);
+    build_carry_lookahead_adder(b, 8);
+    EquivalenceChecker checker(a, b, names(ports.inputs), names(ports.outputs), "rca.", "cla.");
+    EquivResult result = checker.run();
+    assert(result.equivalent && result.exhaustive && result.vectors >= (1u << 17));
+    assert(result.gate_evaluations == (checker.gate_count_a() + checker.gate_count_b()) * result.vectors);
+    std::cout << "✓ 8-bit adders equal on all " << result.vectors << " vectors ("
+              << checker.gate_count_a() << " vs " << checker.gate_count_b() << " gates)\n";
+}
+
+void test_counterexample() {
+    std::cout << "\n=== Test: Minimized Counterexample ===\n";
+
+    Simulator a;
+    Simulator b;
+    CircuitPorts ports = build_ripple_carry_adder(a, 8);
+    build_ripple_carry_adder(b, 8);
+    make_or(b, "rca.fa3.g");   // Generate term a3 & b3 becomes a3 | b3
+
+    EquivalenceChecker checker(a, b, names(ports.inputs), names(ports.outputs));
+    EquivOptions options;
+    options.exhaustive = false;
+    EquivResult result = checker.run(options);
+    assert(!result.equivalent && !result.exhaustive);
+    const Counterexample& cex = result.counterexample;
+    assert(!cex.outputs.empty());
+
+    // Only one of a3/b3 is set, and both matter; nothing else is needed
+    size_t ones = 0;
+    for (size_t i = 0; i < cex.inputs.size(); i++) {
+        bool pin = cex.inputs[i] == "rca.a3" || cex.inputs[i] == "rca.b3";
+        ones += cex.values[i];
+        assert(cex.care[i] == pin);
+    }
+    assert(ones == 1);
+
+    // The event-driven simulators agree with the compiled programs
+    cex.apply(a, 100);
+    cex.apply(b, 100);
+    a.run_all();
+    b.run_all();
+    for (size_t o = 0; o < cex.outputs.size(); o++) {
+        assert(a.get_signal_by_name(cex.outputs[o])->get_value() == cex.values_a[o]);
+        assert(b.get_signal_by_name(cex.outputs[o])->get_value() == cex.values_b[o]);
+    }
+    std::cout << "✓ Vector " << cex.vector << " reduced to one input high; " << cex.outputs.size()
+              << " outputs differ, confirmed by event-driven simulation\n";
+
+    // Same first failure on any thread count
+    options.threads = 4;
+    EquivResult threaded = checker.run(options);
+    assert(threaded.counterexample.vector == cex.vector && threaded.threads == 4);
+    options.exhaustive = true;
+    assert(checker.run(options).counterexample.vector == 8);   // a3 alone: bit 3 of the index
+    std::cout << "✓ Same counterexample with 4 threads; enumeration fails first at vector 8\n";
+}
+
+void test_optimized() {
+    std::cout << "\n=== Test: Netlist Against Its Optimized Copy ===\n";
+
+    Simulator a;
+    Simulator b;
+    CircuitPorts ports = build_random_dag(a, 48, 3000, 2, 9);
+    CircuitPorts copy = build_random_dag(b, 48, 3000, 2, 9);
+    b.tie_constant(copy.inputs[0], 1);
+    a.tie_constant(ports.inputs[0], 1);
+    for (Signal* out : copy.outputs) {
+        b.probe(out);
+    }
+    OptimizeReport report = optimize_netlist(b);
+    assert(report.gates_removed() > 0);
+
+    std::vector<std::string> inputs = names(ports.inputs);
+    inputs.erase(inputs.begin());
+    EquivalenceChecker checker(a, b, inputs, names(ports.outputs));
+    EquivOptions options;
+    options.vectors = 1 << 16;
+    EquivResult result = checker.run(options);
+    assert(result.equivalent && !result.exhaustive && result.vectors == (1u << 16));
+    std::cout << "✓ " << report.gates_removed() << " gates removed, equal on " << result.vectors
+              << " random vectors: " << result.evaluations_per_second() / 1e9 << "G gate evaluations/s\n";
+
+    // Default ports: undriven nets in, unread nets out
+    EquivalenceChecker inferred(a, b);
+    assert(inferred.get_inputs().size() == 47 && inferred.run(options).equivalent);
+    std::cout << "✓ Ports inferred: " << inferred.get_inputs().size() << " inputs, "
+              << inferred.get_outputs().size() << " outputs\n";
+}
+
+void test_one_input_gates() {
+    std::cout << "\n=== Test: One-Input Gates ===\n";
+
+    // The simulator leaves a one-input AND's output alone; a BUF copies
+    Simulator a;
+    Simulator b;
+    Signal* xa = a.create_signal("x", 0);
+    Signal* ya = a.create_signal("y", 0);
+    Signal* xb = b.create_signal("x", 0);
+    Signal* yb = b.create_signal("y", 0);
+    a.create_gate<ANDGate>(100, &xa, 1, ya);
+    b.create_gate<BUFGate>(100, &xb, 1, yb);
+
+    EquivalenceChecker checker(a, b, {"x"}, {"y"});
+    assert(checker.gate_count_a() == 0 && checker.gate_count_b() == 1);
+    EquivResult result = checker.run();
+    assert(!result.equivalent);
+    const Counterexample& cex = result.counterexample;
+    assert(cex.values[0] == 1 && cex.values_a[0] == 0 && cex.values_b[0] == 1);
+    cex.apply(a, 100);
+    cex.apply(b, 100);
+    a.run_all();
+    b.run_all();
+    assert(ya->get_value() == cex.values_a[0] && yb->get_value() == cex.values_b[0]);
+    std::cout << "✓ A one-input AND is compiled as the simulator runs it: never driven\n";
+}
+
+void test_constrained() {
+    std::cout << "\n=== Test: Constrained Vectors ===\n";
+
+    // y = AND of 16 inputs, against y tied low through a buffer
+    Simulator a;
+    Simulator b;
+    std::vector<Signal*> xa, xb;
+    for (int i = 0; i < 16; i++) {
+        xa.push_back(a.create_signal("x" + std::to_string(i), 0));
+        xb.push_back(b.create_signal("x" + std::to_string(i), 0));
+    }
+    a.create_gate<ANDGate>(10, xa.data(), xa.size(), a.create_signal("y", 2));
+    Signal* zero = b.create_signal("zero", 0);
+    b.create_gate<ANDGate>(10, {xb[0], zero}, b.create_signal("y", 2));
+
+    std::vector<std::string> inputs = names(xa);
+    EquivalenceChecker checker(a, b, inputs, {"y"});
+    EquivOptions options;
+    options.exhaustive = false;
+    options.vectors = 4096;
+    assert(checker.run(options).equivalent);   // One in 65536 vectors sets every input
+
+    options.constraints = {{"x1*", 1.0}, {"x*", 0.9}};
+    EquivResult result = checker.run(options);
+    assert(!result.equivalent && result.vectors < 4096);
+    for (size_t i = 0; i < inputs.size(); i++) {
+        assert(result.counterexample.values[i] == 1);
+    }
+    std::cout << "✓ A 1-in-65536 difference missed by 4096 uniform vectors, found at vector "
+              << result.counterexample.vector << " with inputs biased high\n";
+}
+
+void test_sequential() {
+    std::cout << "\n=== Test: Register Cut Points ===\n";
+
+    Simulator a;
+    Simulator b;
+    CircuitPorts ports = build_counter_pipeline(a, 6, 2);
+    build_counter_pipeline(b, 6, 2);
+    EquivalenceChecker checker(a, b, names(ports.inputs), names(ports.outputs));
+    assert(checker.get_inputs().size() > ports.inputs.size());
+    EquivResult result = checker.run();
+    assert(result.equivalent && result.exhaustive);
+    std::cout << "✓ Counter pipeline: " << checker.get_inputs().size() << " inputs with register outputs, "
+              << checker.get_outputs().size() << " compared nets\n";
+
+    // Unsupported netlists
+    Simulator tri;
+    Signal* d = tri.create_signal("d", 0);
+    Signal* en = tri.create_signal("en", 0);
+    tri.create_gate<TriBuf>(10, {d, en}, tri.create_signal("y", 2));
+    bool threw = false;
+    try {
+        EquivalenceChecker bad(tri, tri);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    Simulator loop;
+    Signal* x = loop.create_signal("x", 0);
+    Signal* p = loop.create_signal("p", 2);
+    Signal* q = loop.create_signal("q", 2);
+    loop.create_gate<ANDGate>(10, {x, q}, p);
+    loop.create_gate<BUFGate>(10, {p}, q);
+    threw = false;
+    try {
+        EquivalenceChecker bad(loop, loop, {"x"}, {"q"});
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    std::cout << "✓ Tri-state buffers and combinational loops rejected\n";
+}
+
+int main() {
+    test_adders();
+    test_counterexample();
+    test_optimized();
+    test_one_input_gates();
+    test_constrained();
+    test_sequential();
+
+    std::cout << "\n=========================\n";
+    std::cout << "✓ All Equivalence Tests Passed!\n";
+    std::cout << "=========================\n";
+
+    return 0;
+}
@@ -63,18 +63,28 @@ void test_heap_property() {
         eq.schedule(Event(time_dist(gen), i, 0));
     }
     
-    // Pop all and verify they come out in sorted order
+    // Pop all and verify they come out in sorted order, and in insertion
+    // order within a time
     uint64_t prev_time = 0;
+    int prev_id = -1;
     int count = 0;
     while (!eq.empty()) {
         Event e = eq.pop_next();
         assert(e.time >= prev_time);  // Must be non-decreasing
+        assert(e.time > prev_time || e.signal_id > prev_id);
         prev_time = e.time;
+        prev_id = e.signal_id;
         count++;
     }
 
     assert(count == 1000000);
-    std::cout << "✓ All 1000000 events popped in correct time order\n";
+    std::cout << "✓ All 1000000 events popped in correct time order, ties in insertion order\n";
+
+    // end_batch() without a batch is a no-op
+    eq.end_batch();
+    eq.schedule(Event(200000, 1, 1));
+    assert(eq.size() == 1 && eq.pop_next().time == 200000);
+    std::cout << "✓ Unmatched end_batch() ignored\n";
 }
 
 int main() {
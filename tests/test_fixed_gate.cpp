@@ -0,0 +1,183 @@
+#include "simulator.h"
+#include "fixed_gate.h"
+#include "circuits.h"
+#include "optimize.h"
+#include "signal.h"
+#include "gate.h"
+#include "logic.h"
+#include "event.h"
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Output of a gate after its inputs are set to `values`
+template <typename GateType>
+static uint8_t settle(bool fixed, const std::vector<uint8_t>& values) {
+    Simulator sim;
+    std::vector<Signal*> ins;
+    for (size_t i = 0; i < values.size(); i++) {
+        ins.push_back(sim.create_signal("i" + std::to_string(i), LOGIC_0));
+    }
+    Signal* out = sim.create_signal("y", LOGIC_Z);
+    GateType* gate;
+    if (fixed) {
+        gate = sim.create_gate<GateType>(10, ins.data(), ins.size(), out);
+    } else {
+        gate = sim.create_component<GateType>(10);
+        for (Signal* in : ins) {
+            gate->connect_input(in);
+        }
+        gate->connect_output(out);
+    }
+    assert(gate->get_inputs().size() == values.size());
+    for (size_t i = 0; i < values.size(); i++) {
+        sim.schedule_event(Event(100, ins[i]->get_id(), values[i]));
+    }
+    sim.run_all();
+    return out->get_value();
+}
+
+// Every four-state input combination, against the plain gate
+template <typename GateType>
+static void check_tables(size_t fanin) {
+    size_t combinations = size_t(1) << (2 * fanin);
+    for (size_t index = 0; index < combinations; index++) {
+        std::vector<uint8_t> values;
+        for (size_t pin = 0; pin < fanin; pin++) {
+            values.push_back((index >> (2 * pin)) & 3);
+        }
+        assert(settle<GateType>(true, values) == settle<GateType>(false, values));
+    }
+}
+
+void test_tables() {
+    std::cout << "\n=== Test: Compile-Time Truth Tables ===\n";
+
+    for (size_t fanin = 2; fanin <= MAX_FIXED_FANIN; fanin++) {
+        check_tables<ANDGate>(fanin);
+        check_tables<ORGate>(fanin);
+        check_tables<XORGate>(fanin);
+    }
+    check_tables<NOTGate>(1);
+    check_tables<BUFGate>(1);
+    std::cout << "✓ AND/OR/XOR fan-in 2-" << MAX_FIXED_FANIN
+              << " and NOT/BUF match the plain gates on every 0/1/X/Z input\n";
+
+    static_assert(FixedTable<ANDGate, 2>().values[1 * 4 + 1] == LOGIC_1, "constexpr table");
+    static_assert(FixedTable<ORGate, 3>().values[2 * 16 + 0 + 1] == LOGIC_1, "X | 0 | 1");
+    static_assert(FixedTable<XORGate, 2>().values[1 * 4 + 3] == LOGIC_X, "1 ^ Z");
+    std::cout << "✓ Tables are usable in constant expressions\n";
+}
+
+void test_factory() {
+    std::cout << "\n=== Test: Factory ===\n";
+
+    Simulator sim;
+    Signal* a = sim.create_signal("a", 0);
+    Signal* b = sim.create_signal("b", 0);
+    Signal* c = sim.create_signal("c", 0);
+    Signal* y = sim.create_signal("y", 0);
+    Signal* z = sim.create_signal("z", 1);
+    Signal* w = sim.create_signal("w", 0);
+
+    ANDGate* g = sim.create_component<ANDGate>(10, y, a, b);
+    assert((dynamic_cast<FixedGate<ANDGate, 2>*>(g) != nullptr));
+    assert(g->get_output() == y && g->get_inputs().size() == 2 && g->get_inputs()[1] == b);
+    NOTGate* inv = sim.create_component<NOTGate>(5, z, a);
+    assert((dynamic_cast<FixedGate<NOTGate, 1>*>(inv) != nullptr));
+    ORGate* wide = sim.create_gate<ORGate>(10, {a, b, c, a, b}, w);   // No fixed form
+    assert(typeid(*wide) == typeid(ORGate) && wide->get_inputs().size() == 5);
+    ANDGate* plain = sim.create_component<ANDGate>(10);
+    assert(typeid(*plain) == typeid(ANDGate));
+    std::cout << "✓ create_component<ANDGate>(delay, out, a, b) builds a FixedGate<ANDGate, 2>\n";
+
+    sim.schedule_event(Event(100, a->get_id(), 1));
+    sim.schedule_event(Event(100, b->get_id(), 1));
+    sim.run_all();
+    assert(y->get_value() == 1 && z->get_value() == 0 && w->get_value() == 1);
+    assert(sim.get_current_time() == 110);
+    std::cout << "✓ Fixed and plain gates simulate together\n";
+
+    bool threw = false;
+    try {
+        Gate* base = g;
+        base->connect_input(c);   // Through the base class too
+    } catch (const std::logic_error&) {
+        threw = true;
+    }
+    assert(threw && g->get_inputs().size() == 2);
+    std::cout << "✓ A fixed gate takes no extra input pins\n";
+}
+
+// Final output values after each random vector, with and without batching
+static std::vector<uint8_t> run_dag(bool batched, size_t& fixed_gates) {
+    Simulator sim;
+    CircuitPorts ports = build_random_dag(sim, 32, 2000, 3, 7);
+    fixed_gates = 0;
+    for (Component* component : sim.get_components()) {
+        fixed_gates += dynamic_cast<FixedGate<ANDGate, 2>*>(component) != nullptr ||
+                       dynamic_cast<FixedGate<ORGate, 2>*>(component) != nullptr ||
+                       dynamic_cast<FixedGate<XORGate, 2>*>(component) != nullptr ||
+                       dynamic_cast<FixedGate<NOTGate, 1>*>(component) != nullptr;
+    }
+    if (batched) {
+        sim.enable_batch_eval(1);
+    }
+    std::mt19937 gen(9);
+    std::vector<uint8_t> values;
+    uint64_t time = 0;
+    for (int v = 0; v < 10; v++) {
+        for (Signal* in : ports.inputs) {
+            sim.schedule_event(Event(time, in->get_id(), gen() % 3));
+        }
+        sim.run_all();
+        for (Signal* out : ports.outputs) {
+            values.push_back(out->get_value());
+        }
+        time = sim.get_current_time() + 1000;
+    }
+    if (batched) {
+        assert(sim.get_batcher().batched_gates() == fixed_gates);
+    }
+    return values;
+}
+
+void test_netlists() {
+    std::cout << "\n=== Test: Generated Netlists ===\n";
+
+    size_t fixed_gates;
+    std::vector<uint8_t> plain = run_dag(false, fixed_gates);
+    assert(fixed_gates == 2000);
+    assert(run_dag(true, fixed_gates) == plain);
+    std::cout << "✓ Random DAG gates are fixed-fan-in and all batchable\n";
+
+    Simulator sim;
+    Signal* a = sim.create_signal("a", 0);
+    Signal* one = sim.create_signal("one", 1);
+    Signal* y = sim.create_signal("y", 2);
+    sim.tie_constant(one, 1);
+    sim.create_gate<ANDGate>(10, {a, one, one}, y);   // a & 1 & 1 -> BUF(a)
+    sim.probe(y);
+    OptimizeReport report = optimize_netlist(sim);
+    assert(report.gates_simplified == 1 && report.gates_after == 1);
+    assert((dynamic_cast<FixedGate<BUFGate, 1>*>(sim.get_components().back()) != nullptr));
+    sim.schedule_event(Event(100, a->get_id(), 1));
+    sim.run_all();
+    assert(y->get_value() == 1 && sim.get_current_time() == 110);
+    std::cout << "✓ The optimizer rewrites fixed gates like plain ones\n";
+}
+
+int main() {
+    test_tables();
+    test_factory();
+    test_netlists();
+
+    std::cout << "\n=========================\n";
+    std::cout << "✓ All Fixed Gate Tests Passed!\n";
+    std::cout << "=========================\n";
+
+    return 0;
+}
@@ -0,0 +1,193 @@
+#include "simulator.h"
+#include "signal.h"
+#include "gate.h"
+#include "sequential.h"
+#include "event.h"
+#include "logic.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cassert>
+#include <cstdio>
+
+// Built twice: as test_logic (4-state) and test_logic_two_state
+// (LOGIC_SIM_TWO_STATE), where X and Z collapse to 0
+
+static uint8_t drive(Simulator& sim, Signal* a, Signal* b, uint8_t va, uint8_t vb, Signal* y) {
+    uint64_t t = sim.get_current_time() + 1000;
+    sim.schedule_event(Event(t, a->get_id(), va));
+    sim.schedule_event(Event(t, b->get_id(), vb));
+    sim.run_all();
+    return y->get_value();
+}
+
+void test_truth_tables() {
+    std::cout << "\n=== Test: Four-State Truth Tables ===\n";
+
+    const uint8_t X = LOGIC_X, Z = LOGIC_Z;
+    if constexpr (!TWO_STATE) {
+        assert(logic::or2(1, X) == 1);       // Former ORGate TODO
+        assert(logic::or2(0, X) == X);
+        assert(logic::and2(0, Z) == 0);
+        assert(logic::and2(1, Z) == X);
+        assert(logic::xor2(1, Z) == X);
+        assert(logic::not1(X) == X);
+        assert(logic::not1(Z) == X);
+        assert(logic::buf1(Z) == X);
+        assert(logic::resolve(Z, 1) == 1);
+        assert(logic::resolve(0, 1) == X);
+        assert(logic::resolve(Z, Z) == Z);
+        assert(logic::tri(0, 1) == Z);
+        assert(logic::tri(X, 0) == X);
+    } else {
+        assert(logic::canonical(X) == 0 && logic::canonical(Z) == 0);
+        assert(logic::resolve(0, 1) == 1);   // Wired-OR
+    }
+    for (uint8_t a = 0; a < 2; a++) {
+        for (uint8_t b = 0; b < 2; b++) {
+            assert(logic::and2(a, b) == (a & b));
+            assert(logic::or2(a, b) == (a | b));
+            assert(logic::xor2(a, b) == (a ^ b));
+        }
+        assert(logic::not1(a) == !a);
+    }
+    std::cout << "✓ Tables match 2-state logic and IEEE 1164 X/Z rules\n";
+
+    assert(logic::from_char('H') == 1 && logic::from_char('L') == 0);
+    assert(logic::from_char('U') == X && logic::from_char('-') == X);
+    assert(logic::from_char('z') == Z);
+    assert(logic::from_char('q') == 0xFF);
+    assert(logic::to_char(Z) == 'Z');
+    std::cout << "✓ std_ulogic characters map onto four states\n";
+}
+
+void test_gate_kernels() {
+    std::cout << "\n=== Test: Gate Kernels ===\n";
+
+    Simulator sim;
+    Signal* a = sim.create_signal("A", 0);
+    Signal* b = sim.create_signal("B", 0);
+    Signal* y_or = sim.create_signal("Y_or", 0);
+    Signal* y_not = sim.create_signal("Y_not", 1);
+    ORGate* or_gate = sim.create_component<ORGate>(100);
+    or_gate->connect_input(a);
+    or_gate->connect_input(b);
+    or_gate->connect_output(y_or);
+    NOTGate* not_gate = sim.create_component<NOTGate>(50);
+    not_gate->connect_input(b);
+    not_gate->connect_output(y_not);
+
+    assert(drive(sim, a, b, 1, LOGIC_X, y_or) == 1);
+    if constexpr (!TWO_STATE) {
+        assert(y_not->get_value() == LOGIC_X);   // NOT X is X, not 1
+        assert(drive(sim, a, b, 0, LOGIC_Z, y_or) == LOGIC_X);
+        assert(b->get_value() == LOGIC_Z);
+        assert(b->value_to_string() == "Z");
+    } else {
+        assert(y_not->get_value() == 1);         // X stored as 0
+        assert(b->get_value() == 0);
+    }
+    std::cout << "✓ 1 OR X = 1, NOT X = X, Z inputs read as X\n";
+
+    // A floating D is captured as X
+    Signal* clk = sim.create_signal("CLK", 0);
+    Signal* q = sim.create_signal("Q", 0);
+    DFF* dff = sim.create_component<DFF>(10);
+    dff->connect_clock(clk);
+    dff->connect_data(b);
+    dff->connect_q(q);
+    sim.schedule_event(Event(sim.get_current_time() + 100, clk->get_id(), 1));
+    sim.run_all();
+    assert(q->get_value() == (TWO_STATE ? 0 : LOGIC_X));
+    std::cout << "✓ DFF captures X from a Z data input\n";
+}
+
+void test_tristate_bus() {
+    std::cout << "\n=== Test: Tri-State Bus ===\n";
+
+    Simulator sim;
+    Signal* d0 = sim.create_signal("d0", 0);
+    Signal* d1 = sim.create_signal("d1", 1);
+    Signal* en0 = sim.create_signal("en0", 0);
+    Signal* en1 = sim.create_signal("en1", 0);
+    Signal* drv0 = sim.create_signal("drv0", LOGIC_Z);
+    Signal* drv1 = sim.create_signal("drv1", LOGIC_Z);
+    Signal* bus = sim.create_signal("bus", LOGIC_Z);
+
+    TriBuf* t0 = sim.create_component<TriBuf>(20);
+    t0->connect_input(d0);
+    t0->connect_input(en0);
+    t0->connect_output(drv0);
+    TriBuf* t1 = sim.create_component<TriBuf>(20);
+    t1->connect_input(d1);
+    t1->connect_input(en1);
+    t1->connect_output(drv1);
+    Resolver* res = sim.create_component<Resolver>();
+    res->connect_input(drv0);
+    res->connect_input(drv1);
+    res->connect_output(bus);
+
+    const uint8_t idle = logic::canonical(LOGIC_Z);
+    assert(bus->get_value() == idle);
+
+    sim.schedule_event(Event(100, en0->get_id(), 1));   // Driver 0 puts 0 on the bus
+    sim.run_until(200);
+    assert(bus->get_value() == 0);
+
+    sim.schedule_event(Event(300, en0->get_id(), 0));   // Hand over to driver 1
+    sim.schedule_event(Event(300, en1->get_id(), 1));
+    sim.run_until(400);
+    assert(bus->get_value() == 1);
+
+    sim.schedule_event(Event(500, en0->get_id(), 1));   // Both drive, different values
+    sim.run_until(600);
+    assert(bus->get_value() == (TWO_STATE ? 1 : LOGIC_X));
+
+    sim.schedule_event(Event(700, en0->get_id(), 0));
+    sim.schedule_event(Event(700, en1->get_id(), 0));
+    sim.run_until(800);
+    assert(bus->get_value() == idle);
+    std::cout << "✓ Bus resolves single drivers, contention and release\n";
+}
+
+void test_recorded_values() {
+    std::cout << "\n=== Test: Recorded Values ===\n";
+
+    // Trace, activity and coverage see a net's stored value, not the
+    // scheduled one: in two-state mode an X on a net at 0 is no change
+    Simulator sim;
+    Signal* a = sim.create_signal("a", 0);
+    sim.enable_trace();
+    sim.enable_activity();
+    sim.schedule_event(Event(100, a->get_id(), LOGIC_X));
+    sim.schedule_event(Event(200, a->get_id(), 1));
+    sim.run_until(300);
+
+    ActivityProfile::NetActivity act = sim.get_activity(a);
+    assert(act.rise == (TWO_STATE ? 1 : 0) && act.x_transitions == (TWO_STATE ? 0 : 2));
+    assert(act.time_in[LOGIC_0] == (TWO_STATE ? 200 : 100) && act.time_in[LOGIC_X] == (TWO_STATE ? 0 : 100));
+
+    sim.dump_waveform("test_logic_values.vcd");
+    std::ifstream in("test_logic_values.vcd");
+    std::stringstream vcd;
+    vcd << in.rdbuf();
+    std::string changes = vcd.str().substr(vcd.str().rfind("$end"));
+    assert((changes.find("#100") != std::string::npos) == !TWO_STATE);
+    assert((changes.find('X') != std::string::npos) == !TWO_STATE);
+    assert(changes.find("#200\n1") != std::string::npos);
+    std::remove("test_logic_values.vcd");
+    std::cout << "✓ " << (TWO_STATE ? "X on a net at 0 is not recorded" : "X is recorded") << "\n";
+}
+
+int main() {
+    test_truth_tables();
+    test_gate_kernels();
+    test_tristate_bus();
+    test_recorded_values();
+
+    std::cout << "\n=========================\n";
+    std::cout << "✓ All Logic Tests Passed" << (TWO_STATE ? " (two-state)" : "") << "!\n";
+    std::cout << "=========================\n";
+
+    return 0;
+}
@@ -0,0 +1,249 @@
+#include "simulator.h"
+#include "signal.h"
+#include "event.h"
+#include "memories.h"
+#include <iostream>
+#include <fstream>
+#include <cassert>
+#include <cstdio>
+
+static std::vector<Signal*> make_bus(Simulator& sim, const std::string& name, int width) {
+    std::vector<Signal*> bus;
+    for (int i = 0; i < width; i++) {
+        bus.push_back(sim.create_signal(name + std::to_string(i), 0));
+    }
+    return bus;
+}
+
+static void drive_bus(Simulator& sim, const std::vector<Signal*>& bus, uint64_t value, uint64_t time) {
+    for (size_t i = 0; i < bus.size(); i++) {
+        sim.schedule_event(Event(time, bus[i]->get_id(), (value >> i) & 1));
+    }
+}
+
+static uint64_t read_bus(const std::vector<Signal*>& bus) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bus.size(); i++) {
+        assert(bus[i]->get_value() <= 1);
+        value |= uint64_t(bus[i]->get_value()) << i;
+    }
+    return value;
+}
+
+static void clock_pulse(Simulator& sim, Signal* clk, uint64_t time) {
+    sim.schedule_event(Event(time, clk->get_id(), 1));
+    sim.schedule_event(Event(time + 500, clk->get_id(), 0));
+}
+
+void test_sparse_store() {
+    std::cout << "\n=== Test: Sparse Store ===\n";
+
+    // 4 Gi words of 32 bits: nothing allocated until written
+    SparseMemory mem(32, uint64_t(1) << 32);
+    assert(mem.pages_allocated() == 0);
+    assert(mem.read(123).xmask == 0xFFFFFFFF);   // Untouched words are X
+
+    mem.write(0, 0xDEADBEEF);
+    mem.write(0xFFFFFFFF, 0x12345678);
+    mem.write(0xFFFFFFFE, 0x1FFFFFFFFull);       // Truncated to 32 bits
+    assert(mem.pages_allocated() == 2);
+    assert(mem.bytes_allocated() == 2 * SparseMemory::PAGE_WORDS * sizeof(uint64_t) * 2);
+    assert(mem.read(0).value == 0xDEADBEEF && mem.read(0).xmask == 0);
+    assert(mem.read(0xFFFFFFFF).value == 0x12345678);
+    assert(mem.read(0xFFFFFFFE).value == 0xFFFFFFFF);
+    std::cout << "✓ A 4 GiW address space only allocates the touched pages\n";
+
+    SparseMemory zeroed(8, 1 << 20);
+    zeroed.set_fill(0);
+    zeroed.write(5, 0x5A);
+    assert(zeroed.read(6).value == 0 && zeroed.read(6).xmask == 0);
+    assert(zeroed.bytes_allocated() == SparseMemory::PAGE_WORDS * sizeof(uint64_t));
+    zeroed.write(7, MemWord{0, 0x0F});
+    assert(zeroed.read(7).xmask == 0x0F);
+    assert(zeroed.read(5).value == 0x5A && zeroed.read(5).xmask == 0);
+    std::cout << "✓ Fill value and per-bit X words\n";
+
+    bool threw = false;
+    try {
+        zeroed.read(1 << 20);
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    assert(threw);
+    std::cout << "✓ Out-of-range access throws\n";
+}
+
+void test_images() {
+    std::cout << "\n=== Test: Memory Images ===\n";
+
+    const std::string hex_file = "test_memory.hex";
+    {
+        std::ofstream out(hex_file);
+        out << "// boot table\n"
+            << "0A 0B\n"
+            << "@10 ff_ff 1x // address 0x10\n";
+    }
+    SparseMemory hex(16, 256);
+    hex.set_fill(0);
+    hex.load_image(hex_file, SparseMemory::HEX);
+    std::remove(hex_file.c_str());
+    assert(hex.read(0).value == 0x0A);
+    assert(hex.read(1).value == 0x0B);
+    assert(hex.read(2).value == 0);
+    assert(hex.read(0x10).value == 0xFFFF);
+    assert(hex.read(0x11).value == 0x10 && hex.read(0x11).xmask == 0x0F);
+    std::cout << "✓ Hex image with comments, @address and X digits\n";
+
+    const std::string bin_file = "test_memory.bin";
+    {
+        std::ofstream out(bin_file, std::ios::binary);
+        for (uint32_t i = 0; i < 4096; i++) {
+            uint32_t word = i * 3 + 1;
+            out.write(reinterpret_cast<const char*>(&word), 3);   // 24-bit words
+        }
+    }
+    SparseMemory bin(24, 1 << 16);
+    bin.load_image(bin_file, SparseMemory::BINARY, 100);
+    std::remove(bin_file.c_str());   // The mapping keeps the data alive
+    assert(bin.pages_allocated() == 0);
+    assert(bin.read(100).value == 1);
+    assert(bin.read(100 + 4095).value == 4095 * 3 + 1);
+    assert(bin.read(99).xmask == 0xFFFFFF);
+    assert(bin.read(100 + 4096).xmask == 0xFFFFFF);
+    std::cout << "✓ Binary image is read in place without allocating pages\n";
+
+    bin.write(200, 7);   // Copy-on-write of one page
+    assert(bin.pages_allocated() == 1);
+    assert(bin.read(200).value == 7);
+    assert(bin.read(201).value == 101 * 3 + 1);
+    assert(bin.read(99).xmask == 0xFFFFFF);
+    std::cout << "✓ Writing into an image copies just that page\n";
+
+    {
+        std::ofstream out(bin_file, std::ios::binary);
+        out.write("\x01\x02\x03\x04", 4);   // One 24-bit word and a stray byte
+    }
+    bool threw = false;
+    try {
+        bin.load_image(bin_file, SparseMemory::BINARY);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    std::remove(bin_file.c_str());
+    assert(threw && bin.read(100).value == 1);
+    std::cout << "✓ Binary image with a partial word rejected\n";
+}
+
+void test_ram_ports() {
+    std::cout << "\n=== Test: SyncRAM Ports ===\n";
+
+    Simulator sim;
+    Signal* clk = sim.create_signal("clk", 0);
+    Signal* we = sim.create_signal("we", 0);
+    std::vector<Signal*> wa = make_bus(sim, "wa", 16);
+    std::vector<Signal*> wd = make_bus(sim, "wd", 8);
+    std::vector<Signal*> ra0 = make_bus(sim, "ra0_", 16);
+    std::vector<Signal*> rd0 = make_bus(sim, "rd0_", 8);
+    std::vector<Signal*> ra1 = make_bus(sim, "ra1_", 16);
+    std::vector<Signal*> rd1 = make_bus(sim, "rd1_", 8);
+
+    SyncRAM* ram = sim.create_component<SyncRAM>(8, 1 << 16, 100);
+    ram->connect_clock(clk);
+    ram->add_write_port(wa, wd, we);
+    ram->add_read_port(ra0, rd0);
+    ram->add_read_port(ra1, rd1);
+    assert(ram->is_sequential());
+
+    // Write 0x42 to 0x1234 while port 0 reads the same address (read-first)
+    uint64_t t = 1000;
+    sim.schedule_event(Event(t - 100, we->get_id(), 1));
+    drive_bus(sim, wa, 0x1234, t - 100);
+    drive_bus(sim, wd, 0x42, t - 100);
+    drive_bus(sim, ra0, 0x1234, t - 100);
+    clock_pulse(sim, clk, t);
+    sim.run_until(t + 99);
+    assert(rd0[0]->get_value() == 0);            // Before the read delay
+    sim.run_until(t + 100);
+    assert(rd0[0]->get_value() == 2);            // Old (X) contents
+    std::cout << "✓ Reads see the contents from before the edge\n";
+
+    // Next cycle: stop writing, both ports read
+    t += 1000;
+    sim.schedule_event(Event(t - 100, we->get_id(), 0));
+    drive_bus(sim, ra1, 0x1234, t - 100);
+    drive_bus(sim, ra0, 0x1235, t - 100);
+    clock_pulse(sim, clk, t);
+    sim.run_until(t + 200);
+    assert(read_bus(rd1) == 0x42);
+    assert(rd0[0]->get_value() == 2);
+    assert(ram->get_memory().read(0x1234).value == 0x42);
+    std::cout << "✓ Two read ports sample independently\n";
+
+    // X on the address reads all-X; X on write data stores X bits
+    t += 1000;
+    sim.schedule_event(Event(t - 100, ra1[3]->get_id(), 2));
+    sim.schedule_event(Event(t - 100, we->get_id(), 1));
+    drive_bus(sim, wa, 0x10, t - 100);
+    sim.schedule_event(Event(t - 100, wd[7]->get_id(), 2));
+    clock_pulse(sim, clk, t);
+    sim.run_until(t + 200);
+    for (Signal* bit : rd1) {
+        assert(bit->get_value() == 2);
+    }
+    MemWord stored = ram->get_memory().read(0x10);
+    assert(stored.xmask == 0x80 && stored.value == 0x42);
+    std::cout << "✓ X address reads X, X data bits are stored as X\n";
+
+    assert(ram->get_memory().pages_allocated() == 2);
+}
+
+void test_rom() {
+    std::cout << "\n=== Test: SyncROM ===\n";
+
+    const std::string hex_file = "test_rom.hex";
+    {
+        std::ofstream out(hex_file);
+        for (int i = 0; i < 16; i++) {
+            out << std::hex << (i * i) << "\n";
+        }
+    }
+
+    Simulator sim;
+    Signal* clk = sim.create_signal("clk", 0);
+    Signal* en = sim.create_signal("en", 1);
+    std::vector<Signal*> addr = make_bus(sim, "a", 4);
+    std::vector<Signal*> data = make_bus(sim, "d", 8);
+    SyncROM* rom = sim.create_component<SyncROM>(8, 16, hex_file, SparseMemory::HEX, 50);
+    std::remove(hex_file.c_str());
+    rom->connect_clock(clk);
+    rom->add_read_port(addr, data, en);
+
+    uint64_t t = 1000;
+    for (int i = 0; i < 16; i++, t += 1000) {
+        drive_bus(sim, addr, i, t - 100);
+        clock_pulse(sim, clk, t);
+        sim.run_until(t + 50);
+        assert(read_bus(data) == (uint64_t)(i * i));
+    }
+    std::cout << "✓ ROM returns its image contents\n";
+
+    sim.schedule_event(Event(t - 100, en->get_id(), 0));
+    drive_bus(sim, addr, 2, t - 100);
+    clock_pulse(sim, clk, t);
+    sim.run_until(t + 50);
+    assert(read_bus(data) == 225);   // Disabled port holds its output
+    std::cout << "✓ Disabled read port holds its output\n";
+}
+
+int main() {
+    test_sparse_store();
+    test_images();
+    test_ram_ports();
+    test_rom();
+
+    std::cout << "\n=========================\n";
+    std::cout << "✓ All Memory Tests Passed!\n";
+    std::cout << "=========================\n";
+
+    return 0;
+}
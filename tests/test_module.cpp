@@ -0,0 +1,279 @@
+#include "simulator.h"
+#include "signal.h"
+#include "event.h"
+#include "module.h"
+#include "logic.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cassert>
+#include <cstdio>
+
+// s = a ^ b ^ cin, cout = (a & b) | (cin & (a ^ b)); 100ps per gate
+static std::shared_ptr<ModuleDef> make_full_adder() {
+    auto fa = std::make_shared<ModuleDef>("full_adder");
+    uint32_t a = fa->add_input("a");
+    uint32_t b = fa->add_input("b");
+    uint32_t cin = fa->add_input("cin");
+    uint32_t s = fa->add_output("s");
+    uint32_t cout = fa->add_output("cout");
+    uint32_t ab = fa->add_net("ab");
+    uint32_t g = fa->add_net("g");
+    uint32_t p = fa->add_net("p");
+    fa->add_gate(ModuleDef::XOR, {a, b}, ab, 100);
+    fa->add_gate(ModuleDef::XOR, {ab, cin}, s, 100);
+    fa->add_gate(ModuleDef::AND, {a, b}, g, 100);
+    fa->add_gate(ModuleDef::AND, {cin, ab}, p, 100);
+    fa->add_gate(ModuleDef::OR, {g, p}, cout, 100);
+    return fa;
+}
+
+// 2-bit adder built from two inlined full adders
+static std::shared_ptr<ModuleDef> make_adder2() {
+    auto fa = make_full_adder();
+    auto add = std::make_shared<ModuleDef>("adder2");
+    uint32_t a0 = add->add_input("a0");
+    uint32_t a1 = add->add_input("a1");
+    uint32_t b0 = add->add_input("b0");
+    uint32_t b1 = add->add_input("b1");
+    uint32_t cin = add->add_input("cin");
+    uint32_t s0 = add->add_output("s0");
+    uint32_t s1 = add->add_output("s1");
+    uint32_t cout = add->add_output("cout");
+    uint32_t c1 = add->add_net("c1");
+    add->add_instance(*fa, "fa0", {a0, b0, cin, s0, c1});
+    add->add_instance(*fa, "fa1", {a1, b1, c1, s1, cout});
+    return add;
+}
+
+void test_hierarchical_adder() {
+    std::cout << "\n=== Test: Hierarchical Adder ===\n";
+
+    auto def = make_adder2();
+    Simulator sim;
+    ModuleInstance* u0 = instantiate(sim, def, "u0");
+
+    assert(def->gate_count() == 10);
+    assert(def->get_output_delay(0) == 200);   // s0: ab -> s
+    assert(def->get_output_delay(1) == 400);   // s1 waits for c1
+    assert(def->get_output_delay(2) == 500);   // cout: ab0 -> p0 -> c1 -> p1 -> cout
+    std::cout << "✓ Port delays follow the longest path through the inlined logic\n";
+
+    const char* in_names[] = {"u0.a0", "u0.a1", "u0.b0", "u0.b1", "u0.cin"};
+    uint64_t time = 0;
+    for (int a = 0; a < 4; a++) {
+        for (int b = 0; b < 4; b++) {
+            int bits[] = {a & 1, a >> 1, b & 1, b >> 1, 0};
+            for (int i = 0; i < 5; i++) {
+                sim.schedule_event(Event(time, sim.get_signal_by_name(in_names[i])->get_id(), bits[i]));
+            }
+            sim.run_until(time + 1000);
+            int sum = sim.get_signal_by_name("u0.s0")->get_value() |
+                      (sim.get_signal_by_name("u0.s1")->get_value() << 1) |
+                      (sim.get_signal_by_name("u0.cout")->get_value() << 2);
+            assert(sum == a + b);
+            time += 1000;
+        }
+    }
+    std::cout << "✓ All 16 input combinations add correctly\n";
+
+    // 1 + 1: carry ripples out of fa0, so s1 only changes after 400ps
+    sim.schedule_event(Event(time, sim.get_signal_by_name("u0.a0")->get_id(), 0));
+    sim.schedule_event(Event(time, sim.get_signal_by_name("u0.a1")->get_id(), 0));
+    sim.schedule_event(Event(time, sim.get_signal_by_name("u0.b0")->get_id(), 0));
+    sim.schedule_event(Event(time, sim.get_signal_by_name("u0.b1")->get_id(), 0));
+    sim.run_until(time + 1000);
+    time += 1000;
+    sim.schedule_event(Event(time, sim.get_signal_by_name("u0.a0")->get_id(), 1));
+    sim.schedule_event(Event(time, sim.get_signal_by_name("u0.b0")->get_id(), 1));
+    sim.run_until(time + 399);
+    assert(sim.get_signal_by_name("u0.s1")->get_value() == 0);
+    sim.run_until(time + 400);
+    assert(sim.get_signal_by_name("u0.s1")->get_value() == 1);
+    assert(sim.get_signal_by_name("u0.s0")->get_value() == 0);
+    std::cout << "✓ Outputs change after their port delay\n";
+
+    // Internal nets are reachable by hierarchical name
+    assert(resolve_value(sim, "u0.fa0.ab") == 0);
+    assert(resolve_value(sim, "u0.c1") == 1);
+    assert(resolve_value(sim, "u0.s1") == 1);
+    assert(u0->get_net_value(def->find_net("fa0.g")) == 1);
+    bool threw = false;
+    try {
+        resolve_value(sim, "u0.fa0.nope");
+    } catch (const std::exception&) {
+        threw = true;
+    }
+    assert(threw);
+    std::cout << "✓ resolve_value finds internal nets of inlined sub-modules\n";
+}
+
+void test_shared_definition() {
+    std::cout << "\n=== Test: Shared Definition ===\n";
+
+    auto def = make_full_adder();
+    Simulator sim;
+    const int count = 200;
+    std::vector<ModuleInstance*> insts;
+    for (int i = 0; i < count; i++) {
+        insts.push_back(instantiate(sim, def, "fa" + std::to_string(i)));
+    }
+    assert(def.use_count() == count + 1);
+    assert(sim.get_component_count() == (size_t)count);
+
+    for (int i = 0; i < count; i++) {
+        std::string name = "fa" + std::to_string(i);
+        sim.schedule_event(Event(0, sim.get_signal_by_name(name + ".a")->get_id(), i & 1));
+        sim.schedule_event(Event(0, sim.get_signal_by_name(name + ".b")->get_id(), (i >> 1) & 1));
+        sim.schedule_event(Event(0, sim.get_signal_by_name(name + ".cin")->get_id(), (i >> 2) & 1));
+    }
+    sim.run_all();
+    for (int i = 0; i < count; i++) {
+        int total = (i & 1) + ((i >> 1) & 1) + ((i >> 2) & 1);
+        assert(insts[i]->get_output_port(0)->get_value() == (total & 1));
+        assert(insts[i]->get_output_port(1)->get_value() == (total >> 1));
+    }
+    std::cout << "✓ " << count << " instances share one definition and hold independent state\n";
+}
+
+void test_flops_in_module() {
+    std::cout << "\n=== Test: Flops Inside a Module ===\n";
+
+    // Two-stage shift register: q0 <= d, q1 <= q0
+    auto def = std::make_shared<ModuleDef>("shift2");
+    uint32_t clk = def->add_input("clk");
+    uint32_t d = def->add_input("d");
+    uint32_t q0 = def->add_net("q0", 0);
+    uint32_t q1 = def->add_output("q1", 0);
+    def->add_dff(d, clk, q0, 50);
+    def->add_dff(q0, clk, q1, 50);
+
+    Simulator sim;
+    ModuleInstance* inst = instantiate(sim, def, "sr");
+    assert(inst->is_sequential());
+    assert(def->get_output_delay(0) == 50);
+    Signal* c = sim.get_signal_by_name("sr.clk");
+    Signal* din = sim.get_signal_by_name("sr.d");
+    Signal* q = sim.get_signal_by_name("sr.q1");
+
+    sim.schedule_event(Event(0, c->get_id(), 0));
+    sim.schedule_event(Event(0, din->get_id(), 1));
+    sim.schedule_event(Event(100, c->get_id(), 1));   // q0 = 1
+    sim.schedule_event(Event(200, c->get_id(), 0));
+    sim.schedule_event(Event(250, din->get_id(), 0));
+    sim.schedule_event(Event(300, c->get_id(), 1));   // q1 = 1, q0 = 0
+    sim.schedule_event(Event(400, c->get_id(), 0));
+    sim.schedule_event(Event(500, c->get_id(), 1));   // q1 = 0
+
+    sim.run_until(299);
+    assert(resolve_value(sim, "sr.q0") == 1);    // Internal state updates at the edge
+    sim.run_until(349);
+    assert(q->get_value() == 0);                 // The port follows after the flop delay
+    assert(resolve_value(sim, "sr.q0") == 0);
+    sim.run_until(350);
+    assert(q->get_value() == 1);
+    sim.run_until(600);
+    assert(q->get_value() == 0);
+    std::cout << "✓ Flops sample together on the rising edge\n";
+
+    // A floating D captures X, as in a DFlipFlop
+    sim.schedule_event(Event(650, din->get_id(), 3));
+    sim.schedule_event(Event(700, c->get_id(), 0));
+    sim.schedule_event(Event(800, c->get_id(), 1));   // q0 = X
+    sim.run_until(850);
+    assert(resolve_value(sim, "sr.q0") == 2);
+    sim.schedule_event(Event(900, c->get_id(), 0));
+    sim.schedule_event(Event(1000, c->get_id(), 1));  // q1 = X
+    sim.run_until(1100);
+    assert(q->get_value() == 2);
+    std::cout << "✓ Z on D samples as X\n";
+}
+
+void test_definition_errors() {
+    std::cout << "\n=== Test: Definition Errors ===\n";
+
+    ModuleDef loop("loop");
+    uint32_t a = loop.add_input("a");
+    uint32_t x = loop.add_net("x");
+    uint32_t y = loop.add_output("y");
+    loop.add_gate(ModuleDef::AND, {a, y}, x, 10);
+    loop.add_gate(ModuleDef::BUF, {x}, y, 10);
+    bool threw = false;
+    try {
+        loop.finalize();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    std::cout << "✓ Combinational loops are rejected\n";
+
+    ModuleDef multi("multi");
+    uint32_t m = multi.add_input("a");
+    uint32_t out = multi.add_output("y");
+    multi.add_gate(ModuleDef::BUF, {m}, out, 10);
+    multi.add_gate(ModuleDef::NOT, {m}, out, 10);
+    threw = false;
+    try {
+        multi.finalize();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    std::cout << "✓ Multiply-driven nets are rejected\n";
+
+    // Nets may start at any logic value, Z included, but nothing else
+    ModuleDef init("init");
+    uint32_t z = init.add_output("z", LOGIC_Z);
+    assert(init.get_net_name(z) == "z");
+    threw = false;
+    try {
+        init.add_net("bad", 4);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    Simulator zsim;
+    ModuleInstance* undriven = instantiate(zsim, std::make_shared<ModuleDef>(init), "u");
+    assert(undriven->get_net_value(z) == logic::canonical(LOGIC_Z));
+    assert(zsim.get_signal_by_name("u.z")->get_value() == logic::canonical(LOGIC_Z));
+    std::cout << "✓ Nets start at 0, 1, X or Z; other values are rejected\n";
+}
+
+void test_hierarchical_vcd() {
+    std::cout << "\n=== Test: Hierarchical VCD Scopes ===\n";
+
+    Simulator sim;
+    instantiate(sim, make_adder2(), "u0");
+    sim.enable_trace();
+    sim.schedule_event(Event(0, sim.get_signal_by_name("u0.a0")->get_id(), 1));
+    sim.run_all();
+
+    const std::string filename = "test_module.vcd";
+    sim.dump_waveform(filename);
+    std::ifstream file(filename);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string vcd = buffer.str();
+    std::remove(filename.c_str());
+
+    size_t top = vcd.find("$scope module top $end");
+    size_t u0 = vcd.find("$scope module u0 $end");
+    assert(top != std::string::npos);
+    assert(u0 != std::string::npos && u0 > top);
+    assert(vcd.find(" a0 $end", u0) != std::string::npos);
+    std::cout << "✓ Dotted signal names become nested VCD scopes\n";
+}
+
+int main() {
+    test_hierarchical_adder();
+    test_shared_definition();
+    test_flops_in_module();
+    test_definition_errors();
+    test_hierarchical_vcd();
+
+    std::cout << "\n=========================\n";
+    std::cout << "✓ All Module Tests Passed!\n";
+    std::cout << "=========================\n";
+
+    return 0;
+}
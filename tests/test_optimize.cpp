@@ -0,0 +1,244 @@
+#include "simulator.h"
+#include "signal.h"
+#include "gate.h"
+#include "event.h"
+#include "optimize.h"
+#include "memories.h"
+#include <iostream>
+#include <cassert>
+
+void test_constant_folding() {
+    std::cout << "\n=== Test: Constant Folding ===\n";
+
+    Simulator sim;
+    Signal* a = sim.create_signal("A", 0);
+    Signal* zero = sim.create_signal("zero", 0);
+    Signal* one = sim.create_signal("one", 1);
+    Signal* y1 = sim.create_signal("Y1", 2);
+    Signal* y2 = sim.create_signal("Y2", 2);
+    sim.tie_constant(zero, 0);
+    sim.tie_constant(one, 1);
+
+    ANDGate* and1 = sim.create_component<ANDGate>(100);  // A & 0 -> 0
+    and1->connect_input(a);
+    and1->connect_input(zero);
+    and1->connect_output(y1);
+
+    ANDGate* and2 = sim.create_component<ANDGate>(100);  // A & 1 -> BUF(A)
+    and2->connect_input(a);
+    and2->connect_input(one);
+    and2->connect_output(y2);
+
+    sim.probe(y1);
+    sim.probe(y2);
+
+    OptimizeReport report = optimize_netlist(sim);
+    assert(report.constants_folded == 1);
+    assert(report.gates_simplified == 1);
+    assert(report.gates_after == 1);   // Only the BUF replacing and2 is left
+    assert(report.gates_removed() == 1);
+    std::cout << "✓ A&0 folded to a constant, A&1 reduced to a buffer\n";
+
+    // Folded constant still appears after the gate delay
+    sim.run_until(99);
+    assert(y1->get_value() == 2);
+    sim.run_until(100);
+    assert(y1->get_value() == 0);
+
+    // Delay through the reduced gate is preserved
+    sim.schedule_event(Event(200, a->get_id(), 1));
+    sim.run_until(299);
+    assert(y2->get_value() != 1);
+    sim.run_until(300);
+    assert(y2->get_value() == 1);
+    assert(y1->get_value() == 0);
+    std::cout << "✓ Timing preserved on folded and reduced paths\n";
+}
+
+void test_double_inversion() {
+    std::cout << "\n=== Test: Double Inversion Collapse ===\n";
+
+    Simulator sim;
+    Signal* a = sim.create_signal("A", 0);
+    Signal* b = sim.create_signal("B", 2);
+    Signal* c = sim.create_signal("C", 2);
+
+    NOTGate* not1 = sim.create_component<NOTGate>(50);
+    not1->connect_input(a);
+    not1->connect_output(b);
+    NOTGate* not2 = sim.create_component<NOTGate>(70);
+    not2->connect_input(b);
+    not2->connect_output(c);
+    sim.probe(c);
+
+    OptimizeReport report = optimize_netlist(sim);
+    assert(report.chains_collapsed == 1);
+    assert(report.dead_gates == 1);       // not1 lost its only reader
+    assert(report.gates_after == 1);
+    assert(report.nets_removed() == 1);
+    assert(sim.get_signal_by_name("B") == nullptr);
+    std::cout << "✓ NOT-NOT replaced by one buffer, middle net removed\n";
+
+    sim.schedule_event(Event(0, a->get_id(), 1));
+    sim.run_until(119);
+    assert(c->get_value() == 2);
+    sim.run_until(120);
+    assert(c->get_value() == 1);
+    std::cout << "✓ Buffer carries the summed delay (50 + 70)\n";
+}
+
+void test_dead_logic() {
+    std::cout << "\n=== Test: Dead Logic Removal ===\n";
+
+    Simulator sim;
+    Signal* a = sim.create_signal("A", 0);
+    Signal* b = sim.create_signal("B", 0);
+    Signal* unused = sim.create_signal("unused", 2);
+    Signal* unused2 = sim.create_signal("unused2", 2);
+    Signal* y = sim.create_signal("Y", 2);
+
+    ANDGate* dead1 = sim.create_component<ANDGate>(100);
+    dead1->connect_input(a);
+    dead1->connect_input(b);
+    dead1->connect_output(unused);
+    NOTGate* dead2 = sim.create_component<NOTGate>(100);  // Only reader of "unused"
+    dead2->connect_input(unused);
+    dead2->connect_output(unused2);
+
+    ORGate* live = sim.create_component<ORGate>(100);
+    live->connect_input(a);
+    live->connect_input(b);
+    live->connect_output(y);
+    sim.probe(y);
+
+    OptimizeReport report = optimize_netlist(sim);
+    assert(report.dead_gates == 2);
+    assert(report.gates_removed() == 2);
+    assert(report.nets_removed() == 2);
+    assert(sim.get_signal_by_name("A") != nullptr);  // Primary inputs are kept
+    assert(a->get_observers().size() == 1);
+
+    sim.schedule_event(Event(0, a->get_id(), 1));
+    sim.run_all();
+    assert(y->get_value() == 1);
+    std::cout << "✓ Unobserved cone removed, probed logic intact\n";
+}
+
+void test_full_adder_with_tied_carry() {
+    std::cout << "\n=== Test: Full Adder With Cin Tied Low ===\n";
+
+    Simulator sim;
+    Signal* a = sim.create_signal("A", 0);
+    Signal* b = sim.create_signal("B", 0);
+    Signal* cin = sim.create_signal("Cin", 0);
+    Signal* sum = sim.create_signal("Sum", 2);
+    Signal* cout = sim.create_signal("Cout", 2);
+    Signal* sum1 = sim.create_signal("sum1", 2);
+    Signal* carry1 = sim.create_signal("carry1", 2);
+    Signal* carry2 = sim.create_signal("carry2", 2);
+    sim.tie_constant(cin, 0);
+
+    XORGate* xor1 = sim.create_component<XORGate>(100);
+    xor1->connect_input(a);
+    xor1->connect_input(b);
+    xor1->connect_output(sum1);
+    ANDGate* and1 = sim.create_component<ANDGate>(100);
+    and1->connect_input(a);
+    and1->connect_input(b);
+    and1->connect_output(carry1);
+    XORGate* xor2 = sim.create_component<XORGate>(100);
+    xor2->connect_input(sum1);
+    xor2->connect_input(cin);
+    xor2->connect_output(sum);
+    ANDGate* and2 = sim.create_component<ANDGate>(100);
+    and2->connect_input(sum1);
+    and2->connect_input(cin);
+    and2->connect_output(carry2);
+    ORGate* or_gate = sim.create_component<ORGate>(100);
+    or_gate->connect_input(carry1);
+    or_gate->connect_input(carry2);
+    or_gate->connect_output(cout);
+
+    sim.probe(sum);
+    sim.probe(cout);
+
+    OptimizeReport report = optimize_netlist(sim);
+    std::cout << "  Removed " << report.gates_removed() << " gates and "
+              << report.nets_removed() << " nets\n";
+    assert(report.constants_folded == 1);     // and2 -> 0
+    assert(report.gates_simplified == 2);     // xor2 -> BUF, or_gate -> BUF
+    assert(report.gates_after == 4);
+    assert(report.nets_removed() == 1);       // carry2
+
+    // Behaves like a half adder, with the original 200ps to the outputs
+    uint8_t cases[4][2] = {{0, 0}, {0, 1}, {1, 0}, {1, 1}};
+    uint64_t time = 1000;
+    for (auto& tc : cases) {
+        sim.schedule_event(Event(time, a->get_id(), tc[0]));
+        sim.schedule_event(Event(time, b->get_id(), tc[1]));
+        sim.run_until(time + 200);
+        assert(sum->get_value() == (tc[0] ^ tc[1]));
+        assert(cout->get_value() == (tc[0] & tc[1]));
+        time += 500;
+    }
+    std::cout << "✓ Optimized netlist matches the expected truth table\n";
+}
+
+void test_memory_ports_kept() {
+    std::cout << "\n=== Test: Gates Feeding Memory Ports ===\n";
+
+    // The RAM observes only its clock; address, data and enable are read at
+    // the edge, and reported through get_fanin
+    Simulator sim;
+    Signal* clk = sim.create_signal("clk", 0);
+    Signal* a = sim.create_signal("A", 0);
+    Signal* b = sim.create_signal("B", 0);
+    Signal* c = sim.create_signal("C", 0);
+    Signal* n = sim.create_signal("N", 1);
+    Signal* addr0 = sim.create_signal("addr0", 2);
+    Signal* addr1 = sim.create_signal("addr1", 0);
+    Signal* din0 = sim.create_signal("din0", 2);
+    Signal* din1 = sim.create_signal("din1", 0);
+    Signal* we = sim.create_signal("we", 2);
+    Signal* dout0 = sim.create_signal("dout0", 2);
+    Signal* dout1 = sim.create_signal("dout1", 2);
+    sim.create_gate<ANDGate>(100, {a, b}, addr0);
+    sim.create_gate<XORGate>(100, {a, c}, din0);
+    sim.create_gate<NOTGate>(100, {n}, we);
+    SyncRAM* ram = sim.create_component<SyncRAM>(2, 4, 50);
+    ram->connect_clock(clk);
+    ram->add_write_port({addr0, addr1}, {din0, din1}, we);
+    ram->add_read_port({addr0, addr1}, {dout0, dout1});
+    sim.probe(dout0);
+    sim.probe(dout1);
+
+    OptimizeReport report = optimize_netlist(sim);
+    assert(report.dead_gates == 0 && report.gates_removed() == 0 && report.nets_removed() == 0);
+    assert(sim.get_signal_by_name("addr0") == addr0 && sim.get_signal_by_name("we") == we);
+
+    // Write 1 to address 1, then read it back
+    sim.schedule_event(Event(0, a->get_id(), 1));
+    sim.schedule_event(Event(0, b->get_id(), 1));
+    sim.schedule_event(Event(0, n->get_id(), 0));
+    sim.schedule_event(Event(1000, clk->get_id(), 1));
+    sim.schedule_event(Event(1500, clk->get_id(), 0));
+    sim.schedule_event(Event(1600, n->get_id(), 1));
+    sim.schedule_event(Event(2000, clk->get_id(), 1));
+    sim.run_until(2100);
+    assert(dout0->get_value() == 1 && dout1->get_value() == 0);
+    std::cout << "✓ Gates driving RAM address, data and enable survive and still work\n";
+}
+
+int main() {
+    test_constant_folding();
+    test_double_inversion();
+    test_dead_logic();
+    test_full_adder_with_tied_carry();
+    test_memory_ports_kept();
+
+    std::cout << "\n=========================\n";
+    std::cout << "✓ All Optimization Tests Passed!\n";
+    std::cout << "=========================\n";
+
+    return 0;
+}
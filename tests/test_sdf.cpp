@@ -0,0 +1,159 @@
+#include "simulator.h"
+#include "signal.h"
+#include "gate.h"
+#include "event.h"
+#include "sdf.h"
+#include <iostream>
+#include <sstream>
+#include <cassert>
+
+void test_rise_fall_selection() {
+    std::cout << "\n=== Test: Rise/Fall Selection ===\n";
+
+    Simulator sim;
+    Signal* a = sim.create_signal("A", 0);
+    Signal* y = sim.create_signal("Y", 1);
+    NOTGate* inv = sim.create_component<NOTGate>(50);
+    inv->connect_input(a);
+    inv->connect_output(y);
+
+    uint32_t id = sim.get_delay_table().intern(120, 80);
+    inv->annotate_pin(0, id);
+    assert(inv->is_annotated());
+
+    sim.schedule_event(Event(1000, a->get_id(), 1));   // Y falls
+    sim.run_until(1079);
+    assert(y->get_value() == 1);
+    sim.run_until(1080);
+    assert(y->get_value() == 0);
+
+    sim.schedule_event(Event(2000, a->get_id(), 0));   // Y rises
+    sim.run_until(2119);
+    assert(y->get_value() == 0);
+    sim.run_until(2120);
+    assert(y->get_value() == 1);
+
+    sim.schedule_event(Event(3000, a->get_id(), 2));   // Y goes X: the faster edge
+    sim.run_until(3080);
+    assert(y->get_value() == 2);
+    std::cout << "✓ Output transition picks the rise, fall or (for X) shorter delay\n";
+}
+
+void test_sdf_annotation() {
+    std::cout << "\n=== Test: SDF Annotation ===\n";
+
+    Simulator sim;
+    Signal* a = sim.create_signal("A", 1);
+    Signal* b = sim.create_signal("B", 1);
+    Signal* y = sim.create_signal("Y", 1);
+    Signal* z = sim.create_signal("Z", 0);
+    ANDGate* and_gate = sim.create_component<ANDGate>(100);
+    and_gate->connect_input(a);
+    and_gate->connect_input(b);
+    and_gate->connect_output(y);
+    XORGate* xor_gate = sim.create_component<XORGate>(100);
+    xor_gate->connect_input(a);
+    xor_gate->connect_input(b);
+    xor_gate->connect_output(z);
+
+    std::stringstream sdf;
+    sdf << "(DELAYFILE\n"
+        << "  (SDFVERSION \"3.0\")\n"
+        << "  (TIMESCALE 1ns)  // all values in ns\n"
+        << "  (CELL (CELLTYPE \"AND\") (INSTANCE " << and_gate->get_id() << ")\n"
+        << "    (DELAY (ABSOLUTE\n"
+        << "      (IOPATH A Y (0.1:0.2:0.3) (0.15))\n"
+        << "      (IOPATH B Y (0.4) (0.5)))))\n"
+        << "  (CELL (CELLTYPE \"XOR\") (INSTANCE *)\n"
+        << "    (DELAY (ABSOLUTE (IOPATH A Y (0.2)) (IOPATH B Y (0.2)))\n"
+        << "           (INCREMENT (IOPATH B Y (0.05)))))\n"
+        << "  (CELL (CELLTYPE \"NAND\") (INSTANCE nowhere)\n"
+        << "    (DELAY (ABSOLUTE (IOPATH A Y (1))))))\n";
+    SdfReport report = parse_sdf(sim, sdf);
+    assert(report.cells == 3);
+    assert(report.unknown_instances == 1);
+    assert(report.paths_annotated == 5);
+    assert(sim.get_delay_table().size() == 4);   // (200,150) (400,500) (200,200) (250,250)
+    std::cout << "✓ " << report.paths_annotated << " pin delays stored as "
+              << sim.get_delay_table().size() << " table entries\n";
+
+    // A falls: AND output falls with A's fall delay (150ps), XOR rises after 200ps
+    sim.schedule_event(Event(1000, a->get_id(), 0));
+    sim.run_until(1149);
+    assert(y->get_value() == 1);
+    sim.run_until(1150);
+    assert(y->get_value() == 0);
+    sim.run_until(1200);
+    assert(z->get_value() == 1);
+
+    // B falls: AND already 0; XOR falls after B's incremented 250ps
+    sim.schedule_event(Event(2000, b->get_id(), 0));
+    sim.run_until(2249);
+    assert(z->get_value() == 1);
+    sim.run_until(2250);
+    assert(z->get_value() == 0);
+
+    // B rises with A low, then A rises: AND rises after A's typ rise (200ps)
+    sim.schedule_event(Event(3000, b->get_id(), 1));
+    sim.schedule_event(Event(4000, a->get_id(), 1));
+    sim.run_until(4199);
+    assert(y->get_value() == 0);
+    sim.run_until(4200);
+    assert(y->get_value() == 1);
+    std::cout << "✓ Per-pin rise/fall delays follow the pin that changed\n";
+}
+
+void test_corners_and_errors() {
+    std::cout << "\n=== Test: Corners and Errors ===\n";
+
+    Simulator sim;
+    Signal* a = sim.create_signal("A", 0);
+    Signal* y = sim.create_signal("Y", 0);
+    BUFGate* buf = sim.create_component<BUFGate>(50);
+    buf->connect_input(a);
+    buf->connect_output(y);
+
+    std::string text = "(DELAYFILE (TIMESCALE 10 ps) (CELL (CELLTYPE \"BUF\") (INSTANCE " + buf->get_id() +
+                       ") (DELAY (ABSOLUTE (IOPATH A Y (1:2:3) (4:5:6)) (IOPATH (posedge C) Y (1))))))";
+    std::istringstream max_sdf(text);
+    SdfReport report = parse_sdf(sim, max_sdf, SdfCorner::MAX);
+    assert(report.paths_annotated == 1);
+    assert(report.skipped == 1);   // Edge-qualified IOPATH
+    const RiseFall& delay = sim.get_delay_table()[buf->get_pin_delay(0)];
+    assert(delay.rise == 30 && delay.fall == 60);
+    std::cout << "✓ MAX corner and TIMESCALE scaling\n";
+
+    std::istringstream broken("(DELAYFILE (CELL (CELLTYPE \"BUF\")");
+    bool threw = false;
+    try {
+        parse_sdf(sim, broken);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    std::cout << "✓ Truncated SDF is rejected\n";
+
+    std::istringstream bad_value("(DELAYFILE\n(CELL (CELLTYPE \"BUF\") (INSTANCE *)\n"
+                                 "(DELAY (ABSOLUTE (IOPATH A Y (1.5.0))))))");
+    std::string message;
+    try {
+        parse_sdf(sim, bad_value);
+    } catch (const std::runtime_error& e) {
+        message = e.what();
+    }
+    assert(message.find("SDF line 3") != std::string::npos);
+    assert(message.find("1.5.0") != std::string::npos);
+    std::cout << "✓ A malformed delay value is reported with its line\n";
+}
+
+int main() {
+    test_rise_fall_selection();
+    test_sdf_annotation();
+    test_corners_and_errors();
+
+    std::cout << "\n=========================\n";
+    std::cout << "✓ All SDF Tests Passed!\n";
+    std::cout << "=========================\n";
+
+    return 0;
+}
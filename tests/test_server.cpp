@@ -0,0 +1,266 @@
+#include "sim_server.h"
+#include "simulator.h"
+#include "circuits.h"
+#include "history.h"
+#include "signal.h"
+#include "event.h"
+#include <iostream>
+#include <cassert>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static std::string socket_path() {
+    return "/tmp/logic-sim-test-" + std::to_string(getpid()) + ".sock";
+}
+
+static SimRequest adder_request(uint32_t a, uint32_t b) {
+    SimRequest request;
+    request.design = "rca32";
+    for (int i = 0; i < 32; i++) {
+        request.drives.push_back({"rca.a" + std::to_string(i), 1000, (uint8_t)((a >> i) & 1)});
+        request.drives.push_back({"rca.b" + std::to_string(i), 1000, (uint8_t)((b >> i) & 1)});
+    }
+    request.traces = {"rca.s0", "rca.s7", "rca.s31", "rca.c32"};
+    request.run_length = 20000;
+    return request;
+}
+
+static SimRequest lfsr_request(int cycles) {
+    SimRequest request;
+    request.design = "lfsr64";
+    request.clocks.push_back({"lfsr.clk", 1000});
+    request.traces = {"lfsr.q0", "lfsr.q63"};
+    request.run_length = cycles * 1000;
+    return request;
+}
+
+using Trace = std::vector<std::tuple<uint64_t, std::string, uint8_t>>;
+
+static Trace trace_of(const SimResult& result) {
+    Trace trace;
+    for (const SimResult::Change& change : result.changes) {
+        trace.emplace_back(change.time, change.net, change.value);
+    }
+    return trace;
+}
+
+// The same request simulated from scratch in this process
+static Trace reference(const SimRequest& request) {
+    Simulator sim;
+    build_named_circuit(sim, request.design);
+    History history(sim, 1000000);
+    for (const SimRequest::Drive& drive : request.drives) {
+        sim.schedule_event(Event(drive.time, sim.get_signal_by_name(drive.net)->get_id(), drive.value));
+    }
+    for (const SimRequest::Clock& clock : request.clocks) {
+        uint8_t value = 1;
+        for (uint64_t t = clock.period / 2; t <= request.run_length; t += clock.period / 2, value ^= 1) {
+            sim.schedule_event(Event(t, sim.get_signal_by_name(clock.net)->get_id(), value));
+        }
+    }
+    Trace trace;
+    std::vector<uint8_t> last;
+    for (const std::string& name : request.traces) {
+        last.push_back(sim.get_signal_by_name(name)->get_value());
+        trace.emplace_back(0, name, last.back());
+    }
+    sim.run_until(request.run_length);
+    for (const History::Change& change : history.get_log()) {
+        for (size_t i = 0; i < request.traces.size(); i++) {
+            Signal* sig = sim.get_signal_by_name(request.traces[i]);
+            if ((int)sig->get_id() == change.signal_id && last[i] != change.value) {
+                last[i] = change.value;
+                trace.emplace_back(change.time, request.traces[i], change.value);
+            }
+        }
+    }
+    return trace;
+}
+
+static void add_designs(SimServer& server) {
+    server.add_design("rca32", [](Simulator& sim) { build_named_circuit(sim, "rca32"); });
+    server.add_design("lfsr64", [](Simulator& sim) { build_named_circuit(sim, "lfsr64"); });
+}
+
+void test_runs() {
+    std::cout << "\n=== Test: Runs on Resident Designs ===\n";
+
+    SimServer server(socket_path(), 2);
+    add_designs(server);
+    server.start();
+    struct stat st;
+    assert(stat(socket_path().c_str(), &st) == 0 && S_ISSOCK(st.st_mode));
+
+    SimClient client(socket_path());
+    std::vector<std::string> names = client.designs();
+    assert(names == std::vector<std::string>({"rca32", "lfsr64"}));
+    std::cout << "✓ Designs listed\n";
+
+    SimRequest add = adder_request(0x89abcdef, 0x76543211);   // Sum 0x100000000: carry ripples through
+    SimResult result = client.run(add);
+    assert(trace_of(result) == reference(add));
+    assert(result.events > 0 && result.evaluations > 0);
+    assert(result.changes.back().net == "rca.c32" && result.changes.back().value == 1);
+    std::cout << "✓ Adder run matches an in-process simulation (" << result.events << " events)\n";
+
+    SimRequest lfsr = lfsr_request(200);
+    SimResult first = client.run(lfsr);
+    SimResult second = client.run(lfsr);
+    assert(trace_of(first) == reference(lfsr));
+    assert(trace_of(second) == trace_of(first));
+    assert(second.events == first.events);
+    std::cout << "✓ Each run starts from the elaborated state (" << first.changes.size() << " changes)\n";
+
+    // A different stimulus on the same resident adder
+    SimRequest other = adder_request(5, 9);
+    assert(trace_of(client.run(other)) == reference(other));
+    assert(server.requests_served() == 4);
+    std::cout << "✓ Runs on one connection are independent\n";
+
+    server.stop();
+    assert(stat(socket_path().c_str(), &st) != 0);
+    std::cout << "✓ Stopping removes the socket\n";
+}
+
+void test_errors() {
+    std::cout << "\n=== Test: Bad Requests ===\n";
+
+    SimServer server(socket_path(), 1);
+    add_designs(server);
+    server.start();
+    SimClient client(socket_path());
+
+    auto fails = [&](const SimRequest& request, const std::string& message) {
+        try {
+            client.run(request);
+        } catch (const std::runtime_error& e) {
+            return std::string(e.what()).find(message) != std::string::npos;
+        }
+        return false;
+    };
+
+    SimRequest request = lfsr_request(10);
+    request.design = "cpu";
+    assert(fails(request, "unknown design 'cpu'"));
+    request = lfsr_request(10);
+    request.traces.push_back("lfsr.q64");
+    assert(fails(request, "unknown net 'lfsr.q64'"));
+    request = lfsr_request(10);
+    request.clocks[0].period = 1;
+    assert(fails(request, "clock period"));
+    assert(server.requests_failed() == 3);
+
+    // The connection stays usable after errors
+    SimRequest good = lfsr_request(10);
+    assert(trace_of(client.run(good)) == reference(good));
+    std::cout << "✓ Unknown designs, nets and bad clocks are reported; the connection stays usable\n";
+
+    bool second_server = false;
+    try {
+        SimServer other(socket_path(), 1);
+        other.start();
+    } catch (const std::runtime_error&) {
+        second_server = true;
+    }
+    assert(second_server);
+    std::cout << "✓ A live server's socket is not taken over\n";
+}
+
+void test_concurrent_clients() {
+    std::cout << "\n=== Test: Concurrent Clients ===\n";
+
+    SimServer server(socket_path(), 3);
+    add_designs(server);
+    server.start();
+
+    const Trace expected_adder = reference(adder_request(0xffffffff, 1));
+    const Trace expected_lfsr = reference(lfsr_request(50));
+    const int clients = 6;
+    const int runs = 10;
+    std::vector<int> matches(clients, 0);
+    std::vector<std::thread> threads;
+    for (int c = 0; c < clients; c++) {
+        threads.emplace_back([&, c] {
+            SimClient client(socket_path());
+            for (int r = 0; r < runs; r++) {
+                bool adder = (c + r) % 2 == 0;
+                SimResult result = client.run(adder ? adder_request(0xffffffff, 1) : lfsr_request(50));
+                matches[c] += trace_of(result) == (adder ? expected_adder : expected_lfsr);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (int c = 0; c < clients; c++) {
+        assert(matches[c] == runs);
+    }
+    assert(server.requests_served() == (uint64_t)(clients * runs));
+    std::cout << "✓ " << clients << " clients x " << runs << " runs on " << server.worker_count()
+              << " workers, all results correct\n";
+}
+
+// A bare connection that sends `text` and nothing more
+static int send_raw(const std::string& text) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strcpy(addr.sun_path, socket_path().c_str());
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    assert(fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+    assert(send(fd, text.data(), text.size(), 0) == (ssize_t)text.size());
+    return fd;
+}
+
+void test_stalled_clients() {
+    std::cout << "\n=== Test: Stalled Clients ===\n";
+
+    SimServer server(socket_path(), 1);
+    add_designs(server);
+    server.start();
+
+    // Half-sent requests wait in the dispatcher, not in the only worker
+    std::vector<int> stalled;
+    stalled.push_back(send_raw("design lfsr64\nclock lfsr.clk 1000\n"));
+    stalled.push_back(send_raw("design lfsr64\ntrace lfsr.q0\nru"));
+    stalled.push_back(send_raw("designs"));
+    SimClient client(socket_path());
+    SimRequest lfsr = lfsr_request(20);
+    assert(trace_of(client.run(lfsr)) == reference(lfsr));
+    std::cout << "✓ " << stalled.size() << " stalled requests leave the single worker free\n";
+
+    // A request finished later is served
+    const std::string rest = "n 5000\n";
+    assert(send(stalled[1], rest.data(), rest.size(), 0) == (ssize_t)rest.size());
+    std::string answer;
+    char c;
+    while (recv(stalled[1], &c, 1, 0) == 1 && c != '\n') {
+        answer += c;
+    }
+    assert(answer == "ok lfsr64");
+    for (int fd : stalled) {
+        close(fd);
+    }
+    assert(trace_of(client.run(lfsr)) == reference(lfsr));
+    std::cout << "✓ A request completed later is answered; hang-ups are dropped\n";
+}
+
+int main() {
+    test_runs();
+    test_errors();
+    test_concurrent_clients();
+    test_stalled_clients();
+
+    std::cout << "\n=========================\n";
+    std::cout << "✓ All Server Tests Passed!\n";
+    std::cout << "=========================\n";
+
+    return 0;
+}
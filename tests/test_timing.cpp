@@ -0,0 +1,158 @@
+#include "simulator.h"
+#include "signal.h"
+#include "sequential.h"
+#include "event.h"
+#include "timing.h"
+#include <iostream>
+#include <sstream>
+#include <cassert>
+
+static_assert(TIMING_CHECKS_COMPILED_IN, "test_timing must be built with LOGIC_SIM_TIMING_CHECKS");
+
+struct FlopBench {
+    Simulator sim;
+    Signal* clk;
+    Signal* d;
+    Signal* q;
+    DFF* dff;
+
+    FlopBench() {
+        clk = sim.create_signal("CLK", 0);
+        d = sim.create_signal("D", 0);
+        q = sim.create_signal("Q", 0);
+        dff = sim.create_component<DFF>(100);
+        dff->connect_clock(clk);
+        dff->connect_data(d);
+        dff->connect_q(q);
+    }
+
+    // Rising edge at `time`, D set to `value` at `d_time`
+    void edge_with_data(uint64_t time, uint64_t d_time, uint8_t value) {
+        sim.schedule_event(Event(d_time, d->get_id(), value));
+        sim.schedule_event(Event(time, clk->get_id(), 1));
+        sim.schedule_event(Event(time + 500, clk->get_id(), 0));
+    }
+};
+
+void test_setup_and_hold() {
+    std::cout << "\n=== Test: Setup and Hold Windows ===\n";
+
+    FlopBench tb;
+    tb.sim.check_timing(tb.dff, 50, 40);
+    tb.sim.enable_timing_checks();
+    assert(tb.dff->has_timing_checks());
+
+    tb.edge_with_data(1000, 900, 1);    // 100ps of setup: clean
+    tb.sim.run_until(1200);
+    assert(tb.sim.get_timing().total_violations() == 0);
+    assert(tb.q->get_value() == 1);
+    std::cout << "✓ Stable data gives no violation\n";
+
+    tb.edge_with_data(2000, 1970, 0);   // 30ps before the edge
+    tb.sim.run_until(2200);
+    const TimingChecker& timing = tb.sim.get_timing();
+    assert(timing.total_violations() == 1);
+    assert(timing.get_log()[0].kind == TimingViolation::SETUP);
+    assert(timing.get_log()[0].data_time == 1970 && timing.get_log()[0].clock_time == 2000);
+    assert(tb.q->get_value() == 0);     // Without force-X the new value is captured
+    std::cout << "✓ Setup violation detected\n";
+
+    tb.edge_with_data(3000, 3020, 1);   // 20ps after the edge
+    tb.sim.run_until(3200);
+    assert(timing.total_violations() == 2);
+    assert(timing.get_log()[1].kind == TimingViolation::HOLD);
+    assert(timing.get_log()[1].time == 3020);
+    std::cout << "✓ Hold violation detected\n";
+
+    tb.edge_with_data(4000, 4000, 0);   // Simultaneous: setup
+    tb.sim.run_until(4200);
+    assert(timing.total_violations() == 3);
+    assert(timing.get_log()[2].kind == TimingViolation::SETUP);
+    std::cout << "✓ Data changing with the edge is a setup violation\n";
+
+    std::ostringstream report;
+    timing.report(report);
+    assert(report.str().find("DFF") != std::string::npos);
+    assert(report.str().find("hold violation, D changed 20ps after") != std::string::npos);
+}
+
+void test_force_x() {
+    std::cout << "\n=== Test: Force X on Violation ===\n";
+
+    FlopBench tb;
+    tb.sim.check_timing(50, 40);        // Every DFF
+    tb.sim.enable_timing_checks(true);
+
+    tb.edge_with_data(1000, 990, 1);
+    tb.sim.run_until(1099);
+    assert(tb.q->get_value() == 0);
+    tb.sim.run_until(1100);
+    assert(tb.q->get_value() == 2);
+    std::cout << "✓ Setup violation captures X\n";
+
+    tb.edge_with_data(2000, 1800, 1);   // Clean capture of 1
+    tb.sim.run_until(2100);
+    assert(tb.q->get_value() == 1);
+    tb.edge_with_data(3000, 2800, 0);
+    tb.sim.schedule_event(Event(3030, tb.d->get_id(), 1));   // Inside the 40ps hold window
+    tb.sim.run_until(3129);
+    assert(tb.q->get_value() == 0);
+    tb.sim.run_until(3130);
+    assert(tb.q->get_value() == 2);
+    std::cout << "✓ Hold violation drives Q to X\n";
+}
+
+void test_bounded_log() {
+    std::cout << "\n=== Test: Bounded Violation Log ===\n";
+
+    FlopBench tb;
+    tb.sim.check_timing(tb.dff, 50, 0);
+    tb.sim.enable_timing_checks();
+    tb.sim.get_timing().set_log_limits(100, 3);
+
+    for (int i = 0; i < 20; i++) {
+        uint64_t t = 1000 + i * 1000;
+        tb.edge_with_data(t, t - 10, (i + 1) & 1);
+    }
+    tb.sim.run_all();
+    const TimingChecker& timing = tb.sim.get_timing();
+    assert(timing.total_violations() == 20);
+    assert(timing.get_log().size() == 3);
+    assert(timing.suppressed_violations() == 17);
+
+    std::ostringstream report;
+    timing.report(report);
+    assert(report.str().find("17 more not logged") != std::string::npos);
+    std::cout << "✓ Per-flop limit keeps the log bounded, the rest is counted\n";
+}
+
+void test_disabled() {
+    std::cout << "\n=== Test: Checks Disabled ===\n";
+
+    FlopBench tb;
+    tb.sim.check_timing(tb.dff, 50, 40);   // Registered but never enabled
+    tb.edge_with_data(1000, 995, 1);
+    tb.sim.run_all();
+    assert(tb.sim.get_timing().total_violations() == 0);
+    assert(tb.q->get_value() == 1);
+
+    tb.sim.enable_timing_checks();
+    tb.sim.disable_timing_checks();
+    tb.edge_with_data(3000, 2995, 0);
+    tb.sim.run_all();
+    assert(tb.sim.get_timing().total_violations() == 0);
+    std::cout << "✓ No checks run unless enabled\n";
+}
+
+int main() {
+    test_setup_and_hold();
+    test_force_x();
+    test_bounded_log();
+    test_disabled();
+
+    std::cout << "\n=========================\n";
+    std::cout << "✓ All Timing Check Tests Passed!\n";
+    std::cout << "=========================\n";
+
+    return 0;
+}
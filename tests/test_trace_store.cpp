@@ -0,0 +1,208 @@
+#include "simulator.h"
+#include "trace_store.h"
+#include "circuits.h"
+#include "signal.h"
+#include "event.h"
+#include "logic.h"
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// In-memory reference: every recorded change, in order
+struct Reference {
+    std::vector<uint8_t> initial;
+    std::vector<TraceStore::Change> changes;
+
+    uint8_t value_at(uint32_t signal, uint64_t time) const {
+        uint8_t value = initial[signal];
+        for (const TraceStore::Change& c : changes) {
+            if (c.time > time) {
+                break;
+            }
+            if (c.signal == signal) {
+                value = c.value;
+            }
+        }
+        return value;
+    }
+};
+
+static bool same(const TraceStore::Change& a, const TraceStore::Change& b) {
+    return a.time == b.time && a.signal == b.signal && a.value == b.value;
+}
+
+// Point and window queries at random times against the reference
+static void check_queries(const TraceStore& store, const Reference& ref, uint64_t end, uint32_t seed) {
+    std::mt19937 gen(seed);
+    for (int q = 0; q < 300; q++) {
+        uint32_t signal = gen() % store.signal_count();
+        uint64_t time = gen() % (end + 10);
+        assert(store.value_at(signal, time) == ref.value_at(signal, time));
+    }
+    for (int q = 0; q < 20; q++) {
+        uint64_t from = gen() % end;
+        uint64_t to = from + gen() % 500;
+        uint32_t signal = gen() % store.signal_count();
+        std::vector<TraceStore::Change> one = store.changes(signal, from, to);
+        std::vector<TraceStore::Change> all = store.changes(from, to);
+        size_t i = 0;
+        size_t j = 0;
+        for (const TraceStore::Change& c : ref.changes) {
+            if (c.time < from || c.time > to) {
+                continue;
+            }
+            assert(j < all.size() && all[j].time == c.time);  // Shards interleave within a time
+            j++;
+            if (c.signal == signal) {
+                assert(i < one.size() && same(one[i], c));
+                i++;
+            }
+        }
+        assert(i == one.size() && j == all.size());
+    }
+}
+
+void test_store() {
+    std::cout << "\n=== Test: Store Queries ===\n";
+
+    const std::string path = "trace_store_test.trc";
+    const uint32_t signals = 50;
+    Reference ref;
+    std::vector<std::string> names;
+    for (uint32_t i = 0; i < signals; i++) {
+        names.push_back("s" + std::to_string(i));
+        ref.initial.push_back(i % 3);
+    }
+
+    uint64_t time = 0;
+    {
+        TraceStore store(path, names, ref.initial, 0, 16);   // 4 shards
+        assert(store.shard_count() == 4 && store.is_open());
+        std::mt19937 gen(1);
+        for (int i = 0; i < 40000; i++) {   // Several index blocks per shard
+            time += gen() % 3;
+            TraceStore::Change c = {time, (uint32_t)(gen() % signals), (uint8_t)(gen() % 4)};
+            store.record(c.time, c.signal, c.value);
+            ref.changes.push_back(c);
+        }
+        assert(store.record_count() == 40000);
+        check_queries(store, ref, time, 2);
+        std::cout << "✓ Queries on a store being recorded match the reference\n";
+        store.close(time + 100);
+        assert(!store.is_open() && store.end_time() == time + 100);
+    }
+
+    std::unique_ptr<TraceStore> reopened = TraceStore::open(path);
+    assert(reopened->signal_count() == signals && reopened->record_count() == 40000);
+    assert(reopened->find_signal("s7") == 7 && reopened->find_signal("nope") == -1);
+    assert(reopened->mapped_bytes() < 40000 * 16 + 4 * 4096);   // Trimmed on close
+    check_queries(*reopened, ref, time, 3);
+    assert(reopened->value_at(5, 0) == ref.value_at(5, 0));
+    std::cout << "✓ Reopened read-only: " << reopened->mapped_bytes() << " bytes mapped, same answers\n";
+
+    for (int k = 0; k < 4; k++) {
+        std::remove((path + "." + std::to_string(k) + ".rec").c_str());
+        std::remove((path + "." + std::to_string(k) + ".idx").c_str());
+    }
+    std::remove(path.c_str());
+}
+
+void test_simulator_trace() {
+    std::cout << "\n=== Test: Simulator Recording ===\n";
+
+    const std::string path = "trace_store_sim.trc";
+    Simulator sim;
+    CircuitPorts ports = build_ripple_carry_adder(sim, 8, "rca", 10);
+    sim.enable_trace(path, 32);
+    Signal* late = sim.create_signal("late", 0);   // Created after recording started
+
+    // Reference: the values after each vector settles
+    std::mt19937 gen(4);
+    std::vector<uint64_t> times;
+    std::vector<std::vector<uint8_t>> settled;
+    uint64_t time = 100;
+    for (int v = 0; v < 50; v++) {
+        for (Signal* in : ports.inputs) {
+            sim.schedule_event(Event(time, in->get_id(), gen() & 1));
+        }
+        sim.schedule_event(Event(time, late->get_id(), v & 1));
+        sim.run_all();
+        times.push_back(sim.get_current_time());
+        settled.emplace_back();
+        for (Signal* out : ports.outputs) {
+            settled.back().push_back(out->get_value());
+        }
+        time = sim.get_current_time() + 1000;
+    }
+    TraceStore* store = sim.get_trace_store();
+    assert(store && store->is_open() && store->find_signal("late") == -1);
+    sim.disable_trace();
+    assert(!store->is_open());
+
+    std::unique_ptr<TraceStore> reopened = TraceStore::open(path);
+    for (size_t v = 0; v < times.size(); v++) {
+        for (size_t i = 0; i < ports.outputs.size(); i++) {
+            int slot = reopened->find_signal(ports.outputs[i]->get_name());
+            assert(slot >= 0 && reopened->value_at(slot, times[v]) == settled[v][i]);
+        }
+    }
+    std::cout << "✓ Adder outputs at the end of each of " << times.size() << " vectors, from "
+              << reopened->record_count() << " recorded changes\n";
+
+    for (size_t k = 0; k < reopened->shard_count(); k++) {
+        std::remove((path + "." + std::to_string(k) + ".rec").c_str());
+        std::remove((path + "." + std::to_string(k) + ".idx").c_str());
+    }
+    std::remove(path.c_str());
+}
+
+// Lowest free descriptor: the same before and after if nothing leaked
+static int next_fd() {
+    int fd = open("/dev/null", O_RDONLY);
+    close(fd);
+    return fd;
+}
+
+void test_failed_create() {
+    std::cout << "\n=== Test: Failed Create ===\n";
+
+    // Shard 1's record file cannot be created: a directory is in the way
+    const std::string path = "trace_store_fail.trc";
+    const std::string blocker = path + ".1.rec";
+    assert(mkdir(blocker.c_str(), 0755) == 0);
+    std::vector<std::string> names;
+    for (int i = 0; i < 40; i++) {
+        names.push_back("s" + std::to_string(i));
+    }
+    int fd = next_fd();
+    bool threw = false;
+    try {
+        TraceStore store(path, names, std::vector<uint8_t>(40, 0), 0, 16);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    assert(next_fd() == fd);
+    assert(access((path + ".0.rec").c_str(), F_OK) != 0 && access((path + ".0.idx").c_str(), F_OK) != 0);
+    assert(access(blocker.c_str(), F_OK) == 0 && access(path.c_str(), F_OK) != 0);
+    rmdir(blocker.c_str());
+    std::cout << "✓ No descriptors, mappings or shard files are left behind\n";
+}
+
+int main() {
+    test_store();
+    test_simulator_trace();
+    test_failed_create();
+
+    std::cout << "\n=========================\n";
+    std::cout << "✓ All Trace Store Tests Passed!\n";
+    std::cout << "=========================\n";
+
+    return 0;
+}
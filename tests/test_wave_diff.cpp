@@ -0,0 +1,201 @@
+#include "simulator.h"
+#include "wave_diff.h"
+#include "trace_writer.h"
+#include "signal.h"
+#include "gate.h"
+#include "event.h"
+#include "logic.h"
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+enum class Variant { Good, SlowAnd, XorBug };
+
+// y = (a & b) | c, with a late AND or an XOR in place of the OR
+static void build(Simulator& sim, Variant variant) {
+    Signal* a = sim.create_signal("u.a", 0);
+    Signal* b = sim.create_signal("u.b", 0);
+    Signal* c = sim.create_signal("u.c", 0);
+    Signal* n1 = sim.create_signal("u.n1", 0);
+    Signal* y = sim.create_signal("u.y", 0);
+    sim.create_component<ANDGate>(variant == Variant::SlowAnd ? 13 : 10, n1, a, b);
+    if (variant == Variant::XorBug) {
+        sim.create_component<XORGate>(10, y, n1, c);
+    } else {
+        sim.create_component<ORGate>(10, y, n1, c);
+    }
+}
+
+static void stimulus(Simulator& sim) {
+    const uint8_t vectors[][3] = {{1, 1, 0}, {0, 1, 0}, {0, 0, 1}, {1, 1, 1}, {1, 0, 0}, {1, 1, 0}, {0, 0, 0}};
+    uint64_t time = 100;
+    for (const auto& v : vectors) {
+        for (int i = 0; i < 3; i++) {
+            sim.schedule_event(Event(time, sim.get_signal_by_name(std::string("u.") + "abc"[i])->get_id(), v[i]));
+        }
+        time += 100;
+    }
+}
+
+// Run one variant, dumping it to `path` through a TraceWriter
+static void record(Variant variant, const std::string& path) {
+    Simulator sim;
+    build(sim, variant);
+    TraceWriter writer(sim, path);
+    sim.enable_trace(&writer);
+    stimulus(sim);
+    sim.run_all();
+    writer.close(sim.get_current_time() + 100);
+}
+
+void test_reader() {
+    std::cout << "\n=== Test: VCD Reader ===\n";
+
+    const std::string path = "wave_diff_reader.vcd";
+    {
+        std::ofstream file(path);
+        file << "$date today $end\n$timescale 1 ns $end\n"
+             << "$scope module tb $end\n$var wire 1 ! clk $end\n"
+             << "$scope module cpu $end\n$var reg 1 \" q [0] $end\n$var wire 8 & bus [7:0] $end\n"
+             << "$var wire 1 % x $end\n$upscope $end\n$var wire 1 % x_alias $end\n$upscope $end\n"
+             << "$enddefinitions $end\n"
+             << "$dumpvars\n0!\nx\"\nb00000000 &\n1%\n$end\n"
+             << "#1\n1!\n$comment ignored 0! $end\nb1 \"\nb10101010 &\n#2\nZ%\n";
+    }
+    VcdReader reader(path);
+    const std::vector<std::string>& names = reader.get_names();
+    assert(names.size() == 4 && names[0] == "clk" && names[1] == "cpu.q" && names[2] == "cpu.x" &&
+           names[3] == "x_alias");
+
+    std::vector<VcdReader::Change> changes;
+    VcdReader::Change c;
+    while (reader.next(c)) {
+        changes.push_back(c);
+    }
+    const VcdReader::Change expected[] = {{0, 0, LOGIC_0}, {0, 1, LOGIC_X}, {0, 2, LOGIC_1}, {0, 3, LOGIC_1},
+                                          {1000, 0, LOGIC_1}, {1000, 1, LOGIC_1}, {2000, 2, LOGIC_Z},
+                                          {2000, 3, LOGIC_Z}};
+    assert(changes.size() == 8);
+    for (size_t i = 0; i < changes.size(); i++) {
+        assert(changes[i].time == expected[i].time && changes[i].signal == expected[i].signal &&
+               changes[i].value == expected[i].value);
+    }
+    std::cout << "✓ Scopes, 1-bit vectors, aliases and ns timescale; wide vectors and comments skipped\n";
+    std::remove(path.c_str());
+}
+
+void test_files() {
+    std::cout << "\n=== Test: Golden File Comparison ===\n";
+
+    const std::string golden = "wave_diff_golden.vcd.gz";
+    const std::string slow = "wave_diff_slow.vcd.gz";
+    const std::string bug = "wave_diff_bug.vcd.gz";
+    record(Variant::Good, golden);
+    record(Variant::SlowAnd, slow);
+    record(Variant::XorBug, bug);
+
+    WaveDiffReport same = compare_waveforms(golden, golden);
+    assert(same.passed() && same.compared_signals == 5 && same.golden_changes == same.actual_changes);
+    std::cout << "✓ A run against itself: " << same.compared_signals << " signals, "
+              << same.golden_changes << " changes, no mismatch\n";
+
+    // The AND output (and y after it) switches 3ps late
+    WaveDiffReport late = compare_waveforms(golden, slow);
+    assert(!late.passed() && late.mismatches[0].signal == "u.n1" && late.mismatches[0].time == 110);
+    assert(late.mismatches[0].golden == LOGIC_1 && late.mismatches[0].actual == LOGIC_0);
+    WaveDiffOptions tolerant;
+    tolerant.tolerance = 3;
+    assert(compare_waveforms(golden, slow, tolerant).passed());
+    tolerant.tolerance = 2;
+    assert(!compare_waveforms(golden, slow, tolerant).passed());
+    tolerant.signal_tolerances = {{"u.n*", 5}, {"*", 3}};
+    assert(compare_waveforms(golden, slow, tolerant).passed());
+    std::cout << "✓ 3ps skew: " << late.mismatches.size() << " mismatches exact, none with 3ps tolerance\n";
+
+    // XOR instead of OR: y differs while n1 and c are both 1
+    WaveDiffReport wrong = compare_waveforms(golden, bug, tolerant);
+    assert(wrong.mismatches.size() == 1 && wrong.mismatches[0].signal == "u.y");
+    assert(wrong.mismatches[0].time == 420 && wrong.mismatches[0].golden == LOGIC_1 &&
+           wrong.mismatches[0].actual == LOGIC_0);
+    WaveDiffOptions masked;
+    masked.masks = {"u.y"};
+    WaveDiffReport hidden = compare_waveforms(golden, bug, masked);
+    assert(hidden.passed() && hidden.masked_signals == 1 && hidden.compared_signals == 4);
+    std::cout << "✓ Functional bug found at t=" << wrong.mismatches[0].time << "ps on "
+              << wrong.mismatches[0].signal << ", hidden by a mask\n";
+
+    // A golden run with an extra net, and the early stop
+    {
+        Simulator sim;
+        build(sim, Variant::Good);
+        sim.create_signal("u.spare", LOGIC_X);
+        TraceWriter writer(sim, "wave_diff_extra.vcd.gz");
+        sim.enable_trace(&writer);
+        stimulus(sim);
+        sim.run_all();
+        writer.close();
+    }
+    WaveDiffOptions one;
+    one.max_mismatches = 1;
+    WaveDiffReport extra = compare_waveforms("wave_diff_extra.vcd.gz", slow, one);
+    assert(extra.only_in_golden.size() == 1 && extra.only_in_golden[0] == "u.spare");
+    assert(extra.only_in_actual.empty() && extra.mismatches.size() == 1 && extra.stopped_early);
+    assert(extra.end_time < late.end_time);
+    std::cout << "✓ Unmatched names listed; stopped at t=" << extra.end_time << "ps after the first mismatch\n";
+
+    std::remove(golden.c_str());
+    std::remove(slow.c_str());
+    std::remove(bug.c_str());
+    std::remove("wave_diff_extra.vcd.gz");
+}
+
+void test_live() {
+    std::cout << "\n=== Test: Live Comparison ===\n";
+
+    const std::string golden = "wave_diff_live.vcd.gz";
+    record(Variant::Good, golden);
+
+    {
+        Simulator sim;
+        build(sim, Variant::Good);
+        LiveComparator* check = sim.create_component<LiveComparator>(sim, golden);
+        stimulus(sim);
+        sim.run_all();
+        const WaveDiffReport& report = check->finish();
+        assert(report.passed() && !sim.stopped() && report.compared_signals == 5);
+        assert(report.golden_changes == report.actual_changes + 5);   // $dumpvars
+        std::cout << "✓ Matching run: " << report.actual_changes << " changes checked as they happen\n";
+    }
+    {
+        Simulator sim;
+        build(sim, Variant::XorBug);
+        WaveDiffOptions options;
+        options.max_mismatches = 1;
+        LiveComparator* check = sim.create_component<LiveComparator>(sim, golden, options);
+        stimulus(sim);
+        sim.run_all();
+        assert(sim.stopped());
+        uint64_t stopped_at = sim.get_current_time();
+        const WaveDiffReport& report = check->finish();
+        assert(report.mismatches.size() == 1 && report.mismatches[0].signal == "u.y" &&
+               report.mismatches[0].time == 420 && report.stopped_early);
+        assert(stopped_at < 700);
+        std::cout << "✓ Buggy run stopped at t=" << stopped_at << "ps, mismatch on "
+                  << report.mismatches[0].signal << " from t=" << report.mismatches[0].time << "ps\n";
+    }
+    std::remove(golden.c_str());
+}
+
+int main() {
+    test_reader();
+    test_files();
+    test_live();
+
+    std::cout << "\n=========================\n";
+    std::cout << "✓ All Wave Diff Tests Passed!\n";
+    std::cout << "=========================\n";
+
+    return 0;
+}
@@ -0,0 +1,183 @@
+#include "sim_server.h"
+#include "simulator.h"
+#include "circuits.h"
+#include "signal.h"
+#include "event.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Load generator for sim_server: N concurrent clients, each sending a series
+// of short runs on one design (random input vectors, a clock if the design
+// has one, up to 8 traced outputs), then throughput and latency percentiles.
+// --cold runs the same requests in-process, elaborating the design for every
+// request, as the baseline the server saves.
+//
+// Usage: load_gen [--socket PATH] [--clients N] [--requests N] [--design NAME]
+//                 [--cycles N] [--cold] [--shutdown]
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr uint64_t PERIOD = 10000;  // ps per input vector / clock cycle
+
+// Request `index` for a design with the given ports (deterministic)
+static SimRequest make_request(const std::string& design, const CircuitPorts& ports, int cycles, uint32_t index) {
+    SimRequest request;
+    request.design = design;
+    request.run_length = cycles * PERIOD;
+    std::mt19937 rng(index);
+    for (int c = 0; c < cycles; c++) {
+        for (Signal* in : ports.inputs) {
+            if (in != ports.clock) {
+                request.drives.push_back({in->get_name(), c * PERIOD, (uint8_t)(rng() & 1)});
+            }
+        }
+    }
+    if (ports.clock) {
+        request.clocks.push_back({ports.clock->get_name(), PERIOD});
+    }
+    for (size_t i = 0; i < ports.outputs.size() && i < 8; i++) {
+        request.traces.push_back(ports.outputs[i]->get_name());
+    }
+    return request;
+}
+
+// In-process equivalent of one server run, elaboration included
+static uint64_t run_cold(const SimRequest& request) {
+    Simulator sim;
+    build_named_circuit(sim, request.design);
+    sim.disable_coverage();
+    for (const SimRequest::Drive& drive : request.drives) {
+        sim.schedule_event(Event(drive.time, sim.get_signal_by_name(drive.net)->get_id(), drive.value));
+    }
+    for (const SimRequest::Clock& clock : request.clocks) {
+        int id = sim.get_signal_by_name(clock.net)->get_id();
+        uint8_t value = 1;
+        for (uint64_t t = clock.period / 2; t <= request.run_length; t += clock.period / 2, value ^= 1) {
+            sim.schedule_event(Event(t, id, value));
+        }
+    }
+    uint64_t before = sim.get_events_processed();
+    sim.run_until(request.run_length);
+    return sim.get_events_processed() - before;
+}
+
+static double percentile(std::vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t index = std::min(sorted.size() - 1, (size_t)(p * sorted.size()));
+    return sorted[index];
+}
+
+int main(int argc, char** argv) {
+    std::string socket_path = "/tmp/logic-sim.sock";
+    std::string design = "lfsr64";
+    int clients = 4;
+    int requests = 100;
+    int cycles = 100;
+    bool cold = false;
+    bool shutdown = false;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            socket_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--clients") == 0 && i + 1 < argc) {
+            clients = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--requests") == 0 && i + 1 < argc) {
+            requests = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--design") == 0 && i + 1 < argc) {
+            design = argv[++i];
+        } else if (std::strcmp(argv[i], "--cycles") == 0 && i + 1 < argc) {
+            cycles = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--cold") == 0) {
+            cold = true;
+        } else if (std::strcmp(argv[i], "--shutdown") == 0) {
+            shutdown = true;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--socket PATH] [--clients N] [--requests N]"
+                      << " [--design NAME] [--cycles N] [--cold] [--shutdown]\n";
+            return 1;
+        }
+    }
+
+    // Elaborate once locally to learn the design's ports
+    Simulator probe;
+    CircuitPorts ports;
+    try {
+        ports = build_named_circuit(probe, design);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    std::vector<std::vector<double>> latencies(clients);
+    std::atomic<uint64_t> changes{0};
+    std::atomic<uint64_t> events{0};
+    std::atomic<int> errors{0};
+    Clock::time_point start = Clock::now();
+    std::vector<std::thread> threads;
+    for (int c = 0; c < clients; c++) {
+        threads.emplace_back([&, c] {
+            try {
+                std::unique_ptr<SimClient> client;
+                if (!cold) {
+                    client = std::make_unique<SimClient>(socket_path);
+                }
+                for (int r = 0; r < requests; r++) {
+                    SimRequest request = make_request(design, ports, cycles, c * requests + r);
+                    Clock::time_point sent = Clock::now();
+                    if (cold) {
+                        events += run_cold(request);
+                    } else {
+                        SimResult result = client->run(request);
+                        changes += result.changes.size();
+                        events += result.events;
+                    }
+                    latencies[c].push_back(std::chrono::duration<double, std::milli>(Clock::now() - sent).count());
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "Client " << c << ": " << e.what() << "\n";
+                errors++;
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::vector<double> all;
+    for (const std::vector<double>& list : latencies) {
+        all.insert(all.end(), list.begin(), list.end());
+    }
+    std::sort(all.begin(), all.end());
+    std::cout << std::fixed << std::setprecision(2)
+              << (cold ? "In-process (elaborate per run)" : "Server") << ": " << design
+              << ", " << clients << " client(s) x " << requests << " run(s) of " << cycles << " cycles\n"
+              << "  runs:        " << all.size() << " in " << seconds << " s = "
+              << all.size() / seconds << " runs/s\n"
+              << "  latency ms:  p50 " << percentile(all, 0.50) << "  p99 " << percentile(all, 0.99)
+              << "  max " << (all.empty() ? 0 : all.back()) << "\n"
+              << "  events:      " << events.load() << "\n";
+    if (!cold) {
+        std::cout << "  traced changes streamed: " << changes.load() << "\n";
+    }
+    if (shutdown) {
+        try {
+            SimClient(socket_path).shutdown();
+        } catch (const std::exception& e) {
+            std::cerr << "Shutdown: " << e.what() << "\n";
+            errors++;
+        }
+    }
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,64 @@
+#include "sim_server.h"
+#include "simulator.h"
+#include "circuits.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Simulation daemon: keeps the named circuits from circuits.h elaborated and
+// serves runs on a Unix-domain socket (protocol in sim_server.h) until a
+// client sends "shutdown" (load_gen --shutdown). A server killed instead
+// leaves its socket file behind; the next start replaces it.
+//
+// Usage: sim_server [--socket PATH] [--workers N] [--event-limit N] [--design NAME]...
+
+int main(int argc, char** argv) {
+    std::string socket_path = "/tmp/logic-sim.sock";
+    size_t workers = 0;
+    uint64_t event_limit = 50000000;
+    std::vector<std::string> names;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            socket_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            workers = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--event-limit") == 0 && i + 1 < argc) {
+            event_limit = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--design") == 0 && i + 1 < argc) {
+            names.push_back(argv[++i]);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--socket PATH] [--workers N] [--event-limit N] [--design NAME]...\n"
+                      << "Designs:";
+            for (const std::string& name : named_circuits()) {
+                std::cerr << " " << name;
+            }
+            std::cerr << "\n";
+            return 1;
+        }
+    }
+    if (names.empty()) {
+        names = named_circuits();
+    }
+
+    SimServer server(socket_path, workers);
+    server.set_event_limit(event_limit);
+    try {
+        for (const std::string& name : names) {
+            server.add_design(name, [name](Simulator& sim) { build_named_circuit(sim, name); });
+        }
+        server.start();
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    std::cout << "Serving " << names.size() << " design(s) with " << server.worker_count()
+              << " worker(s) on " << socket_path << "\n" << std::flush;
+
+    server.wait();
+    server.stop();
+    std::cout << "Stopped: " << server.requests_served() << " run(s) served, "
+              << server.requests_failed() << " failed\n";
+    return 0;
+}
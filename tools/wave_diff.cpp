@@ -0,0 +1,78 @@
+#include "wave_diff.h"
+#include "logic.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+// Regression check of a waveform against a golden one. Both files are VCD,
+// plain or gzip-compressed (TraceWriter output, dump_waveform, or another
+// simulator's dump); signals are matched by hierarchical name. Exits 0 when
+// they agree, 1 on mismatches, 2 on errors.
+//
+// Usage: wave_diff GOLDEN ACTUAL [--tolerance PS] [--tolerance-for PATTERN PS]...
+//                  [--mask PATTERN]... [--x-dont-care] [--max N]
+
+static void usage(const char* program) {
+    std::cerr << "Usage: " << program << " GOLDEN ACTUAL [--tolerance PS] [--tolerance-for PATTERN PS]...\n"
+              << "       [--mask PATTERN]... [--x-dont-care] [--max N]\n"
+              << "Patterns match hierarchical names, '*' matching any run of characters.\n";
+}
+
+int main(int argc, char** argv) {
+    WaveDiffOptions options;
+    std::string files[2];
+    int file_count = 0;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+            options.tolerance = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--tolerance-for") == 0 && i + 2 < argc) {
+            std::string pattern = argv[++i];
+            options.signal_tolerances.emplace_back(pattern, std::strtoull(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--mask") == 0 && i + 1 < argc) {
+            options.masks.push_back(argv[++i]);
+        } else if (std::strcmp(argv[i], "--x-dont-care") == 0) {
+            options.golden_x_matches_any = true;
+        } else if (std::strcmp(argv[i], "--max") == 0 && i + 1 < argc) {
+            options.max_mismatches = std::strtoul(argv[++i], nullptr, 10);
+        } else if (argv[i][0] != '-' && file_count < 2) {
+            files[file_count++] = argv[i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (file_count != 2) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    WaveDiffReport report;
+    try {
+        report = compare_waveforms(files[0], files[1], options);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 2;
+    }
+
+    for (const std::string& name : report.only_in_golden) {
+        std::cout << "only in golden: " << name << "\n";
+    }
+    for (const std::string& name : report.only_in_actual) {
+        std::cout << "only in actual: " << name << "\n";
+    }
+    for (const WaveMismatch& m : report.mismatches) {
+        std::cout << "MISMATCH t=" << m.time << "ps " << m.signal << ": golden "
+                  << logic::to_char(m.golden) << ", actual " << logic::to_char(m.actual) << "\n";
+    }
+    std::cout << report.compared_signals << " signal(s) compared (" << report.masked_signals << " masked), "
+              << report.golden_changes << " golden / " << report.actual_changes << " actual changes to t="
+              << report.end_time << "ps: ";
+    if (report.passed()) {
+        std::cout << "PASS\n";
+        return 0;
+    }
+    std::cout << report.mismatches.size() << " mismatch(es)" << (report.stopped_early ? ", stopped early" : "")
+              << ": FAIL\n";
+    return 1;
+}